@@ -0,0 +1,108 @@
+//
+//  TiVonageCoreJNI.cpp
+//  ti.vonage
+//
+//  JNI bindings for ti.vonage.TiVonageCore and the classes wrapping core
+//  objects. Native objects are owned by their Java wrapper through a jlong
+//  handle and destroyed by its release().
+//
+
+#include <jni.h>
+
+#include "tivonage/Core.h"
+#include "tivonage/PixelConvert.h"
+#include "tivonage/SubscriptionController.h"
+
+extern "C" {
+
+JNIEXPORT jstring JNICALL Java_ti_vonage_TiVonageCore_nativeVersion(JNIEnv *env, jclass)
+{
+  return env->NewStringUTF(tivonage::coreVersion());
+}
+
+JNIEXPORT jboolean JNICALL Java_ti_vonage_TiVonageCore_nativeConvertFlexibleYuv(JNIEnv *env, jclass, jobject y, jint yStride, jobject u,
+    jobject v, jint uvStride, jint uvPixelStride, jint width, jint height, jobject destination)
+{
+  tivonage::FlexibleYuvImage image;
+  image.width = width;
+  image.height = height;
+  image.y = static_cast<const uint8_t *>(env->GetDirectBufferAddress(y));
+  image.yStride = yStride;
+  image.u = static_cast<const uint8_t *>(env->GetDirectBufferAddress(u));
+  image.v = static_cast<const uint8_t *>(env->GetDirectBufferAddress(v));
+  image.uvStride = uvStride;
+  image.uvPixelStride = uvPixelStride;
+
+  uint8_t *packed = static_cast<uint8_t *>(env->GetDirectBufferAddress(destination));
+  const int chromaWidth = (width + 1) / 2;
+  const int chromaRows = (height + 1) / 2;
+  const jlong packedSize = jlong(width) * height + 2 * jlong(chromaWidth) * chromaRows;
+  if (!packed || env->GetDirectBufferCapacity(destination) < packedSize) {
+    return false;
+  }
+  tivonage::VideoFrame frame;
+  frame.format = tivonage::PixelFormat::I420;
+  frame.width = width;
+  frame.height = height;
+  frame.planes[0] = { packed, width };
+  frame.planes[1] = { packed + width * height, chromaWidth };
+  frame.planes[2] = { frame.planes[1].data + chromaWidth * chromaRows, chromaWidth };
+  return tivonage::convertFlexibleYuv(image, frame);
+}
+
+static tivonage::SubscriptionController *subscriptionController(jlong handle)
+{
+  return reinterpret_cast<tivonage::SubscriptionController *>(handle);
+}
+
+JNIEXPORT jlong JNICALL Java_ti_vonage_SubscriptionController_nativeCreate(JNIEnv *, jclass)
+{
+  return reinterpret_cast<jlong>(new tivonage::SubscriptionController());
+}
+
+JNIEXPORT void JNICALL Java_ti_vonage_SubscriptionController_nativeDestroy(JNIEnv *, jclass, jlong handle)
+{
+  delete subscriptionController(handle);
+}
+
+JNIEXPORT void JNICALL Java_ti_vonage_SubscriptionController_nativeSetVisible(JNIEnv *, jclass, jlong handle, jboolean visible, jlong nowUs)
+{
+  subscriptionController(handle)->setVisible(visible, nowUs);
+}
+
+JNIEXPORT void JNICALL Java_ti_vonage_SubscriptionController_nativeSetStreamSize(JNIEnv *, jclass, jlong handle, jint width, jint height)
+{
+  subscriptionController(handle)->setStreamSize(width, height);
+}
+
+JNIEXPORT void JNICALL Java_ti_vonage_SubscriptionController_nativeSetViewSize(JNIEnv *, jclass, jlong handle, jint width, jint height)
+{
+  subscriptionController(handle)->setViewSize(width, height);
+}
+
+JNIEXPORT jboolean JNICALL Java_ti_vonage_SubscriptionController_nativeUpdate(JNIEnv *, jclass, jlong handle, jlong nowUs)
+{
+  return subscriptionController(handle)->update(nowUs);
+}
+
+JNIEXPORT jboolean JNICALL Java_ti_vonage_SubscriptionController_nativeSubscribeToVideo(JNIEnv *, jclass, jlong handle)
+{
+  return subscriptionController(handle)->decision().video;
+}
+
+JNIEXPORT jint JNICALL Java_ti_vonage_SubscriptionController_nativePreferredWidth(JNIEnv *, jclass, jlong handle)
+{
+  return subscriptionController(handle)->decision().preferredWidth;
+}
+
+JNIEXPORT jint JNICALL Java_ti_vonage_SubscriptionController_nativePreferredHeight(JNIEnv *, jclass, jlong handle)
+{
+  return subscriptionController(handle)->decision().preferredHeight;
+}
+
+JNIEXPORT jfloat JNICALL Java_ti_vonage_SubscriptionController_nativePreferredFrameRate(JNIEnv *, jclass, jlong handle)
+{
+  return subscriptionController(handle)->decision().preferredFrameRate;
+}
+
+}
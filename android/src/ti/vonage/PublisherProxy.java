@@ -0,0 +1,178 @@
+package ti.vonage;
+
+import com.opentok.android.BaseVideoCapturer;
+import com.opentok.android.OpentokError;
+import com.opentok.android.Publisher;
+import com.opentok.android.PublisherKit;
+import com.opentok.android.Stream;
+
+import org.appcelerator.kroll.KrollDict;
+import org.appcelerator.kroll.KrollProxy;
+import org.appcelerator.kroll.annotations.Kroll;
+import org.appcelerator.kroll.common.Log;
+import org.appcelerator.titanium.TiApplication;
+
+/**
+ * The handle createPublisher() returns: one published stream with its own
+ * settings, events and lifecycle. The publisher (and its camera) exists as
+ * soon as the handle does; the module publishes it whenever it is wanted
+ * and the session is connected. Main thread only.
+ */
+@Kroll.proxy(parentModule = TiVonageModule.class)
+public class PublisherProxy extends KrollProxy implements PublisherKit.PublisherListener {
+
+    private static final String LCAT = "PublisherProxy";
+
+    private final TiVonageModule module;
+    private Publisher publisher;
+    private VideoProxy viewProxy;
+    private boolean wantsPublishing;
+    private boolean published;
+
+    PublisherProxy(TiVonageModule module, Publisher publisher) {
+        super();
+        this.module = module;
+        this.publisher = publisher;
+        publisher.setPublisherListener(this);
+    }
+
+    Publisher publisher() {
+        return publisher;
+    }
+
+    /**
+     * Whether the app asked for the stream to be published; it then is on
+     * every connect until unpublished.
+     */
+    boolean wantsPublishing() {
+        return wantsPublishing;
+    }
+
+    boolean isPublished() {
+        return published;
+    }
+
+    /**
+     * Set by the module once the stream is handed to the session, cleared
+     * when it goes away.
+     */
+    void setPublished(boolean published) {
+        this.published = published;
+    }
+
+    @Kroll.method
+    public void publish() {
+        if (publisher == null) {
+            Log.e(LCAT, "The publisher was destroyed");
+            return;
+        }
+        wantsPublishing = true;
+        module.publish(this);
+    }
+
+    @Kroll.method
+    public void unpublish() {
+        wantsPublishing = false;
+        if (publisher != null) {
+            module.unpublish(this);
+        }
+    }
+
+    /**
+     * Unpublishes and stops capturing for good.
+     */
+    @Kroll.method
+    public void destroy() {
+        if (publisher == null) {
+            return;
+        }
+        unpublish();
+        module.forget(this);
+        publisher.destroy();
+        publisher = null;
+        viewProxy = null;
+    }
+
+    @Kroll.getProperty
+    public VideoProxy getView() {
+        if (viewProxy == null && publisher != null) {
+            viewProxy = new VideoProxy(publisher.getView());
+            viewProxy.createView(TiApplication.getAppCurrentActivity());
+        }
+        return viewProxy;
+    }
+
+    @Kroll.getProperty
+    public boolean getPublished() {
+        return published;
+    }
+
+    @Kroll.getProperty
+    public String getStreamId() {
+        Stream stream = publisher != null ? publisher.getStream() : null;
+        return stream != null ? stream.getStreamId() : null;
+    }
+
+    @Kroll.getProperty
+    public boolean getPublishAudio() {
+        return publisher != null && publisher.getPublishAudio();
+    }
+
+    @Kroll.setProperty
+    public void setPublishAudio(boolean publishAudio) {
+        if (publisher != null) {
+            publisher.setPublishAudio(publishAudio);
+        }
+    }
+
+    @Kroll.getProperty
+    public boolean getPublishVideo() {
+        return publisher != null && publisher.getPublishVideo();
+    }
+
+    @Kroll.setProperty
+    public void setPublishVideo(boolean publishVideo) {
+        if (publisher != null) {
+            publisher.setPublishVideo(publishVideo);
+        }
+    }
+
+    @Kroll.method
+    public KrollDict getStats() {
+        KrollDict stats = new KrollDict();
+        stats.put("published", published);
+        stats.put("streamId", getStreamId());
+        stats.put("publishAudio", getPublishAudio());
+        stats.put("publishVideo", getPublishVideo());
+        BaseVideoCapturer capturer = publisher != null ? publisher.getCapturer() : null;
+        if (capturer instanceof TiVonageVideoCapturer) {
+            stats.put("capturedFrames", ((TiVonageVideoCapturer) capturer).capturedFrames());
+            stats.put("droppedFrames", ((TiVonageVideoCapturer) capturer).droppedFrames());
+        }
+        return stats;
+    }
+
+    @Override
+    public void onStreamCreated(PublisherKit publisherKit, Stream stream) {
+        KrollDict kd = new KrollDict();
+        kd.put("streamId", stream.getStreamId());
+        fireEvent("streamCreated", kd);
+    }
+
+    @Override
+    public void onStreamDestroyed(PublisherKit publisherKit, Stream stream) {
+        published = false;
+        KrollDict kd = new KrollDict();
+        kd.put("streamId", stream.getStreamId());
+        fireEvent("streamDestroyed", kd);
+    }
+
+    @Override
+    public void onError(PublisherKit publisherKit, OpentokError opentokError) {
+        published = false;
+        KrollDict kd = new KrollDict();
+        kd.put("message", opentokError.getMessage());
+        fireEvent("error", kd);
+        Log.e(LCAT, "Publisher error: " + opentokError.getMessage());
+    }
+}
@@ -0,0 +1,99 @@
+package ti.vonage;
+
+import android.os.SystemClock;
+
+/**
+ * Java side of tivonage::SubscriptionController (see core/). Decides, per
+ * subscribed stream, what to request from the SDK based on how the stream's
+ * view is shown. Main thread only; call {@link #release()} when done.
+ */
+final class SubscriptionController {
+
+    private long handle;
+
+    SubscriptionController() {
+        handle = nativeCreate();
+    }
+
+    void setVisible(boolean visible) {
+        nativeSetVisible(handle, visible, now());
+    }
+
+    /**
+     * The stream's full video dimensions; 0 when unknown.
+     */
+    void setStreamSize(int width, int height) {
+        nativeSetStreamSize(handle, width, height);
+    }
+
+    /**
+     * The size of the stream's view in pixels; 0 when unknown.
+     */
+    void setViewSize(int width, int height) {
+        nativeSetViewSize(handle, width, height);
+    }
+
+    /**
+     * Re-evaluates the decision; true if it changed since the last call.
+     */
+    boolean update() {
+        return nativeUpdate(handle, now());
+    }
+
+    boolean subscribeToVideo() {
+        return nativeSubscribeToVideo(handle);
+    }
+
+    /**
+     * Preferred simulcast layer width / height; 0 for no preference.
+     */
+    int preferredWidth() {
+        return nativePreferredWidth(handle);
+    }
+
+    int preferredHeight() {
+        return nativePreferredHeight(handle);
+    }
+
+    /**
+     * Preferred frame rate; 0 for no preference.
+     */
+    float preferredFrameRate() {
+        return nativePreferredFrameRate(handle);
+    }
+
+    void release() {
+        if (handle != 0) {
+            nativeDestroy(handle);
+            handle = 0;
+        }
+    }
+
+    private static long now() {
+        return SystemClock.elapsedRealtimeNanos() / 1000;
+    }
+
+    static {
+        System.loadLibrary("tivonagecore");
+    }
+
+    private static native long nativeCreate();
+
+    private static native void nativeDestroy(long handle);
+
+    private static native void nativeSetVisible(long handle, boolean visible, long nowUs);
+
+    private static native boolean nativeUpdate(long handle, long nowUs);
+
+    private static native void nativeSetStreamSize(long handle, int width, int height);
+
+    private static native void nativeSetViewSize(long handle, int width, int height);
+
+    private static native boolean nativeSubscribeToVideo(long handle);
+
+    private static native int nativePreferredWidth(long handle);
+
+    private static native int nativePreferredHeight(long handle);
+
+    private static native float nativePreferredFrameRate(long handle);
+}
@@ -0,0 +1,35 @@
+package ti.vonage;
+
+import java.nio.ByteBuffer;
+
+/**
+ * Java side of the portable C++ media core (see core/ and android/jni/).
+ */
+final class TiVonageCore {
+
+    static {
+        System.loadLibrary("tivonagecore");
+    }
+
+    private TiVonageCore() {
+    }
+
+    static String version() {
+        return nativeVersion();
+    }
+
+    /**
+     * Packs a YUV_420_888 image into tightly packed I420 in the direct buffer
+     * {@code destination} (at least width * height * 3 / 2 bytes, rounded up
+     * for odd sizes). All buffers must be direct; returns false otherwise.
+     */
+    static boolean convertFlexibleYuv(ByteBuffer y, int yStride, ByteBuffer u, ByteBuffer v, int uvStride, int uvPixelStride,
+            int width, int height, ByteBuffer destination) {
+        return nativeConvertFlexibleYuv(y, yStride, u, v, uvStride, uvPixelStride, width, height, destination);
+    }
+
+    private static native String nativeVersion();
+
+    private static native boolean nativeConvertFlexibleYuv(ByteBuffer y, int yStride, ByteBuffer u, ByteBuffer v, int uvStride,
+            int uvPixelStride, int width, int height, ByteBuffer destination);
+}
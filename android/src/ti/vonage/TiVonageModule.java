@@ -1,6 +1,8 @@
 package ti.vonage;
 
 import android.app.Activity;
+import android.os.Handler;
+import android.os.Looper;
 import android.view.View;
 import android.widget.FrameLayout;
 
@@ -12,6 +14,8 @@ import com.opentok.android.PublisherKit;
 import com.opentok.android.Session;
 import com.opentok.android.Stream;
 import com.opentok.android.Subscriber;
+import com.opentok.android.SubscriberKit;
+import com.opentok.android.VideoUtils;
 
 import org.appcelerator.kroll.KrollDict;
 import org.appcelerator.kroll.KrollModule;
@@ -23,7 +27,12 @@ import org.appcelerator.titanium.TiApplication;
 import org.appcelerator.titanium.proxy.TiViewProxy;
 import org.appcelerator.titanium.view.TiUIView;
 
-@Kroll.module(name = "TiVonage", id = "ti.vonage", propertyAccessors = {"apiKey", "token", "sessionId", "audioOnly"})
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+
+@Kroll.module(name = "TiVonage", id = "ti.vonage", propertyAccessors = {"apiKey", "token", "sessionId", "audioOnly", "pauseHiddenVideo", "adaptVideoToView", "customCapturer"})
 public class TiVonageModule extends KrollModule implements Session.SessionListener, PublisherKit.PublisherListener {
 
     // Standard Debugging variables
@@ -31,15 +40,37 @@ public class TiVonageModule extends KrollModule implements Session.SessionListen
     private static final boolean DBG = TiConfig.LOGD;
     private static final int RC_SETTINGS_SCREEN_PERM = 123;
     private static final int RC_VIDEO_APP_PERM = 124;
+    // Views don't report being scrolled out of sight, so their on-screen
+    // state and size are sampled a few times per second while there are
+    // subscriptions.
+    private static final long SUBSCRIPTION_INTERVAL_MS = 250;
     private static String API_KEY = "";
     private static String SESSION_ID = "";
     private static String TOKEN = "";
     private Session mSession;
     private FrameLayout mPublisherViewContainer;
     private ConstraintLayout mSubscriberViewContainer;
+    // The implicit publisher, configured by the module's properties and
+    // created on connect when the app made none with createPublisher().
     private Publisher mPublisher;
+    private final List<PublisherProxy> publishers = new ArrayList<>();
+    private boolean connected = false;
     private Subscriber mSubscriber;
     private boolean audioOnly = false;
+    private boolean pauseHiddenVideo = true;
+    private boolean adaptVideoToView = true;
+    private boolean customCapturer = false;
+    private final Map<String, Subscription> subscriptions = new HashMap<>();
+    private final Handler subscriptionHandler = new Handler(Looper.getMainLooper());
+    private final Runnable subscriptionCheck = new Runnable() {
+        @Override
+        public void run() {
+            for (Subscription subscription : subscriptions.values()) {
+                subscription.refresh(pauseHiddenVideo, adaptVideoToView);
+            }
+            subscriptionHandler.postDelayed(this, SUBSCRIPTION_INTERVAL_MS);
+        }
+    };
     private final String permissionsText = "This app needs access to your camera and mic to make video calls";
 
     public TiVonageModule() {
@@ -70,6 +101,15 @@ public class TiVonageModule extends KrollModule implements Session.SessionListen
         if (d.containsKey("audioOnly")) {
             audioOnly = (d.getBoolean("audioOnly"));
         }
+        if (d.containsKey("pauseHiddenVideo")) {
+            pauseHiddenVideo = (d.getBoolean("pauseHiddenVideo"));
+        }
+        if (d.containsKey("adaptVideoToView")) {
+            adaptVideoToView = (d.getBoolean("adaptVideoToView"));
+        }
+        if (d.containsKey("customCapturer")) {
+            customCapturer = (d.getBoolean("customCapturer"));
+        }
     }
 
     @Override
@@ -95,12 +135,78 @@ public class TiVonageModule extends KrollModule implements Session.SessionListen
         }
     }
 
+    @Kroll.method
+    public PublisherProxy createPublisher(@Kroll.argument(optional = true) KrollDict options) {
+        if (options == null) {
+            options = new KrollDict();
+        }
+        // The implicit publisher only stands in while the app has none of its
+        // own; it goes first so the camera is free for the new one.
+        if (mPublisher != null) {
+            if (connected) {
+                mSession.unpublish(mPublisher);
+            }
+            mPublisher.destroy();
+            mPublisher = null;
+        }
+        String videoSource = options.optString("videoSource", "camera");
+        if (!videoSource.equals("camera")) {
+            Log.e(LCAT, "Only the camera can be published on Android, not \"" + videoSource + "\"");
+        }
+        Publisher.Builder pb = new Publisher.Builder(TiApplication.getAppCurrentActivity());
+        if (options.containsKey("name")) {
+            pb.name(options.getString("name"));
+        }
+        pb.audioTrack(options.optBoolean("audioTrack", true));
+        if (!options.optBoolean("videoTrack", true)) {
+            pb.videoTrack(false);
+        } else if (options.optBoolean("customCapturer", false)) {
+            pb.capturer(new TiVonageVideoCapturer(TiApplication.getAppCurrentActivity()));
+        }
+        PublisherProxy proxy = new PublisherProxy(this, pb.build());
+        publishers.add(proxy);
+        return proxy;
+    }
+
+    // Publishes now if the session is connected, otherwise once it is.
+    void publish(PublisherProxy proxy) {
+        if (connected && !proxy.isPublished()) {
+            mSession.publish(proxy.publisher());
+            proxy.setPublished(true);
+        }
+    }
+
+    void unpublish(PublisherProxy proxy) {
+        if (connected && proxy.isPublished()) {
+            mSession.unpublish(proxy.publisher());
+        }
+        proxy.setPublished(false);
+    }
+
+    void forget(PublisherProxy proxy) {
+        publishers.remove(proxy);
+    }
+
     @Override
     public void onConnected(Session session) {
         Log.d(LCAT, "Session Connected");
+        connected = true;
+        // Apps that create their own publishers publish them when they like;
+        // otherwise the module's properties describe one implicit publisher.
+        for (PublisherProxy proxy : publishers) {
+            if (proxy.wantsPublishing()) {
+                publish(proxy);
+            }
+        }
+        if (!publishers.isEmpty()) {
+            return;
+        }
+
         Publisher.Builder pb = new Publisher.Builder(TiApplication.getAppCurrentActivity());
         if (audioOnly) {
             pb.videoTrack(false);
+        } else if (customCapturer) {
+            pb.capturer(new TiVonageVideoCapturer(TiApplication.getAppCurrentActivity()));
         }
         mPublisher = pb.build();
         mPublisher.setPublisherListener(this);
@@ -118,6 +224,16 @@ public class TiVonageModule extends KrollModule implements Session.SessionListen
     @Override
     public void onDisconnected(Session session) {
         Log.d(LCAT, "Session Disconnected");
+        connected = false;
+        for (PublisherProxy proxy : publishers) {
+            proxy.setPublished(false);
+        }
+        mPublisher = null;
+        stopSubscriptionCheck();
+        for (Subscription subscription : subscriptions.values()) {
+            subscription.release();
+        }
+        subscriptions.clear();
         fireEvent("disconnected", new KrollDict());
     }
 
@@ -131,6 +247,12 @@ public class TiVonageModule extends KrollModule implements Session.SessionListen
         VideoProxy vp = new VideoProxy(mSubscriber.getView());
         vp.createView(TiApplication.getAppCurrentActivity());
 
+        Subscription previous = subscriptions.put(stream.getStreamId(), new Subscription(mSubscriber, vp));
+        if (previous != null) {
+            previous.release();
+        }
+        startSubscriptionCheck();
+
         kd.put("view", vp);
         kd.put("userType", "subscriber");
         kd.put("streamId", stream.getStreamId());
@@ -144,6 +266,13 @@ public class TiVonageModule extends KrollModule implements Session.SessionListen
     @Override
     public void onStreamDropped(Session session, Stream stream) {
         Log.d(LCAT, "Stream Dropped");
+        Subscription subscription = subscriptions.remove(stream.getStreamId());
+        if (subscription != null) {
+            subscription.release();
+        }
+        if (subscriptions.isEmpty()) {
+            stopSubscriptionCheck();
+        }
 
         mSubscriber = new Subscriber.Builder(TiApplication.getAppCurrentActivity(), stream).build();
         KrollDict kd = new KrollDict();
@@ -176,6 +305,58 @@ public class TiVonageModule extends KrollModule implements Session.SessionListen
         Log.e(LCAT, "Publisher error: " + opentokError.getMessage());
     }
 
+    private void startSubscriptionCheck() {
+        subscriptionHandler.removeCallbacks(subscriptionCheck);
+        subscriptionHandler.postDelayed(subscriptionCheck, SUBSCRIPTION_INTERVAL_MS);
+    }
+
+    private void stopSubscriptionCheck() {
+        subscriptionHandler.removeCallbacks(subscriptionCheck);
+    }
+
+    /**
+     * Book-keeping for one subscribed stream: the SDK subscriber, the proxy
+     * the app shows it in, and the controller deciding what to request.
+     */
+    private static final class Subscription {
+        final Subscriber subscriber;
+        final VideoProxy viewProxy;
+        final SubscriptionController controller = new SubscriptionController();
+
+        Subscription(Subscriber subscriber, VideoProxy viewProxy) {
+            this.subscriber = subscriber;
+            this.viewProxy = viewProxy;
+        }
+
+        /**
+         * Feeds the current on-screen state to the controller and applies
+         * its decision when it changed. Disabled features are fed neutral
+         * observations (always visible, unknown view size).
+         */
+        void refresh(boolean pauseHiddenVideo, boolean adaptVideoToView) {
+            controller.setVisible(!pauseHiddenVideo || viewProxy.isVisibleOnScreen());
+            Stream stream = subscriber.getStream();
+            controller.setStreamSize(stream != null ? stream.getVideoWidth() : 0, stream != null ? stream.getVideoHeight() : 0);
+            controller.setViewSize(adaptVideoToView ? viewProxy.pixelWidth() : 0, adaptVideoToView ? viewProxy.pixelHeight() : 0);
+            if (!controller.update()) {
+                return;
+            }
+
+            subscriber.setSubscribeToVideo(controller.subscribeToVideo());
+            if (controller.preferredWidth() > 0) {
+                subscriber.setPreferredResolution(new VideoUtils.Size(controller.preferredWidth(), controller.preferredHeight()));
+            } else {
+                subscriber.setPreferredResolution(SubscriberKit.NO_PREFERRED_RESOLUTION);
+            }
+            float frameRate = controller.preferredFrameRate();
+            subscriber.setPreferredFrameRate(frameRate > 0 ? frameRate : SubscriberKit.NO_PREFERRED_FRAMERATE);
+        }
+
+        void release() {
+            controller.release();
+        }
+    }
+
     private class VideoView extends TiUIView {
 
         public VideoView(TiViewProxy proxy) {
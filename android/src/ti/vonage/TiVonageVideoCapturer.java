@@ -0,0 +1,277 @@
+package ti.vonage;
+
+import android.annotation.SuppressLint;
+import android.content.Context;
+import android.graphics.ImageFormat;
+import android.hardware.camera2.CameraAccessException;
+import android.hardware.camera2.CameraCaptureSession;
+import android.hardware.camera2.CameraCharacteristics;
+import android.hardware.camera2.CameraDevice;
+import android.hardware.camera2.CameraManager;
+import android.hardware.camera2.CaptureRequest;
+import android.media.Image;
+import android.media.ImageReader;
+import android.os.Handler;
+import android.os.HandlerThread;
+import android.util.Range;
+import android.view.Surface;
+import android.view.WindowManager;
+
+import com.opentok.android.BaseVideoCapturer;
+
+import org.appcelerator.kroll.common.Log;
+
+import java.nio.ByteBuffer;
+import java.util.Collections;
+import java.util.concurrent.atomic.AtomicLong;
+
+/**
+ * Front camera capturer owned by the module. Camera2 delivers YUV_420_888
+ * images into an ImageReader; each one is packed into a recycled direct
+ * buffer as I420 (in native code, see TiVonageCore) and closed right away,
+ * so the camera never waits on the encoder and nothing is allocated per
+ * frame. All camera callbacks run on one background thread.
+ */
+final class TiVonageVideoCapturer extends BaseVideoCapturer {
+
+    private static final String LCAT = "TiVonageVideoCapturer";
+    private static final int WIDTH = 640;
+    private static final int HEIGHT = 480;
+    private static final int FPS = 30;
+    // Images the camera may have in flight; only the newest is consumed.
+    private static final int READER_IMAGES = 3;
+    // The SDK copies a frame before provideBufferFrame returns, so two
+    // buffers are enough; they are reused round-robin.
+    private static final int POOL_SIZE = 2;
+
+    private final Context context;
+    private final ByteBuffer[] pool = new ByteBuffer[POOL_SIZE];
+    private final AtomicLong capturedFrames = new AtomicLong();
+    private final AtomicLong droppedFrames = new AtomicLong();
+    private int poolIndex;
+    private int poolWidth;
+    private int poolHeight;
+    private HandlerThread thread;
+    private Handler handler;
+    private String cameraId;
+    private int sensorOrientation;
+    private ImageReader reader;
+    private CameraDevice camera;
+    private CameraCaptureSession captureSession;
+    private volatile boolean capturing;
+
+    TiVonageVideoCapturer(Context context) {
+        this.context = context.getApplicationContext();
+    }
+
+    long capturedFrames() {
+        return capturedFrames.get();
+    }
+
+    long droppedFrames() {
+        return droppedFrames.get();
+    }
+
+    @Override
+    public void init() {
+        CameraManager manager = (CameraManager) context.getSystemService(Context.CAMERA_SERVICE);
+        try {
+            for (String id : manager.getCameraIdList()) {
+                CameraCharacteristics characteristics = manager.getCameraCharacteristics(id);
+                Integer facing = characteristics.get(CameraCharacteristics.LENS_FACING);
+                if (facing != null && facing == CameraCharacteristics.LENS_FACING_FRONT) {
+                    cameraId = id;
+                    Integer orientation = characteristics.get(CameraCharacteristics.SENSOR_ORIENTATION);
+                    sensorOrientation = orientation != null ? orientation : 0;
+                    break;
+                }
+            }
+        } catch (CameraAccessException e) {
+            Log.e(LCAT, "Cannot list cameras: " + e.getMessage());
+        }
+        if (cameraId == null) {
+            Log.e(LCAT, "No front camera");
+            return;
+        }
+
+        thread = new HandlerThread("ti.vonage.capture");
+        thread.start();
+        handler = new Handler(thread.getLooper());
+        reader = ImageReader.newInstance(WIDTH, HEIGHT, ImageFormat.YUV_420_888, READER_IMAGES);
+        reader.setOnImageAvailableListener(this::onImageAvailable, handler);
+    }
+
+    @SuppressLint("MissingPermission")
+    @Override
+    public int startCapture() {
+        if (reader == null) {
+            return -1;
+        }
+        capturing = true;
+        CameraManager manager = (CameraManager) context.getSystemService(Context.CAMERA_SERVICE);
+        try {
+            manager.openCamera(cameraId, new CameraDevice.StateCallback() {
+                @Override
+                public void onOpened(CameraDevice device) {
+                    camera = device;
+                    if (!capturing) {
+                        closeCamera();
+                        return;
+                    }
+                    startSession();
+                }
+
+                @Override
+                public void onDisconnected(CameraDevice device) {
+                    device.close();
+                    camera = null;
+                }
+
+                @Override
+                public void onError(CameraDevice device, int error) {
+                    Log.e(LCAT, "Camera error " + error);
+                    device.close();
+                    camera = null;
+                }
+            }, handler);
+        } catch (CameraAccessException | SecurityException e) {
+            Log.e(LCAT, "Cannot open the camera: " + e.getMessage());
+            capturing = false;
+            return -1;
+        }
+        return 0;
+    }
+
+    private void startSession() {
+        try {
+            Surface surface = reader.getSurface();
+            camera.createCaptureSession(Collections.singletonList(surface), new CameraCaptureSession.StateCallback() {
+                @Override
+                public void onConfigured(CameraCaptureSession session) {
+                    if (camera == null) {
+                        return;
+                    }
+                    captureSession = session;
+                    try {
+                        CaptureRequest.Builder request = camera.createCaptureRequest(CameraDevice.TEMPLATE_RECORD);
+                        request.addTarget(surface);
+                        request.set(CaptureRequest.CONTROL_AE_TARGET_FPS_RANGE, new Range<>(FPS, FPS));
+                        session.setRepeatingRequest(request.build(), null, handler);
+                    } catch (CameraAccessException e) {
+                        Log.e(LCAT, "Cannot start capturing: " + e.getMessage());
+                    }
+                }
+
+                @Override
+                public void onConfigureFailed(CameraCaptureSession session) {
+                    Log.e(LCAT, "Cannot configure the capture session");
+                }
+            }, handler);
+        } catch (CameraAccessException e) {
+            Log.e(LCAT, "Cannot create the capture session: " + e.getMessage());
+        }
+    }
+
+    @Override
+    public int stopCapture() {
+        capturing = false;
+        if (handler != null) {
+            handler.post(this::closeCamera);
+        }
+        return 0;
+    }
+
+    private void closeCamera() {
+        if (captureSession != null) {
+            captureSession.close();
+            captureSession = null;
+        }
+        if (camera != null) {
+            camera.close();
+            camera = null;
+        }
+    }
+
+    @Override
+    public void destroy() {
+        stopCapture();
+        if (thread != null) {
+            thread.quitSafely();
+            thread = null;
+        }
+        if (reader != null) {
+            reader.close();
+            reader = null;
+        }
+    }
+
+    @Override
+    public boolean isCaptureStarted() {
+        return capturing;
+    }
+
+    @Override
+    public CaptureSettings getCaptureSettings() {
+        CaptureSettings settings = new CaptureSettings();
+        settings.fps = FPS;
+        settings.width = WIDTH;
+        settings.height = HEIGHT;
+        settings.format = YUV420P;
+        settings.expectedDelay = 0;
+        return settings;
+    }
+
+    @Override
+    public void onPause() {
+    }
+
+    @Override
+    public void onResume() {
+    }
+
+    private void onImageAvailable(ImageReader imageReader) {
+        Image image = imageReader.acquireLatestImage();
+        if (image == null) {
+            return;
+        }
+        if (!capturing) {
+            image.close();
+            return;
+        }
+
+        int width = image.getWidth();
+        int height = image.getHeight();
+        ByteBuffer buffer = nextPoolBuffer(width, height);
+        Image.Plane[] planes = image.getPlanes();
+        boolean packed = TiVonageCore.convertFlexibleYuv(planes[0].getBuffer(), planes[0].getRowStride(), planes[1].getBuffer(),
+                planes[2].getBuffer(), planes[1].getRowStride(), planes[1].getPixelStride(), width, height, buffer);
+        image.close();
+        if (!packed) {
+            droppedFrames.incrementAndGet();
+            return;
+        }
+        provideBufferFrame(buffer, YUV420P, width, height, frameRotation(), true);
+        capturedFrames.incrementAndGet();
+    }
+
+    // Buffers are only reallocated when the camera's size changes.
+    private ByteBuffer nextPoolBuffer(int width, int height) {
+        if (width != poolWidth || height != poolHeight) {
+            int size = width * height + 2 * ((width + 1) / 2) * ((height + 1) / 2);
+            for (int i = 0; i < POOL_SIZE; i++) {
+                pool[i] = ByteBuffer.allocateDirect(size);
+            }
+            poolWidth = width;
+            poolHeight = height;
+        }
+        poolIndex = (poolIndex + 1) % POOL_SIZE;
+        return pool[poolIndex];
+    }
+
+    // Front camera: the sensor's mounting plus the display's rotation.
+    private int frameRotation() {
+        WindowManager windowManager = (WindowManager) context.getSystemService(Context.WINDOW_SERVICE);
+        int displayRotation = windowManager != null ? windowManager.getDefaultDisplay().getRotation() * 90 : 0;
+        return (sensorOrientation + displayRotation) % 360;
+    }
+}
@@ -1,6 +1,7 @@
 package ti.vonage;
 
 import android.app.Activity;
+import android.graphics.Rect;
 import android.view.View;
 
 import org.appcelerator.kroll.KrollDict;
@@ -19,6 +20,7 @@ public class VideoProxy extends TiViewProxy {
     private static final String LCAT = "VideoProxy";
     private static final boolean DBG = TiConfig.LOGD;
     private final View vview;
+    private final Rect visibleRect = new Rect();
 
     // Constructor
     public VideoProxy(View view) {
@@ -34,6 +36,27 @@ public class VideoProxy extends TiViewProxy {
         return view;
     }
 
+    /**
+     * Whether any part of the video view can currently be seen: it is
+     * attached, it and its ancestors are visible, and it is not clipped away
+     * (e.g. scrolled out of a scroll view). Main thread only.
+     */
+    boolean isVisibleOnScreen() {
+        return vview != null && vview.isAttachedToWindow() && vview.isShown()
+            && vview.getAlpha() > 0.01f && vview.getGlobalVisibleRect(visibleRect);
+    }
+
+    /**
+     * The video view's size in pixels; 0 while it isn't attached.
+     */
+    int pixelWidth() {
+        return vview != null && vview.isAttachedToWindow() ? vview.getWidth() : 0;
+    }
+
+    int pixelHeight() {
+        return vview != null && vview.isAttachedToWindow() ? vview.getHeight() : 0;
+    }
+
     // Handle creation options
     @Override
     public void handleCreationDict(KrollDict options) {
@@ -0,0 +1,26 @@
+//
+//  AudioRingBufferBench.cpp
+//  ti.vonage
+//
+
+#include "tivonage/AudioRingBuffer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace tivonage;
+
+// One 10 ms block through the ring, as the audio device does per callback.
+static void BM_AudioRingBufferWriteRead(benchmark::State &state)
+{
+  size_t block = size_t(state.range(0));
+  auto ring = AudioRingBuffer::create(block * 4);
+  std::vector<int16_t> input(block, 1), output(block);
+  for (auto _ : state) {
+    ring->write(input.data(), block);
+    benchmark::DoNotOptimize(ring->read(output.data(), block));
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(block));
+}
+BENCHMARK(BM_AudioRingBufferWriteRead)->Arg(80)->Arg(160)->Arg(480);
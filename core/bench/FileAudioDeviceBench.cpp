@@ -0,0 +1,65 @@
+//
+//  FileAudioDeviceBench.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FileAudioDevice.h"
+#include "tivonage/LoopbackAudioBus.h"
+#include "tivonage/WavWriter.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace tivonage;
+
+// The whole audio path without audio hardware or an SDK: a file-backed
+// device runs free against the loopback bus, so each chunk is a capture
+// callback, a pump and a render callback, plus the file conversion.
+// Argument: the capture file's rate (the bus runs at 16 kHz).
+static void BM_FileAudioDevicePath(benchmark::State &state)
+{
+  const int fileRate = int(state.range(0));
+  const std::string path = "/tmp/tivonage_file_audio_device_bench.wav";
+  {
+    std::vector<int16_t> tone(static_cast<size_t>(fileRate));
+    for (size_t i = 0; i < tone.size(); ++i) {
+      tone[i] = int16_t(8000.0 * std::sin(2.0 * M_PI * 440.0 * double(i) / double(fileRate)));
+    }
+    auto writer = WavWriter::create(path, fileRate, 1);
+    writer->write(tone.data(), tone.size());
+    writer->close();
+  }
+
+  auto bus = LoopbackAudioBus::create(16000, 40);
+  FileAudioDevice::Config config;
+  config.capturePath = path;
+  config.realTime = false;
+  auto captureSink = [&](const int16_t *samples, size_t count) { bus->writeCaptureData(samples, count); };
+  auto renderSource = [&](int16_t *samples, size_t count) { return bus->readRenderData(samples, count); };
+  auto device = FileAudioDevice::create(config, captureSink, renderSource);
+  device->setCapturing(true);
+  device->setRendering(true);
+
+  // Chunks run on the benchmark's thread.
+  for (auto _ : state) {
+    device->processChunk();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()));
+
+  // The same through the device's own thread, as an audio test runs it.
+  config.chunkLimit = 3000;
+  device = FileAudioDevice::create(config, captureSink, renderSource);
+  device->setCapturing(true);
+  device->setRendering(true);
+  device->start();
+  device->wait();
+  FileAudioDevice::Stats stats = device->stats();
+  state.counters["threadedSpeed"] = double(stats.chunks) * double(config.chunkMs) * 1000.0 / double(std::max<int64_t>(stats.elapsedUs, 1));
+  device.reset();
+  remove(path.c_str());
+}
+BENCHMARK(BM_FileAudioDevicePath)->Arg(16000)->Arg(48000);
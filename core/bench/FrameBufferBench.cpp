@@ -0,0 +1,22 @@
+//
+//  FrameBufferBench.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace tivonage;
+
+// Baseline cost of allocating a fresh I420 frame, which pooling avoids.
+static void BM_FrameBufferCreateI420(benchmark::State &state)
+{
+  int width = int(state.range(0));
+  int height = int(state.range(1));
+  for (auto _ : state) {
+    auto buffer = FrameBuffer::create(PixelFormat::I420, width, height);
+    benchmark::DoNotOptimize(buffer->frame().planes[0].data);
+  }
+}
+BENCHMARK(BM_FrameBufferCreateI420)->Args({ 320, 240 })->Args({ 640, 480 })->Args({ 1280, 720 });
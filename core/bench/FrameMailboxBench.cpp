@@ -0,0 +1,41 @@
+//
+//  FrameMailboxBench.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameMailbox.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace tivonage;
+
+// One publish and one take of a pooled frame, the per-frame cost of the
+// hand-off between the render callback and display refresh.
+static void BM_FrameMailboxPublishTake(benchmark::State &state)
+{
+  auto pool = FramePool::create(4);
+  FrameMailbox mailbox;
+  FrameHandle shown;
+  for (auto _ : state) {
+    mailbox.publish(pool->acquire(PixelFormat::I420, 640, 480));
+    mailbox.take(shown);
+    benchmark::DoNotOptimize(shown.frame().planes[0].data);
+  }
+}
+BENCHMARK(BM_FrameMailboxPublishTake);
+
+// Producer outruns the consumer 4:1, so three of four frames are dropped.
+static void BM_FrameMailboxDropping(benchmark::State &state)
+{
+  auto pool = FramePool::create(4);
+  FrameMailbox mailbox;
+  FrameHandle shown;
+  for (auto _ : state) {
+    for (int i = 0; i < 4; ++i) {
+      mailbox.publish(pool->acquire(PixelFormat::I420, 640, 480));
+    }
+    mailbox.take(shown);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * 4);
+}
+BENCHMARK(BM_FrameMailboxDropping);
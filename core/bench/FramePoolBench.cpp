@@ -0,0 +1,23 @@
+//
+//  FramePoolBench.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FramePool.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace tivonage;
+
+// Steady-state lease of a pooled I420 frame; compare with BM_FrameBufferCreateI420.
+static void BM_FramePoolAcquireI420(benchmark::State &state)
+{
+  int width = int(state.range(0));
+  int height = int(state.range(1));
+  auto pool = FramePool::create(4);
+  for (auto _ : state) {
+    FrameHandle handle = pool->acquire(PixelFormat::I420, width, height);
+    benchmark::DoNotOptimize(handle.frame().planes[0].data);
+  }
+}
+BENCHMARK(BM_FramePoolAcquireI420)->Args({ 320, 240 })->Args({ 640, 480 })->Args({ 1280, 720 });
@@ -0,0 +1,95 @@
+//
+//  FrameScalerBench.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/FrameScaler.h"
+#include "tivonage/Simd.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <string>
+#include <utility>
+
+using namespace tivonage;
+
+// Arguments: source width, source height, destination width, destination
+// height, filter (0 = box, 1 = bilinear), SIMD level (0 = scalar reference,
+// 1 = best available). I420 in, NV12 out, as in the iOS renderer.
+static void BM_ScaleFrame(benchmark::State &state)
+{
+  const int sourceWidth = int(state.range(0));
+  const int sourceHeight = int(state.range(1));
+  const int width = int(state.range(2));
+  const int height = int(state.range(3));
+  ScaleFilter filter = state.range(4) ? ScaleFilter::Bilinear : ScaleFilter::Box;
+  SimdLevel level = state.range(5) ? detectedSimdLevel() : SimdLevel::Scalar;
+
+  auto source = FrameBuffer::create(PixelFormat::I420, sourceWidth, sourceHeight);
+  auto destination = FrameBuffer::create(PixelFormat::NV12, width, height);
+  memset(source->frame().planes[0].data, 0x80, source->byteSize());
+  FrameScaler scaler(filter);
+
+  setSimdLevelLimit(level);
+  for (auto _ : state) {
+    scaler.scale(source->frame(), destination->frame());
+    benchmark::ClobberMemory();
+  }
+  setSimdLevelLimit(SimdLevel::NEON);
+
+  char ratio[16];
+  snprintf(ratio, sizeof(ratio), "%.2f", double(width) / sourceWidth);
+  state.SetLabel(std::string(filter == ScaleFilter::Box ? "box " : "bilinear ") + "x" + ratio + " " + simdLevelName(level));
+  state.SetItemsProcessed(int64_t(state.iterations()) * sourceWidth * sourceHeight);
+}
+
+static void scaleRatios(benchmark::internal::Benchmark *benchmark)
+{
+  const int sizes[][4] = {
+    { 1280, 720, 640, 360 },
+    { 1280, 720, 428, 240 },
+    { 1280, 720, 320, 180 },
+    { 1280, 720, 160, 90 },
+    { 640, 480, 254, 190 },
+  };
+  for (const auto &size : sizes) {
+    for (int filter = 0; filter < 2; ++filter) {
+      for (int simd = 0; simd < 2; ++simd) {
+        benchmark->Args({ size[0], size[1], size[2], size[3], filter, simd });
+      }
+    }
+  }
+}
+BENCHMARK(BM_ScaleFrame)->Apply(scaleRatios);
+
+// Arguments: rotation (0, 90, 180, 270), downscale (0 = rotate only,
+// 1 = 1280x720 to 640x360 in the same pass), SIMD level as above.
+static void BM_ScaleRotateFrame(benchmark::State &state)
+{
+  const Rotation rotations[] = { Rotation::None, Rotation::Clockwise90, Rotation::Clockwise180, Rotation::Clockwise270 };
+  Rotation rotation = rotations[state.range(0) / 90];
+  int width = state.range(1) ? 640 : 1280;
+  int height = state.range(1) ? 360 : 720;
+  if (swapsDimensions(rotation)) {
+    std::swap(width, height);
+  }
+  SimdLevel level = state.range(2) ? detectedSimdLevel() : SimdLevel::Scalar;
+
+  auto source = FrameBuffer::create(PixelFormat::I420, 1280, 720);
+  auto destination = FrameBuffer::create(PixelFormat::NV12, width, height);
+  memset(source->frame().planes[0].data, 0x80, source->byteSize());
+  FrameScaler scaler;
+
+  setSimdLevelLimit(level);
+  for (auto _ : state) {
+    scaler.scale(source->frame(), destination->frame(), rotation);
+    benchmark::ClobberMemory();
+  }
+  setSimdLevelLimit(SimdLevel::NEON);
+
+  state.SetLabel(std::to_string(state.range(0)) + (state.range(1) ? " scaled " : " ") + simdLevelName(level));
+  state.SetItemsProcessed(int64_t(state.iterations()) * 1280 * 720);
+}
+BENCHMARK(BM_ScaleRotateFrame)->ArgsProduct({ { 0, 90, 180, 270 }, { 0, 1 }, { 0, 1 } });
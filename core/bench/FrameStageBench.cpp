@@ -0,0 +1,56 @@
+//
+//  FrameStageBench.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/FrameStage.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+
+using namespace tivonage;
+
+// Per-frame cost of the built-in stages on a 640x480 NV12 camera frame, to
+// size the processing budget. Argument: blur radius.
+static void BM_BlurStage(benchmark::State &state)
+{
+  auto frame = FrameBuffer::create(PixelFormat::NV12, 640, 480);
+  memset(frame->frame().planes[0].data, 0x80, frame->byteSize());
+  BlurStage blur(0, 0, 0, 0, int(state.range(0)));
+  for (auto _ : state) {
+    VideoFrame target = frame->frame();
+    benchmark::DoNotOptimize(blur.process(target));
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(frame->byteSize()));
+}
+BENCHMARK(BM_BlurStage)->Arg(4)->Arg(16);
+
+static void BM_LutStage(benchmark::State &state)
+{
+  auto frame = FrameBuffer::create(PixelFormat::NV12, 640, 480);
+  memset(frame->frame().planes[0].data, 0x80, frame->byteSize());
+  auto lut = LutStage::adjust(0.1f, 1.2f, 1.1f);
+  for (auto _ : state) {
+    VideoFrame target = frame->frame();
+    benchmark::DoNotOptimize(lut->process(target));
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(frame->byteSize()));
+}
+BENCHMARK(BM_LutStage);
+
+// A 200x60 name tag.
+static void BM_OverlayStage(benchmark::State &state)
+{
+  auto frame = FrameBuffer::create(PixelFormat::NV12, 640, 480);
+  memset(frame->frame().planes[0].data, 0x80, frame->byteSize());
+  auto image = FrameBuffer::create(PixelFormat::ARGB, 200, 60);
+  memset(image->frame().planes[0].data, 0xC0, image->byteSize());
+  auto overlay = OverlayStage::create(image->frame(), 20, 400, 0.8f);
+  for (auto _ : state) {
+    VideoFrame target = frame->frame();
+    benchmark::DoNotOptimize(overlay->process(target));
+  }
+}
+BENCHMARK(BM_OverlayStage);
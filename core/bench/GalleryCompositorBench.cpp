@@ -0,0 +1,51 @@
+//
+//  GalleryCompositorBench.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/GalleryCompositor.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace tivonage;
+
+// Arguments: tile count, whether the sources already have the tile's size
+// (what the renderers deliver once the layout is stable) or are full 640x480
+// frames that must be scaled. One composed 1170x2532 NV12 surface per
+// iteration, as on an iPhone 13 screen.
+static void BM_ComposeGallery(benchmark::State &state)
+{
+  const size_t count = size_t(state.range(0));
+  const bool prescaled = state.range(1) != 0;
+
+  GalleryLayout layout;
+  layout.update(1170, 2532, count);
+  const GalleryTile &tile = layout.tiles()[0];
+
+  std::vector<std::unique_ptr<FrameBuffer>> sources;
+  std::vector<VideoFrame> frames;
+  for (size_t i = 0; i < count; ++i) {
+    sources.push_back(FrameBuffer::create(PixelFormat::NV12, prescaled ? tile.width : 640, prescaled ? tile.height : 480));
+    memset(sources.back()->frame().planes[0].data, int(i * 8), sources.back()->byteSize());
+    frames.push_back(sources.back()->frame());
+  }
+  auto surface = FrameBuffer::create(PixelFormat::NV12, 1170, 2532);
+  GalleryCompositor compositor;
+
+  for (auto _ : state) {
+    compositor.compose(layout.tiles(), frames.data(), frames.size(), surface->frame());
+    benchmark::ClobberMemory();
+  }
+
+  state.SetLabel(std::to_string(count) + " tiles of " + std::to_string(tile.width) + "x" + std::to_string(tile.height) + (prescaled ? " copied" : " scaled"));
+  state.SetItemsProcessed(int64_t(state.iterations()) * 1170 * 2532);
+}
+BENCHMARK(BM_ComposeGallery)
+    ->ArgsProduct({ { 4, 9, 25 }, { 1, 0 } })
+    ->Unit(benchmark::kMicrosecond);
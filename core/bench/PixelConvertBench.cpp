@@ -0,0 +1,41 @@
+//
+//  PixelConvertBench.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/PixelConvert.h"
+#include "tivonage/Simd.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <string>
+
+using namespace tivonage;
+
+// Arguments: source format, destination format, SIMD level (0 = scalar
+// reference, 1 = best available). Frames are 1280x720.
+static void BM_ConvertFrame(benchmark::State &state)
+{
+  const PixelFormat formats[] = { PixelFormat::I420, PixelFormat::NV12, PixelFormat::ARGB };
+  PixelFormat from = formats[state.range(0)];
+  PixelFormat to = formats[state.range(1)];
+  SimdLevel level = state.range(2) ? detectedSimdLevel() : SimdLevel::Scalar;
+
+  auto source = FrameBuffer::create(from, 1280, 720);
+  auto destination = FrameBuffer::create(to, 1280, 720);
+  memset(source->frame().planes[0].data, 0x80, source->byteSize());
+
+  setSimdLevelLimit(level);
+  for (auto _ : state) {
+    convertFrame(source->frame(), destination->frame());
+    benchmark::ClobberMemory();
+  }
+  setSimdLevelLimit(SimdLevel::NEON);
+
+  const char *names[] = { "I420", "NV12", "ARGB" };
+  state.SetLabel(std::string(names[state.range(0)]) + "->" + names[state.range(1)] + " " + simdLevelName(level));
+  state.SetItemsProcessed(int64_t(state.iterations()) * 1280 * 720);
+}
+BENCHMARK(BM_ConvertFrame)->ArgsProduct({ { 0, 1, 2 }, { 0, 1, 2 }, { 0, 1 } });
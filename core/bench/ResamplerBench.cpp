@@ -0,0 +1,48 @@
+//
+//  ResamplerBench.cpp
+//  ti.vonage
+//
+
+#include "tivonage/Resampler.h"
+#include "tivonage/Simd.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace tivonage;
+
+// Arguments: input rate, output rate, SIMD level (0 = scalar reference,
+// 1 = best available). One 10 ms chunk per iteration, as the audio device
+// converts them.
+static void BM_ResamplerChunk(benchmark::State &state)
+{
+  int inputRate = int(state.range(0));
+  int outputRate = int(state.range(1));
+  SimdLevel level = state.range(2) ? detectedSimdLevel() : SimdLevel::Scalar;
+  auto resampler = Resampler::create(inputRate, outputRate);
+  std::vector<int16_t> input(size_t(inputRate / 100));
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = int16_t(12000.0 * std::sin(2.0 * M_PI * 440.0 * double(i) / inputRate));
+  }
+  std::vector<int16_t> output(resampler->maxOutput(input.size()));
+
+  setSimdLevelLimit(level);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(resampler->process(input.data(), input.size(), output.data()));
+  }
+  setSimdLevelLimit(SimdLevel::NEON);
+
+  state.SetLabel(simdLevelName(level));
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(input.size()));
+}
+BENCHMARK(BM_ResamplerChunk)
+    ->Args({ 48000, 16000, 0 })
+    ->Args({ 48000, 16000, 1 })
+    ->Args({ 44100, 16000, 0 })
+    ->Args({ 44100, 16000, 1 })
+    ->Args({ 16000, 48000, 0 })
+    ->Args({ 16000, 48000, 1 })
+    ->Args({ 16000, 44100, 0 })
+    ->Args({ 16000, 44100, 1 });
@@ -0,0 +1,54 @@
+//
+//  SyntheticVideoSourceBench.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FramePool.h"
+#include "tivonage/PixelConvert.h"
+#include "tivonage/SyntheticVideoSource.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+
+using namespace tivonage;
+
+// Publish-path throughput without a camera: the test pattern runs free into
+// a stand-in for the iOS capturer's consumer, which copies every frame into
+// a pooled NV12 buffer the way it does for the encoder. Arguments: width,
+// height.
+static void BM_SyntheticPublishPath(benchmark::State &state)
+{
+  const int width = int(state.range(0));
+  const int height = int(state.range(1));
+  auto pool = FramePool::create(3);
+  SyntheticVideoSource::Config config;
+  config.width = width;
+  config.height = height;
+  config.realTime = false;
+  auto source = SyntheticVideoSource::create(config, [](const VideoFrame &) {});
+
+  // Frames rendered and consumed on the benchmark's thread.
+  uint64_t index = 0;
+  VideoFrame frame;
+  for (auto _ : state) {
+    source->renderFrame(index++, frame);
+    FrameHandle handle = pool->acquire(PixelFormat::NV12, frame.width, frame.height);
+    benchmark::DoNotOptimize(convertFrame(frame, handle.frame()));
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()));
+
+  // The same through the source's own thread, as the module runs it.
+  config.frameLimit = 300;
+  source = SyntheticVideoSource::create(config, [&](const VideoFrame &rendered) {
+    FrameHandle handle = pool->acquire(PixelFormat::NV12, rendered.width, rendered.height);
+    if (handle) {
+      convertFrame(rendered, handle.frame());
+    }
+  });
+  source->start();
+  source->wait();
+  SyntheticVideoSource::Stats stats = source->stats();
+  state.counters["threadedFps"] = double(stats.frames) * 1000000.0 / double(std::max<int64_t>(stats.elapsedUs, 1));
+}
+BENCHMARK(BM_SyntheticPublishPath)->Args({ 640, 480 })->Args({ 1280, 720 });
@@ -0,0 +1,36 @@
+//
+//  TileHasherBench.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/Simd.h"
+#include "tivonage/TileHasher.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+
+using namespace tivonage;
+
+// Argument: SIMD level (0 = scalar reference, 1 = best available). An
+// unchanged full-screen ARGB frame (1170x2532, an iPhone screen), the common
+// case while sharing a static slide.
+static void BM_TileHasherStaticScreen(benchmark::State &state)
+{
+  SimdLevel level = state.range(0) ? detectedSimdLevel() : SimdLevel::Scalar;
+  auto frame = FrameBuffer::create(PixelFormat::ARGB, 1170, 2532);
+  memset(frame->frame().planes[0].data, 0xA0, frame->byteSize());
+
+  setSimdLevelLimit(level);
+  TileHasher hasher;
+  hasher.update(frame->frame());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(hasher.update(frame->frame()));
+  }
+  setSimdLevelLimit(SimdLevel::NEON);
+
+  state.SetLabel(simdLevelName(level));
+  state.SetBytesProcessed(int64_t(state.iterations()) * 1170 * 2532 * 4);
+}
+BENCHMARK(BM_TileHasherStaticScreen)->Arg(0)->Arg(1);
@@ -0,0 +1,88 @@
+//
+//  ActiveSpeakerDetector.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tivonage {
+
+// Finds who is talking in a room from the audio levels the SDK reports for
+// every subscribed stream. Each stream has a voice activity state with
+// hysteresis: it starts speaking once its level stayed above speechDb for
+// attackUs (a cough or a door does not count) and stops once it stayed
+// below silenceDb for hangoverUs (pauses between words do not count). A
+// score, the level averaged over scoreTimeConstantUs, orders speakers.
+//
+// The active speaker is the speaking stream with the best score; it is
+// replaced after holding the spot for minHoldUs, by a stream scoring
+// switchRatio times better or by any speaker once it went quiet. The
+// ranking holds up to maxRanked recent speakers, active speaker first and
+// the others in the order they started speaking; a silent member keeps its
+// place until a new speaker needs it and it was ranked for minHoldUs. Like
+// SubscriptionController a plain state machine: not thread-safe, driven
+// from the UI tick with monotonic microseconds.
+class ActiveSpeakerDetector {
+public:
+  struct Config {
+    double speechDb = -30.0;
+    double silenceDb = -40.0;
+    int64_t attackUs = 150000;
+    int64_t hangoverUs = 800000;
+    int64_t scoreTimeConstantUs = 1500000;
+    int64_t minHoldUs = 2000000;
+    double switchRatio = 1.5;
+    int maxRanked = 3;
+  };
+
+  ActiveSpeakerDetector();
+  explicit ActiveSpeakerDetector(const Config &config);
+
+  const Config &config() const { return m_config; }
+
+  // A level (0 to 1 amplitude) from an audio level delegate. Adds the
+  // stream on its first level.
+  void addLevel(const std::string &streamId, float amplitude, int64_t nowUs);
+  void removeStream(const std::string &streamId);
+  void clear();
+
+  // Re-evaluates the active speaker and the ranking; true if either changed
+  // since the last update(). A stream whose levels stopped arriving (muted,
+  // or its audio unsubscribed) stops speaking after hangoverUs.
+  bool update(int64_t nowUs);
+
+  // Empty until someone spoke.
+  const std::string &activeSpeaker() const { return m_activeSpeaker; }
+  const std::vector<std::string> &ranking() const { return m_ranking; }
+  bool isRanked(const std::string &streamId) const;
+  bool isSpeaking(const std::string &streamId) const;
+
+private:
+  struct Speaker {
+    std::string streamId;
+    bool speaking = false;
+    int64_t loudSinceUs = -1;
+    int64_t quietSinceUs = -1;
+    int64_t lastLevelUs = 0;
+    double score = 0.0;
+    int64_t rankedSinceUs = 0;
+  };
+
+  Speaker *find(const std::string &streamId);
+  const Speaker *find(const std::string &streamId) const;
+  void updateActiveSpeaker(int64_t nowUs);
+  void updateRanking(int64_t nowUs);
+
+  Config m_config;
+  std::vector<Speaker> m_speakers;
+  std::string m_activeSpeaker;
+  int64_t m_activeSinceUs = 0;
+  std::vector<std::string> m_ranking;
+  bool m_removed = false;
+};
+
+}
@@ -0,0 +1,137 @@
+//
+//  AudioBridge.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/AudioRingBuffer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tivonage {
+
+// Connects a platform audio callback, which runs on a real-time thread, to
+// the SDK's audio bus, which may lock and allocate. The real-time side only
+// copies samples in and out of two AudioRingBuffers; a pump thread drains
+// captured samples to the bus and keeps the render ring filled from it,
+// one chunk at a time, so nothing the SDK does can stall the callback.
+// Mono int16 PCM at one sample rate.
+class AudioBridge {
+public:
+  struct Config {
+    int sampleRate = 16000;
+    // The bus is read and written in chunks of this length; the pump runs
+    // once per chunk.
+    int chunkMs = 10;
+    // Rendered audio queued ahead of the callback. Higher survives a
+    // late pump, at the cost of latency.
+    int renderLatencyMs = 40;
+    // Ring sizes; samples beyond them are dropped (capture) or missing
+    // (render) and counted.
+    int captureBufferMs = 200;
+    int renderBufferMs = 200;
+    // Without a pump thread the owner calls pump() once per chunk, e.g.
+    // from a thread it already paces (or a test).
+    bool pumpThread = true;
+  };
+
+  struct Stats {
+    uint64_t capturedSamples = 0;
+    // Captured samples dropped because the pump fell behind.
+    uint64_t captureOverflows = 0;
+    uint64_t renderedSamples = 0;
+    // Samples the callback asked for but had to play as silence.
+    uint64_t renderUnderflows = 0;
+    // Chunks handed to and taken from the bus.
+    uint64_t captureChunks = 0;
+    uint64_t renderChunks = 0;
+  };
+
+  // Called on the pump thread with one chunk of captured samples.
+  using CaptureSink = std::function<void(const int16_t *samples, size_t count)>;
+  // Called on the pump thread to fill one chunk of render samples; returns
+  // how many it wrote, the rest is played as silence.
+  using RenderSource = std::function<size_t(int16_t *samples, size_t count)>;
+
+  // Starts the (idle) pump thread, if any. Returns nullptr on a bad config.
+  static std::unique_ptr<AudioBridge> create(const Config &config, CaptureSink capture, RenderSource render);
+
+  // Stops the pump thread.
+  ~AudioBridge();
+
+  AudioBridge(const AudioBridge &) = delete;
+  AudioBridge &operator=(const AudioBridge &) = delete;
+
+  const Config &config() const { return m_config; }
+  size_t chunkSamples() const { return m_chunkSamples; }
+
+  // The pump only serves a direction while it is on. Audio queued when a
+  // direction is turned off is dropped (by the pump for capture, by the
+  // callback's next read for render), so a restart never plays or sends
+  // stale samples. Any thread but the real-time one.
+  void setCapturing(bool capturing);
+  void setRendering(bool rendering);
+  bool isCapturing() const { return m_capturing.load(std::memory_order_relaxed); }
+  bool isRendering() const { return m_rendering.load(std::memory_order_relaxed); }
+
+  // Real-time thread. Never lock or allocate.
+  void writeCapture(const int16_t *samples, size_t count);
+  // Real-time thread; fills all of samples, with silence where the ring ran
+  // dry.
+  void readRender(int16_t *samples, size_t count);
+
+  // Queued audio in milliseconds, for the device's delay estimates.
+  int captureDelayMs() const;
+  int renderDelayMs() const;
+
+  Stats stats() const;
+
+  // Drains whole chunks of captured samples to the sink and fills the
+  // render ring up to renderLatencyMs from the source. Only without a pump
+  // thread.
+  void pump();
+
+private:
+  AudioBridge(const Config &config, CaptureSink capture, RenderSource render, std::unique_ptr<AudioRingBuffer> captureRing,
+      std::unique_ptr<AudioRingBuffer> renderRing);
+
+  void run();
+  void pumpCapture();
+  void pumpRender();
+
+  const Config m_config;
+  const size_t m_chunkSamples;
+  const size_t m_renderTarget;
+  CaptureSink m_capture;
+  RenderSource m_render;
+  std::unique_ptr<AudioRingBuffer> m_captureRing;
+  std::unique_ptr<AudioRingBuffer> m_renderRing;
+  std::vector<int16_t> m_chunk;
+
+  std::atomic<bool> m_capturing { false };
+  std::atomic<bool> m_rendering { false };
+  std::atomic<bool> m_flushCapture { false };
+  std::atomic<bool> m_flushRender { false };
+
+  std::atomic<uint64_t> m_capturedSamples { 0 };
+  std::atomic<uint64_t> m_captureOverflows { 0 };
+  std::atomic<uint64_t> m_renderedSamples { 0 };
+  std::atomic<uint64_t> m_renderUnderflows { 0 };
+  std::atomic<uint64_t> m_captureChunks { 0 };
+  std::atomic<uint64_t> m_renderChunks { 0 };
+
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  bool m_stopping = false;
+  std::thread m_thread;
+};
+
+}
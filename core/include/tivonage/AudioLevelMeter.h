@@ -0,0 +1,75 @@
+//
+//  AudioLevelMeter.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tivonage {
+
+// Turns the audio levels the SDK reports for every stream, each several
+// times per UI tick, into one batch of talking-indicator values per tick.
+// A raw level (amplitude, 0 to 1) is mapped onto a dB scale from floorDb
+// (0) to full scale (1); a stream's meter rises to each new peak at once
+// and falls by decayPerSecond after it, so a syllable between two ticks
+// still shows. Not thread-safe; drive it from the thread the SDK reports
+// levels on (the main thread). Timestamps are monotonic microseconds.
+class AudioLevelMeter {
+public:
+  struct Config {
+    double floorDb = -50.0;
+    double decayPerSecond = 1.0;
+    // tick() reports a change once a meter moved by at least this much
+    // since the last reported batch, so a silent room sends nothing.
+    double changeThreshold = 0.01;
+  };
+
+  struct Level {
+    std::string streamId;
+    // Smoothed meter at the last tick, 0 to 1.
+    float level = 0.0f;
+    // Loudest raw level (on the same scale) since the previous batch.
+    float peak = 0.0f;
+  };
+
+  AudioLevelMeter();
+  explicit AudioLevelMeter(const Config &config);
+
+  const Config &config() const { return m_config; }
+
+  // Adds the stream on its first level.
+  void addLevel(const std::string &streamId, float amplitude, int64_t nowUs);
+  void removeStream(const std::string &streamId);
+  void clear();
+
+  // The meters at nowUs, in the order the streams appeared. True if the
+  // batch differs from the last one tick() returned true for: a stream was
+  // added or removed, or a meter moved by changeThreshold.
+  bool tick(int64_t nowUs);
+  const std::vector<Level> &levels() const { return m_levels; }
+
+  // A raw amplitude on the meter's 0 to 1 scale.
+  float scale(float amplitude) const;
+
+private:
+  struct Meter {
+    std::string streamId;
+    float held = 0.0f;
+    int64_t heldAtUs = 0;
+    float peak = 0.0f;
+    float reported = -1.0f;
+  };
+
+  float decayed(const Meter &meter, int64_t nowUs) const;
+
+  Config m_config;
+  std::vector<Meter> m_meters;
+  std::vector<Level> m_levels;
+  bool m_membershipChanged = false;
+};
+
+}
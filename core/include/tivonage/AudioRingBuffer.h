@@ -0,0 +1,50 @@
+//
+//  AudioRingBuffer.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace tivonage {
+
+// Lock-free single-producer / single-consumer ring of int16 PCM samples.
+// Storage is allocated once in create(); write() and read() never lock or
+// allocate and are safe to call from a real-time audio thread.
+class AudioRingBuffer {
+public:
+  // The capacity is rounded up to the next power of two.
+  static std::unique_ptr<AudioRingBuffer> create(size_t minimumCapacity);
+
+  ~AudioRingBuffer();
+
+  AudioRingBuffer(const AudioRingBuffer &) = delete;
+  AudioRingBuffer &operator=(const AudioRingBuffer &) = delete;
+
+  size_t capacity() const { return m_mask + 1; }
+
+  // Producer side. Returns the number of samples actually written.
+  size_t write(const int16_t *samples, size_t count);
+  size_t availableToWrite() const;
+
+  // Consumer side. Returns the number of samples actually read.
+  size_t read(int16_t *samples, size_t count);
+  size_t availableToRead() const;
+
+  // Consumer side. Drops up to count samples without copying them.
+  size_t skip(size_t count);
+
+private:
+  AudioRingBuffer(int16_t *storage, size_t capacity);
+
+  int16_t *m_storage;
+  size_t m_mask;
+  alignas(64) std::atomic<size_t> m_writeIndex { 0 };
+  alignas(64) std::atomic<size_t> m_readIndex { 0 };
+};
+
+}
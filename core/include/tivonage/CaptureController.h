@@ -0,0 +1,108 @@
+//
+//  CaptureController.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace tivonage {
+
+// Picks the capture resolution and frame rate for a published stream from
+// how its uplink is doing, so a congested link is sent fewer pixels at the
+// source instead of the encoder throwing bits away. Fed the cumulative
+// counters of the publisher's video network stats; steps one level at a time
+// down a fixed ladder below the base format, quickly when the link is
+// congested and slowly when it is clean. Like SubscriptionController a plain
+// state machine: not thread-safe, timestamps are monotonic microseconds.
+class CaptureController {
+public:
+  struct Config {
+    // Smoothed packet loss above which the link counts as congested, and
+    // below which it counts as clean. Nothing changes in between.
+    double congestedLoss = 0.05;
+    double cleanLoss = 0.01;
+    // Sent bits per captured pixel below which the encoder is starved for
+    // the current format. That counts as congested only while some loss
+    // (above cleanLoss) shows the link is the limit: a still scene, or the
+    // reduced frame rate of a static one, sends little on a clean link too.
+    double minBitsPerPixel = 0.04;
+    // How long congestion must last before stepping down, which is also the
+    // minimum time between two steps down.
+    int64_t downgradeDelayUs = 2000000;
+    // How long the link must stay clean before stepping back up. Doubles, up
+    // to maxUpgradeDelayUs, whenever congestion returns within that time of
+    // a step up, so a link at its limit doesn't oscillate.
+    int64_t upgradeDelayUs = 10000000;
+    int64_t maxUpgradeDelayUs = 80000000;
+    // Weight of the newest interval in the smoothed loss and bitrate.
+    double smoothing = 0.5;
+  };
+
+  struct Format {
+    int width = 0;
+    int height = 0;
+    float frameRate = 0.0f;
+
+    bool operator==(const Format &other) const
+    {
+      return width == other.width && height == other.height && frameRate == other.frameRate;
+    }
+    bool operator!=(const Format &other) const { return !(*this == other); }
+  };
+
+  // Levels below the base format: 3/4 size, then half the frame rate, then
+  // half size, then a quarter of the frame rate.
+  static constexpr int kLevelCount = 5;
+
+  CaptureController();
+  explicit CaptureController(const Config &config);
+
+  const Config &config() const { return m_config; }
+
+  // The format of level 0, what the capturer produces on a clean link.
+  void setBaseFormat(int width, int height, float frameRate);
+  Format format(int level) const;
+
+  // Cumulative totals over all of the publisher's video stats entries. A
+  // counter going backwards (a new stream) starts over.
+  void addStats(int64_t packetsLost, int64_t packetsSent, int64_t bytesSent, int64_t nowUs);
+
+  // Re-evaluates the level; true if it changed since the last update().
+  bool update(int64_t nowUs);
+
+  int level() const { return m_level; }
+  Format format() const { return format(m_level); }
+
+  // Smoothed over the recent stats intervals; 0 until two samples arrived.
+  double lossRate() const { return m_loss; }
+  double bitrate() const { return m_bitrate; }
+  int64_t upgradeDelayUs() const { return m_upgradeDelayUs; }
+
+private:
+  enum class LinkState {
+    Unknown,
+    Congested,
+    Clean,
+  };
+
+  Config m_config;
+  Format m_base;
+  bool m_hasSample = false;
+  int64_t m_lastLost = 0;
+  int64_t m_lastSent = 0;
+  int64_t m_lastBytes = 0;
+  int64_t m_lastSampleUs = 0;
+  bool m_measured = false;
+  double m_loss = 0.0;
+  double m_bitrate = 0.0;
+  LinkState m_state = LinkState::Unknown;
+  int64_t m_stateSinceUs = 0;
+  int m_level = 0;
+  int64_t m_lastStepUs = 0;
+  bool m_probing = false;
+  int64_t m_upgradeDelayUs = 0;
+};
+
+}
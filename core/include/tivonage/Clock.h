@@ -0,0 +1,27 @@
+//
+//  Clock.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace tivonage {
+
+// Monotonic time for intervals and pacing, never goes backwards.
+inline int64_t monotonicMicros()
+{
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Wall-clock time, comparable between devices whose clocks are in sync.
+inline int64_t wallClockMicros()
+{
+  using namespace std::chrono;
+  return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+}
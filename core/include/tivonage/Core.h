@@ -0,0 +1,14 @@
+//
+//  Core.h
+//  ti.vonage
+//
+//  Portable media core shared by the iOS (ObjC++) and Android (JNI) modules.
+//
+
+#pragma once
+
+namespace tivonage {
+
+const char *coreVersion();
+
+}
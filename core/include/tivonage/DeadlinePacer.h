@@ -0,0 +1,83 @@
+//
+//  DeadlinePacer.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace tivonage {
+
+// Runs a task at a fixed rate on a thread of its own, the clock of the
+// synthetic sources. Each tick is paced against an absolute deadline
+// computed from the start, so the rate doesn't drift however long it runs.
+// A deadline missed by a whole interval skips that tick rather than running
+// a burst. Free-running mode runs ticks back to back to measure throughput.
+class DeadlinePacer {
+public:
+  struct Config {
+    double intervalUs = 10000.0;
+    bool realTime = true;
+    // Stop after this many ticks; 0 runs until stop().
+    uint64_t tickLimit = 0;
+  };
+
+  struct Stats {
+    uint64_t ticks = 0;
+    // Ticks skipped because their deadline had passed by an interval.
+    uint64_t skipped = 0;
+    // How late ticks ran (real-time mode only).
+    double meanLatenessUs = 0.0;
+    int64_t maxLatenessUs = 0;
+    // Since start(); ticks / elapsed is the achieved rate.
+    int64_t elapsedUs = 0;
+  };
+
+  // Called on the pacer's thread. The index counts from 0 at start(),
+  // skipped ticks included, so index * interval is the tick's time.
+  using Task = std::function<void(uint64_t index)>;
+
+  DeadlinePacer(const Config &config, Task task);
+
+  // Stops (see stop()).
+  ~DeadlinePacer();
+
+  DeadlinePacer(const DeadlinePacer &) = delete;
+  DeadlinePacer &operator=(const DeadlinePacer &) = delete;
+
+  const Config &config() const { return m_config; }
+
+  // Starts the thread; false if it is already running.
+  bool start();
+  // Joins the thread, after the tick in flight. Idempotent.
+  void stop();
+  // Blocks until the tick limit is reached. Only with a tickLimit.
+  void wait();
+  Stats stats() const;
+
+  // The pacing decision on its own, for a thread woken nowUs after start()
+  // to run tick index: the index to run, past the ticks whose deadline has
+  // passed by a whole interval, and how late that tick is.
+  static uint64_t dueTick(uint64_t index, double intervalUs, int64_t nowUs, int64_t &latenessUs);
+
+private:
+  void run();
+
+  const Config m_config;
+  Task m_task;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_wake;
+  bool m_stopping = false;
+  bool m_done = false;
+  Stats m_stats;
+  double m_totalLatenessUs = 0.0;
+  std::thread m_thread;
+};
+
+}
@@ -0,0 +1,133 @@
+//
+//  FileAudioDevice.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/AudioBridge.h"
+#include "tivonage/DeadlinePacer.h"
+#include "tivonage/Resampler.h"
+#include "tivonage/WavReader.h"
+#include "tivonage/WavWriter.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace tivonage {
+
+// An audio device without audio hardware, for load and regression tests and
+// benchmarks: capture audio comes from a WAV file, render audio goes to
+// one. A thread of its own plays the hardware's part once per chunk: it
+// writes a chunk of the file to an AudioBridge as a capture callback would,
+// pumps the bridge, and reads a chunk of render audio as a render callback
+// would, so everything between the callbacks and the bus runs as it does on
+// a phone. Chunks are paced by a DeadlinePacer, like SyntheticVideoSource's
+// frames: a chunk whose deadline passed by a whole chunk is skipped, as with
+// a stalled audio unit, and free-running mode runs chunks back to back to
+// measure throughput.
+class FileAudioDevice {
+public:
+  struct Config {
+    // Empty captures silence. Any rate and channel count; it is mixed down
+    // and converted to sampleRate.
+    std::string capturePath;
+    // Empty discards render audio. Written at sampleRate, mono.
+    std::string renderPath;
+    // The bus's rate.
+    int sampleRate = 16000;
+    int chunkMs = 10;
+    // Play the capture file again from the start when it ends; otherwise
+    // capture silence from there on.
+    bool loop = true;
+    bool realTime = true;
+    // Stop after this many chunks; 0 runs until stop().
+    uint64_t chunkLimit = 0;
+    // See AudioBridge::Config.
+    int renderLatencyMs = 40;
+  };
+
+  struct Stats {
+    uint64_t chunks = 0;
+    // Chunks skipped because their deadline had passed by a chunk.
+    uint64_t skipped = 0;
+    // Samples taken from the capture file and written to the render file.
+    uint64_t capturedFrames = 0;
+    uint64_t renderedSamples = 0;
+    // How late chunks ran (real-time mode only).
+    double meanLatenessUs = 0.0;
+    int64_t maxLatenessUs = 0;
+    // Since start(); chunks * chunkMs / elapsed is the achieved speed.
+    int64_t elapsedUs = 0;
+    AudioBridge::Stats bridge;
+  };
+
+  // Returns nullptr if the capture file can't be read, the render file
+  // can't be created or the rates can't be converted.
+  static std::unique_ptr<FileAudioDevice> create(const Config &config, AudioBridge::CaptureSink capture, AudioBridge::RenderSource render);
+
+  // Stops, and completes the render file.
+  ~FileAudioDevice();
+
+  FileAudioDevice(const FileAudioDevice &) = delete;
+  FileAudioDevice &operator=(const FileAudioDevice &) = delete;
+
+  const Config &config() const { return m_config; }
+  size_t chunkSamples() const { return m_bridge->chunkSamples(); }
+
+  // As the platform device's start/stop capture and rendering: audio only
+  // moves in a direction while it is on. Capture resumes where the file
+  // was left.
+  void setCapturing(bool capturing) { m_bridge->setCapturing(capturing); }
+  void setRendering(bool rendering) { m_bridge->setRendering(rendering); }
+  bool isCapturing() const { return m_bridge->isCapturing(); }
+  bool isRendering() const { return m_bridge->isRendering(); }
+  int captureDelayMs() const { return m_bridge->captureDelayMs(); }
+  int renderDelayMs() const { return m_bridge->renderDelayMs(); }
+
+  // Starts the device's thread; false if it is already running.
+  bool start();
+  // Joins the thread, after the chunk in flight. Idempotent.
+  void stop();
+  // Blocks until the chunk limit is reached. Only with a chunkLimit.
+  void wait();
+  Stats stats() const;
+
+  // Runs one chunk on the caller's thread, without pacing. Not while
+  // started.
+  void processChunk();
+
+  // Completes the render file as it stands; rendering resumed later appends
+  // to it. For the SDK's stopRendering(), which may be followed by a start.
+  bool flushRenderFile();
+  // Completes the render file for good. Nothing is written to it afterwards.
+  bool closeRenderFile();
+
+private:
+  FileAudioDevice(const Config &config, std::unique_ptr<AudioBridge> bridge, std::unique_ptr<WavReader> reader,
+      std::unique_ptr<Resampler> resampler, std::unique_ptr<WavWriter> writer);
+
+  void readCapture();
+
+  const Config m_config;
+  std::unique_ptr<AudioBridge> m_bridge;
+  std::unique_ptr<WavReader> m_reader;
+  std::unique_ptr<Resampler> m_resampler;
+  std::unique_ptr<WavWriter> m_writer;
+  size_t m_position = 0;
+  std::vector<int16_t> m_fileChunk;
+  std::vector<int16_t> m_captureChunk;
+  std::vector<int16_t> m_renderChunk;
+  std::atomic<uint64_t> m_capturedFrames { 0 };
+  std::atomic<uint64_t> m_renderedSamples { 0 };
+  // Keeps closeRenderFile() out of a chunk's write.
+  mutable std::mutex m_writerMutex;
+  // Last, so its thread stops before the rest goes away.
+  DeadlinePacer m_pacer;
+};
+
+}
@@ -0,0 +1,42 @@
+//
+//  FrameBuffer.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/VideoFrame.h"
+
+#include <cstddef>
+#include <memory>
+
+namespace tivonage {
+
+// A single allocation holding every plane of a frame. Rows are padded to
+// kSimdAlignment so kernels can use aligned loads on each row start.
+class FrameBuffer {
+public:
+  static std::unique_ptr<FrameBuffer> create(PixelFormat format, int width, int height);
+
+  ~FrameBuffer();
+
+  FrameBuffer(const FrameBuffer &) = delete;
+  FrameBuffer &operator=(const FrameBuffer &) = delete;
+
+  PixelFormat format() const { return m_frame.format; }
+  int width() const { return m_frame.width; }
+  int height() const { return m_frame.height; }
+  size_t byteSize() const { return m_byteSize; }
+
+  VideoFrame &frame() { return m_frame; }
+  const VideoFrame &frame() const { return m_frame; }
+
+private:
+  FrameBuffer(uint8_t *storage, size_t byteSize, const VideoFrame &frame);
+
+  uint8_t *m_storage;
+  size_t m_byteSize;
+  VideoFrame m_frame;
+};
+
+}
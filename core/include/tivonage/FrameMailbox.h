@@ -0,0 +1,63 @@
+//
+//  FrameMailbox.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/FramePool.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace tivonage {
+
+// Latest-frame-wins hand-off between one producer (the SDK render thread)
+// and one consumer (the display refresh). Triple buffered: the producer and
+// consumer each own a slot and swap it with the shared middle slot through
+// a single atomic exchange, so neither side ever waits for the other. A
+// frame that is replaced before the consumer picks it up is released right
+// away and counted as dropped.
+class FrameMailbox {
+public:
+  struct Counters {
+    uint64_t published = 0;
+    uint64_t taken = 0;
+    uint64_t dropped = 0;
+  };
+
+  FrameMailbox() = default;
+
+  FrameMailbox(const FrameMailbox &) = delete;
+  FrameMailbox &operator=(const FrameMailbox &) = delete;
+
+  // Producer side. Returns false if this replaced a frame nobody took.
+  bool publish(FrameHandle frame);
+
+  // Consumer side. Moves the newest unseen frame into frame, or returns
+  // false if nothing was published since the last take().
+  bool take(FrameHandle &frame);
+
+  // Either side; a hint only, the answer may be stale by the time it returns.
+  bool hasFrame() const { return m_middle.load(std::memory_order_relaxed) & kFresh; }
+
+  Counters counters() const;
+
+private:
+  static constexpr uint32_t kIndexMask = 3;
+  static constexpr uint32_t kFresh = 4;
+
+  struct alignas(64) Slot {
+    FrameHandle frame;
+  };
+
+  Slot m_slots[3];
+  alignas(64) std::atomic<uint32_t> m_middle { 1 };
+  alignas(64) uint32_t m_back = 0;
+  std::atomic<uint64_t> m_published { 0 };
+  std::atomic<uint64_t> m_dropped { 0 };
+  alignas(64) uint32_t m_front = 2;
+  std::atomic<uint64_t> m_taken { 0 };
+};
+
+}
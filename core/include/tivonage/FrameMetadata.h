@@ -0,0 +1,49 @@
+//
+//  FrameMetadata.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tivonage {
+
+// What the module attaches to each published frame through OTVideoFrame's
+// metadata (at most 32 bytes on the wire). Layout, little endian:
+//
+//   0   2  magic "TV"
+//   2   1  version (1)
+//   3   1  payload size
+//   4   4  sequence number
+//   8   8  capture time, wall-clock microseconds
+//   16 16  application payload
+//
+// The capture time is wall-clock rather than monotonic so that a receiver
+// with a synchronised clock can compare it against its own.
+struct FrameMetadata {
+  static constexpr size_t kMaxEncodedSize = 32;
+  static constexpr size_t kMaxPayloadSize = 16;
+
+  uint32_t sequence = 0;
+  int64_t captureTimeUs = 0;
+  uint8_t payloadSize = 0;
+  uint8_t payload[kMaxPayloadSize] = {};
+};
+
+// Writes the encoded metadata and returns its size, or 0 if the buffer is
+// too small or the payload too large.
+size_t encodeFrameMetadata(const FrameMetadata &metadata, uint8_t *data, size_t capacity);
+
+// False for anything this module didn't write (other senders may attach
+// their own metadata).
+bool decodeFrameMetadata(const uint8_t *data, size_t size, FrameMetadata &metadata);
+
+// A decoded FrameMetadata together with when the receiver rendered it.
+struct ReceivedFrameMetadata {
+  FrameMetadata metadata;
+  int64_t receivedTimeUs = 0;
+};
+
+}
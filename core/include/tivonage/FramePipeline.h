@@ -0,0 +1,72 @@
+//
+//  FramePipeline.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/FrameStage.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tivonage {
+
+// Runs a chain of FrameStages on a frame within a per-frame time budget.
+// Each stage's cost is tracked as a moving average; a skippable stage whose
+// expected cost no longer fits in what is left of the budget is skipped for
+// that frame, so a busy device loses effects instead of frames. A skipped
+// stage is run again every kProbeFrames skips to measure it afresh, so it
+// comes back once the device catches up. Stages that can't be skipped
+// (crop, scale) always run. Not thread-safe; FrameProcessor drives one from
+// its worker.
+class FramePipeline {
+public:
+  // A second at 30 fps.
+  static constexpr uint64_t kProbeFrames = 30;
+
+  struct StageStats {
+    std::string name;
+    uint64_t runs = 0;
+    uint64_t skips = 0;
+    double averageUs = 0.0;
+  };
+
+  // 0 means no budget: every stage always runs.
+  explicit FramePipeline(int64_t budgetUs = 0);
+
+  int64_t budgetUs() const { return m_budgetUs; }
+  void setBudgetUs(int64_t budgetUs) { m_budgetUs = budgetUs; }
+
+  void addStage(std::unique_ptr<FrameStage> stage);
+  void clear();
+  size_t stageCount() const { return m_stages.size(); }
+
+  // Runs the stages in order. False if one of them dropped the frame; the
+  // frame may then be left half-processed.
+  bool run(VideoFrame &frame);
+
+  std::vector<StageStats> stageStats() const;
+  uint64_t frames() const { return m_frames; }
+  // Frames whose stages took longer than the budget in total.
+  uint64_t overBudgetFrames() const { return m_overBudgetFrames; }
+
+private:
+  struct Entry {
+    std::unique_ptr<FrameStage> stage;
+    uint64_t runs = 0;
+    uint64_t skips = 0;
+    // Frames skipped since the stage last ran.
+    uint64_t skipStreak = 0;
+    double averageUs = 0.0;
+  };
+
+  int64_t m_budgetUs;
+  std::vector<Entry> m_stages;
+  uint64_t m_frames = 0;
+  uint64_t m_overBudgetFrames = 0;
+};
+
+}
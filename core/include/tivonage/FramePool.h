@@ -0,0 +1,106 @@
+//
+//  FramePool.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/FrameBuffer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace tivonage {
+
+class FramePool;
+
+// Reference-counted lease on a pooled FrameBuffer. Copying a handle only
+// bumps an atomic counter; the buffer goes back to its pool when the last
+// handle is dropped, from whichever thread that happens on.
+class FrameHandle {
+public:
+  FrameHandle() = default;
+  FrameHandle(const FrameHandle &other);
+  FrameHandle(FrameHandle &&other) noexcept;
+  FrameHandle &operator=(const FrameHandle &other);
+  FrameHandle &operator=(FrameHandle &&other) noexcept;
+  ~FrameHandle();
+
+  explicit operator bool() const { return m_slot != nullptr; }
+
+  FrameBuffer *buffer() const;
+  VideoFrame &frame() const { return buffer()->frame(); }
+
+  void reset();
+
+  // Hands the lease to C code (e.g. a CVPixelBuffer release callback) as an
+  // opaque pointer. Every detach() must be matched by one adopt().
+  void *detach();
+  static FrameHandle adopt(void *opaque);
+
+private:
+  friend class FramePool;
+  struct Slot;
+  explicit FrameHandle(Slot *slot)
+      : m_slot(slot)
+  {
+  }
+
+  Slot *m_slot = nullptr;
+};
+
+// A fixed number of frame buffers that are reused as long as the requested
+// format and dimensions stay the same. When the stream changes resolution,
+// idle buffers of the old geometry are replaced one at a time.
+class FramePool : public std::enable_shared_from_this<FramePool> {
+public:
+  struct Counters {
+    uint64_t acquired = 0;
+    uint64_t reused = 0;
+    uint64_t allocated = 0;
+    uint64_t exhausted = 0;
+  };
+
+  static std::shared_ptr<FramePool> create(size_t capacity);
+
+  ~FramePool();
+
+  FramePool(const FramePool &) = delete;
+  FramePool &operator=(const FramePool &) = delete;
+
+  // Returns an idle buffer with exactly this geometry, or an empty handle if
+  // every buffer is still in flight (the caller should drop the frame).
+  FrameHandle acquire(PixelFormat format, int width, int height);
+
+  size_t capacity() const { return m_capacity; }
+  size_t inFlight() const;
+  Counters counters() const;
+
+private:
+  friend class FrameHandle;
+
+  explicit FramePool(size_t capacity);
+  void recycle(FrameHandle::Slot *slot);
+
+  const size_t m_capacity;
+  mutable std::mutex m_mutex;
+  std::vector<std::unique_ptr<FrameHandle::Slot>> m_slots;
+  std::vector<FrameHandle::Slot *> m_idle;
+  Counters m_counters;
+};
+
+struct FrameHandle::Slot {
+  std::unique_ptr<FrameBuffer> buffer;
+  std::shared_ptr<FramePool> pool;
+  std::atomic<int> references { 0 };
+};
+
+inline FrameBuffer *FrameHandle::buffer() const
+{
+  return m_slot ? m_slot->buffer.get() : nullptr;
+}
+
+}
@@ -0,0 +1,101 @@
+//
+//  FrameProcessor.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/FrameMailbox.h"
+#include "tivonage/FramePipeline.h"
+#include "tivonage/FramePool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tivonage {
+
+// Runs the pre-encode processing chain on a dedicated worker thread. The
+// capture thread hands each frame over with submit(), which copies it into
+// a pooled buffer and returns; the worker runs the FramePipeline on the
+// newest waiting frame and passes the result to the output (in the module,
+// the publisher's capturer). A frame submitted while the worker is still
+// busy replaces the one waiting, so a slow chain costs frame rate, never
+// latency or memory.
+class FrameProcessor {
+public:
+  struct Config {
+    // Per-frame budget for the pipeline, see FramePipeline. One frame
+    // interval at 30 fps leaves no headroom, so the default is less.
+    int64_t budgetUs = 20000;
+    // Buffers shared by the capture thread, the mailbox and the worker.
+    size_t poolFrames = 4;
+  };
+
+  struct Counters {
+    uint64_t submitted = 0;
+    uint64_t processed = 0;
+    // Replaced in the mailbox before the worker got to them, or no buffer.
+    uint64_t dropped = 0;
+    // Dropped by a stage.
+    uint64_t rejected = 0;
+    uint64_t overBudget = 0;
+  };
+
+  // Called on the worker with each processed frame; the frame's memory is
+  // only valid for the duration of the call.
+  using Output = std::function<void(const VideoFrame &frame)>;
+
+  static std::unique_ptr<FrameProcessor> create(Output output, const Config &config);
+  static std::unique_ptr<FrameProcessor> create(Output output);
+
+  // Stops (see stop()).
+  ~FrameProcessor();
+
+  FrameProcessor(const FrameProcessor &) = delete;
+  FrameProcessor &operator=(const FrameProcessor &) = delete;
+
+  // Capture thread. False if the frame was dropped (no buffer, or stopped).
+  bool submit(const VideoFrame &frame);
+
+  // Any thread. Replaces the chain from the next frame on; an empty list
+  // passes frames through unchanged.
+  void setStages(std::vector<std::unique_ptr<FrameStage>> stages);
+  void setBudgetUs(int64_t budgetUs);
+
+  std::vector<FramePipeline::StageStats> stageStats() const;
+  Counters counters() const;
+
+  // Finishes the frame being processed and joins the worker; frames still
+  // waiting are dropped. Idempotent.
+  void stop();
+
+private:
+  FrameProcessor(Output output, const Config &config);
+
+  void run();
+
+  Output m_output;
+  std::shared_ptr<FramePool> m_pool;
+  FrameMailbox m_mailbox;
+
+  mutable std::mutex m_pipelineMutex;
+  FramePipeline m_pipeline;
+
+  std::mutex m_wakeMutex;
+  std::condition_variable m_wake;
+  bool m_stopping = false;
+
+  std::atomic<uint64_t> m_submitted { 0 };
+  std::atomic<uint64_t> m_processed { 0 };
+  std::atomic<uint64_t> m_dropped { 0 };
+  std::atomic<uint64_t> m_rejected { 0 };
+  std::thread m_thread;
+};
+
+}
@@ -0,0 +1,95 @@
+//
+//  FrameScaler.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/VideoFrame.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tivonage {
+
+enum class ScaleFilter {
+  // Area average over the source pixels each output pixel covers. Best for
+  // the large reductions of gallery thumbnails.
+  Box,
+  Bilinear,
+};
+
+// Clockwise rotation applied while scaling.
+enum class Rotation {
+  None,
+  Clockwise90,
+  Clockwise180,
+  Clockwise270,
+};
+
+// The rotation that shows a frame of this orientation upright. OpenTok
+// describes Left as rotated by 90 degrees and Right as rotated by 270.
+Rotation uprightRotation(VideoOrientation orientation);
+
+inline bool swapsDimensions(Rotation rotation)
+{
+  return rotation == Rotation::Clockwise90 || rotation == Rotation::Clockwise270;
+}
+
+// Largest size not above the source that still covers the bounds while
+// keeping the aspect ratio (what an aspect-fill view shows). Dimensions are
+// rounded to even numbers so 4:2:0 chroma stays aligned.
+void scaledSizeToFill(int sourceWidth, int sourceHeight, int boundsWidth, int boundsHeight, int &width, int &height);
+
+// Resamples frames to the destination's dimensions. Supports I420, NV12
+// and ARGB to the same format, plus I420 to NV12 (scaling and interleaving
+// in one pass). A rotation is fused into the same pass: the scaler works in
+// strips of eight output rows that stay in cache and are transposed (or
+// mirrored) straight into the destination, so the full-size source is read
+// once and nothing frame-sized is written twice. Scratch rows are kept
+// between calls, so steady-state scaling does not allocate. Not thread-safe;
+// use one per render thread.
+class FrameScaler {
+public:
+  explicit FrameScaler(ScaleFilter filter = ScaleFilter::Box);
+
+  ScaleFilter filter() const { return m_filter; }
+  void setFilter(ScaleFilter filter) { m_filter = filter; }
+
+  // The destination's dimensions are those after rotation. The result is
+  // upright, so its orientation is set to VideoOrientation::Up.
+  bool scale(const VideoFrame &source, VideoFrame &destination, Rotation rotation = Rotation::None);
+
+  // Scales one plane of interleaved 8-bit samples with the given number of
+  // channels (1 for Y / U / V, 2 for NV12 UV, 4 for ARGB). width and height
+  // are the destination's, after rotation.
+  void scalePlane(const uint8_t *source, int sourceStride, int sourceWidth, int sourceHeight,
+      uint8_t *destination, int destinationStride, int width, int height, int channels,
+      Rotation rotation = Rotation::None);
+
+private:
+  enum class Mode {
+    Copy,
+    Box,
+    Bilinear,
+  };
+
+  // Produce rows [firstRow, firstRow + rowCount) of the unrotated scaled
+  // plane. The column table must have been prepared for the plane.
+  void boxRows(const uint8_t *source, int sourceStride, int sourceWidth, int sourceHeight, int width, int height,
+      int channels, int firstRow, int rowCount, uint8_t *destination, ptrdiff_t destinationStride);
+  void bilinearRows(const uint8_t *source, int sourceStride, int sourceWidth, int sourceHeight, int width, int height,
+      int channels, int firstRow, int rowCount, uint8_t *destination, ptrdiff_t destinationStride);
+  void rotateStrip(const uint8_t *strip, ptrdiff_t stripStride, int firstRow, int rowCount, int width, int height,
+      int channels, Rotation rotation, uint8_t *destination, int destinationStride);
+
+  ScaleFilter m_filter;
+  std::vector<uint16_t> m_accumulator;
+  std::vector<uint8_t> m_row;
+  std::vector<int> m_columns;
+  std::vector<uint8_t> m_strip;
+  std::vector<uint8_t> m_chroma;
+};
+
+}
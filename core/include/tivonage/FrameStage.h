@@ -0,0 +1,140 @@
+//
+//  FrameStage.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/FrameScaler.h"
+#include "tivonage/VideoFrame.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace tivonage {
+
+// One step of the pre-encode processing chain (see FramePipeline). Stages
+// run one after the other on the processing worker, each on the previous
+// one's output. Built-in stages handle I420 and NV12 and keep whatever
+// storage they need between frames, so steady-state processing does not
+// allocate. Custom stages subclass this.
+class FrameStage {
+public:
+  virtual ~FrameStage() = default;
+
+  virtual const char *name() const = 0;
+
+  // Whether the pipeline may skip the stage to stay within its time budget.
+  // Stages that change the frame's geometry can't be skipped, or the stream
+  // would change size whenever the device is busy.
+  virtual bool skippable() const { return true; }
+
+  // Processes the frame in place, or points it at the stage's own storage.
+  // The frame's memory belongs to the pipeline for the duration of the run.
+  // Returns false to drop the frame.
+  virtual bool process(VideoFrame &frame) = 0;
+};
+
+// Cuts a rectangle out of the frame without copying, by moving the plane
+// pointers. The rectangle is clipped to the frame and rounded to even
+// coordinates for 4:2:0 chroma.
+class CropStage : public FrameStage {
+public:
+  CropStage(int x, int y, int width, int height);
+
+  const char *name() const override { return "crop"; }
+  bool skippable() const override { return false; }
+  bool process(VideoFrame &frame) override;
+
+private:
+  int m_x;
+  int m_y;
+  int m_width;
+  int m_height;
+};
+
+// Resamples the frame to exactly width x height (crop first to keep the
+// aspect ratio).
+class ScaleStage : public FrameStage {
+public:
+  ScaleStage(int width, int height);
+
+  const char *name() const override { return "scale"; }
+  bool skippable() const override { return false; }
+  bool process(VideoFrame &frame) override;
+
+private:
+  int m_width;
+  int m_height;
+  FrameScaler m_scaler;
+  std::unique_ptr<FrameBuffer> m_output;
+};
+
+// Maps every Y, U and V sample through a lookup table, in place.
+class LutStage : public FrameStage {
+public:
+  LutStage(const uint8_t y[256], const uint8_t u[256], const uint8_t v[256]);
+
+  // Tables for video-range YUV: brightness in [-1, 1] shifts luma,
+  // contrast scales luma around mid-grey and saturation scales chroma
+  // around neutral (1 leaves them unchanged).
+  static std::unique_ptr<LutStage> adjust(float brightness, float contrast, float saturation);
+
+  const char *name() const override { return "lut"; }
+  bool process(VideoFrame &frame) override;
+
+private:
+  uint8_t m_y[256];
+  uint8_t m_u[256];
+  uint8_t m_v[256];
+};
+
+// Blends an image with alpha (a watermark, a name tag) onto the frame at a
+// fixed position, in place. The image is converted to 4:2:0 with per-sample
+// alpha once, when the stage is created.
+class OverlayStage : public FrameStage {
+public:
+  // image is ARGB (B, G, R, A in memory, straight alpha); opacity scales
+  // its alpha. Returns nullptr for an empty image.
+  static std::unique_ptr<OverlayStage> create(const VideoFrame &image, int x, int y, float opacity);
+
+  const char *name() const override { return "overlay"; }
+  bool process(VideoFrame &frame) override;
+
+private:
+  OverlayStage(std::unique_ptr<FrameBuffer> yuv, int x, int y);
+
+  std::unique_ptr<FrameBuffer> m_yuv;
+  std::vector<uint8_t> m_alpha;
+  std::vector<uint8_t> m_chromaAlpha;
+  int m_x;
+  int m_y;
+};
+
+// Box-blurs a rectangle of the frame in place (e.g. to hide a background
+// region or a face). A width or height of 0 blurs the whole frame. The
+// radius is in luma pixels, at most kMaxRadius.
+class BlurStage : public FrameStage {
+public:
+  static constexpr int kMaxRadius = 32;
+
+  BlurStage(int x, int y, int width, int height, int radius);
+
+  const char *name() const override { return "blur"; }
+  bool process(VideoFrame &frame) override;
+
+private:
+  void blurPlane(uint8_t *data, int stride, int width, int height, int channels, int radius);
+
+  int m_x;
+  int m_y;
+  int m_width;
+  int m_height;
+  int m_radius;
+  std::vector<uint8_t> m_rows;
+  std::vector<uint32_t> m_sums;
+};
+
+}
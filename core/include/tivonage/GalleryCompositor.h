@@ -0,0 +1,46 @@
+//
+//  GalleryCompositor.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/FrameScaler.h"
+#include "tivonage/GalleryLayout.h"
+#include "tivonage/VideoFrame.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tivonage {
+
+// Draws many streams into one NV12 surface, one per GalleryLayout tile.
+// Each frame is centre-cropped to its tile's aspect ratio and scaled (and
+// turned upright) into place with the SIMD FrameScaler; a frame that already
+// has the tile's size after cropping is a plain row copy. Everything outside
+// a drawn tile is filled black, so every surface pixel is written exactly
+// once. Not thread-safe; use one per display thread.
+class GalleryCompositor {
+public:
+  static constexpr uint8_t kBackgroundLuma = 16;
+  static constexpr uint8_t kBackgroundChroma = 128;
+
+  explicit GalleryCompositor(ScaleFilter filter = ScaleFilter::Box);
+
+  // frames[i] goes into tiles[i]; a frame without pixels (zero width or
+  // height, or an unsupported format) leaves its tile black. Sources may be
+  // I420 or NV12. The surface must be NV12.
+  bool compose(const std::vector<GalleryTile> &tiles, const VideoFrame *frames, size_t frameCount, VideoFrame &surface);
+
+  // Draws a single frame into its tile, leaving the rest of the surface as is.
+  bool drawTile(const VideoFrame &frame, const GalleryTile &tile, VideoFrame &surface);
+
+private:
+  void fillBackground(const std::vector<GalleryTile> &tiles, const VideoFrame *frames, size_t frameCount, VideoFrame &surface);
+
+  FrameScaler m_scaler;
+  std::vector<int> m_spans;
+};
+
+}
@@ -0,0 +1,58 @@
+//
+//  GalleryLayout.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace tivonage {
+
+// A tile's rectangle in surface pixels. Position and size are even so 4:2:0
+// chroma rows and columns line up with the tile.
+struct GalleryTile {
+  int x = 0;
+  int y = 0;
+  int width = 0;
+  int height = 0;
+
+  bool contains(int px, int py) const { return px >= x && py >= y && px < x + width && py < y + height; }
+};
+
+// Arranges N equally sized tiles of a fixed aspect ratio in a grid on a
+// surface, picking the column count that gives the largest tiles. The grid
+// is centred, and a partly filled last row is centred on its own.
+class GalleryLayout {
+public:
+  struct Config {
+    // Gap around and between tiles, in pixels.
+    int spacing = 8;
+    // Tile width / height.
+    double tileAspect = 1.0;
+  };
+
+  GalleryLayout();
+  explicit GalleryLayout(const Config &config);
+
+  // Recomputes the tiles; returns true if any of them moved or resized.
+  bool update(int surfaceWidth, int surfaceHeight, size_t tileCount);
+
+  const std::vector<GalleryTile> &tiles() const { return m_tiles; }
+  int columns() const { return m_columns; }
+  int rows() const { return m_rows; }
+
+  // Index of the tile under the point, or -1 for the gaps between tiles.
+  int tileAt(int x, int y) const;
+
+private:
+  Config m_config;
+  int m_surfaceWidth = 0;
+  int m_surfaceHeight = 0;
+  int m_columns = 0;
+  int m_rows = 0;
+  std::vector<GalleryTile> m_tiles;
+};
+
+}
@@ -0,0 +1,69 @@
+//
+//  LatencyHistogram.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace tivonage {
+
+// HDR-style histogram of microsecond latencies: values below 32 are counted
+// exactly, above that each power-of-two range is split into 32 linear
+// buckets, so any percentile is reported within ~3% of the true value up to
+// kMaxValueUs (larger values are clamped). Fixed memory, no allocation.
+//
+// record() is meant for one writer thread; the queries may run on any thread
+// concurrently and see a recent, possibly not quite consistent, state.
+class LatencyHistogram {
+public:
+  static constexpr int kSubBucketBits = 5;
+  static constexpr int kMaxValueBits = 30;
+  static constexpr int64_t kMaxValueUs = (int64_t(1) << kMaxValueBits) - 1;
+  static constexpr size_t kBucketCount = size_t(kMaxValueBits - kSubBucketBits + 1) << kSubBucketBits;
+
+  struct Summary {
+    uint64_t count = 0;
+    int64_t minUs = 0;
+    int64_t meanUs = 0;
+    int64_t p50Us = 0;
+    int64_t p95Us = 0;
+    int64_t p99Us = 0;
+    int64_t maxUs = 0;
+  };
+
+  LatencyHistogram();
+
+  // Negative values (sender clock ahead of ours) are recorded as 0.
+  void record(int64_t valueUs);
+
+  uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+  int64_t min() const;
+  int64_t max() const { return m_max.load(std::memory_order_relaxed); }
+  int64_t mean() const;
+
+  // The highest value equivalent to the bucket holding the given percentile
+  // (0-100), never above max(). 0 when empty.
+  int64_t percentile(double percent) const;
+
+  Summary summary() const;
+
+  // Not safe against a concurrent record().
+  void reset();
+
+  static size_t bucketIndex(int64_t valueUs);
+  static int64_t bucketLowest(size_t index);
+  static int64_t bucketHighest(size_t index);
+
+private:
+  std::atomic<uint32_t> m_buckets[kBucketCount];
+  std::atomic<uint64_t> m_count;
+  std::atomic<int64_t> m_sum;
+  std::atomic<int64_t> m_min;
+  std::atomic<int64_t> m_max;
+};
+
+}
@@ -0,0 +1,52 @@
+//
+//  LoopbackAudioBus.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/AudioRingBuffer.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace tivonage {
+
+// Stands in for the SDK's audio bus where there is none (tests, benchmarks,
+// the Linux build): captured samples come back as render samples delayMs
+// later, as if every subscriber echoed the publisher. Mono int16 PCM. One
+// thread writes and one reads, each possibly the real-time one; nothing
+// locks or allocates after create().
+class LoopbackAudioBus {
+public:
+  // Returns nullptr on a bad rate. The ring holds the delay plus
+  // bufferMs; captured samples that don't fit are dropped and counted.
+  static std::unique_ptr<LoopbackAudioBus> create(int sampleRate, int delayMs, int bufferMs = 500);
+
+  LoopbackAudioBus(const LoopbackAudioBus &) = delete;
+  LoopbackAudioBus &operator=(const LoopbackAudioBus &) = delete;
+
+  int sampleRate() const { return m_sampleRate; }
+
+  // As OTAudioBus's writeCaptureData / readRenderData. Reading returns the
+  // samples available, at most count.
+  void writeCaptureData(const int16_t *samples, size_t count);
+  size_t readRenderData(int16_t *samples, size_t count);
+
+  uint64_t capturedSamples() const { return m_capturedSamples.load(std::memory_order_relaxed); }
+  uint64_t droppedSamples() const { return m_droppedSamples.load(std::memory_order_relaxed); }
+  uint64_t renderedSamples() const { return m_renderedSamples.load(std::memory_order_relaxed); }
+
+private:
+  LoopbackAudioBus(int sampleRate, std::unique_ptr<AudioRingBuffer> ring);
+
+  const int m_sampleRate;
+  std::unique_ptr<AudioRingBuffer> m_ring;
+  std::atomic<uint64_t> m_capturedSamples { 0 };
+  std::atomic<uint64_t> m_droppedSamples { 0 };
+  std::atomic<uint64_t> m_renderedSamples { 0 };
+};
+
+}
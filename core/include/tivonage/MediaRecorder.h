@@ -0,0 +1,133 @@
+//
+//  MediaRecorder.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/AudioRingBuffer.h"
+#include "tivonage/FramePool.h"
+#include "tivonage/FrameScaler.h"
+#include "tivonage/SpscQueue.h"
+#include "tivonage/VideoFrame.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tivonage {
+
+class WavWriter;
+class Y4mWriter;
+
+// Records one stream's video to .y4m and, optionally, audio to .wav with
+// write-behind I/O. The render and audio threads only copy into storage
+// allocated up front (a small frame pool and a sample ring) and never touch
+// the disk; a dedicated thread drains both into the files. When the disk
+// falls behind and that storage is full, new frames and samples are dropped
+// and counted instead of blocking the caller, so memory stays flat however
+// long the recording runs. Video is retimed onto the file's constant frame
+// rate by timestamp, so a slower or uneven source keeps time with the audio.
+class MediaRecorder {
+public:
+  struct Config {
+    // The .y4m's constant rate. Each timestamped frame takes the slot of this
+    // grid nearest its time: the previous frame is repeated over empty slots
+    // and a frame landing on an already written slot is dropped. Frames
+    // without a timestamp (0) take the next slot.
+    int frameRate = 30;
+    // Frames that may wait for the disk before new ones are dropped.
+    size_t queuedFrames = 8;
+    int audioSampleRate = 48000;
+    int audioChannels = 1;
+    // Audio that may wait for the disk before new samples are dropped.
+    int queuedAudioMs = 2000;
+  };
+
+  struct Counters {
+    // Frames written to the file, and extra copies written to fill gaps.
+    uint64_t recordedFrames = 0;
+    uint64_t repeatedFrames = 0;
+    // Includes frames dropped for landing on a slot already written.
+    uint64_t droppedFrames = 0;
+    uint64_t recordedSamples = 0;
+    uint64_t droppedSamples = 0;
+    // A write failed (e.g. the disk is full); nothing more is written.
+    bool failed = false;
+  };
+
+  // An empty audioPath records video only. Returns nullptr if the audio file
+  // can't be created; the video file is created with the first frame, whose
+  // upright size fixes the recording's size.
+  static std::unique_ptr<MediaRecorder> create(const std::string &videoPath, const std::string &audioPath, const Config &config);
+  static std::unique_ptr<MediaRecorder> create(const std::string &videoPath, const std::string &audioPath);
+
+  // Stops (see stop()).
+  ~MediaRecorder();
+
+  MediaRecorder(const MediaRecorder &) = delete;
+  MediaRecorder &operator=(const MediaRecorder &) = delete;
+
+  // Render thread (one producer). Turns the frame upright, converts it to
+  // I420 and scales it to the recording size if it changed. False if the
+  // frame was dropped.
+  bool writeVideoFrame(const VideoFrame &frame);
+
+  // Audio thread (one producer). Interleaved samples; returns how many were
+  // queued, the rest are dropped.
+  size_t writeAudio(const int16_t *samples, size_t count);
+
+  // Writes what is queued, finalises the files and joins the I/O thread.
+  // Frames and samples arriving afterwards are dropped. Idempotent.
+  void stop();
+
+  bool stopped() const { return m_stopping.load(std::memory_order_acquire); }
+  Counters counters() const;
+
+private:
+  MediaRecorder(const std::string &videoPath, std::unique_ptr<WavWriter> audio, const Config &config);
+
+  void run();
+  bool drain();
+  bool writeFrame(const FrameHandle &handle);
+
+  const Config m_config;
+  const std::string m_videoPath;
+
+  // Producer side of the video path.
+  std::shared_ptr<FramePool> m_pool;
+  FrameScaler m_scaler;
+  std::unique_ptr<FrameBuffer> m_scratch;
+  int m_width = 0;
+  int m_height = 0;
+
+  SpscQueue<FrameHandle> m_frames;
+  std::unique_ptr<AudioRingBuffer> m_audio;
+
+  // I/O thread only.
+  std::unique_ptr<Y4mWriter> m_videoWriter;
+  std::unique_ptr<WavWriter> m_audioWriter;
+  std::vector<int16_t> m_audioChunk;
+  // The last frame written, repeated over gaps in the timestamps.
+  FrameHandle m_lastFrame;
+  // Timestamp of grid slot 0, set by the first timestamped frame.
+  int64_t m_originUs = 0;
+  bool m_hasOrigin = false;
+  // Grid slots written so far.
+  int64_t m_nextSlot = 0;
+
+  std::atomic<uint64_t> m_recordedFrames { 0 };
+  std::atomic<uint64_t> m_repeatedFrames { 0 };
+  std::atomic<uint64_t> m_droppedFrames { 0 };
+  std::atomic<uint64_t> m_recordedSamples { 0 };
+  std::atomic<uint64_t> m_droppedSamples { 0 };
+  std::atomic<bool> m_failed { false };
+  std::atomic<bool> m_stopping { false };
+  std::thread m_thread;
+};
+
+}
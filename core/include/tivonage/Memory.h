@@ -0,0 +1,35 @@
+//
+//  Memory.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+
+namespace tivonage {
+
+// Alignment used for every buffer a SIMD kernel may touch.
+constexpr size_t kSimdAlignment = 64;
+
+constexpr size_t alignUp(size_t value, size_t alignment)
+{
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+inline void *alignedAlloc(size_t size, size_t alignment = kSimdAlignment)
+{
+  void *pointer = nullptr;
+  if (posix_memalign(&pointer, alignment, size) != 0) {
+    return nullptr;
+  }
+  return pointer;
+}
+
+inline void alignedFree(void *pointer)
+{
+  free(pointer);
+}
+
+}
@@ -0,0 +1,37 @@
+//
+//  PixelConvert.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/VideoFrame.h"
+
+namespace tivonage {
+
+// Converts between any two of I420, NV12 and ARGB (BT.601, video range),
+// honouring the stride of every plane. Both frames must have the same
+// dimensions; identical formats are copied. Uses the best kernels for
+// activeSimdLevel(); SimdLevel::Scalar is the reference implementation.
+bool convertFrame(const VideoFrame &source, VideoFrame &destination);
+
+// A 4:2:0 image whose chroma samples are pixelStride bytes apart, as handed
+// out by Android's ImageReader (YUV_420_888): 1 for planar, 2 for U and V
+// interleaved in either order.
+struct FlexibleYuvImage {
+  int width = 0;
+  int height = 0;
+  const uint8_t *y = nullptr;
+  int yStride = 0;
+  const uint8_t *u = nullptr;
+  const uint8_t *v = nullptr;
+  int uvStride = 0;
+  int uvPixelStride = 1;
+};
+
+// Packs the image into an I420 frame of the same dimensions. Planar and
+// interleaved chroma use the SIMD kernels; other pixel strides are copied
+// sample by sample.
+bool convertFlexibleYuv(const FlexibleYuvImage &source, VideoFrame &destination);
+
+}
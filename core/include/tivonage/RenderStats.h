@@ -0,0 +1,77 @@
+//
+//  RenderStats.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace tivonage {
+
+// Arrival times of the last kCapacity events (frames), kept as intervals in
+// a fixed ring. Gaps longer than kMaxIntervalUs (a paused or stalled stream)
+// restart the measurement instead of being counted as one slow frame.
+//
+// add() is for one writer thread; summary() may run on any thread and sees
+// a recent, possibly slightly torn, window, which is fine for statistics.
+class FrameIntervalWindow {
+public:
+  static constexpr size_t kCapacity = 128;
+  static constexpr int64_t kMaxIntervalUs = 1000000;
+
+  struct Summary {
+    size_t intervals = 0;
+    double fps = 0.0;
+    double meanIntervalMs = 0.0;
+    // Standard deviation of the intervals.
+    double jitterMs = 0.0;
+    double maxIntervalMs = 0.0;
+  };
+
+  FrameIntervalWindow();
+
+  void add(int64_t nowUs);
+
+  // Reports nothing (zero fps) once no event arrived for kMaxIntervalUs.
+  Summary summary(int64_t nowUs) const;
+
+private:
+  std::atomic<uint32_t> m_intervals[kCapacity];
+  std::atomic<uint64_t> m_count { 0 };
+  std::atomic<int64_t> m_lastUs { 0 };
+};
+
+// Per-stream render health: frames received from the SDK, shown by the
+// display and dropped on the way (pool exhausted, or replaced in the mailbox
+// before the display took them), plus frame rate and inter-frame jitter on
+// both sides over the last FrameIntervalWindow::kCapacity frames. Received
+// and displayed are each fed by their own thread.
+class RenderStats {
+public:
+  struct Snapshot {
+    uint64_t received = 0;
+    uint64_t displayed = 0;
+    uint64_t dropped = 0;
+    FrameIntervalWindow::Summary receiving;
+    FrameIntervalWindow::Summary displaying;
+  };
+
+  void frameReceived(int64_t nowUs);
+  void frameDisplayed(int64_t nowUs);
+  // Any thread.
+  void frameDropped() { m_dropped.fetch_add(1, std::memory_order_relaxed); }
+
+  Snapshot snapshot(int64_t nowUs) const;
+
+private:
+  std::atomic<uint64_t> m_received { 0 };
+  std::atomic<uint64_t> m_displayed { 0 };
+  std::atomic<uint64_t> m_dropped { 0 };
+  FrameIntervalWindow m_receiving;
+  FrameIntervalWindow m_displaying;
+};
+
+}
@@ -0,0 +1,69 @@
+//
+//  Resampler.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace tivonage {
+
+// Converts mono int16 PCM from one sample rate to another, e.g. the 44.1 or
+// 48 kHz of the audio hardware to the 16 kHz the SDK's bus runs at. A
+// polyphase FIR: the rates reduce to a ratio up/down, and each output sample
+// is one dot product of the newest input with one of up phases of a
+// Kaiser-windowed sinc low-pass that stops below the lower rate's Nyquist
+// frequency. Taps are generated in create(); process() streams any number of
+// samples per call without allocating, and converting a stream in pieces
+// gives exactly the samples of converting it at once. Not thread-safe.
+class Resampler {
+public:
+  // Zero crossings of the sinc on each side, at the lower of the two rates:
+  // the sharpness of the filter, and its cost per output sample.
+  static constexpr int kZeroCrossings = 32;
+
+  // Returns nullptr unless both rates are positive and reduce to a ratio of
+  // at most 1024:1024. Equal rates copy samples through.
+  static std::unique_ptr<Resampler> create(int inputRate, int outputRate);
+
+  Resampler(const Resampler &) = delete;
+  Resampler &operator=(const Resampler &) = delete;
+
+  int inputRate() const { return m_inputRate; }
+  int outputRate() const { return m_outputRate; }
+  // Filter taps per output sample.
+  int tapsPerPhase() const { return m_tapsPerPhase; }
+
+  // The most samples process() writes for count input samples. With both
+  // rates multiples of 100, 10 ms of input always gives exactly 10 ms.
+  size_t maxOutput(size_t count) const;
+
+  // Converts count input samples; output must hold maxOutput(count).
+  // Returns the number of samples written.
+  size_t process(const int16_t *input, size_t count, int16_t *output);
+
+  // Forgets the input history, as if newly created.
+  void reset();
+
+private:
+  Resampler(int inputRate, int outputRate, int up, int down, int tapsPerPhase, std::vector<int16_t> taps);
+
+  const int m_inputRate;
+  const int m_outputRate;
+  const int m_up;
+  const int m_down;
+  const int m_tapsPerPhase;
+  // up phases of tapsPerPhase taps each, oldest sample's tap first.
+  const std::vector<int16_t> m_taps;
+  // The last tapsPerPhase - 1 input samples, then the block being converted.
+  std::vector<int16_t> m_history;
+  // Input index (in the current block) and phase of the next output sample.
+  size_t m_position = 0;
+  int m_phase = 0;
+};
+
+}
@@ -0,0 +1,46 @@
+//
+//  RunningStats.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace tivonage {
+
+// Streaming count / mean / variance / min / max (Welford). Constant memory,
+// suitable for aggregating per-frame or per-callback measurements.
+class RunningStats {
+public:
+  void add(double value)
+  {
+    ++m_count;
+    double delta = value - m_mean;
+    m_mean += delta / double(m_count);
+    m_m2 += delta * (value - m_mean);
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+  }
+
+  void reset() { *this = RunningStats(); }
+
+  uint64_t count() const { return m_count; }
+  double mean() const { return m_count ? m_mean : 0.0; }
+  double variance() const { return m_count > 1 ? m_m2 / double(m_count - 1) : 0.0; }
+  double standardDeviation() const { return std::sqrt(variance()); }
+  double min() const { return m_count ? m_min : 0.0; }
+  double max() const { return m_count ? m_max : 0.0; }
+
+private:
+  uint64_t m_count = 0;
+  double m_mean = 0.0;
+  double m_m2 = 0.0;
+  double m_min = std::numeric_limits<double>::infinity();
+  double m_max = -std::numeric_limits<double>::infinity();
+};
+
+}
@@ -0,0 +1,30 @@
+//
+//  Simd.h
+//  ti.vonage
+//
+
+#pragma once
+
+namespace tivonage {
+
+enum class SimdLevel {
+  Scalar,
+  SSE2,
+  AVX2,
+  NEON,
+};
+
+// Best instruction set the kernels can use on this CPU.
+SimdLevel detectedSimdLevel();
+
+// The level kernels dispatch to: detectedSimdLevel(), unless capped.
+SimdLevel activeSimdLevel();
+
+// Caps dispatch at the given level, e.g. SimdLevel::Scalar to run the
+// reference kernels in tests and benchmarks. Levels above what the CPU
+// supports are ignored.
+void setSimdLevelLimit(SimdLevel limit);
+
+const char *simdLevelName(SimdLevel level);
+
+}
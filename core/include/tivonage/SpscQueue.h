@@ -0,0 +1,77 @@
+//
+//  SpscQueue.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace tivonage {
+
+// Lock-free single-producer / single-consumer queue of fixed capacity. All
+// slots are constructed up front; push() and pop() only move values in and
+// out, so they never allocate (as long as moving a T doesn't) and are safe
+// on real-time and render threads. A full queue rejects the push; what to
+// do with the rejected value is up to the producer.
+template <typename T>
+class SpscQueue {
+public:
+  // The capacity is rounded up to the next power of two.
+  explicit SpscQueue(size_t minimumCapacity)
+  {
+    size_t capacity = 1;
+    while (capacity < minimumCapacity) {
+      capacity <<= 1;
+    }
+    m_slots.reset(new T[capacity]);
+    m_mask = capacity - 1;
+  }
+
+  SpscQueue(const SpscQueue &) = delete;
+  SpscQueue &operator=(const SpscQueue &) = delete;
+
+  size_t capacity() const { return m_mask + 1; }
+
+  // Producer side.
+  bool push(T value)
+  {
+    size_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+    if (writeIndex - m_readIndex.load(std::memory_order_acquire) == capacity()) {
+      return false;
+    }
+    m_slots[writeIndex & m_mask] = std::move(value);
+    m_writeIndex.store(writeIndex + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side.
+  bool pop(T &value)
+  {
+    size_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+    if (readIndex == m_writeIndex.load(std::memory_order_acquire)) {
+      return false;
+    }
+    value = std::move(m_slots[readIndex & m_mask]);
+    m_readIndex.store(readIndex + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Either side; a snapshot that may be stale by the time it returns.
+  size_t size() const
+  {
+    return m_writeIndex.load(std::memory_order_acquire) - m_readIndex.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+
+private:
+  std::unique_ptr<T[]> m_slots;
+  size_t m_mask = 0;
+  alignas(64) std::atomic<size_t> m_writeIndex { 0 };
+  alignas(64) std::atomic<size_t> m_readIndex { 0 };
+};
+
+}
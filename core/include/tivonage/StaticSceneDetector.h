@@ -0,0 +1,67 @@
+//
+//  StaticSceneDetector.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/VideoFrame.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace tivonage {
+
+// Tells a still camera scene (a kiosk, a document camera) from one with
+// motion, so the capturer can send fewer frames while nothing moves. Each
+// frame's luma is compared with the previous frame's, on every rowStep-th
+// row, in tiles of kTileSize x kTileSize pixels: a tile whose mean absolute
+// difference exceeds tileThreshold has changed, which sensor noise alone
+// does not do. The scene turns static once changed tiles stayed below
+// motionFraction for staticDelayUs, and back to motion on the first frame
+// above it. Like CaptureController a plain state machine: not thread-safe,
+// timestamps are monotonic microseconds. Storage only grows when the frame
+// does.
+class StaticSceneDetector {
+public:
+  static constexpr int kTileSize = 32;
+
+  struct Config {
+    int rowStep = 4;
+    int tileThreshold = 8;
+    double motionFraction = 0.01;
+    int64_t staticDelayUs = 1500000;
+    // Frame rate to capture at while static.
+    float staticFrameRate = 5.0f;
+  };
+
+  StaticSceneDetector();
+  explicit StaticSceneDetector(const Config &config);
+
+  const Config &config() const { return m_config; }
+
+  // First plane of an I420 or NV12 frame. True if the state changed.
+  bool update(const VideoFrame &frame, int64_t nowUs);
+
+  // Forgets the previous frame and returns to motion.
+  void reset();
+
+  bool isStatic() const { return m_static; }
+  // Share of tiles that changed in the last update, 0 to 1.
+  double motion() const { return m_motion; }
+  // fullRate while there is motion, at most staticFrameRate while static.
+  float frameRate(float fullRate) const;
+
+private:
+  Config m_config;
+  int m_width = 0;
+  int m_height = 0;
+  bool m_hasPrevious = false;
+  bool m_static = false;
+  int64_t m_quietSinceUs = 0;
+  double m_motion = 0.0;
+  std::vector<uint8_t> m_previous;
+  std::vector<uint32_t> m_tileSums;
+};
+
+}
@@ -0,0 +1,107 @@
+//
+//  SubscriptionController.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace tivonage {
+
+// Decides what to ask the SDK for on behalf of one subscribed stream, from
+// how the app is showing it. A plain state machine: the platform code feeds
+// it observations with a monotonic timestamp, calls update() on its UI tick
+// and applies decision() to the subscriber whenever update() reports a
+// change. Not thread-safe; drive it from the UI thread.
+class SubscriptionController {
+public:
+  struct Config {
+    // How long a view must stay off screen before its video is paused, so
+    // scrolling past a tile doesn't toggle its subscription. Coming back on
+    // screen restores video immediately.
+    int64_t hideDelayUs = 1000000;
+
+    // Simulcast layers assumed below the stream's own size, each half the
+    // size of the one above (the usual 1x / 0.5x / 0.25x ladder).
+    int layerCount = 3;
+    // A layer still counts as big enough for a view needing up to this much
+    // more (a 15% upscale isn't visible). Downgrading requires the smaller
+    // layer to fit without it, which is the size hysteresis.
+    double upscaleTolerance = 0.85;
+    // How long a smaller layer must keep fitting before switching down to
+    // it; switching up is immediate.
+    int64_t downgradeDelayUs = 2000000;
+    // Frame rate asked for on the smallest layer; thumbnails don't need the
+    // full rate. 0 leaves it to the SDK.
+    float smallestLayerFrameRate = 15.0f;
+    // The largest layer a low-priority stream (not among the active
+    // speakers) gets, however big its view: 1 is half size.
+    int lowPriorityLayer = 1;
+  };
+
+  struct Decision {
+    bool video = true;
+    // Preferred simulcast resolution and frame rate; 0 means no preference
+    // (full quality).
+    int preferredWidth = 0;
+    int preferredHeight = 0;
+    float preferredFrameRate = 0.0f;
+
+    bool operator==(const Decision &other) const
+    {
+      return video == other.video && preferredWidth == other.preferredWidth && preferredHeight == other.preferredHeight
+          && preferredFrameRate == other.preferredFrameRate;
+    }
+    bool operator!=(const Decision &other) const { return !(*this == other); }
+  };
+
+  SubscriptionController();
+  explicit SubscriptionController(const Config &config);
+
+  const Config &config() const { return m_config; }
+
+  // Whether the stream's view is attached, not hidden and at least partly on
+  // screen. Streams start out visible.
+  void setVisible(bool visible, int64_t nowUs);
+  bool visible() const { return m_visible; }
+
+  // The stream's full video dimensions (OTStream.videoDimensions) and the
+  // size of its view in device pixels. Either being 0 means no preference.
+  void setStreamSize(int width, int height);
+  void setViewSize(int width, int height);
+
+  // Whether the stream may use the full-size layer, e.g. because it ranks
+  // among the active speakers (see ActiveSpeakerDetector). Losing priority
+  // downgrades after downgradeDelayUs like any other downgrade, gaining it
+  // upgrades at once. Streams start out with priority.
+  void setHighPriority(bool highPriority);
+  bool highPriority() const { return m_highPriority; }
+
+  // Re-evaluates the decision; true if it changed since the last update().
+  bool update(int64_t nowUs);
+  const Decision &decision() const { return m_decision; }
+
+  // The layer index (0 = full size) currently asked for.
+  int layer() const { return m_layer; }
+
+private:
+  int smallestFittingLayer(double tolerance) const;
+  int priorityLayer() const;
+
+  Config m_config;
+  bool m_visible = true;
+  int64_t m_hiddenSinceUs = 0;
+  int m_streamWidth = 0;
+  int m_streamHeight = 0;
+  int m_viewWidth = 0;
+  int m_viewHeight = 0;
+  bool m_highPriority = true;
+  bool m_sized = false;
+  int m_layer = 0;
+  int m_pendingLayer = 0;
+  int64_t m_pendingSinceUs = 0;
+  Decision m_decision;
+};
+
+}
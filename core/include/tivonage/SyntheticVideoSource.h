@@ -0,0 +1,105 @@
+//
+//  SyntheticVideoSource.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/DeadlinePacer.h"
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/FrameScaler.h"
+#include "tivonage/VideoFrame.h"
+#include "tivonage/Y4mReader.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace tivonage {
+
+// Draws frame index of a moving test pattern: colour bars over a luma ramp
+// with a white box sweeping across it, so consecutive frames differ the way
+// a camera's do. I420 or NV12.
+void drawTestPattern(VideoFrame &frame, uint64_t index);
+
+// Produces I420 frames from a .y4m file (looped) or the test pattern at a
+// fixed size and rate, for reproducible load tests of the publish path
+// without a camera. Frames are paced by a DeadlinePacer: the rate doesn't
+// drift however long it runs, a deadline missed by a whole frame interval
+// skips that frame rather than sending a burst, and free-running mode
+// produces frames back to back to measure a consumer's throughput.
+class SyntheticVideoSource {
+public:
+  struct Config {
+    // Empty for the test pattern.
+    std::string path;
+    // Output size; 0 keeps the file's (640x480 for the pattern). Files are
+    // scaled when it differs.
+    int width = 0;
+    int height = 0;
+    // 0 uses the file's rate (30 for the pattern).
+    double frameRate = 0;
+    bool realTime = true;
+    // Stop after this many frames; 0 runs until stop().
+    uint64_t frameLimit = 0;
+  };
+
+  struct Stats {
+    uint64_t frames = 0;
+    // Frames skipped because their deadline had passed by an interval.
+    uint64_t skipped = 0;
+    // How late frames were handed to the consumer (real-time mode only).
+    double meanLatenessUs = 0.0;
+    int64_t maxLatenessUs = 0;
+    // Since start(); frames / elapsed is the achieved rate.
+    int64_t elapsedUs = 0;
+  };
+
+  // Called on the source's thread; the frame's memory is only valid for the
+  // duration of the call.
+  using Consumer = std::function<void(const VideoFrame &frame)>;
+
+  // Returns nullptr if the file can't be read or the size is not even.
+  static std::unique_ptr<SyntheticVideoSource> create(const Config &config, Consumer consumer);
+
+  // Stops (see stop()).
+  ~SyntheticVideoSource();
+
+  SyntheticVideoSource(const SyntheticVideoSource &) = delete;
+  SyntheticVideoSource &operator=(const SyntheticVideoSource &) = delete;
+
+  int width() const { return m_width; }
+  int height() const { return m_height; }
+  double frameRate() const { return m_frameRate; }
+
+  // Starts the source's thread; false if it is already running.
+  bool start();
+  // Joins the thread, after the frame in flight. Idempotent.
+  void stop();
+  // Blocks until the frame limit is reached. Only with a frameLimit.
+  void wait();
+  Stats stats() const;
+
+  // Produces frame index on the caller's thread, without pacing; for
+  // driving a consumer synchronously. Not while started.
+  bool renderFrame(uint64_t index, VideoFrame &frame);
+
+private:
+  SyntheticVideoSource(const Config &config, Consumer consumer, std::unique_ptr<Y4mReader> reader, int width, int height, double frameRate);
+
+  void produceFrame(uint64_t index);
+
+  const Config m_config;
+  Consumer m_consumer;
+  std::unique_ptr<Y4mReader> m_reader;
+  int m_width;
+  int m_height;
+  double m_frameRate;
+  std::unique_ptr<FrameBuffer> m_buffer;
+  FrameScaler m_scaler;
+  // Last, so its thread stops before the rest goes away.
+  DeadlinePacer m_pacer;
+};
+
+}
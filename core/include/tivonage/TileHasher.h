@@ -0,0 +1,51 @@
+//
+//  TileHasher.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/VideoFrame.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tivonage {
+
+// Finds the parts of a frame that changed since the previous one by keeping a
+// checksum of every kTileSize x kTileSize tile of its first plane (luma, or
+// the pixels of ARGB). Meant for screen content, where most frames repeat the
+// previous one exactly. An unchanged tile is always clean and a single
+// changed pixel always dirties its tile; larger changes could in theory
+// collide, so callers should still send a frame now and then. Storage only
+// grows when the tile grid does.
+class TileHasher {
+public:
+  static constexpr int kTileSize = 32;
+
+  // Hashes every tile and returns the number that differ from the previous
+  // update. The first frame, and any change of format or size, marks every
+  // tile dirty.
+  int update(const VideoFrame &frame);
+
+  // Makes the next update report every tile dirty.
+  void reset();
+
+  int columns() const { return m_columns; }
+  int rows() const { return m_rows; }
+  bool isDirty(int column, int row) const { return m_dirty[size_t(row * m_columns + column)] != 0; }
+
+private:
+  PixelFormat m_format = PixelFormat::I420;
+  int m_width = 0;
+  int m_height = 0;
+  int m_columns = 0;
+  int m_rows = 0;
+  bool m_valid = false;
+  std::vector<uint32_t> m_hashes;
+  std::vector<uint8_t> m_dirty;
+  std::vector<uint32_t> m_lanes;
+};
+
+}
@@ -0,0 +1,87 @@
+//
+//  VideoFrame.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace tivonage {
+
+constexpr uint32_t fourCC(char a, char b, char c, char d)
+{
+  return (uint32_t(uint8_t(a)) << 24) | (uint32_t(uint8_t(b)) << 16) | (uint32_t(uint8_t(c)) << 8) | uint32_t(uint8_t(d));
+}
+
+// Mirrors OTPixelFormat so values can cross the ObjC++ / JNI boundary as-is.
+enum class PixelFormat : uint32_t {
+  I420 = fourCC('I', '4', '2', '0'),
+  ARGB = fourCC('A', 'R', 'G', 'B'),
+  NV12 = fourCC('N', 'V', '1', '2'),
+};
+
+// Mirrors OTVideoOrientation.
+enum class VideoOrientation : int32_t {
+  Up = 1,
+  Down = 2,
+  Left = 3,
+  Right = 4,
+};
+
+struct VideoPlane {
+  uint8_t *data = nullptr;
+  int stride = 0;
+};
+
+// Non-owning description of a frame. Planes may point into SDK memory, a
+// FrameBuffer or a platform pixel buffer.
+struct VideoFrame {
+  PixelFormat format = PixelFormat::I420;
+  int width = 0;
+  int height = 0;
+  VideoPlane planes[3];
+  VideoOrientation orientation = VideoOrientation::Up;
+  int64_t timestampUs = 0;
+};
+
+inline int planeCount(PixelFormat format)
+{
+  switch (format) {
+  case PixelFormat::I420:
+    return 3;
+  case PixelFormat::NV12:
+    return 2;
+  case PixelFormat::ARGB:
+    return 1;
+  }
+  return 0;
+}
+
+// Number of meaningful bytes in one row of the given plane.
+inline int planeRowBytes(PixelFormat format, int plane, int width)
+{
+  switch (format) {
+  case PixelFormat::I420:
+    return plane == 0 ? width : (width + 1) / 2;
+  case PixelFormat::NV12:
+    return plane == 0 ? width : ((width + 1) / 2) * 2;
+  case PixelFormat::ARGB:
+    return width * 4;
+  }
+  return 0;
+}
+
+inline int planeRows(PixelFormat format, int plane, int height)
+{
+  if (format == PixelFormat::ARGB || plane == 0) {
+    return height;
+  }
+  return (height + 1) / 2;
+}
+
+// Copies every plane row by row, honouring both strides. Source and
+// destination must have the same format and dimensions.
+bool copyFrame(const VideoFrame &source, VideoFrame &destination);
+
+}
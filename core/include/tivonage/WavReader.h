@@ -0,0 +1,50 @@
+//
+//  WavReader.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace tivonage {
+
+// Reads 16-bit PCM RIFF/WAVE files through a read-only memory mapping, so
+// reading costs a copy out of the page cache and no allocation. The
+// counterpart of WavWriter; a data size left at its maximum (a file its
+// writer never closed) or past the end of the file reads to the end.
+class WavReader {
+public:
+  // Returns nullptr if the file can't be mapped or is not 16-bit PCM with
+  // 1 to 8 channels.
+  static std::unique_ptr<WavReader> open(const std::string &path);
+
+  ~WavReader();
+
+  WavReader(const WavReader &) = delete;
+  WavReader &operator=(const WavReader &) = delete;
+
+  int sampleRate() const { return m_sampleRate; }
+  int channels() const { return m_channels; }
+  // Samples per channel.
+  size_t frameCount() const { return m_frameCount; }
+
+  // Copies up to count frames from frame index on, averaging the channels
+  // into one. Returns the number of frames copied.
+  size_t readMono(size_t index, int16_t *samples, size_t count) const;
+
+private:
+  WavReader(const uint8_t *mapping, size_t size);
+
+  const uint8_t *m_mapping;
+  size_t m_size;
+  int m_sampleRate = 0;
+  int m_channels = 0;
+  size_t m_dataOffset = 0;
+  size_t m_frameCount = 0;
+};
+
+}
@@ -0,0 +1,53 @@
+//
+//  WavWriter.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace tivonage {
+
+// Writes 16-bit PCM to a RIFF/WAVE file. The sizes in the header are
+// patched on flush() and close(); until then they are left at their
+// maximum, which most players read as "until the end of the file". RIFF caps a file at 4 GiB
+// (about 12 hours of 48 kHz mono); samples past that are refused.
+class WavWriter {
+public:
+  static std::unique_ptr<WavWriter> create(const std::string &path, int sampleRate, int channels);
+
+  ~WavWriter();
+
+  WavWriter(const WavWriter &) = delete;
+  WavWriter &operator=(const WavWriter &) = delete;
+
+  int sampleRate() const { return m_sampleRate; }
+  int channels() const { return m_channels; }
+  // Samples per channel written so far.
+  uint64_t frameCount() const { return m_dataBytes / (sizeof(int16_t) * size_t(m_channels)); }
+
+  // Interleaved samples; count is the total over all channels.
+  bool write(const int16_t *samples, size_t count);
+
+  // Patches the header to the samples written so far and flushes them, so
+  // the file is complete as it stands; writing carries on after them.
+  bool flush();
+
+  bool close();
+
+private:
+  WavWriter(FILE *file, int sampleRate, int channels);
+
+  FILE *m_file;
+  int m_sampleRate;
+  int m_channels;
+  uint64_t m_dataBytes = 0;
+  bool m_failed = false;
+};
+
+}
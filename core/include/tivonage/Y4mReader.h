@@ -0,0 +1,53 @@
+//
+//  Y4mReader.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/VideoFrame.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tivonage {
+
+// Reads 4:2:0 YUV4MPEG2 (.y4m) files through a read-only memory mapping.
+// Frames are handed out as I420 VideoFrames pointing straight into the
+// mapping, so reading one costs no copy and no allocation; the kernel pages
+// the file in as it is read. The counterpart of Y4mWriter.
+class Y4mReader {
+public:
+  // Returns nullptr if the file can't be mapped, is not 4:2:0 with an even
+  // size, or holds no complete frame. A truncated last frame is ignored.
+  static std::unique_ptr<Y4mReader> open(const std::string &path);
+
+  ~Y4mReader();
+
+  Y4mReader(const Y4mReader &) = delete;
+  Y4mReader &operator=(const Y4mReader &) = delete;
+
+  int width() const { return m_width; }
+  int height() const { return m_height; }
+  // From the header's F tag; 30 if it has none.
+  double frameRate() const { return m_frameRate; }
+  size_t frameCount() const { return m_frames.size(); }
+
+  // Points frame at the planes of frame index. Valid while the reader lives.
+  bool frame(size_t index, VideoFrame &frame) const;
+
+private:
+  Y4mReader(const uint8_t *mapping, size_t size);
+
+  const uint8_t *m_mapping;
+  size_t m_size;
+  int m_width = 0;
+  int m_height = 0;
+  double m_frameRate = 30.0;
+  std::vector<size_t> m_frames;
+};
+
+}
@@ -0,0 +1,50 @@
+//
+//  Y4mWriter.h
+//  ti.vonage
+//
+
+#pragma once
+
+#include "tivonage/VideoFrame.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace tivonage {
+
+// Writes raw I420 frames to a YUV4MPEG2 (.y4m) stream: a one-line header,
+// then "FRAME\n" and the three planes per frame. Nothing needs patching at
+// the end, so a recording cut short by a crash is still playable.
+class Y4mWriter {
+public:
+  // Returns nullptr if the file can't be created or the size is not even.
+  static std::unique_ptr<Y4mWriter> create(const std::string &path, int width, int height, int frameRate);
+
+  ~Y4mWriter();
+
+  Y4mWriter(const Y4mWriter &) = delete;
+  Y4mWriter &operator=(const Y4mWriter &) = delete;
+
+  int width() const { return m_width; }
+  int height() const { return m_height; }
+  uint64_t frameCount() const { return m_frameCount; }
+
+  // The frame must be I420 of the writer's size.
+  bool writeFrame(const VideoFrame &frame);
+
+  // Flushes and closes the file; false if any write failed.
+  bool close();
+
+private:
+  Y4mWriter(FILE *file, int width, int height);
+
+  FILE *m_file;
+  int m_width;
+  int m_height;
+  uint64_t m_frameCount = 0;
+  bool m_failed = false;
+};
+
+}
@@ -0,0 +1,206 @@
+//
+//  ActiveSpeakerDetector.cpp
+//  ti.vonage
+//
+
+#include "tivonage/ActiveSpeakerDetector.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tivonage {
+
+ActiveSpeakerDetector::ActiveSpeakerDetector()
+    : ActiveSpeakerDetector(Config())
+{
+}
+
+ActiveSpeakerDetector::ActiveSpeakerDetector(const Config &config)
+    : m_config(config)
+{
+}
+
+ActiveSpeakerDetector::Speaker *ActiveSpeakerDetector::find(const std::string &streamId)
+{
+  auto it = std::find_if(m_speakers.begin(), m_speakers.end(), [&](const Speaker &speaker) { return speaker.streamId == streamId; });
+  return it != m_speakers.end() ? &*it : nullptr;
+}
+
+const ActiveSpeakerDetector::Speaker *ActiveSpeakerDetector::find(const std::string &streamId) const
+{
+  return const_cast<ActiveSpeakerDetector *>(this)->find(streamId);
+}
+
+bool ActiveSpeakerDetector::isRanked(const std::string &streamId) const
+{
+  return std::find(m_ranking.begin(), m_ranking.end(), streamId) != m_ranking.end();
+}
+
+bool ActiveSpeakerDetector::isSpeaking(const std::string &streamId) const
+{
+  const Speaker *speaker = find(streamId);
+  return speaker != nullptr && speaker->speaking;
+}
+
+void ActiveSpeakerDetector::addLevel(const std::string &streamId, float amplitude, int64_t nowUs)
+{
+  Speaker *speaker = find(streamId);
+  if (speaker == nullptr) {
+    Speaker added;
+    added.streamId = streamId;
+    added.lastLevelUs = nowUs;
+    m_speakers.push_back(added);
+    speaker = &m_speakers.back();
+  }
+
+  double level = std::max(double(amplitude), 0.0);
+  double elapsed = double(std::max<int64_t>(nowUs - speaker->lastLevelUs, 0));
+  speaker->score += (level - speaker->score) * (1.0 - std::exp(-elapsed / double(std::max<int64_t>(m_config.scoreTimeConstantUs, 1))));
+  speaker->lastLevelUs = nowUs;
+
+  double db = level > 0.0 ? 20.0 * std::log10(level) : -120.0;
+  if (!speaker->speaking) {
+    if (db < m_config.speechDb) {
+      speaker->loudSinceUs = -1;
+    } else if (speaker->loudSinceUs < 0) {
+      speaker->loudSinceUs = nowUs;
+    }
+    if (speaker->loudSinceUs >= 0 && nowUs - speaker->loudSinceUs >= m_config.attackUs) {
+      speaker->speaking = true;
+      speaker->quietSinceUs = -1;
+    }
+  } else {
+    if (db >= m_config.silenceDb) {
+      speaker->quietSinceUs = -1;
+    } else if (speaker->quietSinceUs < 0) {
+      speaker->quietSinceUs = nowUs;
+    }
+    if (speaker->quietSinceUs >= 0 && nowUs - speaker->quietSinceUs >= m_config.hangoverUs) {
+      speaker->speaking = false;
+      speaker->loudSinceUs = -1;
+    }
+  }
+}
+
+void ActiveSpeakerDetector::removeStream(const std::string &streamId)
+{
+  auto it = std::find_if(m_speakers.begin(), m_speakers.end(), [&](const Speaker &speaker) { return speaker.streamId == streamId; });
+  if (it == m_speakers.end()) {
+    return;
+  }
+  m_speakers.erase(it);
+  m_ranking.erase(std::remove(m_ranking.begin(), m_ranking.end(), streamId), m_ranking.end());
+  if (m_activeSpeaker == streamId) {
+    m_activeSpeaker.clear();
+  }
+  m_removed = true;
+}
+
+void ActiveSpeakerDetector::clear()
+{
+  m_removed = m_removed || !m_speakers.empty();
+  m_speakers.clear();
+  m_ranking.clear();
+  m_activeSpeaker.clear();
+}
+
+bool ActiveSpeakerDetector::update(int64_t nowUs)
+{
+  std::string activeSpeaker = m_activeSpeaker;
+  std::vector<std::string> ranking = m_ranking;
+
+  for (Speaker &speaker : m_speakers) {
+    if (speaker.speaking && nowUs - speaker.lastLevelUs >= m_config.hangoverUs) {
+      speaker.speaking = false;
+      speaker.loudSinceUs = -1;
+    }
+  }
+  updateActiveSpeaker(nowUs);
+  updateRanking(nowUs);
+
+  bool changed = m_removed || activeSpeaker != m_activeSpeaker || ranking != m_ranking;
+  m_removed = false;
+  return changed;
+}
+
+void ActiveSpeakerDetector::updateActiveSpeaker(int64_t nowUs)
+{
+  const Speaker *best = nullptr;
+  for (const Speaker &speaker : m_speakers) {
+    if (speaker.speaking && (best == nullptr || speaker.score > best->score)) {
+      best = &speaker;
+    }
+  }
+  if (best == nullptr || best->streamId == m_activeSpeaker) {
+    return;
+  }
+  const Speaker *active = find(m_activeSpeaker);
+  if (active != nullptr) {
+    if (nowUs - m_activeSinceUs < m_config.minHoldUs) {
+      return;
+    }
+    if (active->speaking && best->score < active->score * m_config.switchRatio) {
+      return;
+    }
+  }
+  m_activeSpeaker = best->streamId;
+  m_activeSinceUs = nowUs;
+}
+
+void ActiveSpeakerDetector::updateRanking(int64_t nowUs)
+{
+  const size_t capacity = size_t(std::max(m_config.maxRanked, 1));
+
+  // Newcomers, best first; the active speaker always gets a place.
+  std::vector<Speaker *> candidates;
+  for (Speaker &speaker : m_speakers) {
+    if ((speaker.speaking || speaker.streamId == m_activeSpeaker) && !isRanked(speaker.streamId)) {
+      candidates.push_back(&speaker);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), [this](const Speaker *a, const Speaker *b) {
+    if ((a->streamId == m_activeSpeaker) != (b->streamId == m_activeSpeaker)) {
+      return a->streamId == m_activeSpeaker;
+    }
+    return a->score > b->score;
+  });
+
+  for (Speaker *candidate : candidates) {
+    if (m_ranking.size() < capacity) {
+      candidate->rankedSinceUs = nowUs;
+      m_ranking.push_back(candidate->streamId);
+      continue;
+    }
+    // Whom to give up: a member past its hold, preferably a silent one,
+    // then the lowest score.
+    bool mustPlace = candidate->streamId == m_activeSpeaker;
+    int victim = -1;
+    for (size_t i = 0; i < m_ranking.size(); ++i) {
+      const Speaker *member = find(m_ranking[i]);
+      if (member->streamId == m_activeSpeaker || (!mustPlace && nowUs - member->rankedSinceUs < m_config.minHoldUs)) {
+        continue;
+      }
+      if (!mustPlace && member->speaking && member->score >= candidate->score) {
+        continue;
+      }
+      const Speaker *current = victim >= 0 ? find(m_ranking[size_t(victim)]) : nullptr;
+      if (current == nullptr || (current->speaking && !member->speaking)
+          || (current->speaking == member->speaking && member->score < current->score)) {
+        victim = int(i);
+      }
+    }
+    if (victim < 0) {
+      continue;
+    }
+    candidate->rankedSinceUs = nowUs;
+    m_ranking.erase(m_ranking.begin() + victim);
+    m_ranking.push_back(candidate->streamId);
+  }
+
+  auto active = std::find(m_ranking.begin(), m_ranking.end(), m_activeSpeaker);
+  if (active != m_ranking.end()) {
+    std::rotate(m_ranking.begin(), active, active + 1);
+  }
+}
+
+}
@@ -0,0 +1,201 @@
+//
+//  AudioBridge.cpp
+//  ti.vonage
+//
+
+#include "tivonage/AudioBridge.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace tivonage {
+
+static size_t samplesForMs(int sampleRate, int ms)
+{
+  return size_t(int64_t(sampleRate) * ms / 1000);
+}
+
+std::unique_ptr<AudioBridge> AudioBridge::create(const Config &config, CaptureSink capture, RenderSource render)
+{
+  if (config.sampleRate <= 0 || config.chunkMs <= 0 || !capture || !render || samplesForMs(config.sampleRate, config.chunkMs) == 0) {
+    return nullptr;
+  }
+  // Each ring holds at least its target plus one chunk, so the pump can
+  // always make progress.
+  size_t chunk = samplesForMs(config.sampleRate, config.chunkMs);
+  size_t renderTarget = std::max(chunk, samplesForMs(config.sampleRate, config.renderLatencyMs));
+  std::unique_ptr<AudioRingBuffer> captureRing = AudioRingBuffer::create(std::max(2 * chunk, samplesForMs(config.sampleRate, config.captureBufferMs)));
+  std::unique_ptr<AudioRingBuffer> renderRing = AudioRingBuffer::create(std::max(renderTarget + chunk, samplesForMs(config.sampleRate, config.renderBufferMs)));
+  if (!captureRing || !renderRing) {
+    return nullptr;
+  }
+  return std::unique_ptr<AudioBridge>(new AudioBridge(config, std::move(capture), std::move(render), std::move(captureRing), std::move(renderRing)));
+}
+
+AudioBridge::AudioBridge(const Config &config, CaptureSink capture, RenderSource render, std::unique_ptr<AudioRingBuffer> captureRing,
+    std::unique_ptr<AudioRingBuffer> renderRing)
+    : m_config(config)
+    , m_chunkSamples(samplesForMs(config.sampleRate, config.chunkMs))
+    , m_renderTarget(std::max(m_chunkSamples, samplesForMs(config.sampleRate, config.renderLatencyMs)))
+    , m_capture(std::move(capture))
+    , m_render(std::move(render))
+    , m_captureRing(std::move(captureRing))
+    , m_renderRing(std::move(renderRing))
+    , m_chunk(m_chunkSamples)
+{
+  if (m_config.pumpThread) {
+    m_thread = std::thread([this] { run(); });
+  }
+}
+
+AudioBridge::~AudioBridge()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_wake.notify_all();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+void AudioBridge::setCapturing(bool capturing)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!capturing && m_capturing.load(std::memory_order_relaxed)) {
+      m_flushCapture.store(true, std::memory_order_relaxed);
+    }
+    m_capturing.store(capturing, std::memory_order_release);
+  }
+  m_wake.notify_all();
+}
+
+void AudioBridge::setRendering(bool rendering)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!rendering && m_rendering.load(std::memory_order_relaxed)) {
+      m_flushRender.store(true, std::memory_order_relaxed);
+    }
+    m_rendering.store(rendering, std::memory_order_release);
+  }
+  m_wake.notify_all();
+}
+
+void AudioBridge::writeCapture(const int16_t *samples, size_t count)
+{
+  if (!m_capturing.load(std::memory_order_acquire)) {
+    return;
+  }
+  size_t written = m_captureRing->write(samples, count);
+  m_capturedSamples.fetch_add(written, std::memory_order_relaxed);
+  if (written < count) {
+    m_captureOverflows.fetch_add(count - written, std::memory_order_relaxed);
+  }
+}
+
+void AudioBridge::readRender(int16_t *samples, size_t count)
+{
+  // The render ring's consumer is this thread, so stale samples are dropped
+  // here rather than by the pump.
+  if (m_flushRender.exchange(false, std::memory_order_acquire)) {
+    m_renderRing->skip(m_renderRing->availableToRead());
+  }
+  if (!m_rendering.load(std::memory_order_acquire)) {
+    memset(samples, 0, count * sizeof(int16_t));
+    return;
+  }
+  size_t read = m_renderRing->read(samples, count);
+  m_renderedSamples.fetch_add(read, std::memory_order_relaxed);
+  if (read < count) {
+    memset(samples + read, 0, (count - read) * sizeof(int16_t));
+    m_renderUnderflows.fetch_add(count - read, std::memory_order_relaxed);
+  }
+}
+
+int AudioBridge::captureDelayMs() const
+{
+  return int(int64_t(m_captureRing->availableToRead()) * 1000 / m_config.sampleRate);
+}
+
+int AudioBridge::renderDelayMs() const
+{
+  return int(int64_t(m_renderRing->availableToRead()) * 1000 / m_config.sampleRate);
+}
+
+AudioBridge::Stats AudioBridge::stats() const
+{
+  Stats stats;
+  stats.capturedSamples = m_capturedSamples.load(std::memory_order_relaxed);
+  stats.captureOverflows = m_captureOverflows.load(std::memory_order_relaxed);
+  stats.renderedSamples = m_renderedSamples.load(std::memory_order_relaxed);
+  stats.renderUnderflows = m_renderUnderflows.load(std::memory_order_relaxed);
+  stats.captureChunks = m_captureChunks.load(std::memory_order_relaxed);
+  stats.renderChunks = m_renderChunks.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void AudioBridge::pump()
+{
+  // The capture ring's consumer is this thread.
+  if (m_flushCapture.exchange(false, std::memory_order_acquire)) {
+    m_captureRing->skip(m_captureRing->availableToRead());
+  }
+  if (m_capturing.load(std::memory_order_acquire)) {
+    pumpCapture();
+  }
+  if (m_rendering.load(std::memory_order_acquire)) {
+    pumpRender();
+  }
+}
+
+void AudioBridge::pumpCapture()
+{
+  while (m_captureRing->availableToRead() >= m_chunkSamples) {
+    m_captureRing->read(m_chunk.data(), m_chunkSamples);
+    m_capture(m_chunk.data(), m_chunkSamples);
+    m_captureChunks.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void AudioBridge::pumpRender()
+{
+  while (m_renderRing->availableToRead() < m_renderTarget && m_renderRing->availableToWrite() >= m_chunkSamples) {
+    size_t count = std::min(m_render(m_chunk.data(), m_chunkSamples), m_chunkSamples);
+    std::fill(m_chunk.begin() + std::ptrdiff_t(count), m_chunk.end(), int16_t(0));
+    m_renderRing->write(m_chunk.data(), m_chunkSamples);
+    m_renderChunks.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void AudioBridge::run()
+{
+  using Clock = std::chrono::steady_clock;
+  const Clock::duration interval = std::chrono::milliseconds(m_config.chunkMs);
+  Clock::time_point next = Clock::now();
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;) {
+    m_wake.wait(lock, [this] { return m_stopping || isCapturing() || isRendering(); });
+    if (m_stopping) {
+      break;
+    }
+    lock.unlock();
+    pump();
+    lock.lock();
+
+    // Each pass drains and refills whatever is due, so after a stall (or an
+    // idle spell) the schedule restarts from now instead of catching up.
+    Clock::time_point now = Clock::now();
+    next += interval;
+    if (next <= now) {
+      next = now + interval;
+    }
+    m_wake.wait_until(lock, next, [this] { return m_stopping; });
+  }
+}
+
+}
@@ -0,0 +1,94 @@
+//
+//  AudioLevelMeter.cpp
+//  ti.vonage
+//
+
+#include "tivonage/AudioLevelMeter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tivonage {
+
+AudioLevelMeter::AudioLevelMeter()
+    : AudioLevelMeter(Config())
+{
+}
+
+AudioLevelMeter::AudioLevelMeter(const Config &config)
+    : m_config(config)
+{
+}
+
+float AudioLevelMeter::scale(float amplitude) const
+{
+  if (!(amplitude > 0.0f) || m_config.floorDb >= 0.0) {
+    return 0.0f;
+  }
+  double db = 20.0 * std::log10(double(amplitude));
+  return float(std::clamp((db - m_config.floorDb) / -m_config.floorDb, 0.0, 1.0));
+}
+
+float AudioLevelMeter::decayed(const Meter &meter, int64_t nowUs) const
+{
+  double elapsed = double(std::max<int64_t>(nowUs - meter.heldAtUs, 0)) / 1e6;
+  return float(std::max(0.0, double(meter.held) - elapsed * m_config.decayPerSecond));
+}
+
+void AudioLevelMeter::addLevel(const std::string &streamId, float amplitude, int64_t nowUs)
+{
+  auto it = std::find_if(m_meters.begin(), m_meters.end(), [&](const Meter &meter) { return meter.streamId == streamId; });
+  if (it == m_meters.end()) {
+    Meter meter;
+    meter.streamId = streamId;
+    meter.heldAtUs = nowUs;
+    it = m_meters.insert(m_meters.end(), meter);
+    m_membershipChanged = true;
+  }
+  float value = scale(amplitude);
+  it->peak = std::max(it->peak, value);
+  if (value >= decayed(*it, nowUs)) {
+    it->held = value;
+    it->heldAtUs = nowUs;
+  }
+}
+
+void AudioLevelMeter::removeStream(const std::string &streamId)
+{
+  auto it = std::find_if(m_meters.begin(), m_meters.end(), [&](const Meter &meter) { return meter.streamId == streamId; });
+  if (it != m_meters.end()) {
+    m_meters.erase(it);
+    m_membershipChanged = true;
+  }
+}
+
+void AudioLevelMeter::clear()
+{
+  m_membershipChanged = m_membershipChanged || !m_meters.empty();
+  m_meters.clear();
+}
+
+bool AudioLevelMeter::tick(int64_t nowUs)
+{
+  bool changed = m_membershipChanged;
+  for (const Meter &meter : m_meters) {
+    changed = changed || std::abs(decayed(meter, nowUs) - meter.reported) >= m_config.changeThreshold;
+  }
+  if (!changed) {
+    return false;
+  }
+
+  m_membershipChanged = false;
+  m_levels.resize(m_meters.size());
+  for (size_t i = 0; i < m_meters.size(); ++i) {
+    Meter &meter = m_meters[i];
+    meter.reported = decayed(meter, nowUs);
+    m_levels[i].streamId = meter.streamId;
+    m_levels[i].level = meter.reported;
+    m_levels[i].peak = meter.peak;
+    meter.peak = 0.0f;
+  }
+  return true;
+}
+
+}
@@ -0,0 +1,94 @@
+//
+//  AudioRingBuffer.cpp
+//  ti.vonage
+//
+
+#include "tivonage/AudioRingBuffer.h"
+
+#include "tivonage/Memory.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace tivonage {
+
+std::unique_ptr<AudioRingBuffer> AudioRingBuffer::create(size_t minimumCapacity)
+{
+  size_t capacity = 1;
+  while (capacity < minimumCapacity) {
+    capacity <<= 1;
+  }
+
+  int16_t *storage = static_cast<int16_t *>(alignedAlloc(capacity * sizeof(int16_t)));
+  if (!storage) {
+    return nullptr;
+  }
+  memset(storage, 0, capacity * sizeof(int16_t));
+  return std::unique_ptr<AudioRingBuffer>(new AudioRingBuffer(storage, capacity));
+}
+
+AudioRingBuffer::AudioRingBuffer(int16_t *storage, size_t capacity)
+    : m_storage(storage)
+    , m_mask(capacity - 1)
+{
+}
+
+AudioRingBuffer::~AudioRingBuffer()
+{
+  alignedFree(m_storage);
+}
+
+size_t AudioRingBuffer::availableToWrite() const
+{
+  size_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+  size_t readIndex = m_readIndex.load(std::memory_order_acquire);
+  return capacity() - (writeIndex - readIndex);
+}
+
+size_t AudioRingBuffer::availableToRead() const
+{
+  size_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+  size_t writeIndex = m_writeIndex.load(std::memory_order_acquire);
+  return writeIndex - readIndex;
+}
+
+size_t AudioRingBuffer::write(const int16_t *samples, size_t count)
+{
+  size_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+  size_t readIndex = m_readIndex.load(std::memory_order_acquire);
+  count = std::min(count, capacity() - (writeIndex - readIndex));
+
+  size_t start = writeIndex & m_mask;
+  size_t first = std::min(count, capacity() - start);
+  memcpy(m_storage + start, samples, first * sizeof(int16_t));
+  memcpy(m_storage, samples + first, (count - first) * sizeof(int16_t));
+
+  m_writeIndex.store(writeIndex + count, std::memory_order_release);
+  return count;
+}
+
+size_t AudioRingBuffer::read(int16_t *samples, size_t count)
+{
+  size_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+  size_t writeIndex = m_writeIndex.load(std::memory_order_acquire);
+  count = std::min(count, writeIndex - readIndex);
+
+  size_t start = readIndex & m_mask;
+  size_t first = std::min(count, capacity() - start);
+  memcpy(samples, m_storage + start, first * sizeof(int16_t));
+  memcpy(samples + first, m_storage, (count - first) * sizeof(int16_t));
+
+  m_readIndex.store(readIndex + count, std::memory_order_release);
+  return count;
+}
+
+size_t AudioRingBuffer::skip(size_t count)
+{
+  size_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+  size_t writeIndex = m_writeIndex.load(std::memory_order_acquire);
+  count = std::min(count, writeIndex - readIndex);
+  m_readIndex.store(readIndex + count, std::memory_order_release);
+  return count;
+}
+
+}
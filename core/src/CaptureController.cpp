@@ -0,0 +1,131 @@
+//
+//  CaptureController.cpp
+//  ti.vonage
+//
+
+#include "tivonage/CaptureController.h"
+
+#include <algorithm>
+
+namespace tivonage {
+
+namespace {
+
+struct LevelScale {
+  double size;
+  double frameRate;
+};
+
+const LevelScale kLevels[CaptureController::kLevelCount] = {
+  { 1.0, 1.0 },
+  { 0.75, 1.0 },
+  { 0.75, 0.5 },
+  { 0.5, 0.5 },
+  { 0.5, 0.25 },
+};
+
+}
+
+CaptureController::CaptureController()
+    : CaptureController(Config())
+{
+}
+
+CaptureController::CaptureController(const Config &config)
+    : m_config(config)
+    , m_upgradeDelayUs(config.upgradeDelayUs)
+{
+}
+
+void CaptureController::setBaseFormat(int width, int height, float frameRate)
+{
+  m_base.width = width;
+  m_base.height = height;
+  m_base.frameRate = frameRate;
+}
+
+CaptureController::Format CaptureController::format(int level) const
+{
+  const LevelScale &scale = kLevels[std::min(std::max(level, 0), kLevelCount - 1)];
+  Format format;
+  // Even, so 4:2:0 chroma stays aligned.
+  format.width = int(m_base.width * scale.size) & ~1;
+  format.height = int(m_base.height * scale.size) & ~1;
+  format.frameRate = float(m_base.frameRate * scale.frameRate);
+  return format;
+}
+
+void CaptureController::addStats(int64_t packetsLost, int64_t packetsSent, int64_t bytesSent, int64_t nowUs)
+{
+  const bool restarted = packetsLost < m_lastLost || packetsSent < m_lastSent || bytesSent < m_lastBytes;
+  if (!m_hasSample || restarted || nowUs <= m_lastSampleUs) {
+    m_hasSample = true;
+    m_lastLost = packetsLost;
+    m_lastSent = packetsSent;
+    m_lastBytes = bytesSent;
+    m_lastSampleUs = nowUs;
+    return;
+  }
+
+  const int64_t lost = packetsLost - m_lastLost;
+  const int64_t sent = packetsSent - m_lastSent;
+  const double seconds = double(nowUs - m_lastSampleUs) / 1000000.0;
+  const double bitrate = double(bytesSent - m_lastBytes) * 8.0 / seconds;
+  m_lastLost = packetsLost;
+  m_lastSent = packetsSent;
+  m_lastBytes = bytesSent;
+  m_lastSampleUs = nowUs;
+
+  LinkState state = LinkState::Unknown;
+  // Nothing sent (video muted, or not flowing yet) says nothing about the
+  // link.
+  if (sent > 0) {
+    const double loss = std::min(1.0, double(lost) / double(sent));
+    m_loss = m_measured ? m_loss + m_config.smoothing * (loss - m_loss) : loss;
+    m_bitrate = m_measured ? m_bitrate + m_config.smoothing * (bitrate - m_bitrate) : bitrate;
+    m_measured = true;
+
+    const Format current = format();
+    const double floor = m_config.minBitsPerPixel * current.width * current.height * current.frameRate;
+    if (m_loss > m_config.congestedLoss || (m_loss >= m_config.cleanLoss && m_bitrate < floor)) {
+      state = LinkState::Congested;
+    } else if (m_loss < m_config.cleanLoss) {
+      state = LinkState::Clean;
+    }
+  }
+  if (state != m_state) {
+    m_state = state;
+    m_stateSinceUs = nowUs;
+  }
+}
+
+bool CaptureController::update(int64_t nowUs)
+{
+  const int previous = m_level;
+
+  // A step up that held for the whole upgrade delay was a successful probe.
+  if (m_probing && nowUs - m_lastStepUs >= m_upgradeDelayUs) {
+    m_probing = false;
+    m_upgradeDelayUs = m_config.upgradeDelayUs;
+  }
+
+  // Every step restarts the state's clock, so these delays also space the
+  // steps apart.
+  if (m_state == LinkState::Congested && m_level + 1 < kLevelCount && nowUs - m_stateSinceUs >= m_config.downgradeDelayUs) {
+    if (m_probing) {
+      m_probing = false;
+      m_upgradeDelayUs = std::min(m_upgradeDelayUs * 2, m_config.maxUpgradeDelayUs);
+    }
+    ++m_level;
+    m_lastStepUs = nowUs;
+    m_stateSinceUs = nowUs;
+  } else if (m_state == LinkState::Clean && m_level > 0 && nowUs - m_stateSinceUs >= m_upgradeDelayUs) {
+    --m_level;
+    m_lastStepUs = nowUs;
+    m_stateSinceUs = nowUs;
+    m_probing = true;
+  }
+  return m_level != previous;
+}
+
+}
@@ -0,0 +1,41 @@
+//
+//  CompareRows.h
+//  ti.vonage
+//
+//  Row kernels for telling frames apart cheaply: a checksum that changes with
+//  any byte of the row, and how far two rows are apart. Every implementation
+//  must produce exactly the scalar result, since hashes from different frames
+//  are compared with each other.
+//
+
+#pragma once
+
+#include "tivonage/Simd.h"
+
+#include <cstdint>
+
+namespace tivonage {
+
+constexpr int kHashLanes = 8;
+
+struct CompareRowKernels {
+  // Folds count bytes into the lanes: every 32-byte block updates
+  // lanes[j] = rotl(lanes[j], 5) + word j of the block (little endian), and a
+  // trailing partial block is zero padded.
+  void (*hashRow)(const uint8_t *data, int count, uint32_t lanes[kHashLanes]);
+  // Sum of absolute differences between count bytes of a and b.
+  uint32_t (*sadRow)(const uint8_t *a, const uint8_t *b, int count);
+};
+
+const CompareRowKernels &scalarCompareRowKernels();
+#if defined(__x86_64__) || defined(__i386__)
+const CompareRowKernels &sse2CompareRowKernels();
+const CompareRowKernels &avx2CompareRowKernels();
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+const CompareRowKernels &neonCompareRowKernels();
+#endif
+
+const CompareRowKernels &compareRowKernels(SimdLevel level);
+
+}
@@ -0,0 +1,57 @@
+//
+//  CompareRowsAVX2.cpp
+//  ti.vonage
+//
+
+#include "CompareRows.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#define TIVONAGE_AVX2 __attribute__((target("avx2")))
+
+namespace tivonage {
+
+TIVONAGE_AVX2 static inline __m256i rotl5(__m256i value)
+{
+  return _mm256_or_si256(_mm256_slli_epi32(value, 5), _mm256_srli_epi32(value, 27));
+}
+
+TIVONAGE_AVX2 static void hashRowAVX2(const uint8_t *data, int count, uint32_t lanes[kHashLanes])
+{
+  __m256i hash = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lanes));
+  int i = 0;
+  for (; i + 32 <= count; i += 32) {
+    hash = _mm256_add_epi32(rotl5(hash), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)));
+  }
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), hash);
+  scalarCompareRowKernels().hashRow(data + i, count - i, lanes);
+}
+
+TIVONAGE_AVX2 static uint32_t sadRowAVX2(const uint8_t *a, const uint8_t *b, int count)
+{
+  __m256i sums = _mm256_setzero_si256();
+  int i = 0;
+  for (; i + 32 <= count; i += 32) {
+    __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+    sums = _mm256_add_epi64(sums, _mm256_sad_epu8(left, right));
+  }
+  __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+  uint32_t sum = uint32_t(_mm_cvtsi128_si32(half)) + uint32_t(_mm_cvtsi128_si32(_mm_srli_si128(half, 8)));
+  return sum + scalarCompareRowKernels().sadRow(a + i, b + i, count - i);
+}
+
+const CompareRowKernels &avx2CompareRowKernels()
+{
+  static const CompareRowKernels kernels = {
+    hashRowAVX2,
+    sadRowAVX2,
+  };
+  return kernels;
+}
+
+}
+
+#endif
@@ -0,0 +1,62 @@
+//
+//  CompareRowsNEON.cpp
+//  ti.vonage
+//
+
+#include "CompareRows.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+namespace tivonage {
+
+static inline uint32x4_t rotl5(uint32x4_t value)
+{
+  return vsriq_n_u32(vshlq_n_u32(value, 5), value, 27);
+}
+
+static void hashRowNEON(const uint8_t *data, int count, uint32_t lanes[kHashLanes])
+{
+  uint32x4_t low = vld1q_u32(lanes);
+  uint32x4_t high = vld1q_u32(lanes + 4);
+  int i = 0;
+  for (; i + 32 <= count; i += 32) {
+    low = vaddq_u32(rotl5(low), vreinterpretq_u32_u8(vld1q_u8(data + i)));
+    high = vaddq_u32(rotl5(high), vreinterpretq_u32_u8(vld1q_u8(data + i + 16)));
+  }
+  vst1q_u32(lanes, low);
+  vst1q_u32(lanes + 4, high);
+  scalarCompareRowKernels().hashRow(data + i, count - i, lanes);
+}
+
+// Absolute differences are widened pairwise into 16-bit sums, which hold
+// 128 iterations before they could overflow, then folded into 32 bits.
+static uint32_t sadRowNEON(const uint8_t *a, const uint8_t *b, int count)
+{
+  uint32x4_t sums = vdupq_n_u32(0);
+  int i = 0;
+  while (i + 16 <= count) {
+    uint16x8_t partial = vdupq_n_u16(0);
+    for (int block = 0; block < 128 && i + 16 <= count; ++block, i += 16) {
+      partial = vpadalq_u8(partial, vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+    }
+    sums = vpadalq_u16(sums, partial);
+  }
+  uint64x2_t pairs = vpaddlq_u32(sums);
+  uint32_t sum = uint32_t(vgetq_lane_u64(pairs, 0) + vgetq_lane_u64(pairs, 1));
+  return sum + scalarCompareRowKernels().sadRow(a + i, b + i, count - i);
+}
+
+const CompareRowKernels &neonCompareRowKernels()
+{
+  static const CompareRowKernels kernels = {
+    hashRowNEON,
+    sadRowNEON,
+  };
+  return kernels;
+}
+
+}
+
+#endif
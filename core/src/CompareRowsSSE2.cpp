@@ -0,0 +1,58 @@
+//
+//  CompareRowsSSE2.cpp
+//  ti.vonage
+//
+
+#include "CompareRows.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <emmintrin.h>
+
+namespace tivonage {
+
+static inline __m128i rotl5(__m128i value)
+{
+  return _mm_or_si128(_mm_slli_epi32(value, 5), _mm_srli_epi32(value, 27));
+}
+
+static void hashRowSSE2(const uint8_t *data, int count, uint32_t lanes[kHashLanes])
+{
+  __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lanes));
+  __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lanes + 4));
+  int i = 0;
+  for (; i + 32 <= count; i += 32) {
+    low = _mm_add_epi32(rotl5(low), _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)));
+    high = _mm_add_epi32(rotl5(high), _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + 16)));
+  }
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), low);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes + 4), high);
+  scalarCompareRowKernels().hashRow(data + i, count - i, lanes);
+}
+
+// psadbw leaves two 16-bit partial sums, one per 64-bit half.
+static uint32_t sadRowSSE2(const uint8_t *a, const uint8_t *b, int count)
+{
+  __m128i sums = _mm_setzero_si128();
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+    __m128i right = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+    sums = _mm_add_epi64(sums, _mm_sad_epu8(left, right));
+  }
+  uint32_t sum = uint32_t(_mm_cvtsi128_si32(sums)) + uint32_t(_mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+  return sum + scalarCompareRowKernels().sadRow(a + i, b + i, count - i);
+}
+
+const CompareRowKernels &sse2CompareRowKernels()
+{
+  static const CompareRowKernels kernels = {
+    hashRowSSE2,
+    sadRowSSE2,
+  };
+  return kernels;
+}
+
+}
+
+#endif
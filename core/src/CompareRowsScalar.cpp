@@ -0,0 +1,74 @@
+//
+//  CompareRowsScalar.cpp
+//  ti.vonage
+//
+
+#include "CompareRows.h"
+
+#include <cstring>
+
+namespace tivonage {
+
+static inline uint32_t rotl5(uint32_t value)
+{
+  return (value << 5) | (value >> 27);
+}
+
+static void hashRowScalar(const uint8_t *data, int count, uint32_t lanes[kHashLanes])
+{
+  int i = 0;
+  for (; i + 32 <= count; i += 32) {
+    for (int lane = 0; lane < kHashLanes; ++lane) {
+      uint32_t word;
+      memcpy(&word, data + i + 4 * lane, sizeof(word));
+      lanes[lane] = rotl5(lanes[lane]) + word;
+    }
+  }
+  if (i < count) {
+    uint8_t block[32] = {};
+    memcpy(block, data + i, size_t(count - i));
+    for (int lane = 0; lane < kHashLanes; ++lane) {
+      uint32_t word;
+      memcpy(&word, block + 4 * lane, sizeof(word));
+      lanes[lane] = rotl5(lanes[lane]) + word;
+    }
+  }
+}
+
+static uint32_t sadRowScalar(const uint8_t *a, const uint8_t *b, int count)
+{
+  uint32_t sum = 0;
+  for (int i = 0; i < count; ++i) {
+    sum += uint32_t(a[i] > b[i] ? a[i] - b[i] : b[i] - a[i]);
+  }
+  return sum;
+}
+
+const CompareRowKernels &scalarCompareRowKernels()
+{
+  static const CompareRowKernels kernels = {
+    hashRowScalar,
+    sadRowScalar,
+  };
+  return kernels;
+}
+
+const CompareRowKernels &compareRowKernels(SimdLevel level)
+{
+  switch (level) {
+#if defined(__x86_64__) || defined(__i386__)
+  case SimdLevel::SSE2:
+    return sse2CompareRowKernels();
+  case SimdLevel::AVX2:
+    return avx2CompareRowKernels();
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  case SimdLevel::NEON:
+    return neonCompareRowKernels();
+#endif
+  default:
+    return scalarCompareRowKernels();
+  }
+}
+
+}
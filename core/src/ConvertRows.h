@@ -0,0 +1,51 @@
+//
+//  ConvertRows.h
+//  ti.vonage
+//
+//  Row kernels behind convertFrame(). Every SIMD variant must produce
+//  exactly the same bytes as the scalar one; they handle the bulk of a row
+//  and fall back to the scalar kernel for the tail.
+//
+
+#pragma once
+
+#include "tivonage/Simd.h"
+
+#include <cstdint>
+
+namespace tivonage {
+
+struct ConvertRowKernels {
+  // width is in chroma samples.
+  void (*mergeUV)(const uint8_t *u, const uint8_t *v, uint8_t *uv, int width);
+  void (*splitUV)(const uint8_t *uv, uint8_t *u, uint8_t *v, int width);
+  // width is in pixels; chroma is horizontally subsampled by two.
+  void (*i420ToARGB)(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *argb, int width);
+  void (*nv12ToARGB)(const uint8_t *y, const uint8_t *uv, uint8_t *argb, int width);
+  void (*argbToY)(const uint8_t *argb, uint8_t *y, int width);
+  // Averages 2x2 blocks of two adjacent rows into one row of U and V.
+  void (*argbToUV)(const uint8_t *argb0, const uint8_t *argb1, uint8_t *u, uint8_t *v, int width);
+};
+
+const ConvertRowKernels &scalarConvertRowKernels();
+#if defined(__x86_64__) || defined(__i386__)
+const ConvertRowKernels &sse2ConvertRowKernels();
+const ConvertRowKernels &avx2ConvertRowKernels();
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+const ConvertRowKernels &neonConvertRowKernels();
+#endif
+
+const ConvertRowKernels &convertRowKernels(SimdLevel level);
+
+// Fixed-point BT.601 video-range coefficients shared by all kernels.
+// YUV -> RGB uses 6 fractional bits so every term fits in int16.
+namespace yuv {
+constexpr int kY = 74;
+constexpr int kUB = 129;
+constexpr int kUG = 25;
+constexpr int kVG = 52;
+constexpr int kVR = 102;
+}
+
+}
@@ -0,0 +1,200 @@
+//
+//  ConvertRowsAVX2.cpp
+//  ti.vonage
+//
+//  Compiled with per-function target attributes rather than -mavx2 so the
+//  file builds with default flags and only runs after CPU detection.
+//
+
+#include "ConvertRows.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#define TIVONAGE_AVX2 __attribute__((target("avx2")))
+
+namespace tivonage {
+
+TIVONAGE_AVX2 static void mergeUVAVX2(const uint8_t *u, const uint8_t *v, uint8_t *uv, int width)
+{
+  int i = 0;
+  for (; i + 32 <= width; i += 32) {
+    const __m256i us = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(u + i));
+    const __m256i vs = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(v + i));
+    const __m256i low = _mm256_unpacklo_epi8(us, vs);
+    const __m256i high = _mm256_unpackhi_epi8(us, vs);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(uv + 2 * i), _mm256_permute2x128_si256(low, high, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(uv + 2 * i + 32), _mm256_permute2x128_si256(low, high, 0x31));
+  }
+  sse2ConvertRowKernels().mergeUV(u + i, v + i, uv + 2 * i, width - i);
+}
+
+TIVONAGE_AVX2 static void splitUVAVX2(const uint8_t *uv, uint8_t *u, uint8_t *v, int width)
+{
+  const __m256i mask = _mm256_set1_epi16(0x00FF);
+  int i = 0;
+  for (; i + 32 <= width; i += 32) {
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(uv + 2 * i));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(uv + 2 * i + 32));
+    // packus works per 128-bit lane; the permute restores sample order.
+    const __m256i us = _mm256_packus_epi16(_mm256_and_si256(a, mask), _mm256_and_si256(b, mask));
+    const __m256i vs = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(u + i), _mm256_permute4x64_epi64(us, _MM_SHUFFLE(3, 1, 2, 0)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(v + i), _mm256_permute4x64_epi64(vs, _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+  sse2ConvertRowKernels().splitUV(uv + 2 * i, u + i, v + i, width - i);
+}
+
+// Sixteen pixels of 16-bit Y, U and V (chroma already upsampled) to BGRA.
+TIVONAGE_AVX2 static inline void yuvToBGRA16(__m256i y, __m256i u, __m256i v, uint8_t *argb)
+{
+  const __m256i luma = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(y, _mm256_set1_epi16(16)), _mm256_set1_epi16(yuv::kY)), _mm256_set1_epi16(32));
+  const __m256i d = _mm256_sub_epi16(u, _mm256_set1_epi16(128));
+  const __m256i e = _mm256_sub_epi16(v, _mm256_set1_epi16(128));
+
+  __m256i b = _mm256_adds_epi16(luma, _mm256_mullo_epi16(d, _mm256_set1_epi16(yuv::kUB)));
+  __m256i g = _mm256_subs_epi16(_mm256_subs_epi16(luma, _mm256_mullo_epi16(d, _mm256_set1_epi16(yuv::kUG))), _mm256_mullo_epi16(e, _mm256_set1_epi16(yuv::kVG)));
+  __m256i r = _mm256_adds_epi16(luma, _mm256_mullo_epi16(e, _mm256_set1_epi16(yuv::kVR)));
+
+  const __m256i zero = _mm256_setzero_si256();
+  b = _mm256_packus_epi16(_mm256_srai_epi16(b, 6), zero);
+  g = _mm256_packus_epi16(_mm256_srai_epi16(g, 6), zero);
+  r = _mm256_packus_epi16(_mm256_srai_epi16(r, 6), zero);
+
+  // Within each 128-bit lane: pixels 0-7 (low lane) and 8-15 (high lane).
+  const __m256i bg = _mm256_unpacklo_epi8(b, g);
+  const __m256i ra = _mm256_unpacklo_epi8(r, _mm256_set1_epi8(char(0xFF)));
+  const __m256i low = _mm256_unpacklo_epi16(bg, ra);
+  const __m256i high = _mm256_unpackhi_epi16(bg, ra);
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(argb), _mm256_permute2x128_si256(low, high, 0x20));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(argb + 32), _mm256_permute2x128_si256(low, high, 0x31));
+}
+
+// Eight 16-bit chroma samples, each repeated for two pixels, in pixel order.
+TIVONAGE_AVX2 static inline __m256i upsampleChroma(__m128i chroma)
+{
+  return _mm256_set_m128i(_mm_unpackhi_epi16(chroma, chroma), _mm_unpacklo_epi16(chroma, chroma));
+}
+
+TIVONAGE_AVX2 static void i420ToARGBAVX2(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *argb, int width)
+{
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const __m256i ys = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(y + x)));
+    const __m128i us = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(u + x / 2)));
+    const __m128i vs = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(v + x / 2)));
+    yuvToBGRA16(ys, upsampleChroma(us), upsampleChroma(vs), argb + 4 * x);
+  }
+  sse2ConvertRowKernels().i420ToARGB(y + x, u + x / 2, v + x / 2, argb + 4 * x, width - x);
+}
+
+TIVONAGE_AVX2 static void nv12ToARGBAVX2(const uint8_t *y, const uint8_t *uv, uint8_t *argb, int width)
+{
+  const __m128i mask = _mm_set1_epi16(0x00FF);
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const __m256i ys = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(y + x)));
+    const __m128i uvs = _mm_loadu_si128(reinterpret_cast<const __m128i *>(uv + x));
+    const __m128i us = _mm_and_si128(uvs, mask);
+    const __m128i vs = _mm_srli_epi16(uvs, 8);
+    yuvToBGRA16(ys, upsampleChroma(us), upsampleChroma(vs), argb + 4 * x);
+  }
+  sse2ConvertRowKernels().nv12ToARGB(y + x, uv + x, argb + 4 * x, width - x);
+}
+
+TIVONAGE_AVX2 static void argbToYAVX2(const uint8_t *argb, uint8_t *y, int width)
+{
+  const __m256i mask = _mm256_set1_epi32(0xFF);
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const __m256i p0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(argb + 4 * x));
+    const __m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(argb + 4 * x + 32));
+    // Lanes end up as pixels 0-3, 8-11, 4-7, 12-15; fixed after the math.
+    const __m256i b = _mm256_packs_epi32(_mm256_and_si256(p0, mask), _mm256_and_si256(p1, mask));
+    const __m256i g = _mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(p0, 8), mask), _mm256_and_si256(_mm256_srli_epi32(p1, 8), mask));
+    const __m256i r = _mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(p0, 16), mask), _mm256_and_si256(_mm256_srli_epi32(p1, 16), mask));
+
+    __m256i sum = _mm256_add_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(66)), _mm256_mullo_epi16(g, _mm256_set1_epi16(129)));
+    sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(b, _mm256_set1_epi16(25)));
+    sum = _mm256_add_epi16(_mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(128)), 8), _mm256_set1_epi16(16));
+    sum = _mm256_permute4x64_epi64(sum, _MM_SHUFFLE(3, 1, 2, 0));
+
+    const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(sum, sum), _MM_SHUFFLE(3, 1, 2, 0));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(y + x), _mm256_castsi256_si128(packed));
+  }
+  sse2ConvertRowKernels().argbToY(argb + 4 * x, y + x, width - x);
+}
+
+// Splits sixteen BGRA pixels into 16-bit B, G and R lanes. The lanes hold
+// pixels 0-3, 8-11 | 4-7, 12-15, which keeps horizontal neighbours together.
+TIVONAGE_AVX2 static inline void unpackBGR16(const uint8_t *argb, __m256i &b, __m256i &g, __m256i &r)
+{
+  const __m256i mask = _mm256_set1_epi32(0xFF);
+  const __m256i p0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(argb));
+  const __m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(argb + 32));
+  b = _mm256_packs_epi32(_mm256_and_si256(p0, mask), _mm256_and_si256(p1, mask));
+  g = _mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(p0, 8), mask), _mm256_and_si256(_mm256_srli_epi32(p1, 8), mask));
+  r = _mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(p0, 16), mask), _mm256_and_si256(_mm256_srli_epi32(p1, 16), mask));
+}
+
+TIVONAGE_AVX2 static inline __m256i average2x2(__m256i top, __m256i bottom)
+{
+  const __m256i sum = _mm256_add_epi16(top, bottom);
+  const __m256i pairs = _mm256_add_epi32(_mm256_and_si256(sum, _mm256_set1_epi32(0xFFFF)), _mm256_srli_epi32(sum, 16));
+  return _mm256_srli_epi32(_mm256_add_epi32(pairs, _mm256_set1_epi32(2)), 2);
+}
+
+// Packs sixteen 16-bit chroma results to bytes. The input lane order is
+// c0 c1 c4 c5 c8 c9 c12 c13 | c2 c3 c6 c7 c10 c11 c14 c15.
+TIVONAGE_AVX2 static inline __m128i packChroma(__m256i chroma)
+{
+  const __m256i packed = _mm256_packus_epi16(chroma, chroma);
+  return _mm_unpacklo_epi16(_mm256_castsi256_si128(packed), _mm256_extracti128_si256(packed, 1));
+}
+
+TIVONAGE_AVX2 static void argbToUVAVX2(const uint8_t *argb0, const uint8_t *argb1, uint8_t *u, uint8_t *v, int width)
+{
+  int x = 0;
+  for (; x + 32 <= width; x += 32) {
+    __m256i b0, g0, r0, b1, g1, r1;
+    __m256i b2, g2, r2, b3, g3, r3;
+    unpackBGR16(argb0 + 4 * x, b0, g0, r0);
+    unpackBGR16(argb1 + 4 * x, b1, g1, r1);
+    unpackBGR16(argb0 + 4 * x + 64, b2, g2, r2);
+    unpackBGR16(argb1 + 4 * x + 64, b3, g3, r3);
+
+    const __m256i b = _mm256_packs_epi32(average2x2(b0, b1), average2x2(b2, b3));
+    const __m256i g = _mm256_packs_epi32(average2x2(g0, g1), average2x2(g2, g3));
+    const __m256i r = _mm256_packs_epi32(average2x2(r0, r1), average2x2(r2, r3));
+
+    __m256i us = _mm256_sub_epi16(_mm256_mullo_epi16(b, _mm256_set1_epi16(112)), _mm256_mullo_epi16(g, _mm256_set1_epi16(74)));
+    us = _mm256_sub_epi16(us, _mm256_mullo_epi16(r, _mm256_set1_epi16(38)));
+    us = _mm256_add_epi16(_mm256_srai_epi16(_mm256_add_epi16(us, _mm256_set1_epi16(128)), 8), _mm256_set1_epi16(128));
+
+    __m256i vs = _mm256_sub_epi16(_mm256_mullo_epi16(r, _mm256_set1_epi16(112)), _mm256_mullo_epi16(g, _mm256_set1_epi16(94)));
+    vs = _mm256_sub_epi16(vs, _mm256_mullo_epi16(b, _mm256_set1_epi16(18)));
+    vs = _mm256_add_epi16(_mm256_srai_epi16(_mm256_add_epi16(vs, _mm256_set1_epi16(128)), 8), _mm256_set1_epi16(128));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(u + x / 2), packChroma(us));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(v + x / 2), packChroma(vs));
+  }
+  sse2ConvertRowKernels().argbToUV(argb0 + 4 * x, argb1 + 4 * x, u + x / 2, v + x / 2, width - x);
+}
+
+const ConvertRowKernels &avx2ConvertRowKernels()
+{
+  static const ConvertRowKernels kernels = {
+    mergeUVAVX2,
+    splitUVAVX2,
+    i420ToARGBAVX2,
+    nv12ToARGBAVX2,
+    argbToYAVX2,
+    argbToUVAVX2,
+  };
+  return kernels;
+}
+
+}
+
+#endif
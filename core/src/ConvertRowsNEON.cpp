@@ -0,0 +1,142 @@
+//
+//  ConvertRowsNEON.cpp
+//  ti.vonage
+//
+
+#include "ConvertRows.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+namespace tivonage {
+
+static void mergeUVNEON(const uint8_t *u, const uint8_t *v, uint8_t *uv, int width)
+{
+  int i = 0;
+  for (; i + 16 <= width; i += 16) {
+    uint8x16x2_t interleaved;
+    interleaved.val[0] = vld1q_u8(u + i);
+    interleaved.val[1] = vld1q_u8(v + i);
+    vst2q_u8(uv + 2 * i, interleaved);
+  }
+  scalarConvertRowKernels().mergeUV(u + i, v + i, uv + 2 * i, width - i);
+}
+
+static void splitUVNEON(const uint8_t *uv, uint8_t *u, uint8_t *v, int width)
+{
+  int i = 0;
+  for (; i + 16 <= width; i += 16) {
+    const uint8x16x2_t planes = vld2q_u8(uv + 2 * i);
+    vst1q_u8(u + i, planes.val[0]);
+    vst1q_u8(v + i, planes.val[1]);
+  }
+  scalarConvertRowKernels().splitUV(uv + 2 * i, u + i, v + i, width - i);
+}
+
+// Eight pixels of Y and upsampled U / V to BGRA.
+static inline void yuvToBGRA8(uint8x8_t y, uint8x8_t u, uint8x8_t v, uint8_t *argb)
+{
+  const int16x8_t luma = vaddq_s16(vmulq_n_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(y)), vdupq_n_s16(16)), yuv::kY), vdupq_n_s16(32));
+  const int16x8_t d = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u)), vdupq_n_s16(128));
+  const int16x8_t e = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v)), vdupq_n_s16(128));
+
+  const int16x8_t b = vqaddq_s16(luma, vmulq_n_s16(d, yuv::kUB));
+  const int16x8_t g = vqsubq_s16(vqsubq_s16(luma, vmulq_n_s16(d, yuv::kUG)), vmulq_n_s16(e, yuv::kVG));
+  const int16x8_t r = vqaddq_s16(luma, vmulq_n_s16(e, yuv::kVR));
+
+  uint8x8x4_t bgra;
+  bgra.val[0] = vqmovun_s16(vshrq_n_s16(b, 6));
+  bgra.val[1] = vqmovun_s16(vshrq_n_s16(g, 6));
+  bgra.val[2] = vqmovun_s16(vshrq_n_s16(r, 6));
+  bgra.val[3] = vdup_n_u8(255);
+  vst4_u8(argb, bgra);
+}
+
+static void i420ToARGBNEON(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *argb, int width)
+{
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const uint8x16_t ys = vld1q_u8(y + x);
+    const uint8x8_t us = vld1_u8(u + x / 2);
+    const uint8x8_t vs = vld1_u8(v + x / 2);
+    const uint8x8x2_t uu = vzip_u8(us, us);
+    const uint8x8x2_t vv = vzip_u8(vs, vs);
+    yuvToBGRA8(vget_low_u8(ys), uu.val[0], vv.val[0], argb + 4 * x);
+    yuvToBGRA8(vget_high_u8(ys), uu.val[1], vv.val[1], argb + 4 * x + 32);
+  }
+  scalarConvertRowKernels().i420ToARGB(y + x, u + x / 2, v + x / 2, argb + 4 * x, width - x);
+}
+
+static void nv12ToARGBNEON(const uint8_t *y, const uint8_t *uv, uint8_t *argb, int width)
+{
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const uint8x16_t ys = vld1q_u8(y + x);
+    const uint8x8x2_t chroma = vld2_u8(uv + x);
+    const uint8x8x2_t uu = vzip_u8(chroma.val[0], chroma.val[0]);
+    const uint8x8x2_t vv = vzip_u8(chroma.val[1], chroma.val[1]);
+    yuvToBGRA8(vget_low_u8(ys), uu.val[0], vv.val[0], argb + 4 * x);
+    yuvToBGRA8(vget_high_u8(ys), uu.val[1], vv.val[1], argb + 4 * x + 32);
+  }
+  scalarConvertRowKernels().nv12ToARGB(y + x, uv + x, argb + 4 * x, width - x);
+}
+
+static void argbToYNEON(const uint8_t *argb, uint8_t *y, int width)
+{
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    const uint8x8x4_t bgra = vld4_u8(argb + 4 * x);
+    uint16x8_t sum = vmull_u8(bgra.val[2], vdup_n_u8(66));
+    sum = vmlal_u8(sum, bgra.val[1], vdup_n_u8(129));
+    sum = vmlal_u8(sum, bgra.val[0], vdup_n_u8(25));
+    sum = vaddq_u16(sum, vdupq_n_u16(128));
+    vst1_u8(y + x, vadd_u8(vshrn_n_u16(sum, 8), vdup_n_u8(16)));
+  }
+  scalarConvertRowKernels().argbToY(argb + 4 * x, y + x, width - x);
+}
+
+// Rounded average of 2x2 blocks: sixteen columns of two rows to eight lanes.
+static inline int16x8_t average2x2(uint8x16_t top, uint8x16_t bottom)
+{
+  const uint16x8_t sum = vaddq_u16(vpaddlq_u8(top), vpaddlq_u8(bottom));
+  return vreinterpretq_s16_u16(vrshrq_n_u16(sum, 2));
+}
+
+static void argbToUVNEON(const uint8_t *argb0, const uint8_t *argb1, uint8_t *u, uint8_t *v, int width)
+{
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const uint8x16x4_t top = vld4q_u8(argb0 + 4 * x);
+    const uint8x16x4_t bottom = vld4q_u8(argb1 + 4 * x);
+    const int16x8_t b = average2x2(top.val[0], bottom.val[0]);
+    const int16x8_t g = average2x2(top.val[1], bottom.val[1]);
+    const int16x8_t r = average2x2(top.val[2], bottom.val[2]);
+
+    int16x8_t us = vsubq_s16(vsubq_s16(vmulq_n_s16(b, 112), vmulq_n_s16(g, 74)), vmulq_n_s16(r, 38));
+    us = vaddq_s16(vshrq_n_s16(vaddq_s16(us, vdupq_n_s16(128)), 8), vdupq_n_s16(128));
+    int16x8_t vs = vsubq_s16(vsubq_s16(vmulq_n_s16(r, 112), vmulq_n_s16(g, 94)), vmulq_n_s16(b, 18));
+    vs = vaddq_s16(vshrq_n_s16(vaddq_s16(vs, vdupq_n_s16(128)), 8), vdupq_n_s16(128));
+
+    vst1_u8(u + x / 2, vqmovun_s16(us));
+    vst1_u8(v + x / 2, vqmovun_s16(vs));
+  }
+  scalarConvertRowKernels().argbToUV(argb0 + 4 * x, argb1 + 4 * x, u + x / 2, v + x / 2, width - x);
+}
+
+const ConvertRowKernels &neonConvertRowKernels()
+{
+  static const ConvertRowKernels kernels = {
+    mergeUVNEON,
+    splitUVNEON,
+    i420ToARGBNEON,
+    nv12ToARGBNEON,
+    argbToYNEON,
+    argbToUVNEON,
+  };
+  return kernels;
+}
+
+}
+
+#endif
@@ -0,0 +1,187 @@
+//
+//  ConvertRowsSSE2.cpp
+//  ti.vonage
+//
+
+#include "ConvertRows.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <emmintrin.h>
+
+#include <cstring>
+
+namespace tivonage {
+
+static inline __m128i loadLow32(const uint8_t *source)
+{
+  int32_t value;
+  memcpy(&value, source, sizeof(value));
+  return _mm_cvtsi32_si128(value);
+}
+
+static inline void storeLow32(uint8_t *destination, __m128i value)
+{
+  int32_t low = _mm_cvtsi128_si32(value);
+  memcpy(destination, &low, sizeof(low));
+}
+
+// Eight pixels of 16-bit Y, U and V (chroma already upsampled) to BGRA.
+static inline void yuvToBGRA8(__m128i y, __m128i u, __m128i v, uint8_t *argb)
+{
+  const __m128i luma = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(y, _mm_set1_epi16(16)), _mm_set1_epi16(yuv::kY)), _mm_set1_epi16(32));
+  const __m128i d = _mm_sub_epi16(u, _mm_set1_epi16(128));
+  const __m128i e = _mm_sub_epi16(v, _mm_set1_epi16(128));
+
+  __m128i b = _mm_adds_epi16(luma, _mm_mullo_epi16(d, _mm_set1_epi16(yuv::kUB)));
+  __m128i g = _mm_subs_epi16(_mm_subs_epi16(luma, _mm_mullo_epi16(d, _mm_set1_epi16(yuv::kUG))), _mm_mullo_epi16(e, _mm_set1_epi16(yuv::kVG)));
+  __m128i r = _mm_adds_epi16(luma, _mm_mullo_epi16(e, _mm_set1_epi16(yuv::kVR)));
+
+  b = _mm_packus_epi16(_mm_srai_epi16(b, 6), _mm_setzero_si128());
+  g = _mm_packus_epi16(_mm_srai_epi16(g, 6), _mm_setzero_si128());
+  r = _mm_packus_epi16(_mm_srai_epi16(r, 6), _mm_setzero_si128());
+
+  const __m128i bg = _mm_unpacklo_epi8(b, g);
+  const __m128i ra = _mm_unpacklo_epi8(r, _mm_set1_epi8(char(0xFF)));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(argb), _mm_unpacklo_epi16(bg, ra));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(argb + 16), _mm_unpackhi_epi16(bg, ra));
+}
+
+static void mergeUVSSE2(const uint8_t *u, const uint8_t *v, uint8_t *uv, int width)
+{
+  int i = 0;
+  for (; i + 16 <= width; i += 16) {
+    const __m128i us = _mm_loadu_si128(reinterpret_cast<const __m128i *>(u + i));
+    const __m128i vs = _mm_loadu_si128(reinterpret_cast<const __m128i *>(v + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(uv + 2 * i), _mm_unpacklo_epi8(us, vs));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(uv + 2 * i + 16), _mm_unpackhi_epi8(us, vs));
+  }
+  scalarConvertRowKernels().mergeUV(u + i, v + i, uv + 2 * i, width - i);
+}
+
+static void splitUVSSE2(const uint8_t *uv, uint8_t *u, uint8_t *v, int width)
+{
+  const __m128i mask = _mm_set1_epi16(0x00FF);
+  int i = 0;
+  for (; i + 16 <= width; i += 16) {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(uv + 2 * i));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(uv + 2 * i + 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(u + i), _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(v + i), _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)));
+  }
+  scalarConvertRowKernels().splitUV(uv + 2 * i, u + i, v + i, width - i);
+}
+
+static void i420ToARGBSSE2(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *argb, int width)
+{
+  const __m128i zero = _mm_setzero_si128();
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    const __m128i ys = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(y + x)), zero);
+    __m128i us = _mm_unpacklo_epi8(loadLow32(u + x / 2), zero);
+    __m128i vs = _mm_unpacklo_epi8(loadLow32(v + x / 2), zero);
+    us = _mm_unpacklo_epi16(us, us);
+    vs = _mm_unpacklo_epi16(vs, vs);
+    yuvToBGRA8(ys, us, vs, argb + 4 * x);
+  }
+  scalarConvertRowKernels().i420ToARGB(y + x, u + x / 2, v + x / 2, argb + 4 * x, width - x);
+}
+
+static void nv12ToARGBSSE2(const uint8_t *y, const uint8_t *uv, uint8_t *argb, int width)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i mask = _mm_set1_epi16(0x00FF);
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    const __m128i ys = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(y + x)), zero);
+    // Each 16-bit lane of uvs holds one u | v << 8 pair.
+    const __m128i uvs = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(uv + x));
+    __m128i us = _mm_and_si128(uvs, mask);
+    __m128i vs = _mm_srli_epi16(uvs, 8);
+    us = _mm_unpacklo_epi16(us, us);
+    vs = _mm_unpacklo_epi16(vs, vs);
+    yuvToBGRA8(ys, us, vs, argb + 4 * x);
+  }
+  scalarConvertRowKernels().nv12ToARGB(y + x, uv + x, argb + 4 * x, width - x);
+}
+
+// Splits eight BGRA pixels into 16-bit B, G and R lanes.
+static inline void unpackBGR8(const uint8_t *argb, __m128i &b, __m128i &g, __m128i &r)
+{
+  const __m128i mask = _mm_set1_epi32(0xFF);
+  const __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(argb));
+  const __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(argb + 16));
+  b = _mm_packs_epi32(_mm_and_si128(p0, mask), _mm_and_si128(p1, mask));
+  g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 8), mask), _mm_and_si128(_mm_srli_epi32(p1, 8), mask));
+  r = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 16), mask), _mm_and_si128(_mm_srli_epi32(p1, 16), mask));
+}
+
+static void argbToYSSE2(const uint8_t *argb, uint8_t *y, int width)
+{
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    __m128i b, g, r;
+    unpackBGR8(argb + 4 * x, b, g, r);
+    // The weighted sum peaks at 56228, so unsigned 16-bit lanes are exact.
+    __m128i sum = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(66)), _mm_mullo_epi16(g, _mm_set1_epi16(129)));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(b, _mm_set1_epi16(25)));
+    sum = _mm_add_epi16(_mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(128)), 8), _mm_set1_epi16(16));
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(y + x), _mm_packus_epi16(sum, sum));
+  }
+  scalarConvertRowKernels().argbToY(argb + 4 * x, y + x, width - x);
+}
+
+// Rounded average of the 2x2 blocks in eight columns of two rows: four
+// 32-bit lanes per channel.
+static inline __m128i average2x2(__m128i top, __m128i bottom)
+{
+  const __m128i sum = _mm_add_epi16(top, bottom);
+  const __m128i pairs = _mm_add_epi32(_mm_and_si128(sum, _mm_set1_epi32(0xFFFF)), _mm_srli_epi32(sum, 16));
+  return _mm_srli_epi32(_mm_add_epi32(pairs, _mm_set1_epi32(2)), 2);
+}
+
+static void argbToUVSSE2(const uint8_t *argb0, const uint8_t *argb1, uint8_t *u, uint8_t *v, int width)
+{
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    __m128i b0, g0, r0, b1, g1, r1;
+    __m128i b2, g2, r2, b3, g3, r3;
+    unpackBGR8(argb0 + 4 * x, b0, g0, r0);
+    unpackBGR8(argb1 + 4 * x, b1, g1, r1);
+    unpackBGR8(argb0 + 4 * x + 32, b2, g2, r2);
+    unpackBGR8(argb1 + 4 * x + 32, b3, g3, r3);
+
+    const __m128i b = _mm_packs_epi32(average2x2(b0, b1), average2x2(b2, b3));
+    const __m128i g = _mm_packs_epi32(average2x2(g0, g1), average2x2(g2, g3));
+    const __m128i r = _mm_packs_epi32(average2x2(r0, r1), average2x2(r2, r3));
+
+    __m128i us = _mm_sub_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(112)), _mm_mullo_epi16(g, _mm_set1_epi16(74)));
+    us = _mm_sub_epi16(us, _mm_mullo_epi16(r, _mm_set1_epi16(38)));
+    us = _mm_add_epi16(_mm_srai_epi16(_mm_add_epi16(us, _mm_set1_epi16(128)), 8), _mm_set1_epi16(128));
+
+    __m128i vs = _mm_sub_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(112)), _mm_mullo_epi16(g, _mm_set1_epi16(94)));
+    vs = _mm_sub_epi16(vs, _mm_mullo_epi16(b, _mm_set1_epi16(18)));
+    vs = _mm_add_epi16(_mm_srai_epi16(_mm_add_epi16(vs, _mm_set1_epi16(128)), 8), _mm_set1_epi16(128));
+
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(u + x / 2), _mm_packus_epi16(us, us));
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(v + x / 2), _mm_packus_epi16(vs, vs));
+  }
+  scalarConvertRowKernels().argbToUV(argb0 + 4 * x, argb1 + 4 * x, u + x / 2, v + x / 2, width - x);
+}
+
+const ConvertRowKernels &sse2ConvertRowKernels()
+{
+  static const ConvertRowKernels kernels = {
+    mergeUVSSE2,
+    splitUVSSE2,
+    i420ToARGBSSE2,
+    nv12ToARGBSSE2,
+    argbToYSSE2,
+    argbToUVSSE2,
+  };
+  return kernels;
+}
+
+}
+
+#endif
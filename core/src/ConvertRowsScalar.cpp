@@ -0,0 +1,110 @@
+//
+//  ConvertRowsScalar.cpp
+//  ti.vonage
+//
+
+#include "ConvertRows.h"
+
+#include <algorithm>
+
+namespace tivonage {
+
+static inline uint8_t clampToByte(int value)
+{
+  return uint8_t(std::min(std::max(value, 0), 255));
+}
+
+static inline void yuvToBGRA(int y, int u, int v, uint8_t *bgra)
+{
+  int luma = yuv::kY * (y - 16) + 32;
+  int d = u - 128;
+  int e = v - 128;
+  bgra[0] = clampToByte((luma + yuv::kUB * d) >> 6);
+  bgra[1] = clampToByte((luma - yuv::kUG * d - yuv::kVG * e) >> 6);
+  bgra[2] = clampToByte((luma + yuv::kVR * e) >> 6);
+  bgra[3] = 255;
+}
+
+static void mergeUVScalar(const uint8_t *u, const uint8_t *v, uint8_t *uv, int width)
+{
+  for (int i = 0; i < width; ++i) {
+    uv[2 * i] = u[i];
+    uv[2 * i + 1] = v[i];
+  }
+}
+
+static void splitUVScalar(const uint8_t *uv, uint8_t *u, uint8_t *v, int width)
+{
+  for (int i = 0; i < width; ++i) {
+    u[i] = uv[2 * i];
+    v[i] = uv[2 * i + 1];
+  }
+}
+
+static void i420ToARGBScalar(const uint8_t *y, const uint8_t *u, const uint8_t *v, uint8_t *argb, int width)
+{
+  for (int x = 0; x < width; ++x) {
+    yuvToBGRA(y[x], u[x / 2], v[x / 2], argb + 4 * x);
+  }
+}
+
+static void nv12ToARGBScalar(const uint8_t *y, const uint8_t *uv, uint8_t *argb, int width)
+{
+  for (int x = 0; x < width; ++x) {
+    yuvToBGRA(y[x], uv[(x / 2) * 2], uv[(x / 2) * 2 + 1], argb + 4 * x);
+  }
+}
+
+static void argbToYScalar(const uint8_t *argb, uint8_t *y, int width)
+{
+  for (int x = 0; x < width; ++x) {
+    const uint8_t *pixel = argb + 4 * x;
+    y[x] = uint8_t(((66 * pixel[2] + 129 * pixel[1] + 25 * pixel[0] + 128) >> 8) + 16);
+  }
+}
+
+static void argbToUVScalar(const uint8_t *argb0, const uint8_t *argb1, uint8_t *u, uint8_t *v, int width)
+{
+  for (int x = 0; x < width; x += 2) {
+    int left = 4 * x;
+    int right = 4 * std::min(x + 1, width - 1);
+    int b = (argb0[left] + argb0[right] + argb1[left] + argb1[right] + 2) >> 2;
+    int g = (argb0[left + 1] + argb0[right + 1] + argb1[left + 1] + argb1[right + 1] + 2) >> 2;
+    int r = (argb0[left + 2] + argb0[right + 2] + argb1[left + 2] + argb1[right + 2] + 2) >> 2;
+    u[x / 2] = uint8_t(((112 * b - 74 * g - 38 * r + 128) >> 8) + 128);
+    v[x / 2] = uint8_t(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+  }
+}
+
+const ConvertRowKernels &scalarConvertRowKernels()
+{
+  static const ConvertRowKernels kernels = {
+    mergeUVScalar,
+    splitUVScalar,
+    i420ToARGBScalar,
+    nv12ToARGBScalar,
+    argbToYScalar,
+    argbToUVScalar,
+  };
+  return kernels;
+}
+
+const ConvertRowKernels &convertRowKernels(SimdLevel level)
+{
+  switch (level) {
+#if defined(__x86_64__) || defined(__i386__)
+  case SimdLevel::SSE2:
+    return sse2ConvertRowKernels();
+  case SimdLevel::AVX2:
+    return avx2ConvertRowKernels();
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  case SimdLevel::NEON:
+    return neonConvertRowKernels();
+#endif
+  default:
+    return scalarConvertRowKernels();
+  }
+}
+
+}
@@ -0,0 +1,15 @@
+//
+//  Core.cpp
+//  ti.vonage
+//
+
+#include "tivonage/Core.h"
+
+namespace tivonage {
+
+const char *coreVersion()
+{
+  return "1.0.0";
+}
+
+}
@@ -0,0 +1,126 @@
+//
+//  DeadlinePacer.cpp
+//  ti.vonage
+//
+
+#include "tivonage/DeadlinePacer.h"
+
+#include "tivonage/Clock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace tivonage {
+
+DeadlinePacer::DeadlinePacer(const Config &config, Task task)
+    : m_config(config)
+    , m_task(std::move(task))
+{
+}
+
+DeadlinePacer::~DeadlinePacer()
+{
+  stop();
+}
+
+bool DeadlinePacer::start()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_thread.joinable()) {
+    return false;
+  }
+  m_stopping = false;
+  m_done = false;
+  m_stats = Stats();
+  m_totalLatenessUs = 0.0;
+  m_thread = std::thread([this] { run(); });
+  return true;
+}
+
+void DeadlinePacer::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_wake.notify_all();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+void DeadlinePacer::wait()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_wake.wait(lock, [this] { return m_done; });
+}
+
+DeadlinePacer::Stats DeadlinePacer::stats() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_stats;
+}
+
+uint64_t DeadlinePacer::dueTick(uint64_t index, double intervalUs, int64_t nowUs, int64_t &latenessUs)
+{
+  const int64_t offsetUs = int64_t(std::llround(double(index) * intervalUs));
+  latenessUs = std::max<int64_t>(nowUs - offsetUs, 0);
+  const uint64_t missed = uint64_t(double(latenessUs) / intervalUs);
+  if (missed > 0) {
+    latenessUs -= int64_t(std::llround(double(missed) * intervalUs));
+  }
+  return index + missed;
+}
+
+void DeadlinePacer::run()
+{
+  using Clock = std::chrono::steady_clock;
+  const double intervalUs = m_config.intervalUs;
+  const int64_t startUs = monotonicMicros();
+  const Clock::time_point start = Clock::now();
+  uint64_t index = 0;
+  uint64_t ticks = 0;
+
+  for (;;) {
+    int64_t latenessUs = 0;
+    if (m_config.realTime) {
+      // Deadlines are computed from the start, never from the previous
+      // tick, so rounding and wakeup delays don't accumulate.
+      const int64_t offsetUs = int64_t(std::llround(double(index) * intervalUs));
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_wake.wait_until(lock, start + std::chrono::microseconds(offsetUs), [this] { return m_stopping; });
+      if (m_stopping) {
+        break;
+      }
+      const uint64_t due = dueTick(index, intervalUs, monotonicMicros() - startUs, latenessUs);
+      m_stats.skipped += due - index;
+      index = due;
+    } else {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_stopping) {
+        break;
+      }
+    }
+
+    m_task(index);
+    ++index;
+    ++ticks;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.ticks = ticks;
+    m_stats.elapsedUs = monotonicMicros() - startUs;
+    m_totalLatenessUs += double(latenessUs);
+    m_stats.meanLatenessUs = m_totalLatenessUs / double(ticks);
+    m_stats.maxLatenessUs = std::max(m_stats.maxLatenessUs, latenessUs);
+    if (m_config.tickLimit && ticks >= m_config.tickLimit) {
+      break;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_done = true;
+  m_wake.notify_all();
+}
+
+}
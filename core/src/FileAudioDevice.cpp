@@ -0,0 +1,174 @@
+//
+//  FileAudioDevice.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FileAudioDevice.h"
+
+#include <algorithm>
+
+namespace tivonage {
+
+static DeadlinePacer::Config pacerConfig(const FileAudioDevice::Config &config)
+{
+  DeadlinePacer::Config pacer;
+  pacer.intervalUs = double(config.chunkMs) * 1000.0;
+  pacer.realTime = config.realTime;
+  pacer.tickLimit = config.chunkLimit;
+  return pacer;
+}
+
+std::unique_ptr<FileAudioDevice> FileAudioDevice::create(const Config &config, AudioBridge::CaptureSink capture, AudioBridge::RenderSource render)
+{
+  // The device's thread is the bridge's pump.
+  AudioBridge::Config bridgeConfig;
+  bridgeConfig.sampleRate = config.sampleRate;
+  bridgeConfig.chunkMs = config.chunkMs;
+  bridgeConfig.renderLatencyMs = config.renderLatencyMs;
+  bridgeConfig.pumpThread = false;
+  std::unique_ptr<AudioBridge> bridge = AudioBridge::create(bridgeConfig, std::move(capture), std::move(render));
+  if (!bridge) {
+    return nullptr;
+  }
+
+  std::unique_ptr<WavReader> reader;
+  std::unique_ptr<Resampler> resampler;
+  if (!config.capturePath.empty()) {
+    reader = WavReader::open(config.capturePath);
+    if (!reader) {
+      return nullptr;
+    }
+    if (reader->sampleRate() != config.sampleRate) {
+      resampler = Resampler::create(reader->sampleRate(), config.sampleRate);
+      if (!resampler) {
+        return nullptr;
+      }
+    }
+  }
+
+  std::unique_ptr<WavWriter> writer;
+  if (!config.renderPath.empty()) {
+    writer = WavWriter::create(config.renderPath, config.sampleRate, 1);
+    if (!writer) {
+      return nullptr;
+    }
+  }
+  return std::unique_ptr<FileAudioDevice>(new FileAudioDevice(config, std::move(bridge), std::move(reader), std::move(resampler), std::move(writer)));
+}
+
+FileAudioDevice::FileAudioDevice(const Config &config, std::unique_ptr<AudioBridge> bridge, std::unique_ptr<WavReader> reader,
+    std::unique_ptr<Resampler> resampler, std::unique_ptr<WavWriter> writer)
+    : m_config(config)
+    , m_bridge(std::move(bridge))
+    , m_reader(std::move(reader))
+    , m_resampler(std::move(resampler))
+    , m_writer(std::move(writer))
+    , m_renderChunk(m_bridge->chunkSamples())
+    , m_pacer(pacerConfig(config), [this](uint64_t) { processChunk(); })
+{
+  // A chunk of the file covers chunkMs at the file's own rate.
+  const int fileRate = m_reader ? m_reader->sampleRate() : config.sampleRate;
+  m_fileChunk.resize(std::max<size_t>(size_t(int64_t(fileRate) * config.chunkMs / 1000), 1));
+  if (m_resampler) {
+    m_captureChunk.resize(m_resampler->maxOutput(m_fileChunk.size()));
+  }
+}
+
+FileAudioDevice::~FileAudioDevice()
+{
+  stop();
+  closeRenderFile();
+}
+
+bool FileAudioDevice::flushRenderFile()
+{
+  std::lock_guard<std::mutex> lock(m_writerMutex);
+  return !m_writer || m_writer->flush();
+}
+
+bool FileAudioDevice::closeRenderFile()
+{
+  std::lock_guard<std::mutex> lock(m_writerMutex);
+  if (!m_writer) {
+    return true;
+  }
+  bool closed = m_writer->close();
+  m_writer.reset();
+  return closed;
+}
+
+bool FileAudioDevice::start()
+{
+  return m_pacer.start();
+}
+
+void FileAudioDevice::stop()
+{
+  m_pacer.stop();
+}
+
+void FileAudioDevice::wait()
+{
+  m_pacer.wait();
+}
+
+FileAudioDevice::Stats FileAudioDevice::stats() const
+{
+  DeadlinePacer::Stats pacer = m_pacer.stats();
+  Stats stats;
+  stats.chunks = pacer.ticks;
+  stats.skipped = pacer.skipped;
+  stats.meanLatenessUs = pacer.meanLatenessUs;
+  stats.maxLatenessUs = pacer.maxLatenessUs;
+  stats.elapsedUs = pacer.elapsedUs;
+  stats.capturedFrames = m_capturedFrames.load(std::memory_order_relaxed);
+  stats.renderedSamples = m_renderedSamples.load(std::memory_order_relaxed);
+  stats.bridge = m_bridge->stats();
+  return stats;
+}
+
+void FileAudioDevice::readCapture()
+{
+  size_t filled = 0;
+  if (m_reader) {
+    while (filled < m_fileChunk.size()) {
+      size_t read = m_reader->readMono(m_position, m_fileChunk.data() + filled, m_fileChunk.size() - filled);
+      m_position += read;
+      filled += read;
+      if (read == 0) {
+        if (!m_config.loop || m_position == 0) {
+          break;
+        }
+        m_position = 0;
+      }
+    }
+  }
+  std::fill(m_fileChunk.begin() + std::ptrdiff_t(filled), m_fileChunk.end(), int16_t(0));
+  m_capturedFrames.fetch_add(filled, std::memory_order_relaxed);
+}
+
+void FileAudioDevice::processChunk()
+{
+  if (m_bridge->isCapturing()) {
+    readCapture();
+    if (m_resampler) {
+      size_t count = m_resampler->process(m_fileChunk.data(), m_fileChunk.size(), m_captureChunk.data());
+      m_bridge->writeCapture(m_captureChunk.data(), count);
+    } else {
+      m_bridge->writeCapture(m_fileChunk.data(), m_fileChunk.size());
+    }
+  }
+
+  m_bridge->pump();
+
+  if (m_bridge->isRendering()) {
+    m_bridge->readRender(m_renderChunk.data(), m_renderChunk.size());
+    m_renderedSamples.fetch_add(m_renderChunk.size(), std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(m_writerMutex);
+    if (m_writer) {
+      m_writer->write(m_renderChunk.data(), m_renderChunk.size());
+    }
+  }
+}
+
+}
@@ -0,0 +1,72 @@
+//
+//  FilterRows.h
+//  ti.vonage
+//
+//  Kernels for FIR filtering 16-bit PCM. Every implementation must produce
+//  exactly the scalar result, so converted audio does not depend on the CPU.
+//
+
+#pragma once
+
+#include "tivonage/Simd.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tivonage {
+
+// A polyphase filter: phases sets of tapsPerPhase taps, oldest sample's tap
+// first. Each output moves the window on by step samples and stepPhase
+// phases, carrying into the next sample when the phase wraps.
+struct FilterBank {
+  const int16_t *taps;
+  // A multiple of 16, so kernels need no tail.
+  int tapsPerPhase;
+  int phases;
+  size_t step;
+  int stepPhase;
+  // Taps are fixed point with this many fraction bits.
+  int shift;
+};
+
+struct FilterRowKernels {
+  // Filters one block: while position < end, writes the output whose window
+  // is samples[position, position + tapsPerPhase) under the taps of phase,
+  // as the 32-bit dot product rounded by shift and clamped to int16, then
+  // advances position and phase. Returns the number of outputs written.
+  // Callers keep the sums in range by bounding the taps (see Resampler.cpp).
+  size_t (*filterBlock)(const int16_t *samples, size_t end, const FilterBank &bank, size_t &position, int &phase, int16_t *output);
+};
+
+// Collects the windows and taps of up to count next outputs that start
+// before end, advancing position and phase past them. The SIMD kernels
+// filter outputs in groups from it so one reduction serves several.
+inline int nextOutputs(const FilterBank &bank, const int16_t *samples, size_t end, size_t &position, int &phase,
+    const int16_t **windows, const int16_t **taps, int count)
+{
+  int collected = 0;
+  for (; collected < count && position < end; ++collected) {
+    windows[collected] = samples + position;
+    taps[collected] = bank.taps + size_t(phase) * size_t(bank.tapsPerPhase);
+    position += bank.step;
+    phase += bank.stepPhase;
+    if (phase >= bank.phases) {
+      phase -= bank.phases;
+      ++position;
+    }
+  }
+  return collected;
+}
+
+const FilterRowKernels &scalarFilterRowKernels();
+#if defined(__x86_64__) || defined(__i386__)
+const FilterRowKernels &sse2FilterRowKernels();
+const FilterRowKernels &avx2FilterRowKernels();
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+const FilterRowKernels &neonFilterRowKernels();
+#endif
+
+const FilterRowKernels &filterRowKernels(SimdLevel level);
+
+}
@@ -0,0 +1,60 @@
+//
+//  FilterRowsAVX2.cpp
+//  ti.vonage
+//
+
+#include "FilterRows.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#define TIVONAGE_AVX2 __attribute__((target("avx2")))
+
+namespace tivonage {
+
+TIVONAGE_AVX2 static size_t filterBlockAVX2(const int16_t *samples, size_t end, const FilterBank &bank, size_t &position, int &phase, int16_t *output)
+{
+  const __m128i rounding = _mm_set1_epi32(1 << (bank.shift - 1));
+  const __m128i bits = _mm_cvtsi32_si128(bank.shift);
+  size_t written = 0;
+  const int16_t *windows[4];
+  const int16_t *taps[4];
+  while (int count = nextOutputs(bank, samples, end, position, phase, windows, taps, 4)) {
+    for (int lane = count; lane < 4; ++lane) {
+      windows[lane] = windows[0];
+      taps[lane] = taps[0];
+    }
+    __m256i sums[4] = { _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256() };
+    for (int i = 0; i < bank.tapsPerPhase; i += 16) {
+      for (int lane = 0; lane < 4; ++lane) {
+        const __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(windows[lane] + i));
+        const __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(taps[lane] + i));
+        sums[lane] = _mm256_add_epi32(sums[lane], _mm256_madd_epi16(left, right));
+      }
+    }
+    // Two rounds of hadd leave each 128-bit half holding partial sums of the
+    // four outputs in order; adding the halves finishes them.
+    const __m256i pairs = _mm256_hadd_epi32(_mm256_hadd_epi32(sums[0], sums[1]), _mm256_hadd_epi32(sums[2], sums[3]));
+    __m128i values = _mm_add_epi32(_mm256_castsi256_si128(pairs), _mm256_extracti128_si256(pairs, 1));
+    values = _mm_sra_epi32(_mm_add_epi32(values, rounding), bits);
+    int16_t results[8];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(results), _mm_packs_epi32(values, values));
+    for (int lane = 0; lane < count; ++lane) {
+      output[written++] = results[lane];
+    }
+  }
+  return written;
+}
+
+const FilterRowKernels &avx2FilterRowKernels()
+{
+  static const FilterRowKernels kernels = {
+    filterBlockAVX2,
+  };
+  return kernels;
+}
+
+}
+
+#endif
@@ -0,0 +1,59 @@
+//
+//  FilterRowsNEON.cpp
+//  ti.vonage
+//
+
+#include "FilterRows.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+namespace tivonage {
+
+static size_t filterBlockNEON(const int16_t *samples, size_t end, const FilterBank &bank, size_t &position, int &phase, int16_t *output)
+{
+  const int32x4_t bits = vdupq_n_s32(-bank.shift);
+  size_t written = 0;
+  const int16_t *windows[4];
+  const int16_t *taps[4];
+  while (int count = nextOutputs(bank, samples, end, position, phase, windows, taps, 4)) {
+    for (int lane = count; lane < 4; ++lane) {
+      windows[lane] = windows[0];
+      taps[lane] = taps[0];
+    }
+    int32x4_t sums[4] = { vdupq_n_s32(0), vdupq_n_s32(0), vdupq_n_s32(0), vdupq_n_s32(0) };
+    for (int i = 0; i < bank.tapsPerPhase; i += 8) {
+      for (int lane = 0; lane < 4; ++lane) {
+        const int16x8_t left = vld1q_s16(windows[lane] + i);
+        const int16x8_t right = vld1q_s16(taps[lane] + i);
+        sums[lane] = vmlal_s16(sums[lane], vget_low_s16(left), vget_low_s16(right));
+        sums[lane] = vmlal_s16(sums[lane], vget_high_s16(left), vget_high_s16(right));
+      }
+    }
+    int32x2_t halves[4];
+    for (int lane = 0; lane < 4; ++lane) {
+      halves[lane] = vadd_s32(vget_low_s32(sums[lane]), vget_high_s32(sums[lane]));
+    }
+    // A rounding shift right, then a saturating narrow for the clamp.
+    const int32x4_t values = vrshlq_s32(vcombine_s32(vpadd_s32(halves[0], halves[1]), vpadd_s32(halves[2], halves[3])), bits);
+    int16_t results[4];
+    vst1_s16(results, vqmovn_s32(values));
+    for (int lane = 0; lane < count; ++lane) {
+      output[written++] = results[lane];
+    }
+  }
+  return written;
+}
+
+const FilterRowKernels &neonFilterRowKernels()
+{
+  static const FilterRowKernels kernels = {
+    filterBlockNEON,
+  };
+  return kernels;
+}
+
+}
+
+#endif
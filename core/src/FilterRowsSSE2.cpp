@@ -0,0 +1,61 @@
+//
+//  FilterRowsSSE2.cpp
+//  ti.vonage
+//
+
+#include "FilterRows.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <emmintrin.h>
+
+namespace tivonage {
+
+// pmaddwd multiplies eight pairs and adds neighbours into four 32-bit sums.
+// Four outputs are filtered at once and their sums transposed together, so
+// the horizontal reduction costs one shuffle tree per four outputs.
+static size_t filterBlockSSE2(const int16_t *samples, size_t end, const FilterBank &bank, size_t &position, int &phase, int16_t *output)
+{
+  const __m128i rounding = _mm_set1_epi32(1 << (bank.shift - 1));
+  const __m128i bits = _mm_cvtsi32_si128(bank.shift);
+  size_t written = 0;
+  const int16_t *windows[4];
+  const int16_t *taps[4];
+  while (int count = nextOutputs(bank, samples, end, position, phase, windows, taps, 4)) {
+    for (int lane = count; lane < 4; ++lane) {
+      windows[lane] = windows[0];
+      taps[lane] = taps[0];
+    }
+    __m128i sums[4] = { _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128() };
+    for (int i = 0; i < bank.tapsPerPhase; i += 8) {
+      for (int lane = 0; lane < 4; ++lane) {
+        const __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i *>(windows[lane] + i));
+        const __m128i right = _mm_loadu_si128(reinterpret_cast<const __m128i *>(taps[lane] + i));
+        sums[lane] = _mm_add_epi32(sums[lane], _mm_madd_epi16(left, right));
+      }
+    }
+    const __m128i low = _mm_add_epi32(_mm_unpacklo_epi32(sums[0], sums[1]), _mm_unpackhi_epi32(sums[0], sums[1]));
+    const __m128i high = _mm_add_epi32(_mm_unpacklo_epi32(sums[2], sums[3]), _mm_unpackhi_epi32(sums[2], sums[3]));
+    __m128i values = _mm_add_epi32(_mm_unpacklo_epi64(low, high), _mm_unpackhi_epi64(low, high));
+    // The signed pack saturates, which is the clamp to int16.
+    values = _mm_sra_epi32(_mm_add_epi32(values, rounding), bits);
+    int16_t results[8];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(results), _mm_packs_epi32(values, values));
+    for (int lane = 0; lane < count; ++lane) {
+      output[written++] = results[lane];
+    }
+  }
+  return written;
+}
+
+const FilterRowKernels &sse2FilterRowKernels()
+{
+  static const FilterRowKernels kernels = {
+    filterBlockSSE2,
+  };
+  return kernels;
+}
+
+}
+
+#endif
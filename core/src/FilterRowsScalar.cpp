@@ -0,0 +1,56 @@
+//
+//  FilterRowsScalar.cpp
+//  ti.vonage
+//
+
+#include "FilterRows.h"
+
+#include <algorithm>
+
+namespace tivonage {
+
+static size_t filterBlockScalar(const int16_t *samples, size_t end, const FilterBank &bank, size_t &position, int &phase, int16_t *output)
+{
+  const int tapsPerPhase = bank.tapsPerPhase;
+  const int shift = bank.shift;
+  size_t written = 0;
+  const int16_t *window;
+  const int16_t *taps;
+  while (nextOutputs(bank, samples, end, position, phase, &window, &taps, 1)) {
+    int32_t sum = 0;
+    for (int i = 0; i < tapsPerPhase; ++i) {
+      sum += int32_t(window[i]) * taps[i];
+    }
+    const int32_t value = (sum + (1 << (shift - 1))) >> shift;
+    output[written++] = int16_t(std::clamp(value, int32_t(INT16_MIN), int32_t(INT16_MAX)));
+  }
+  return written;
+}
+
+const FilterRowKernels &scalarFilterRowKernels()
+{
+  static const FilterRowKernels kernels = {
+    filterBlockScalar,
+  };
+  return kernels;
+}
+
+const FilterRowKernels &filterRowKernels(SimdLevel level)
+{
+  switch (level) {
+#if defined(__x86_64__) || defined(__i386__)
+  case SimdLevel::SSE2:
+    return sse2FilterRowKernels();
+  case SimdLevel::AVX2:
+    return avx2FilterRowKernels();
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  case SimdLevel::NEON:
+    return neonFilterRowKernels();
+#endif
+  default:
+    return scalarFilterRowKernels();
+  }
+}
+
+}
@@ -0,0 +1,55 @@
+//
+//  FrameBuffer.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+
+#include "tivonage/Memory.h"
+
+namespace tivonage {
+
+std::unique_ptr<FrameBuffer> FrameBuffer::create(PixelFormat format, int width, int height)
+{
+  if (width <= 0 || height <= 0) {
+    return nullptr;
+  }
+
+  VideoFrame frame;
+  frame.format = format;
+  frame.width = width;
+  frame.height = height;
+
+  size_t offsets[3] = { 0, 0, 0 };
+  size_t byteSize = 0;
+  for (int plane = 0; plane < planeCount(format); ++plane) {
+    size_t stride = alignUp(size_t(planeRowBytes(format, plane, width)), kSimdAlignment);
+    frame.planes[plane].stride = int(stride);
+    offsets[plane] = byteSize;
+    byteSize += stride * size_t(planeRows(format, plane, height));
+  }
+
+  uint8_t *storage = static_cast<uint8_t *>(alignedAlloc(byteSize));
+  if (!storage) {
+    return nullptr;
+  }
+  for (int plane = 0; plane < planeCount(format); ++plane) {
+    frame.planes[plane].data = storage + offsets[plane];
+  }
+
+  return std::unique_ptr<FrameBuffer>(new FrameBuffer(storage, byteSize, frame));
+}
+
+FrameBuffer::FrameBuffer(uint8_t *storage, size_t byteSize, const VideoFrame &frame)
+    : m_storage(storage)
+    , m_byteSize(byteSize)
+    , m_frame(frame)
+{
+}
+
+FrameBuffer::~FrameBuffer()
+{
+  alignedFree(m_storage);
+}
+
+}
@@ -0,0 +1,51 @@
+//
+//  FrameMailbox.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameMailbox.h"
+
+#include <utility>
+
+namespace tivonage {
+
+bool FrameMailbox::publish(FrameHandle frame)
+{
+  m_slots[m_back].frame = std::move(frame);
+  uint32_t previous = m_middle.exchange(m_back | kFresh, std::memory_order_acq_rel);
+  m_back = previous & kIndexMask;
+  m_published.fetch_add(1, std::memory_order_relaxed);
+
+  // The slot we got back either held a frame the consumer never saw, or was
+  // emptied by take(). Releasing it here returns the buffer to its pool now
+  // rather than on the next publish().
+  m_slots[m_back].frame.reset();
+  if (previous & kFresh) {
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+bool FrameMailbox::take(FrameHandle &frame)
+{
+  if (!(m_middle.load(std::memory_order_relaxed) & kFresh)) {
+    return false;
+  }
+  uint32_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+  m_front = previous & kIndexMask;
+  frame = std::move(m_slots[m_front].frame);
+  m_taken.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+FrameMailbox::Counters FrameMailbox::counters() const
+{
+  Counters counters;
+  counters.published = m_published.load(std::memory_order_relaxed);
+  counters.taken = m_taken.load(std::memory_order_relaxed);
+  counters.dropped = m_dropped.load(std::memory_order_relaxed);
+  return counters;
+}
+
+}
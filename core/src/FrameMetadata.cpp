@@ -0,0 +1,64 @@
+//
+//  FrameMetadata.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameMetadata.h"
+
+#include <cstring>
+
+namespace tivonage {
+
+static const uint8_t kMagic[2] = { 'T', 'V' };
+static const uint8_t kVersion = 1;
+static const size_t kHeaderSize = 16;
+
+static void storeLittleEndian(uint8_t *data, uint64_t value, int bytes)
+{
+  for (int i = 0; i < bytes; ++i) {
+    data[i] = uint8_t(value >> (8 * i));
+  }
+}
+
+static uint64_t loadLittleEndian(const uint8_t *data, int bytes)
+{
+  uint64_t value = 0;
+  for (int i = 0; i < bytes; ++i) {
+    value |= uint64_t(data[i]) << (8 * i);
+  }
+  return value;
+}
+
+size_t encodeFrameMetadata(const FrameMetadata &metadata, uint8_t *data, size_t capacity)
+{
+  size_t size = kHeaderSize + metadata.payloadSize;
+  if (metadata.payloadSize > FrameMetadata::kMaxPayloadSize || capacity < size) {
+    return 0;
+  }
+  data[0] = kMagic[0];
+  data[1] = kMagic[1];
+  data[2] = kVersion;
+  data[3] = metadata.payloadSize;
+  storeLittleEndian(data + 4, metadata.sequence, 4);
+  storeLittleEndian(data + 8, uint64_t(metadata.captureTimeUs), 8);
+  memcpy(data + kHeaderSize, metadata.payload, metadata.payloadSize);
+  return size;
+}
+
+bool decodeFrameMetadata(const uint8_t *data, size_t size, FrameMetadata &metadata)
+{
+  if (size < kHeaderSize || data[0] != kMagic[0] || data[1] != kMagic[1] || data[2] != kVersion) {
+    return false;
+  }
+  uint8_t payloadSize = data[3];
+  if (payloadSize > FrameMetadata::kMaxPayloadSize || size < kHeaderSize + payloadSize) {
+    return false;
+  }
+  metadata.sequence = uint32_t(loadLittleEndian(data + 4, 4));
+  metadata.captureTimeUs = int64_t(loadLittleEndian(data + 8, 8));
+  metadata.payloadSize = payloadSize;
+  memcpy(metadata.payload, data + kHeaderSize, payloadSize);
+  return true;
+}
+
+}
@@ -0,0 +1,93 @@
+//
+//  FramePipeline.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FramePipeline.h"
+
+#include "tivonage/Clock.h"
+
+namespace tivonage {
+
+// Weight of the newest measurement in a stage's average cost: reacts within
+// a few frames to the device slowing down without flapping on one outlier.
+static const double kCostSmoothing = 0.2;
+
+FramePipeline::FramePipeline(int64_t budgetUs)
+    : m_budgetUs(budgetUs)
+{
+}
+
+void FramePipeline::addStage(std::unique_ptr<FrameStage> stage)
+{
+  if (stage) {
+    Entry entry;
+    entry.stage = std::move(stage);
+    m_stages.push_back(std::move(entry));
+  }
+}
+
+void FramePipeline::clear()
+{
+  m_stages.clear();
+}
+
+bool FramePipeline::run(VideoFrame &frame)
+{
+  ++m_frames;
+  const int64_t startUs = monotonicMicros();
+  int64_t nowUs = startUs;
+  bool kept = true;
+  for (Entry &entry : m_stages) {
+    // A stage's first run pays for its allocations and cold caches, so its
+    // cost only counts from the second run on; until then it runs as long as
+    // any budget is left. A stage skipped for kProbeFrames runs once more
+    // (if any budget is left) to find out whether it fits again.
+    if (m_budgetUs > 0 && entry.stage->skippable()) {
+      const double elapsedUs = double(nowUs - startUs);
+      const bool probing = entry.runs < 2 || entry.skipStreak >= kProbeFrames;
+      if (elapsedUs >= double(m_budgetUs) || (!probing && elapsedUs + entry.averageUs > double(m_budgetUs))) {
+        ++entry.skips;
+        ++entry.skipStreak;
+        continue;
+      }
+    }
+    kept = entry.stage->process(frame);
+    const int64_t endUs = monotonicMicros();
+    const double costUs = double(endUs - nowUs);
+    // The second run's cost replaces the cold first one, and a probe's an
+    // average that went stale while the stage was skipped.
+    if (entry.runs < 2 || entry.skipStreak >= kProbeFrames) {
+      entry.averageUs = costUs;
+    } else {
+      entry.averageUs += kCostSmoothing * (costUs - entry.averageUs);
+    }
+    ++entry.runs;
+    entry.skipStreak = 0;
+    nowUs = endUs;
+    if (!kept) {
+      break;
+    }
+  }
+  if (m_budgetUs > 0 && nowUs - startUs > m_budgetUs) {
+    ++m_overBudgetFrames;
+  }
+  return kept;
+}
+
+std::vector<FramePipeline::StageStats> FramePipeline::stageStats() const
+{
+  std::vector<StageStats> stats;
+  stats.reserve(m_stages.size());
+  for (const Entry &entry : m_stages) {
+    StageStats stage;
+    stage.name = entry.stage->name();
+    stage.runs = entry.runs;
+    stage.skips = entry.skips;
+    stage.averageUs = entry.averageUs;
+    stats.push_back(std::move(stage));
+  }
+  return stats;
+}
+
+}
@@ -0,0 +1,152 @@
+//
+//  FramePool.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FramePool.h"
+
+#include <algorithm>
+
+namespace tivonage {
+
+FrameHandle::FrameHandle(const FrameHandle &other)
+    : m_slot(other.m_slot)
+{
+  if (m_slot) {
+    m_slot->references.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+FrameHandle::FrameHandle(FrameHandle &&other) noexcept
+    : m_slot(other.m_slot)
+{
+  other.m_slot = nullptr;
+}
+
+FrameHandle &FrameHandle::operator=(const FrameHandle &other)
+{
+  if (this != &other) {
+    FrameHandle copy(other);
+    std::swap(m_slot, copy.m_slot);
+  }
+  return *this;
+}
+
+FrameHandle &FrameHandle::operator=(FrameHandle &&other) noexcept
+{
+  if (this != &other) {
+    reset();
+    m_slot = other.m_slot;
+    other.m_slot = nullptr;
+  }
+  return *this;
+}
+
+FrameHandle::~FrameHandle()
+{
+  reset();
+}
+
+void FrameHandle::reset()
+{
+  Slot *slot = m_slot;
+  m_slot = nullptr;
+  if (slot && slot->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    // The pool may only be kept alive by this lease; recycle() drops the
+    // slot's reference to it after the slot is back on the idle list.
+    std::shared_ptr<FramePool> pool = slot->pool;
+    pool->recycle(slot);
+  }
+}
+
+void *FrameHandle::detach()
+{
+  Slot *slot = m_slot;
+  m_slot = nullptr;
+  return slot;
+}
+
+FrameHandle FrameHandle::adopt(void *opaque)
+{
+  return FrameHandle(static_cast<Slot *>(opaque));
+}
+
+std::shared_ptr<FramePool> FramePool::create(size_t capacity)
+{
+  if (capacity == 0) {
+    return nullptr;
+  }
+  return std::shared_ptr<FramePool>(new FramePool(capacity));
+}
+
+FramePool::FramePool(size_t capacity)
+    : m_capacity(capacity)
+{
+  m_slots.reserve(capacity);
+  m_idle.reserve(capacity);
+}
+
+FramePool::~FramePool() = default;
+
+FrameHandle FramePool::acquire(PixelFormat format, int width, int height)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_counters.acquired;
+
+  auto matches = [&](FrameHandle::Slot *slot) {
+    const FrameBuffer &buffer = *slot->buffer;
+    return buffer.format() == format && buffer.width() == width && buffer.height() == height;
+  };
+
+  FrameHandle::Slot *slot = nullptr;
+  auto idle = std::find_if(m_idle.begin(), m_idle.end(), matches);
+  if (idle != m_idle.end()) {
+    slot = *idle;
+    m_idle.erase(idle);
+    ++m_counters.reused;
+  } else if (m_slots.size() < m_capacity || !m_idle.empty()) {
+    auto buffer = FrameBuffer::create(format, width, height);
+    if (!buffer) {
+      ++m_counters.exhausted;
+      return FrameHandle();
+    }
+    if (m_slots.size() < m_capacity) {
+      m_slots.push_back(std::make_unique<FrameHandle::Slot>());
+      slot = m_slots.back().get();
+    } else {
+      // Geometry changed: repurpose the longest idle slot.
+      slot = m_idle.front();
+      m_idle.erase(m_idle.begin());
+    }
+    slot->buffer = std::move(buffer);
+    ++m_counters.allocated;
+  } else {
+    ++m_counters.exhausted;
+    return FrameHandle();
+  }
+
+  slot->pool = shared_from_this();
+  slot->references.store(1, std::memory_order_relaxed);
+  return FrameHandle(slot);
+}
+
+void FramePool::recycle(FrameHandle::Slot *slot)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_idle.push_back(slot);
+  slot->pool.reset();
+}
+
+size_t FramePool::inFlight() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_slots.size() - m_idle.size();
+}
+
+FramePool::Counters FramePool::counters() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_counters;
+}
+
+}
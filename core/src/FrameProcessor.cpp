@@ -0,0 +1,148 @@
+//
+//  FrameProcessor.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameProcessor.h"
+
+#include "tivonage/PixelConvert.h"
+
+namespace tivonage {
+
+std::unique_ptr<FrameProcessor> FrameProcessor::create(Output output)
+{
+  return create(std::move(output), Config());
+}
+
+std::unique_ptr<FrameProcessor> FrameProcessor::create(Output output, const Config &config)
+{
+  // The mailbox holds up to three frames and the capture thread fills one.
+  if (!output || config.poolFrames < 4) {
+    return nullptr;
+  }
+  return std::unique_ptr<FrameProcessor>(new FrameProcessor(std::move(output), config));
+}
+
+FrameProcessor::FrameProcessor(Output output, const Config &config)
+    : m_output(std::move(output))
+    , m_pool(FramePool::create(config.poolFrames))
+    , m_pipeline(config.budgetUs)
+{
+  m_thread = std::thread([this] { run(); });
+}
+
+FrameProcessor::~FrameProcessor()
+{
+  stop();
+}
+
+bool FrameProcessor::submit(const VideoFrame &frame)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    if (m_stopping) {
+      return false;
+    }
+  }
+  m_submitted.fetch_add(1, std::memory_order_relaxed);
+  FrameHandle handle = m_pool->acquire(frame.format, frame.width, frame.height);
+  if (!handle || !convertFrame(frame, handle.frame())) {
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  handle.frame().orientation = frame.orientation;
+  handle.frame().timestampUs = frame.timestampUs;
+  if (!m_mailbox.publish(std::move(handle))) {
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+  // The worker checks the mailbox under the lock before it sleeps; passing
+  // through the lock orders the publish before that check, so the wakeup
+  // can't be lost.
+  {
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+  }
+  m_wake.notify_one();
+  return true;
+}
+
+void FrameProcessor::setStages(std::vector<std::unique_ptr<FrameStage>> stages)
+{
+  std::lock_guard<std::mutex> lock(m_pipelineMutex);
+  m_pipeline.clear();
+  for (auto &stage : stages) {
+    m_pipeline.addStage(std::move(stage));
+  }
+}
+
+void FrameProcessor::setBudgetUs(int64_t budgetUs)
+{
+  std::lock_guard<std::mutex> lock(m_pipelineMutex);
+  m_pipeline.setBudgetUs(budgetUs);
+}
+
+std::vector<FramePipeline::StageStats> FrameProcessor::stageStats() const
+{
+  std::lock_guard<std::mutex> lock(m_pipelineMutex);
+  return m_pipeline.stageStats();
+}
+
+FrameProcessor::Counters FrameProcessor::counters() const
+{
+  Counters counters;
+  counters.submitted = m_submitted.load(std::memory_order_relaxed);
+  counters.processed = m_processed.load(std::memory_order_relaxed);
+  counters.dropped = m_dropped.load(std::memory_order_relaxed);
+  counters.rejected = m_rejected.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(m_pipelineMutex);
+  counters.overBudget = m_pipeline.overBudgetFrames();
+  return counters;
+}
+
+void FrameProcessor::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    m_stopping = true;
+  }
+  m_wake.notify_one();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+void FrameProcessor::run()
+{
+  for (;;) {
+    FrameHandle handle;
+    {
+      std::unique_lock<std::mutex> lock(m_wakeMutex);
+      m_wake.wait(lock, [this] { return m_stopping || m_mailbox.hasFrame(); });
+      if (m_stopping) {
+        break;
+      }
+    }
+    if (!m_mailbox.take(handle)) {
+      continue;
+    }
+
+    // The stages may point the frame at their own storage, so the output
+    // runs before setStages() can free it; the handle keeps the pooled
+    // buffer leased until then.
+    VideoFrame frame = handle.frame();
+    bool kept;
+    {
+      std::lock_guard<std::mutex> lock(m_pipelineMutex);
+      kept = m_pipeline.run(frame);
+      if (kept) {
+        m_output(frame);
+      }
+    }
+    if (kept) {
+      m_processed.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      m_rejected.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+}
@@ -0,0 +1,368 @@
+//
+//  FrameScaler.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameScaler.h"
+
+#include "ConvertRows.h"
+#include "ScaleRows.h"
+#include "tivonage/PixelConvert.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace tivonage {
+
+// Output rows per strip when rotating; one 8x8 transpose block high.
+static const int kStripRows = 8;
+
+Rotation uprightRotation(VideoOrientation orientation)
+{
+  switch (orientation) {
+  case VideoOrientation::Up:
+    return Rotation::None;
+  case VideoOrientation::Down:
+    return Rotation::Clockwise180;
+  case VideoOrientation::Left:
+    return Rotation::Clockwise90;
+  case VideoOrientation::Right:
+    return Rotation::Clockwise270;
+  }
+  return Rotation::None;
+}
+
+void scaledSizeToFill(int sourceWidth, int sourceHeight, int boundsWidth, int boundsHeight, int &width, int &height)
+{
+  width = sourceWidth;
+  height = sourceHeight;
+  if (sourceWidth <= 0 || sourceHeight <= 0 || boundsWidth <= 0 || boundsHeight <= 0) {
+    return;
+  }
+
+  // Aspect fill: the larger of the two ratios wins, and we never upscale.
+  double scale = std::max(double(boundsWidth) / sourceWidth, double(boundsHeight) / sourceHeight);
+  if (scale >= 1.0) {
+    return;
+  }
+  width = std::max(2, (int(sourceWidth * scale + 1.0)) & ~1);
+  height = std::max(2, (int(sourceHeight * scale + 1.0)) & ~1);
+  width = std::min(width, sourceWidth);
+  height = std::min(height, sourceHeight);
+}
+
+FrameScaler::FrameScaler(ScaleFilter filter)
+    : m_filter(filter)
+{
+}
+
+bool FrameScaler::scale(const VideoFrame &source, VideoFrame &destination, Rotation rotation)
+{
+  if (source.width <= 0 || source.height <= 0 || destination.width <= 0 || destination.height <= 0) {
+    return false;
+  }
+  bool sameFormat = source.format == destination.format;
+  bool interleave = source.format == PixelFormat::I420 && destination.format == PixelFormat::NV12;
+  if (!sameFormat && !interleave) {
+    return false;
+  }
+  if (rotation == Rotation::None && source.width == destination.width && source.height == destination.height) {
+    return convertFrame(source, destination);
+  }
+
+  const VideoPlane *from = source.planes;
+  VideoPlane *to = destination.planes;
+  const int chromaWidth = (source.width + 1) / 2;
+  const int chromaHeight = (source.height + 1) / 2;
+  const int width = (destination.width + 1) / 2;
+  const int height = (destination.height + 1) / 2;
+
+  switch (source.format) {
+  case PixelFormat::ARGB:
+    scalePlane(from[0].data, from[0].stride, source.width, source.height, to[0].data, to[0].stride, destination.width, destination.height, 4, rotation);
+    break;
+  case PixelFormat::NV12:
+    scalePlane(from[0].data, from[0].stride, source.width, source.height, to[0].data, to[0].stride, destination.width, destination.height, 1, rotation);
+    scalePlane(from[1].data, from[1].stride, chromaWidth, chromaHeight, to[1].data, to[1].stride, width, height, 2, rotation);
+    break;
+  case PixelFormat::I420:
+    scalePlane(from[0].data, from[0].stride, source.width, source.height, to[0].data, to[0].stride, destination.width, destination.height, 1, rotation);
+    if (sameFormat) {
+      scalePlane(from[1].data, from[1].stride, chromaWidth, chromaHeight, to[1].data, to[1].stride, width, height, 1, rotation);
+      scalePlane(from[2].data, from[2].stride, chromaWidth, chromaHeight, to[2].data, to[2].stride, width, height, 1, rotation);
+      break;
+    }
+    // Scale U and V into small scratch planes, then interleave them into
+    // the NV12 destination; only output-sized data is touched twice.
+    m_chroma.resize(size_t(width) * size_t(height) * 2);
+    uint8_t *u = m_chroma.data();
+    uint8_t *v = u + size_t(width) * size_t(height);
+    scalePlane(from[1].data, from[1].stride, chromaWidth, chromaHeight, u, width, width, height, 1, rotation);
+    scalePlane(from[2].data, from[2].stride, chromaWidth, chromaHeight, v, width, width, height, 1, rotation);
+    const ConvertRowKernels &kernels = convertRowKernels(activeSimdLevel());
+    for (int y = 0; y < height; ++y) {
+      kernels.mergeUV(u + y * width, v + y * width, to[1].data + y * to[1].stride, width);
+    }
+    break;
+  }
+
+  destination.orientation = rotation == Rotation::None ? source.orientation : VideoOrientation::Up;
+  destination.timestampUs = source.timestampUs;
+  return true;
+}
+
+// Maps output coordinate i to a 16.16 source position, pixel centres aligned.
+static inline int64_t sourcePosition(int i, int sourceSize, int size)
+{
+  int64_t position = ((int64_t(2 * i + 1) * sourceSize << 16) / (2 * size) - (1 << 15));
+  return std::min(std::max(position, int64_t(0)), int64_t(sourceSize - 1) << 16);
+}
+
+void FrameScaler::scalePlane(const uint8_t *source, int sourceStride, int sourceWidth, int sourceHeight,
+    uint8_t *destination, int destinationStride, int width, int height, int channels, Rotation rotation)
+{
+  if (swapsDimensions(rotation)) {
+    std::swap(width, height);
+  }
+
+  // A box never shrinks below one source pixel, so enlarging falls back to
+  // bilinear filtering. The 16-bit column sums cap a box at 257 rows.
+  Mode mode = Mode::Bilinear;
+  if (width == sourceWidth && height == sourceHeight) {
+    mode = Mode::Copy;
+  } else if (m_filter == ScaleFilter::Box && width <= sourceWidth && height <= sourceHeight && sourceHeight / height < 257) {
+    mode = Mode::Box;
+  }
+
+  if (mode == Mode::Box) {
+    m_accumulator.resize(size_t(sourceWidth * channels));
+    m_columns.resize(size_t(width) + 1);
+    for (int x = 0; x <= width; ++x) {
+      m_columns[size_t(x)] = int(int64_t(x) * sourceWidth / width);
+    }
+  } else if (mode == Mode::Bilinear) {
+    m_row.resize(size_t(sourceWidth * channels));
+    m_columns.resize(size_t(width));
+    for (int x = 0; x < width; ++x) {
+      m_columns[size_t(x)] = int(sourcePosition(x, sourceWidth, width));
+    }
+  }
+
+  if (rotation == Rotation::None) {
+    if (mode == Mode::Copy) {
+      for (int y = 0; y < height; ++y) {
+        memcpy(destination + y * destinationStride, source + y * sourceStride, size_t(width * channels));
+      }
+    } else if (mode == Mode::Box) {
+      boxRows(source, sourceStride, sourceWidth, sourceHeight, width, height, channels, 0, height, destination, destinationStride);
+    } else {
+      bilinearRows(source, sourceStride, sourceWidth, sourceHeight, width, height, channels, 0, height, destination, destinationStride);
+    }
+    return;
+  }
+
+  const int stripStride = width * channels;
+  m_strip.resize(size_t(stripStride) * kStripRows);
+  for (int firstRow = 0; firstRow < height; firstRow += kStripRows) {
+    const int rowCount = std::min(kStripRows, height - firstRow);
+    if (mode == Mode::Copy) {
+      rotateStrip(source + firstRow * sourceStride, sourceStride, firstRow, rowCount, width, height, channels, rotation, destination, destinationStride);
+      continue;
+    }
+    if (mode == Mode::Box) {
+      boxRows(source, sourceStride, sourceWidth, sourceHeight, width, height, channels, firstRow, rowCount, m_strip.data(), stripStride);
+    } else {
+      bilinearRows(source, sourceStride, sourceWidth, sourceHeight, width, height, channels, firstRow, rowCount, m_strip.data(), stripStride);
+    }
+    rotateStrip(m_strip.data(), stripStride, firstRow, rowCount, width, height, channels, rotation, destination, destinationStride);
+  }
+}
+
+// Horizontal passes for the ratios the row kernels don't cover, specialised
+// per channel count so the inner loops unroll. They are shared by all SIMD
+// levels.
+template <int Channels>
+static void boxColumns(const uint16_t *sums, const int *columns, int narrowest, const uint64_t reciprocals[2], uint8_t *output, int width)
+{
+  for (int x = 0; x < width; ++x) {
+    const int left = columns[x];
+    const int right = columns[x + 1];
+    const uint64_t reciprocal = reciprocals[right - left - narrowest];
+    for (int channel = 0; channel < Channels; ++channel) {
+      uint32_t sum = 0;
+      for (int column = left; column < right; ++column) {
+        sum += sums[column * Channels + channel];
+      }
+      output[x * Channels + channel] = uint8_t((sum * reciprocal + (uint64_t(1) << 31)) >> 32);
+    }
+  }
+}
+
+template <int Channels>
+static void bilinearColumns(const uint8_t *row, const int *columns, int sourceWidth, uint8_t *output, int width)
+{
+  for (int x = 0; x < width; ++x) {
+    const int left = columns[x] >> 16;
+    const int right = std::min(left + 1, sourceWidth - 1);
+    const int weight = (columns[x] >> 8) & 0xFF;
+    for (int channel = 0; channel < Channels; ++channel) {
+      const int a = row[left * Channels + channel];
+      const int b = row[right * Channels + channel];
+      output[x * Channels + channel] = uint8_t((a * (256 - weight) + b * weight + 128) >> 8);
+    }
+  }
+}
+
+void FrameScaler::boxRows(const uint8_t *source, int sourceStride, int sourceWidth, int sourceHeight, int width, int height,
+    int channels, int firstRow, int rowCount, uint8_t *destination, ptrdiff_t destinationStride)
+{
+  const ScaleRowKernels &kernels = scaleRowKernels(activeSimdLevel());
+  const int rowBytes = sourceWidth * channels;
+  const int narrowest = sourceWidth / width;
+  // Boxes a power of two columns wide reduce with the halving kernels, as
+  // long as the whole box area stays a power of two that fits the 16-bit sums.
+  int halvings = 0;
+  while ((width << halvings) < sourceWidth) {
+    ++halvings;
+  }
+  const bool halvable = (width << halvings) == sourceWidth && (channels == 1 || channels == 2 || channels == 4);
+
+  for (int y = firstRow; y < firstRow + rowCount; ++y) {
+    const int top = int(int64_t(y) * sourceHeight / height);
+    const int bottom = int(int64_t(y + 1) * sourceHeight / height);
+    std::fill(m_accumulator.begin(), m_accumulator.end(), uint16_t(0));
+    for (int row = top; row < bottom; ++row) {
+      kernels.accumulateRow(source + row * sourceStride, m_accumulator.data(), rowBytes);
+    }
+
+    uint8_t *output = destination + (y - firstRow) * destinationStride;
+    const int area = (bottom - top) << halvings;
+    if (halvable && area <= 256 && (area & (area - 1)) == 0) {
+      for (int pass = 1; pass <= halvings; ++pass) {
+        kernels.halveColumns(m_accumulator.data(), m_accumulator.data(), sourceWidth >> pass, channels);
+      }
+      int shift = 0;
+      while ((1 << shift) < area) {
+        ++shift;
+      }
+      kernels.shiftRow(m_accumulator.data(), output, width * channels, shift);
+      continue;
+    }
+
+    // Box widths only take two values, so one reciprocal each replaces a
+    // division per sample.
+    const uint64_t boxArea = uint64_t(bottom - top) * uint64_t(narrowest);
+    const uint64_t reciprocals[2] = { ((uint64_t(1) << 32) + boxArea / 2) / boxArea,
+      ((uint64_t(1) << 32) + (boxArea + (bottom - top)) / 2) / (boxArea + (bottom - top)) };
+    switch (channels) {
+    case 1:
+      boxColumns<1>(m_accumulator.data(), m_columns.data(), narrowest, reciprocals, output, width);
+      break;
+    case 2:
+      boxColumns<2>(m_accumulator.data(), m_columns.data(), narrowest, reciprocals, output, width);
+      break;
+    default:
+      boxColumns<4>(m_accumulator.data(), m_columns.data(), narrowest, reciprocals, output, width);
+      break;
+    }
+  }
+}
+
+void FrameScaler::bilinearRows(const uint8_t *source, int sourceStride, int sourceWidth, int sourceHeight, int width, int height,
+    int channels, int firstRow, int rowCount, uint8_t *destination, ptrdiff_t destinationStride)
+{
+  const ScaleRowKernels &kernels = scaleRowKernels(activeSimdLevel());
+  const int rowBytes = sourceWidth * channels;
+
+  for (int y = firstRow; y < firstRow + rowCount; ++y) {
+    const int64_t position = sourcePosition(y, sourceHeight, height);
+    const int top = int(position >> 16);
+    const int bottom = std::min(top + 1, sourceHeight - 1);
+    const int fraction = int((position >> 8) & 0xFF);
+    const uint8_t *row = source + top * sourceStride;
+    if (fraction != 0 && bottom != top) {
+      kernels.interpolateRow(row, source + bottom * sourceStride, m_row.data(), rowBytes, fraction);
+      row = m_row.data();
+    }
+
+    uint8_t *output = destination + (y - firstRow) * destinationStride;
+    switch (channels) {
+    case 1:
+      bilinearColumns<1>(row, m_columns.data(), sourceWidth, output, width);
+      break;
+    case 2:
+      bilinearColumns<2>(row, m_columns.data(), sourceWidth, output, width);
+      break;
+    default:
+      bilinearColumns<4>(row, m_columns.data(), sourceWidth, output, width);
+      break;
+    }
+  }
+}
+
+// destination[i][j] = source[j][i] for a rows x columns block of samples;
+// the edges the 8x8 kernels don't cover.
+static void transposeBlock(const uint8_t *source, ptrdiff_t sourceStride, uint8_t *destination, ptrdiff_t destinationStride,
+    int rows, int columns, int channels)
+{
+  for (int i = 0; i < columns; ++i) {
+    for (int j = 0; j < rows; ++j) {
+      memcpy(destination + i * destinationStride + j * channels, source + j * sourceStride + i * channels, size_t(channels));
+    }
+  }
+}
+
+void FrameScaler::rotateStrip(const uint8_t *strip, ptrdiff_t stripStride, int firstRow, int rowCount, int width, int height,
+    int channels, Rotation rotation, uint8_t *destination, int destinationStride)
+{
+  const ScaleRowKernels &kernels = scaleRowKernels(activeSimdLevel());
+
+  if (rotation == Rotation::Clockwise180) {
+    for (int row = 0; row < rowCount; ++row) {
+      const uint8_t *input = strip + row * stripStride;
+      uint8_t *output = destination + (height - 1 - firstRow - row) * destinationStride;
+      if (channels == 1) {
+        kernels.reverseRow(input, output, width);
+      } else if (channels == 2) {
+        kernels.reversePairs(input, output, width);
+      } else {
+        for (int x = 0; x < width; ++x) {
+          memcpy(output + x * channels, input + (width - 1 - x) * channels, size_t(channels));
+        }
+      }
+    }
+    return;
+  }
+
+  // Both quarter turns are transposes: 90 degrees reads the strip bottom-up
+  // and writes output column height - 1 - y, 270 degrees writes output rows
+  // bottom-up.
+  const ptrdiff_t outputStride = rotation == Rotation::Clockwise90 ? destinationStride : -ptrdiff_t(destinationStride);
+  const uint8_t *input = strip;
+  ptrdiff_t inputStride = stripStride;
+  uint8_t *output;
+  if (rotation == Rotation::Clockwise90) {
+    input = strip + (rowCount - 1) * stripStride;
+    inputStride = -stripStride;
+    output = destination + (height - firstRow - rowCount) * channels;
+  } else {
+    output = destination + ptrdiff_t(width - 1) * destinationStride + firstRow * channels;
+  }
+
+  void (*transpose)(const uint8_t *, ptrdiff_t, uint8_t *, ptrdiff_t) = nullptr;
+  if (rowCount == kStripRows && channels == 1) {
+    transpose = kernels.transpose8x8;
+  } else if (rowCount == kStripRows && channels == 2) {
+    transpose = kernels.transposePairs8x8;
+  }
+  int x = 0;
+  if (transpose) {
+    for (; x + 8 <= width; x += 8) {
+      transpose(input + x * channels, inputStride, output + x * outputStride, outputStride);
+    }
+  }
+  transposeBlock(input + x * channels, inputStride, output + x * outputStride, outputStride, rowCount, width - x, channels);
+}
+
+}
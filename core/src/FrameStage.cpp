@@ -0,0 +1,342 @@
+//
+//  FrameStage.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameStage.h"
+
+#include "tivonage/PixelConvert.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace tivonage {
+
+static inline bool isYuv420(const VideoFrame &frame)
+{
+  return frame.format == PixelFormat::I420 || frame.format == PixelFormat::NV12;
+}
+
+// (value + 127) / 255 for value in [0, 255 * 255], without a division.
+static inline uint8_t divide255(uint32_t value)
+{
+  value += 128;
+  return uint8_t((value + (value >> 8)) >> 8);
+}
+
+static inline uint8_t clampSample(float value, float low, float high)
+{
+  return uint8_t(std::lround(std::min(std::max(value, low), high)));
+}
+
+CropStage::CropStage(int x, int y, int width, int height)
+    : m_x(std::max(x, 0) & ~1)
+    , m_y(std::max(y, 0) & ~1)
+    , m_width(width)
+    , m_height(height)
+{
+}
+
+bool CropStage::process(VideoFrame &frame)
+{
+  const int width = std::min(m_width, frame.width - m_x) & ~1;
+  const int height = std::min(m_height, frame.height - m_y) & ~1;
+  if (width <= 0 || height <= 0) {
+    return false;
+  }
+  switch (frame.format) {
+  case PixelFormat::ARGB:
+    frame.planes[0].data += m_y * frame.planes[0].stride + 4 * m_x;
+    break;
+  case PixelFormat::I420:
+    frame.planes[0].data += m_y * frame.planes[0].stride + m_x;
+    frame.planes[1].data += m_y / 2 * frame.planes[1].stride + m_x / 2;
+    frame.planes[2].data += m_y / 2 * frame.planes[2].stride + m_x / 2;
+    break;
+  case PixelFormat::NV12:
+    frame.planes[0].data += m_y * frame.planes[0].stride + m_x;
+    frame.planes[1].data += m_y / 2 * frame.planes[1].stride + m_x;
+    break;
+  }
+  frame.width = width;
+  frame.height = height;
+  return true;
+}
+
+ScaleStage::ScaleStage(int width, int height)
+    : m_width(width & ~1)
+    , m_height(height & ~1)
+    , m_scaler(ScaleFilter::Bilinear)
+{
+}
+
+bool ScaleStage::process(VideoFrame &frame)
+{
+  if (m_width <= 0 || m_height <= 0) {
+    return false;
+  }
+  if (frame.width == m_width && frame.height == m_height) {
+    return true;
+  }
+  if (!m_output || m_output->format() != frame.format) {
+    m_output = FrameBuffer::create(frame.format, m_width, m_height);
+    if (!m_output) {
+      return false;
+    }
+  }
+  if (!m_scaler.scale(frame, m_output->frame())) {
+    return false;
+  }
+  int64_t timestampUs = frame.timestampUs;
+  frame = m_output->frame();
+  frame.timestampUs = timestampUs;
+  return true;
+}
+
+LutStage::LutStage(const uint8_t y[256], const uint8_t u[256], const uint8_t v[256])
+{
+  memcpy(m_y, y, sizeof(m_y));
+  memcpy(m_u, u, sizeof(m_u));
+  memcpy(m_v, v, sizeof(m_v));
+}
+
+std::unique_ptr<LutStage> LutStage::adjust(float brightness, float contrast, float saturation)
+{
+  uint8_t y[256];
+  uint8_t u[256];
+  for (int i = 0; i < 256; ++i) {
+    // Video range: luma 16-235 around 125.5, chroma 16-240 around 128.
+    y[i] = clampSample((float(i) - 125.5f) * contrast + 125.5f + brightness * 219.0f, 16.0f, 235.0f);
+    u[i] = clampSample((float(i) - 128.0f) * saturation + 128.0f, 16.0f, 240.0f);
+  }
+  return std::unique_ptr<LutStage>(new LutStage(y, u, u));
+}
+
+bool LutStage::process(VideoFrame &frame)
+{
+  if (!isYuv420(frame)) {
+    return false;
+  }
+  for (int row = 0; row < frame.height; ++row) {
+    uint8_t *samples = frame.planes[0].data + row * frame.planes[0].stride;
+    for (int x = 0; x < frame.width; ++x) {
+      samples[x] = m_y[samples[x]];
+    }
+  }
+  const int chromaWidth = (frame.width + 1) / 2;
+  const int chromaRows = (frame.height + 1) / 2;
+  for (int row = 0; row < chromaRows; ++row) {
+    if (frame.format == PixelFormat::NV12) {
+      uint8_t *uv = frame.planes[1].data + row * frame.planes[1].stride;
+      for (int x = 0; x < chromaWidth; ++x) {
+        uv[2 * x] = m_u[uv[2 * x]];
+        uv[2 * x + 1] = m_v[uv[2 * x + 1]];
+      }
+      continue;
+    }
+    uint8_t *u = frame.planes[1].data + row * frame.planes[1].stride;
+    uint8_t *v = frame.planes[2].data + row * frame.planes[2].stride;
+    for (int x = 0; x < chromaWidth; ++x) {
+      u[x] = m_u[u[x]];
+      v[x] = m_v[v[x]];
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<OverlayStage> OverlayStage::create(const VideoFrame &image, int x, int y, float opacity)
+{
+  if (image.format != PixelFormat::ARGB || image.width <= 0 || image.height <= 0 || !image.planes[0].data) {
+    return nullptr;
+  }
+  auto yuv = FrameBuffer::create(PixelFormat::I420, image.width, image.height);
+  if (!yuv || !convertFrame(image, yuv->frame())) {
+    return nullptr;
+  }
+
+  std::unique_ptr<OverlayStage> stage(new OverlayStage(std::move(yuv), x, y));
+  const int scale = int(std::lround(std::min(std::max(opacity, 0.0f), 1.0f) * 255.0f));
+  const int width = image.width;
+  const int height = image.height;
+  stage->m_alpha.resize(size_t(width) * size_t(height));
+  for (int row = 0; row < height; ++row) {
+    const uint8_t *pixels = image.planes[0].data + row * image.planes[0].stride;
+    for (int column = 0; column < width; ++column) {
+      stage->m_alpha[size_t(row * width + column)] = divide255(uint32_t(pixels[4 * column + 3] * scale));
+    }
+  }
+  // Chroma alpha is the mean of the 2x2 luma alphas it covers.
+  const int chromaWidth = (width + 1) / 2;
+  const int chromaRows = (height + 1) / 2;
+  stage->m_chromaAlpha.resize(size_t(chromaWidth) * size_t(chromaRows));
+  for (int row = 0; row < chromaRows; ++row) {
+    const int top = 2 * row;
+    const int bottom = std::min(top + 1, height - 1);
+    for (int column = 0; column < chromaWidth; ++column) {
+      const int left = 2 * column;
+      const int right = std::min(left + 1, width - 1);
+      const auto &alpha = stage->m_alpha;
+      int sum = alpha[size_t(top * width + left)] + alpha[size_t(top * width + right)] + alpha[size_t(bottom * width + left)]
+          + alpha[size_t(bottom * width + right)];
+      stage->m_chromaAlpha[size_t(row * chromaWidth + column)] = uint8_t((sum + 2) / 4);
+    }
+  }
+  return stage;
+}
+
+OverlayStage::OverlayStage(std::unique_ptr<FrameBuffer> yuv, int x, int y)
+    : m_yuv(std::move(yuv))
+    , m_x(x & ~1)
+    , m_y(y & ~1)
+{
+}
+
+bool OverlayStage::process(VideoFrame &frame)
+{
+  if (!isYuv420(frame)) {
+    return false;
+  }
+  const VideoFrame &image = m_yuv->frame();
+  const int left = std::max(m_x, 0);
+  const int top = std::max(m_y, 0);
+  const int right = std::min(m_x + image.width, frame.width);
+  const int bottom = std::min(m_y + image.height, frame.height);
+  if (left >= right || top >= bottom) {
+    return true;
+  }
+
+  for (int row = top; row < bottom; ++row) {
+    const int imageRow = row - m_y;
+    uint8_t *destination = frame.planes[0].data + row * frame.planes[0].stride;
+    const uint8_t *source = image.planes[0].data + imageRow * image.planes[0].stride;
+    const uint8_t *alpha = &m_alpha[size_t(imageRow * image.width)];
+    for (int column = left; column < right; ++column) {
+      const uint32_t a = alpha[column - m_x];
+      destination[column] = divide255(destination[column] * (255 - a) + source[column - m_x] * a);
+    }
+  }
+
+  const int imageChromaWidth = (image.width + 1) / 2;
+  const int chromaLeft = left / 2;
+  const int chromaRight = std::min((right + 1) / 2, (frame.width + 1) / 2);
+  const int chromaBottom = std::min((bottom + 1) / 2, (frame.height + 1) / 2);
+  for (int row = top / 2; row < chromaBottom; ++row) {
+    const int imageRow = row - m_y / 2;
+    const uint8_t *u = image.planes[1].data + imageRow * image.planes[1].stride;
+    const uint8_t *v = image.planes[2].data + imageRow * image.planes[2].stride;
+    const uint8_t *alpha = &m_chromaAlpha[size_t(imageRow * imageChromaWidth)];
+    uint8_t *first = frame.planes[1].data + row * frame.planes[1].stride;
+    uint8_t *second = frame.format == PixelFormat::I420 ? frame.planes[2].data + row * frame.planes[2].stride : nullptr;
+    for (int column = chromaLeft; column < chromaRight; ++column) {
+      const int imageColumn = column - m_x / 2;
+      const uint32_t a = alpha[imageColumn];
+      if (second) {
+        first[column] = divide255(first[column] * (255 - a) + u[imageColumn] * a);
+        second[column] = divide255(second[column] * (255 - a) + v[imageColumn] * a);
+      } else {
+        first[2 * column] = divide255(first[2 * column] * (255 - a) + u[imageColumn] * a);
+        first[2 * column + 1] = divide255(first[2 * column + 1] * (255 - a) + v[imageColumn] * a);
+      }
+    }
+  }
+  return true;
+}
+
+BlurStage::BlurStage(int x, int y, int width, int height, int radius)
+    : m_x(std::max(x, 0) & ~1)
+    , m_y(std::max(y, 0) & ~1)
+    , m_width(width)
+    , m_height(height)
+    , m_radius(std::min(std::max(radius, 1), kMaxRadius))
+{
+}
+
+bool BlurStage::process(VideoFrame &frame)
+{
+  if (!isYuv420(frame)) {
+    return false;
+  }
+  const int x = m_width > 0 && m_height > 0 ? m_x : 0;
+  const int y = m_width > 0 && m_height > 0 ? m_y : 0;
+  const int width = (m_width > 0 && m_height > 0 ? std::min(m_width, frame.width - x) : frame.width) & ~1;
+  const int height = (m_width > 0 && m_height > 0 ? std::min(m_height, frame.height - y) : frame.height) & ~1;
+  if (width <= 0 || height <= 0) {
+    return true;
+  }
+
+  blurPlane(frame.planes[0].data + y * frame.planes[0].stride + x, frame.planes[0].stride, width, height, 1, m_radius);
+  const int chromaRadius = std::max(m_radius / 2, 1);
+  if (frame.format == PixelFormat::NV12) {
+    blurPlane(frame.planes[1].data + y / 2 * frame.planes[1].stride + x, frame.planes[1].stride, width / 2, height / 2, 2, chromaRadius);
+  } else {
+    for (int plane = 1; plane < 3; ++plane) {
+      blurPlane(frame.planes[plane].data + y / 2 * frame.planes[plane].stride + x / 2, frame.planes[plane].stride, width / 2, height / 2, 1,
+          chromaRadius);
+    }
+  }
+  return true;
+}
+
+// Separable box blur with edges clamped. The vertical pass runs down the
+// columns with a sliding sum per sample; rows it has already overwritten
+// are kept in a ring of radius + 1 original rows for the sum's trailing
+// edge.
+void BlurStage::blurPlane(uint8_t *data, int stride, int width, int height, int channels, int radius)
+{
+  const int rowBytes = width * channels;
+  const int window = 2 * radius + 1;
+  const uint32_t reciprocal = (65536u + uint32_t(window) / 2) / uint32_t(window);
+  const size_t ringRows = size_t(radius + 1);
+  if (m_rows.size() < (ringRows + 1) * size_t(rowBytes)) {
+    m_rows.resize((ringRows + 1) * size_t(rowBytes));
+  }
+  if (m_sums.size() < size_t(rowBytes)) {
+    m_sums.resize(size_t(rowBytes));
+  }
+  uint8_t *scratch = m_rows.data() + ringRows * size_t(rowBytes);
+  uint32_t *sums = m_sums.data();
+
+  for (int row = 0; row < height; ++row) {
+    uint8_t *samples = data + row * stride;
+    memcpy(scratch, samples, size_t(rowBytes));
+    for (int channel = 0; channel < channels; ++channel) {
+      auto at = [&](int column) { return uint32_t(scratch[std::min(std::max(column, 0), width - 1) * channels + channel]); };
+      uint32_t sum = 0;
+      for (int k = -radius; k <= radius; ++k) {
+        sum += at(k);
+      }
+      for (int column = 0; column < width; ++column) {
+        samples[column * channels + channel] = uint8_t((sum * reciprocal + 32768u) >> 16);
+        sum += at(column + radius + 1) - at(column - radius);
+      }
+    }
+  }
+
+  auto clampRow = [&](int row) { return std::min(std::max(row, 0), height - 1); };
+  memset(sums, 0, size_t(rowBytes) * sizeof(uint32_t));
+  for (int k = -radius; k <= radius; ++k) {
+    const uint8_t *samples = data + clampRow(k) * stride;
+    for (int i = 0; i < rowBytes; ++i) {
+      sums[i] += samples[i];
+    }
+  }
+  for (int row = 0; row < height; ++row) {
+    uint8_t *samples = data + row * stride;
+    memcpy(m_rows.data() + size_t(row % int(ringRows)) * size_t(rowBytes), samples, size_t(rowBytes));
+    for (int i = 0; i < rowBytes; ++i) {
+      samples[i] = uint8_t((sums[i] * reciprocal + 32768u) >> 16);
+    }
+    // Rows up to this one now hold output; their originals are in the ring.
+    auto original = [&](int index) {
+      return index > row ? data + index * stride : m_rows.data() + size_t(index % int(ringRows)) * size_t(rowBytes);
+    };
+    const uint8_t *entering = original(clampRow(row + radius + 1));
+    const uint8_t *leaving = original(clampRow(row - radius));
+    for (int i = 0; i < rowBytes; ++i) {
+      sums[i] += uint32_t(entering[i]) - uint32_t(leaving[i]);
+    }
+  }
+}
+
+}
@@ -0,0 +1,136 @@
+//
+//  GalleryCompositor.cpp
+//  ti.vonage
+//
+
+#include "tivonage/GalleryCompositor.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace tivonage {
+
+static bool drawable(const VideoFrame &frame)
+{
+  return frame.width > 0 && frame.height > 0 && frame.planes[0].data
+      && (frame.format == PixelFormat::I420 || frame.format == PixelFormat::NV12);
+}
+
+static bool fits(const GalleryTile &tile, const VideoFrame &surface)
+{
+  return tile.width >= 2 && tile.height >= 2 && tile.x >= 0 && tile.y >= 0 && !(tile.x & 1) && !(tile.y & 1)
+      && tile.x + tile.width <= surface.width && tile.y + tile.height <= surface.height;
+}
+
+GalleryCompositor::GalleryCompositor(ScaleFilter filter)
+    : m_scaler(filter)
+{
+}
+
+bool GalleryCompositor::compose(const std::vector<GalleryTile> &tiles, const VideoFrame *frames, size_t frameCount, VideoFrame &surface)
+{
+  if (surface.format != PixelFormat::NV12 || surface.width <= 0 || surface.height <= 0 || !surface.planes[0].data || !surface.planes[1].data) {
+    return false;
+  }
+  fillBackground(tiles, frames, frameCount, surface);
+  bool drawn = true;
+  for (size_t i = 0; i < tiles.size() && i < frameCount; ++i) {
+    if (drawable(frames[i]) && fits(tiles[i], surface)) {
+      drawn &= drawTile(frames[i], tiles[i], surface);
+    }
+  }
+  return drawn;
+}
+
+bool GalleryCompositor::drawTile(const VideoFrame &frame, const GalleryTile &tile, VideoFrame &surface)
+{
+  if (!drawable(frame) || !fits(tile, surface) || surface.format != PixelFormat::NV12) {
+    return false;
+  }
+
+  // Crop the upright picture to the tile's aspect ratio, then map the crop
+  // back into the (possibly rotated) source. A centred crop is symmetric, so
+  // swapping its dimensions is all the mapping there is.
+  Rotation rotation = uprightRotation(frame.orientation);
+  bool swap = swapsDimensions(rotation);
+  int uprightWidth = swap ? frame.height : frame.width;
+  int uprightHeight = swap ? frame.width : frame.height;
+  int cropWidth = uprightWidth;
+  int cropHeight = uprightHeight;
+  if (int64_t(uprightWidth) * tile.height > int64_t(uprightHeight) * tile.width) {
+    cropWidth = std::max(2, int(int64_t(uprightHeight) * tile.width / tile.height) & ~1);
+  } else {
+    cropHeight = std::max(2, int(int64_t(uprightWidth) * tile.height / tile.width) & ~1);
+  }
+  cropWidth = std::min(cropWidth, uprightWidth);
+  cropHeight = std::min(cropHeight, uprightHeight);
+  if (swap) {
+    std::swap(cropWidth, cropHeight);
+  }
+  const int left = ((frame.width - cropWidth) / 2) & ~1;
+  const int top = ((frame.height - cropHeight) / 2) & ~1;
+
+  VideoFrame source = frame;
+  source.width = cropWidth;
+  source.height = cropHeight;
+  source.planes[0].data += ptrdiff_t(top) * frame.planes[0].stride + left;
+  if (frame.format == PixelFormat::I420) {
+    source.planes[1].data += ptrdiff_t(top / 2) * frame.planes[1].stride + left / 2;
+    source.planes[2].data += ptrdiff_t(top / 2) * frame.planes[2].stride + left / 2;
+  } else {
+    source.planes[1].data += ptrdiff_t(top / 2) * frame.planes[1].stride + left;
+  }
+
+  VideoFrame destination = surface;
+  destination.width = tile.width;
+  destination.height = tile.height;
+  destination.planes[0].data += ptrdiff_t(tile.y) * surface.planes[0].stride + tile.x;
+  destination.planes[1].data += ptrdiff_t(tile.y / 2) * surface.planes[1].stride + tile.x;
+  return m_scaler.scale(source, destination, rotation);
+}
+
+void GalleryCompositor::fillBackground(const std::vector<GalleryTile> &tiles, const VideoFrame *frames, size_t frameCount, VideoFrame &surface)
+{
+  // Tiles start and end on even rows, so a pair of luma rows and the chroma
+  // row between them share the same spans.
+  const int chromaRowBytes = planeRowBytes(PixelFormat::NV12, 1, surface.width);
+  for (int y = 0; y < surface.height; y += 2) {
+    m_spans.clear();
+    for (size_t i = 0; i < tiles.size() && i < frameCount; ++i) {
+      const GalleryTile &tile = tiles[i];
+      if (y >= tile.y && y < tile.y + tile.height && drawable(frames[i]) && fits(tile, surface)) {
+        m_spans.push_back(tile.x);
+        m_spans.push_back(tile.x + tile.width);
+      }
+    }
+    // Tiles in a row usually arrive left to right already; an insertion sort
+    // of the few spans keeps this allocation-free either way.
+    for (size_t i = 2; i < m_spans.size(); i += 2) {
+      for (size_t j = i; j >= 2 && m_spans[j - 2] > m_spans[j]; j -= 2) {
+        std::swap(m_spans[j - 2], m_spans[j]);
+        std::swap(m_spans[j - 1], m_spans[j + 1]);
+      }
+    }
+
+    uint8_t *luma = surface.planes[0].data + ptrdiff_t(y) * surface.planes[0].stride;
+    uint8_t *nextLuma = y + 1 < surface.height ? luma + surface.planes[0].stride : nullptr;
+    uint8_t *chroma = surface.planes[1].data + ptrdiff_t(y / 2) * surface.planes[1].stride;
+    int x = 0;
+    for (size_t i = 0; i <= m_spans.size(); i += 2) {
+      const int end = i < m_spans.size() ? std::min(m_spans[i], surface.width) : surface.width;
+      if (end > x) {
+        memset(luma + x, kBackgroundLuma, size_t(end - x));
+        if (nextLuma) {
+          memset(nextLuma + x, kBackgroundLuma, size_t(end - x));
+        }
+        const int chromaEnd = std::min(end + (end & 1), chromaRowBytes);
+        memset(chroma + x, kBackgroundChroma, size_t(chromaEnd - x));
+      }
+      if (i < m_spans.size()) {
+        x = std::max(x, m_spans[i + 1]);
+      }
+    }
+  }
+}
+
+}
@@ -0,0 +1,97 @@
+//
+//  GalleryLayout.cpp
+//  ti.vonage
+//
+
+#include "tivonage/GalleryLayout.h"
+
+#include <algorithm>
+
+namespace tivonage {
+
+GalleryLayout::GalleryLayout()
+    : GalleryLayout(Config())
+{
+}
+
+GalleryLayout::GalleryLayout(const Config &config)
+    : m_config(config)
+{
+}
+
+bool GalleryLayout::update(int surfaceWidth, int surfaceHeight, size_t tileCount)
+{
+  if (surfaceWidth == m_surfaceWidth && surfaceHeight == m_surfaceHeight && tileCount == m_tiles.size()) {
+    return false;
+  }
+  m_surfaceWidth = surfaceWidth;
+  m_surfaceHeight = surfaceHeight;
+
+  const int count = int(tileCount);
+  const int spacing = std::max(0, m_config.spacing);
+  const double aspect = m_config.tileAspect > 0.0 ? m_config.tileAspect : 1.0;
+
+  // Try every column count; the one with the largest tile wins (fewer
+  // columns on a tie, which keeps tiles wider than tall on phones).
+  int bestColumns = std::max(1, count);
+  int bestWidth = 0;
+  int bestHeight = 0;
+  for (int columns = 1; columns <= count; ++columns) {
+    int rows = (count + columns - 1) / columns;
+    double cellWidth = double(surfaceWidth - (columns + 1) * spacing) / columns;
+    double cellHeight = double(surfaceHeight - (rows + 1) * spacing) / rows;
+    if (cellWidth < 2.0 || cellHeight < 2.0) {
+      continue;
+    }
+    double width = std::min(cellWidth, cellHeight * aspect);
+    int tileWidth = int(width) & ~1;
+    int tileHeight = int(width / aspect) & ~1;
+    if (tileWidth * tileHeight > bestWidth * bestHeight) {
+      bestColumns = columns;
+      bestWidth = tileWidth;
+      bestHeight = tileHeight;
+    }
+  }
+
+  m_columns = count ? bestColumns : 0;
+  m_rows = count ? (count + bestColumns - 1) / bestColumns : 0;
+  std::vector<GalleryTile> tiles(tileCount);
+  if (bestWidth >= 2 && bestHeight >= 2) {
+    const int gridHeight = m_rows * bestHeight + (m_rows - 1) * spacing;
+    const int top = ((surfaceHeight - gridHeight) / 2) & ~1;
+    for (int row = 0; row < m_rows; ++row) {
+      const int inRow = std::min(m_columns, count - row * m_columns);
+      const int rowWidth = inRow * bestWidth + (inRow - 1) * spacing;
+      const int left = ((surfaceWidth - rowWidth) / 2) & ~1;
+      for (int column = 0; column < inRow; ++column) {
+        GalleryTile &tile = tiles[size_t(row * m_columns + column)];
+        tile.x = left + column * (bestWidth + spacing);
+        tile.y = top + row * (bestHeight + spacing);
+        // Odd spacing would misalign every other tile's chroma.
+        tile.x &= ~1;
+        tile.y &= ~1;
+        tile.width = bestWidth;
+        tile.height = bestHeight;
+      }
+    }
+  }
+
+  bool changed = tiles.size() != m_tiles.size()
+      || !std::equal(tiles.begin(), tiles.end(), m_tiles.begin(), [](const GalleryTile &a, const GalleryTile &b) {
+           return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+         });
+  m_tiles = std::move(tiles);
+  return changed;
+}
+
+int GalleryLayout::tileAt(int x, int y) const
+{
+  for (size_t i = 0; i < m_tiles.size(); ++i) {
+    if (m_tiles[i].contains(x, y)) {
+      return int(i);
+    }
+  }
+  return -1;
+}
+
+}
@@ -0,0 +1,123 @@
+//
+//  LatencyHistogram.cpp
+//  ti.vonage
+//
+
+#include "tivonage/LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tivonage {
+
+static const size_t kSubBucketCount = size_t(1) << LatencyHistogram::kSubBucketBits;
+
+static int highestBit(uint64_t value)
+{
+  return 63 - __builtin_clzll(value);
+}
+
+LatencyHistogram::LatencyHistogram()
+{
+  reset();
+}
+
+size_t LatencyHistogram::bucketIndex(int64_t valueUs)
+{
+  uint64_t value = uint64_t(std::clamp<int64_t>(valueUs, 0, kMaxValueUs));
+  if (value < kSubBucketCount) {
+    return size_t(value);
+  }
+  // value >> shift lands in [32, 64), so consecutive ranges follow on.
+  int shift = highestBit(value) - kSubBucketBits;
+  return (size_t(shift) << kSubBucketBits) + size_t(value >> shift);
+}
+
+int64_t LatencyHistogram::bucketLowest(size_t index)
+{
+  if (index < kSubBucketCount) {
+    return int64_t(index);
+  }
+  int shift = int(index >> kSubBucketBits) - 1;
+  int64_t mantissa = int64_t(index & (kSubBucketCount - 1)) + int64_t(kSubBucketCount);
+  return mantissa << shift;
+}
+
+int64_t LatencyHistogram::bucketHighest(size_t index)
+{
+  if (index < kSubBucketCount) {
+    return int64_t(index);
+  }
+  int shift = int(index >> kSubBucketBits) - 1;
+  return bucketLowest(index) + (int64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::record(int64_t valueUs)
+{
+  int64_t value = std::clamp<int64_t>(valueUs, 0, kMaxValueUs);
+  m_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  m_sum.fetch_add(value, std::memory_order_relaxed);
+  if (value < m_min.load(std::memory_order_relaxed)) {
+    m_min.store(value, std::memory_order_relaxed);
+  }
+  if (value > m_max.load(std::memory_order_relaxed)) {
+    m_max.store(value, std::memory_order_relaxed);
+  }
+  // Last, so a reader that sees the count also sees a bucket for it.
+  m_count.fetch_add(1, std::memory_order_release);
+}
+
+int64_t LatencyHistogram::min() const
+{
+  return count() ? m_min.load(std::memory_order_relaxed) : 0;
+}
+
+int64_t LatencyHistogram::mean() const
+{
+  uint64_t samples = count();
+  return samples ? m_sum.load(std::memory_order_relaxed) / int64_t(samples) : 0;
+}
+
+int64_t LatencyHistogram::percentile(double percent) const
+{
+  uint64_t samples = m_count.load(std::memory_order_acquire);
+  if (!samples) {
+    return 0;
+  }
+  double clamped = std::clamp(percent, 0.0, 100.0);
+  uint64_t rank = std::max<uint64_t>(1, uint64_t(std::ceil(clamped / 100.0 * double(samples))));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += m_buckets[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return std::min(bucketHighest(i), max());
+    }
+  }
+  return max();
+}
+
+LatencyHistogram::Summary LatencyHistogram::summary() const
+{
+  Summary summary;
+  summary.count = count();
+  summary.minUs = min();
+  summary.meanUs = mean();
+  summary.p50Us = percentile(50);
+  summary.p95Us = percentile(95);
+  summary.p99Us = percentile(99);
+  summary.maxUs = max();
+  return summary;
+}
+
+void LatencyHistogram::reset()
+{
+  for (auto &bucket : m_buckets) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  m_sum.store(0, std::memory_order_relaxed);
+  m_min.store(kMaxValueUs, std::memory_order_relaxed);
+  m_max.store(0, std::memory_order_relaxed);
+  m_count.store(0, std::memory_order_release);
+}
+
+}
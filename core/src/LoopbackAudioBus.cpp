@@ -0,0 +1,51 @@
+//
+//  LoopbackAudioBus.cpp
+//  ti.vonage
+//
+
+#include "tivonage/LoopbackAudioBus.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace tivonage {
+
+std::unique_ptr<LoopbackAudioBus> LoopbackAudioBus::create(int sampleRate, int delayMs, int bufferMs)
+{
+  if (sampleRate <= 0 || delayMs < 0 || bufferMs <= 0) {
+    return nullptr;
+  }
+  const size_t delay = size_t(int64_t(sampleRate) * delayMs / 1000);
+  std::unique_ptr<AudioRingBuffer> ring = AudioRingBuffer::create(delay + size_t(int64_t(sampleRate) * bufferMs / 1000));
+  if (!ring) {
+    return nullptr;
+  }
+  // The delay is silence queued ahead of the first captured sample.
+  std::vector<int16_t> silence(delay, 0);
+  ring->write(silence.data(), silence.size());
+  return std::unique_ptr<LoopbackAudioBus>(new LoopbackAudioBus(sampleRate, std::move(ring)));
+}
+
+LoopbackAudioBus::LoopbackAudioBus(int sampleRate, std::unique_ptr<AudioRingBuffer> ring)
+    : m_sampleRate(sampleRate)
+    , m_ring(std::move(ring))
+{
+}
+
+void LoopbackAudioBus::writeCaptureData(const int16_t *samples, size_t count)
+{
+  size_t written = m_ring->write(samples, count);
+  m_capturedSamples.fetch_add(written, std::memory_order_relaxed);
+  if (written < count) {
+    m_droppedSamples.fetch_add(count - written, std::memory_order_relaxed);
+  }
+}
+
+size_t LoopbackAudioBus::readRenderData(int16_t *samples, size_t count)
+{
+  size_t read = m_ring->read(samples, count);
+  m_renderedSamples.fetch_add(read, std::memory_order_relaxed);
+  return read;
+}
+
+}
@@ -0,0 +1,263 @@
+//
+//  MediaRecorder.cpp
+//  ti.vonage
+//
+
+#include "tivonage/MediaRecorder.h"
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/PixelConvert.h"
+#include "tivonage/WavWriter.h"
+#include "tivonage/Y4mWriter.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace tivonage {
+
+// How long the I/O thread sleeps when there is nothing to write. Producers
+// never signal it, so they stay lock-free; at 30 fps this adds at most a
+// fraction of a frame of queueing.
+static const std::chrono::milliseconds kIdleInterval(5);
+
+// Audio is written in chunks of this many milliseconds.
+static const int kAudioChunkMs = 20;
+
+std::unique_ptr<MediaRecorder> MediaRecorder::create(const std::string &videoPath, const std::string &audioPath)
+{
+  return create(videoPath, audioPath, Config());
+}
+
+std::unique_ptr<MediaRecorder> MediaRecorder::create(const std::string &videoPath, const std::string &audioPath, const Config &config)
+{
+  if (videoPath.empty() || config.frameRate <= 0 || config.queuedFrames == 0) {
+    return nullptr;
+  }
+  std::unique_ptr<WavWriter> audio;
+  if (!audioPath.empty()) {
+    audio = WavWriter::create(audioPath, config.audioSampleRate, config.audioChannels);
+    if (!audio) {
+      return nullptr;
+    }
+  }
+  return std::unique_ptr<MediaRecorder>(new MediaRecorder(videoPath, std::move(audio), config));
+}
+
+MediaRecorder::MediaRecorder(const std::string &videoPath, std::unique_ptr<WavWriter> audio, const Config &config)
+    : m_config(config)
+    , m_videoPath(videoPath)
+    // One buffer being filled, the queued ones, one being written and the
+    // last one written, kept for repeating.
+    , m_pool(FramePool::create(config.queuedFrames + 3))
+    , m_scaler(ScaleFilter::Bilinear)
+    , m_frames(config.queuedFrames + 2)
+    , m_audioWriter(std::move(audio))
+{
+  if (m_audioWriter) {
+    const size_t samplesPerMs = size_t(config.audioSampleRate) * size_t(config.audioChannels) / 1000;
+    m_audio = AudioRingBuffer::create(samplesPerMs * size_t(std::max(config.queuedAudioMs, kAudioChunkMs)));
+    m_audioChunk.resize(samplesPerMs * kAudioChunkMs);
+  }
+  m_thread = std::thread([this] { run(); });
+}
+
+MediaRecorder::~MediaRecorder()
+{
+  stop();
+}
+
+bool MediaRecorder::writeVideoFrame(const VideoFrame &frame)
+{
+  if (m_stopping.load(std::memory_order_acquire) || frame.width <= 0 || frame.height <= 0) {
+    return false;
+  }
+
+  Rotation rotation = uprightRotation(frame.orientation);
+  bool swap = swapsDimensions(rotation);
+  int uprightWidth = swap ? frame.height : frame.width;
+  int uprightHeight = swap ? frame.width : frame.height;
+  if (!m_width) {
+    // Y4M can't change size mid-stream, and I420 wants even dimensions.
+    m_width = std::max(2, uprightWidth & ~1);
+    m_height = std::max(2, uprightHeight & ~1);
+  }
+
+  FrameHandle handle = m_pool->acquire(PixelFormat::I420, m_width, m_height);
+  if (!handle) {
+    m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  bool copied;
+  if (rotation == Rotation::None && frame.width == m_width && frame.height == m_height) {
+    copied = convertFrame(frame, handle.frame());
+  } else if (frame.format == PixelFormat::I420) {
+    copied = m_scaler.scale(frame, handle.frame(), rotation);
+  } else {
+    // The scaler keeps NV12 and ARGB in their format, so those are scaled
+    // first and converted after.
+    if (!m_scratch || m_scratch->format() != frame.format) {
+      m_scratch = FrameBuffer::create(frame.format, m_width, m_height);
+    }
+    copied = m_scratch && m_scaler.scale(frame, m_scratch->frame(), rotation) && convertFrame(m_scratch->frame(), handle.frame());
+  }
+  if (!copied) {
+    m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  handle.frame().timestampUs = frame.timestampUs;
+
+  // The queue holds more than the pool, so this only fails if the pool's
+  // buffers were all handed out, which acquire() already ruled out.
+  if (!m_frames.push(std::move(handle))) {
+    m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+size_t MediaRecorder::writeAudio(const int16_t *samples, size_t count)
+{
+  if (!m_audio || m_stopping.load(std::memory_order_acquire)) {
+    return 0;
+  }
+  size_t written = m_audio->write(samples, count);
+  if (written < count) {
+    m_droppedSamples.fetch_add(count - written, std::memory_order_relaxed);
+  }
+  return written;
+}
+
+void MediaRecorder::stop()
+{
+  m_stopping.store(true, std::memory_order_release);
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+MediaRecorder::Counters MediaRecorder::counters() const
+{
+  Counters counters;
+  counters.recordedFrames = m_recordedFrames.load(std::memory_order_relaxed);
+  counters.repeatedFrames = m_repeatedFrames.load(std::memory_order_relaxed);
+  counters.droppedFrames = m_droppedFrames.load(std::memory_order_relaxed);
+  counters.recordedSamples = m_recordedSamples.load(std::memory_order_relaxed);
+  counters.droppedSamples = m_droppedSamples.load(std::memory_order_relaxed);
+  counters.failed = m_failed.load(std::memory_order_relaxed);
+  return counters;
+}
+
+void MediaRecorder::run()
+{
+  for (;;) {
+    // Read the flag first: whatever was queued before stop() is then still
+    // drained by the pass below.
+    bool stopping = m_stopping.load(std::memory_order_acquire);
+    bool wrote = drain();
+    if (stopping && !wrote) {
+      break;
+    }
+    if (!wrote) {
+      std::this_thread::sleep_for(kIdleInterval);
+    }
+  }
+
+  m_lastFrame.reset();
+  bool closed = true;
+  if (m_videoWriter) {
+    closed &= m_videoWriter->close();
+  }
+  if (m_audioWriter) {
+    closed &= m_audioWriter->close();
+  }
+  if (!closed) {
+    m_failed.store(true, std::memory_order_relaxed);
+  }
+}
+
+bool MediaRecorder::drain()
+{
+  bool wrote = false;
+
+  FrameHandle handle;
+  while (m_frames.pop(handle)) {
+    wrote = true;
+    if (m_failed.load(std::memory_order_relaxed)) {
+      handle.reset();
+      continue;
+    }
+    if (writeFrame(handle)) {
+      // The previous frame goes back to the pool; this one stays for
+      // repeating.
+      m_lastFrame = std::move(handle);
+    } else {
+      handle.reset();
+    }
+  }
+
+  if (m_audio) {
+    size_t count;
+    while ((count = m_audio->read(m_audioChunk.data(), m_audioChunk.size())) > 0) {
+      wrote = true;
+      if (m_failed.load(std::memory_order_relaxed)) {
+        continue;
+      }
+      if (m_audioWriter->write(m_audioChunk.data(), count)) {
+        m_recordedSamples.fetch_add(count, std::memory_order_relaxed);
+      } else {
+        m_failed.store(true, std::memory_order_relaxed);
+      }
+    }
+  }
+  return wrote;
+}
+
+// Writes the frame at its grid slot, after repeating the last frame over
+// the slots before it. False if it was dropped or the write failed.
+bool MediaRecorder::writeFrame(const FrameHandle &handle)
+{
+  const VideoFrame &frame = handle.frame();
+  const int64_t frameRate = m_config.frameRate;
+  int64_t slot = m_nextSlot;
+  if (frame.timestampUs > 0) {
+    // A clock that jumped back by more than a second (e.g. a restarted
+    // source) starts a new timeline at the next slot instead of dropping
+    // everything until it catches up.
+    int64_t offset = frame.timestampUs - m_originUs;
+    if (!m_hasOrigin || offset * frameRate + 500000 < (m_nextSlot - frameRate) * 1000000) {
+      m_originUs = frame.timestampUs - m_nextSlot * 1000000 / frameRate;
+      m_hasOrigin = true;
+      offset = frame.timestampUs - m_originUs;
+    }
+    slot = (offset * frameRate + 500000) / 1000000;
+    if (offset < 0 || slot < m_nextSlot) {
+      m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+  }
+
+  if (!m_videoWriter) {
+    m_videoWriter = Y4mWriter::create(m_videoPath, frame.width, frame.height, m_config.frameRate);
+    if (!m_videoWriter) {
+      m_failed.store(true, std::memory_order_relaxed);
+      return false;
+    }
+  }
+  for (; m_lastFrame && m_nextSlot < slot; ++m_nextSlot) {
+    if (!m_videoWriter->writeFrame(m_lastFrame.frame())) {
+      m_failed.store(true, std::memory_order_relaxed);
+      return false;
+    }
+    m_repeatedFrames.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (!m_videoWriter->writeFrame(frame)) {
+    m_failed.store(true, std::memory_order_relaxed);
+    return false;
+  }
+  m_recordedFrames.fetch_add(1, std::memory_order_relaxed);
+  m_nextSlot = slot + 1;
+  return true;
+}
+
+}
@@ -0,0 +1,163 @@
+//
+//  PixelConvert.cpp
+//  ti.vonage
+//
+
+#include "tivonage/PixelConvert.h"
+
+#include "ConvertRows.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace tivonage {
+
+static inline const uint8_t *row(const VideoPlane &plane, int y)
+{
+  return plane.data + y * plane.stride;
+}
+
+static inline uint8_t *row(VideoPlane &plane, int y)
+{
+  return plane.data + y * plane.stride;
+}
+
+static void copyPlane(const VideoPlane &source, VideoPlane &destination, int rowBytes, int rows)
+{
+  for (int y = 0; y < rows; ++y) {
+    memcpy(row(destination, y), row(source, y), size_t(rowBytes));
+  }
+}
+
+static void argbToChroma(const ConvertRowKernels &kernels, const VideoFrame &source, VideoFrame &destination)
+{
+  const int chromaRows = (source.height + 1) / 2;
+  for (int y = 0; y < chromaRows; ++y) {
+    const uint8_t *top = row(source.planes[0], 2 * y);
+    const uint8_t *bottom = row(source.planes[0], std::min(2 * y + 1, source.height - 1));
+    if (destination.format == PixelFormat::I420) {
+      kernels.argbToUV(top, bottom, row(destination.planes[1], y), row(destination.planes[2], y), source.width);
+      continue;
+    }
+
+    // NV12: subsample a slice into U and V scratch rows, then interleave.
+    constexpr int kSlice = 1024;
+    alignas(64) uint8_t u[kSlice / 2];
+    alignas(64) uint8_t v[kSlice / 2];
+    uint8_t *uv = row(destination.planes[1], y);
+    for (int x = 0; x < source.width; x += kSlice) {
+      int width = std::min(kSlice, source.width - x);
+      kernels.argbToUV(top + 4 * x, bottom + 4 * x, u, v, width);
+      kernels.mergeUV(u, v, uv + x, (width + 1) / 2);
+    }
+  }
+}
+
+bool convertFrame(const VideoFrame &source, VideoFrame &destination)
+{
+  if (source.width != destination.width || source.height != destination.height || source.width <= 0 || source.height <= 0) {
+    return false;
+  }
+  if (source.format == destination.format) {
+    return copyFrame(source, destination);
+  }
+  for (int plane = 0; plane < planeCount(source.format); ++plane) {
+    if (!source.planes[plane].data) {
+      return false;
+    }
+  }
+  for (int plane = 0; plane < planeCount(destination.format); ++plane) {
+    if (!destination.planes[plane].data) {
+      return false;
+    }
+  }
+
+  const ConvertRowKernels &kernels = convertRowKernels(activeSimdLevel());
+  const int width = source.width;
+  const int height = source.height;
+  const int chromaWidth = (width + 1) / 2;
+  const int chromaRows = (height + 1) / 2;
+  const VideoPlane *from = source.planes;
+  VideoPlane *to = destination.planes;
+
+  switch (source.format) {
+  case PixelFormat::I420:
+    if (destination.format == PixelFormat::NV12) {
+      copyPlane(from[0], to[0], width, height);
+      for (int y = 0; y < chromaRows; ++y) {
+        kernels.mergeUV(row(from[1], y), row(from[2], y), row(to[1], y), chromaWidth);
+      }
+    } else {
+      for (int y = 0; y < height; ++y) {
+        kernels.i420ToARGB(row(from[0], y), row(from[1], y / 2), row(from[2], y / 2), row(to[0], y), width);
+      }
+    }
+    break;
+  case PixelFormat::NV12:
+    if (destination.format == PixelFormat::I420) {
+      copyPlane(from[0], to[0], width, height);
+      for (int y = 0; y < chromaRows; ++y) {
+        kernels.splitUV(row(from[1], y), row(to[1], y), row(to[2], y), chromaWidth);
+      }
+    } else {
+      for (int y = 0; y < height; ++y) {
+        kernels.nv12ToARGB(row(from[0], y), row(from[1], y / 2), row(to[0], y), width);
+      }
+    }
+    break;
+  case PixelFormat::ARGB:
+    for (int y = 0; y < height; ++y) {
+      kernels.argbToY(row(from[0], y), row(to[0], y), width);
+    }
+    argbToChroma(kernels, source, destination);
+    break;
+  }
+
+  destination.orientation = source.orientation;
+  destination.timestampUs = source.timestampUs;
+  return true;
+}
+
+bool convertFlexibleYuv(const FlexibleYuvImage &source, VideoFrame &destination)
+{
+  if (destination.format != PixelFormat::I420 || source.width != destination.width || source.height != destination.height
+      || source.width <= 0 || source.height <= 0 || !source.y || !source.u || !source.v || source.uvPixelStride < 1) {
+    return false;
+  }
+  for (int plane = 0; plane < 3; ++plane) {
+    if (!destination.planes[plane].data) {
+      return false;
+    }
+  }
+
+  const ConvertRowKernels &kernels = convertRowKernels(activeSimdLevel());
+  const int chromaWidth = (source.width + 1) / 2;
+  const int chromaRows = (source.height + 1) / 2;
+  VideoPlane *to = destination.planes;
+  copyPlane(VideoPlane { const_cast<uint8_t *>(source.y), source.yStride }, to[0], source.width, source.height);
+
+  for (int y = 0; y < chromaRows; ++y) {
+    const uint8_t *u = source.u + y * source.uvStride;
+    const uint8_t *v = source.v + y * source.uvStride;
+    if (source.uvPixelStride == 1) {
+      memcpy(row(to[1], y), u, size_t(chromaWidth));
+      memcpy(row(to[2], y), v, size_t(chromaWidth));
+    } else if (source.uvPixelStride == 2 && v == u + 1) {
+      kernels.splitUV(u, row(to[1], y), row(to[2], y), chromaWidth);
+    } else if (source.uvPixelStride == 2 && u == v + 1) {
+      // NV21 is NV12 with the chroma order swapped.
+      kernels.splitUV(v, row(to[2], y), row(to[1], y), chromaWidth);
+    } else {
+      uint8_t *uRow = row(to[1], y);
+      uint8_t *vRow = row(to[2], y);
+      for (int x = 0; x < chromaWidth; ++x) {
+        uRow[x] = u[x * source.uvPixelStride];
+        vRow[x] = v[x * source.uvPixelStride];
+      }
+    }
+  }
+  destination.orientation = VideoOrientation::Up;
+  return true;
+}
+
+}
@@ -0,0 +1,89 @@
+//
+//  RenderStats.cpp
+//  ti.vonage
+//
+
+#include "tivonage/RenderStats.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tivonage {
+
+FrameIntervalWindow::FrameIntervalWindow()
+{
+  for (auto &interval : m_intervals) {
+    interval.store(0, std::memory_order_relaxed);
+  }
+}
+
+void FrameIntervalWindow::add(int64_t nowUs)
+{
+  const int64_t last = m_lastUs.exchange(nowUs, std::memory_order_relaxed);
+  const int64_t interval = nowUs - last;
+  if (!last || interval < 0 || interval > kMaxIntervalUs) {
+    // Start over, so the window only ever describes continuous playback.
+    m_count.store(0, std::memory_order_release);
+    return;
+  }
+  const uint64_t count = m_count.load(std::memory_order_relaxed);
+  m_intervals[count % kCapacity].store(uint32_t(interval), std::memory_order_relaxed);
+  m_count.store(count + 1, std::memory_order_release);
+}
+
+FrameIntervalWindow::Summary FrameIntervalWindow::summary(int64_t nowUs) const
+{
+  Summary summary;
+  const int64_t last = m_lastUs.load(std::memory_order_relaxed);
+  const uint64_t count = m_count.load(std::memory_order_acquire);
+  if (!count || nowUs - last > kMaxIntervalUs) {
+    return summary;
+  }
+
+  const size_t intervals = size_t(std::min<uint64_t>(count, kCapacity));
+  uint64_t sum = 0;
+  uint32_t longest = 0;
+  for (size_t i = 0; i < intervals; ++i) {
+    uint32_t interval = m_intervals[i].load(std::memory_order_relaxed);
+    sum += interval;
+    longest = std::max(longest, interval);
+  }
+  const double mean = double(sum) / double(intervals);
+  double squares = 0.0;
+  for (size_t i = 0; i < intervals; ++i) {
+    double deviation = double(m_intervals[i].load(std::memory_order_relaxed)) - mean;
+    squares += deviation * deviation;
+  }
+
+  summary.intervals = intervals;
+  summary.fps = mean > 0.0 ? 1000000.0 / mean : 0.0;
+  summary.meanIntervalMs = mean / 1000.0;
+  summary.jitterMs = std::sqrt(squares / double(intervals)) / 1000.0;
+  summary.maxIntervalMs = double(longest) / 1000.0;
+  return summary;
+}
+
+void RenderStats::frameReceived(int64_t nowUs)
+{
+  m_received.fetch_add(1, std::memory_order_relaxed);
+  m_receiving.add(nowUs);
+}
+
+void RenderStats::frameDisplayed(int64_t nowUs)
+{
+  m_displayed.fetch_add(1, std::memory_order_relaxed);
+  m_displaying.add(nowUs);
+}
+
+RenderStats::Snapshot RenderStats::snapshot(int64_t nowUs) const
+{
+  Snapshot snapshot;
+  snapshot.received = m_received.load(std::memory_order_relaxed);
+  snapshot.displayed = m_displayed.load(std::memory_order_relaxed);
+  snapshot.dropped = m_dropped.load(std::memory_order_relaxed);
+  snapshot.receiving = m_receiving.summary(nowUs);
+  snapshot.displaying = m_displaying.summary(nowUs);
+  return snapshot;
+}
+
+}
@@ -0,0 +1,163 @@
+//
+//  Resampler.cpp
+//  ti.vonage
+//
+
+#include "tivonage/Resampler.h"
+
+#include "FilterRows.h"
+#include "tivonage/Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace tivonage {
+
+static const int kMaxFactor = 1024;
+// Input is converted in blocks of this many samples, so the history buffer
+// is allocated once.
+static const size_t kBlockSamples = 1024;
+// Taps per phase are rounded up to whole AVX2 vectors, widening the window.
+static const int kTapAlignment = 16;
+// The low-pass cutoff, as a fraction of the lower rate's Nyquist frequency,
+// leaves room for the transition band below it.
+static const double kCutoff = 0.92;
+static const double kKaiserBeta = 8.6;
+// Each phase's taps sum to 1.0 in Q14. Q14 rather than Q15 keeps the 32-bit
+// dot product from overflowing: even a full-scale input of alternating sign
+// stays below 2^31 while a phase's absolute tap sum stays below 4.
+static const int kTapShift = 14;
+
+static double besselI0(double x)
+{
+  double sum = 1.0;
+  double term = 1.0;
+  for (int k = 1; k < 50; ++k) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+    if (term < sum * 1e-12) {
+      break;
+    }
+  }
+  return sum;
+}
+
+// The prototype low-pass runs at up * inputRate; phase p of output n uses
+// its taps p, p + up, p + 2 up, ... against the newest input samples.
+static std::vector<int16_t> makeTaps(int up, int down, int tapsPerPhase)
+{
+  const int length = up * tapsPerPhase;
+  const double center = (length - 1) / 2.0;
+  const double cutoff = 0.5 * kCutoff / std::max(up, down);
+  const double window = besselI0(kKaiserBeta);
+  std::vector<double> prototype(size_t(length), 0.0);
+  for (int n = 0; n < length; ++n) {
+    double t = n - center;
+    double x = 2.0 * cutoff * t;
+    double sinc = std::abs(x) < 1e-12 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+    double r = t / (center + 0.5);
+    prototype[size_t(n)] = 2.0 * cutoff * sinc * besselI0(kKaiserBeta * std::sqrt(std::max(0.0, 1.0 - r * r))) / window;
+  }
+
+  std::vector<int16_t> taps(size_t(length), 0);
+  const double unity = double(1 << kTapShift);
+  for (int phase = 0; phase < up; ++phase) {
+    double sum = 0.0;
+    for (int k = 0; k < tapsPerPhase; ++k) {
+      sum += prototype[size_t(k * up + phase)];
+    }
+    // Rounding error goes into the largest tap, so every phase has exactly
+    // unity gain at DC.
+    int16_t *phaseTaps = taps.data() + size_t(phase) * size_t(tapsPerPhase);
+    int total = 0;
+    int largest = 0;
+    for (int k = 0; k < tapsPerPhase; ++k) {
+      int value = int(std::lround(prototype[size_t(k * up + phase)] / sum * unity));
+      phaseTaps[tapsPerPhase - 1 - k] = int16_t(value);
+      total += value;
+      if (std::abs(value) > std::abs(phaseTaps[largest])) {
+        largest = tapsPerPhase - 1 - k;
+      }
+    }
+    phaseTaps[largest] = int16_t(phaseTaps[largest] + (1 << kTapShift) - total);
+  }
+  return taps;
+}
+
+std::unique_ptr<Resampler> Resampler::create(int inputRate, int outputRate)
+{
+  if (inputRate <= 0 || outputRate <= 0) {
+    return nullptr;
+  }
+  int divisor = std::gcd(inputRate, outputRate);
+  int up = outputRate / divisor;
+  int down = inputRate / divisor;
+  if (up > kMaxFactor || down > kMaxFactor) {
+    return nullptr;
+  }
+  if (up == down) {
+    return std::unique_ptr<Resampler>(new Resampler(inputRate, outputRate, 1, 1, 1, std::vector<int16_t>()));
+  }
+  // Downsampling stretches the sinc over down / up input samples per zero
+  // crossing.
+  int taps = (2 * kZeroCrossings * std::max(up, down) + up - 1) / up;
+  taps = (taps + kTapAlignment - 1) / kTapAlignment * kTapAlignment;
+  return std::unique_ptr<Resampler>(new Resampler(inputRate, outputRate, up, down, taps, makeTaps(up, down, taps)));
+}
+
+Resampler::Resampler(int inputRate, int outputRate, int up, int down, int tapsPerPhase, std::vector<int16_t> taps)
+    : m_inputRate(inputRate)
+    , m_outputRate(outputRate)
+    , m_up(up)
+    , m_down(down)
+    , m_tapsPerPhase(tapsPerPhase)
+    , m_taps(std::move(taps))
+    , m_history(size_t(tapsPerPhase - 1) + kBlockSamples, 0)
+{
+}
+
+size_t Resampler::maxOutput(size_t count) const
+{
+  return (count * size_t(m_up) + size_t(m_down) - 1) / size_t(m_down) + 1;
+}
+
+void Resampler::reset()
+{
+  std::fill(m_history.begin(), m_history.end(), int16_t(0));
+  m_position = 0;
+  m_phase = 0;
+}
+
+size_t Resampler::process(const int16_t *input, size_t count, int16_t *output)
+{
+  if (m_taps.empty()) {
+    memcpy(output, input, count * sizeof(int16_t));
+    return count;
+  }
+
+  const FilterRowKernels &kernels = filterRowKernels(activeSimdLevel());
+  const size_t history = size_t(m_tapsPerPhase - 1);
+  int16_t *buffer = m_history.data();
+  // Each output advances the input by down / up; kept as a whole part and
+  // a phase so the kernels do not divide.
+  const FilterBank bank = { m_taps.data(), m_tapsPerPhase, m_up, size_t(m_down / m_up), m_down % m_up, kTapShift };
+  size_t written = 0;
+  while (count > 0) {
+    size_t block = std::min(count, kBlockSamples);
+    memcpy(buffer + history, input, block * sizeof(int16_t));
+
+    // Output n sits at input n * down / up: its window ends at input
+    // m_position, whose newest sample is buffer[m_position + history].
+    written += kernels.filterBlock(buffer, block, bank, m_position, m_phase, output + written);
+    m_position -= block;
+
+    memmove(buffer, buffer + block, history * sizeof(int16_t));
+    input += block;
+    count -= block;
+  }
+  return written;
+}
+
+}
@@ -0,0 +1,53 @@
+//
+//  ScaleRows.h
+//  ti.vonage
+//
+//  Row kernels behind FrameScaler. Both box passes read every source
+//  sample: the vertical pass sums source rows into 16-bit column sums, and
+//  the horizontal pass reduces those sums across each box. The horizontal
+//  kernels cover power-of-two boxes; other ratios reduce in scalar code.
+//
+
+#pragma once
+
+#include "tivonage/Simd.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tivonage {
+
+struct ScaleRowKernels {
+  // accumulator[i] += source[i]
+  void (*accumulateRow)(const uint8_t *source, uint16_t *accumulator, int count);
+  // destination[i] = (row0[i] * (256 - fraction) + row1[i] * fraction + 128) >> 8, fraction in [1, 255]
+  void (*interpolateRow)(const uint8_t *row0, const uint8_t *row1, uint8_t *destination, int count, int fraction);
+  // output[x][c] = sums[2x][c] + sums[2x + 1][c] over count output pixels of
+  // 1, 2 or 4 channels. output may alias sums. Callers keep box areas at or
+  // below 256 samples so the sums cannot wrap.
+  void (*halveColumns)(const uint16_t *sums, uint16_t *output, int count, int channels);
+  // destination[i] = (sums[i] + (1 << shift >> 1)) >> shift
+  void (*shiftRow)(const uint16_t *sums, uint8_t *destination, int count, int shift);
+
+  // Rotation building blocks. destination[i][j] = source[j][i] for an 8x8
+  // block of bytes / of byte pairs (NV12 UV). Strides may be negative, which
+  // is how the 90 and 270 degree rotations flip while transposing.
+  void (*transpose8x8)(const uint8_t *source, ptrdiff_t sourceStride, uint8_t *destination, ptrdiff_t destinationStride);
+  void (*transposePairs8x8)(const uint8_t *source, ptrdiff_t sourceStride, uint8_t *destination, ptrdiff_t destinationStride);
+  // destination[i] = source[count - 1 - i], over count bytes / byte pairs.
+  void (*reverseRow)(const uint8_t *source, uint8_t *destination, int count);
+  void (*reversePairs)(const uint8_t *source, uint8_t *destination, int count);
+};
+
+const ScaleRowKernels &scalarScaleRowKernels();
+#if defined(__x86_64__) || defined(__i386__)
+const ScaleRowKernels &sse2ScaleRowKernels();
+const ScaleRowKernels &avx2ScaleRowKernels();
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+const ScaleRowKernels &neonScaleRowKernels();
+#endif
+
+const ScaleRowKernels &scaleRowKernels(SimdLevel level);
+
+}
@@ -0,0 +1,128 @@
+//
+//  ScaleRowsAVX2.cpp
+//  ti.vonage
+//
+
+#include "ScaleRows.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#define TIVONAGE_AVX2 __attribute__((target("avx2")))
+
+namespace tivonage {
+
+TIVONAGE_AVX2 static void accumulateRowAVX2(const uint8_t *source, uint16_t *accumulator, int count)
+{
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m256i bytes = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i)));
+    __m256i *sums = reinterpret_cast<__m256i *>(accumulator + i);
+    _mm256_storeu_si256(sums, _mm256_add_epi16(_mm256_loadu_si256(sums), bytes));
+  }
+  sse2ScaleRowKernels().accumulateRow(source + i, accumulator + i, count - i);
+}
+
+TIVONAGE_AVX2 static void interpolateRowAVX2(const uint8_t *row0, const uint8_t *row1, uint8_t *destination, int count, int fraction)
+{
+  const __m256i weight0 = _mm256_set1_epi16(short(256 - fraction));
+  const __m256i weight1 = _mm256_set1_epi16(short(fraction));
+  const __m256i rounding = _mm256_set1_epi16(128);
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + i)));
+    const __m256i b = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + i)));
+    __m256i sum = _mm256_add_epi16(_mm256_mullo_epi16(a, weight0), _mm256_mullo_epi16(b, weight1));
+    sum = _mm256_srli_epi16(_mm256_add_epi16(sum, rounding), 8);
+    const __m256i packed = _mm256_packus_epi16(sum, sum);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), _mm256_castsi256_si128(_mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0))));
+  }
+  sse2ScaleRowKernels().interpolateRow(row0 + i, row1 + i, destination + i, count - i, fraction);
+}
+
+TIVONAGE_AVX2 static void halveColumnsAVX2(const uint16_t *sums, uint16_t *output, int count, int channels)
+{
+  // Each 128-bit lane pairs up within itself, leaving the quarters in the
+  // order a0 b0 a1 b1; one permute puts them back in sample order.
+  const int samples = count * channels;
+  int i = 0;
+  for (; i + 16 <= samples; i += 16) {
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(sums + 2 * i));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(sums + 2 * i + 16));
+    __m256i halved;
+    if (channels == 1) {
+      halved = _mm256_hadd_epi16(a, b);
+    } else if (channels == 2) {
+      const __m256 left = _mm256_castsi256_ps(a);
+      const __m256 right = _mm256_castsi256_ps(b);
+      halved = _mm256_add_epi16(_mm256_castps_si256(_mm256_shuffle_ps(left, right, _MM_SHUFFLE(2, 0, 2, 0))),
+          _mm256_castps_si256(_mm256_shuffle_ps(left, right, _MM_SHUFFLE(3, 1, 3, 1))));
+    } else {
+      halved = _mm256_add_epi16(_mm256_unpacklo_epi64(a, b), _mm256_unpackhi_epi64(a, b));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + i), _mm256_permute4x64_epi64(halved, _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+  sse2ScaleRowKernels().halveColumns(sums + 2 * i, output + i, count - i / channels, channels);
+}
+
+TIVONAGE_AVX2 static void shiftRowAVX2(const uint16_t *sums, uint8_t *destination, int count, int shift)
+{
+  const __m256i rounding = _mm256_set1_epi16(short(1 << shift >> 1));
+  const __m128i bits = _mm_cvtsi32_si128(shift);
+  int i = 0;
+  for (; i + 32 <= count; i += 32) {
+    const __m256i low = _mm256_srl_epi16(_mm256_add_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(sums + i)), rounding), bits);
+    const __m256i high = _mm256_srl_epi16(_mm256_add_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(sums + i + 16)), rounding), bits);
+    const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), _MM_SHUFFLE(3, 1, 2, 0));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + i), packed);
+  }
+  sse2ScaleRowKernels().shiftRow(sums + i, destination + i, count - i, shift);
+}
+
+TIVONAGE_AVX2 static void reverseRowAVX2(const uint8_t *source, uint8_t *destination, int count)
+{
+  const __m256i mask = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+      15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+  int i = 0;
+  for (; i + 32 <= count; i += 32) {
+    const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + count - 32 - i));
+    const __m256i reversed = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(value, mask), _MM_SHUFFLE(1, 0, 3, 2));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + i), reversed);
+  }
+  sse2ScaleRowKernels().reverseRow(source, destination + i, count - i);
+}
+
+TIVONAGE_AVX2 static void reversePairsAVX2(const uint8_t *source, uint8_t *destination, int count)
+{
+  const __m256i mask = _mm256_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+      14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + 2 * (count - 16 - i)));
+    const __m256i reversed = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(value, mask), _MM_SHUFFLE(1, 0, 3, 2));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + 2 * i), reversed);
+  }
+  sse2ScaleRowKernels().reversePairs(source, destination + 2 * i, count - i);
+}
+
+const ScaleRowKernels &avx2ScaleRowKernels()
+{
+  // An 8x8 byte transpose fits one SSE register per output row pair, so the
+  // SSE2 transposes are used as they are.
+  static const ScaleRowKernels kernels = {
+    accumulateRowAVX2,
+    interpolateRowAVX2,
+    halveColumnsAVX2,
+    shiftRowAVX2,
+    sse2ScaleRowKernels().transpose8x8,
+    sse2ScaleRowKernels().transposePairs8x8,
+    reverseRowAVX2,
+    reversePairsAVX2,
+  };
+  return kernels;
+}
+
+}
+
+#endif
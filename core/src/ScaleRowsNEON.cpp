@@ -0,0 +1,161 @@
+//
+//  ScaleRowsNEON.cpp
+//  ti.vonage
+//
+
+#include "ScaleRows.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+namespace tivonage {
+
+static void accumulateRowNEON(const uint8_t *source, uint16_t *accumulator, int count)
+{
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const uint8x16_t bytes = vld1q_u8(source + i);
+    vst1q_u16(accumulator + i, vaddw_u8(vld1q_u16(accumulator + i), vget_low_u8(bytes)));
+    vst1q_u16(accumulator + i + 8, vaddw_u8(vld1q_u16(accumulator + i + 8), vget_high_u8(bytes)));
+  }
+  scalarScaleRowKernels().accumulateRow(source + i, accumulator + i, count - i);
+}
+
+static void interpolateRowNEON(const uint8_t *row0, const uint8_t *row1, uint8_t *destination, int count, int fraction)
+{
+  const uint8x8_t weight0 = vdup_n_u8(uint8_t(256 - fraction));
+  const uint8x8_t weight1 = vdup_n_u8(uint8_t(fraction));
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const uint8x16_t a = vld1q_u8(row0 + i);
+    const uint8x16_t b = vld1q_u8(row1 + i);
+    const uint16x8_t low = vmlal_u8(vmull_u8(vget_low_u8(a), weight0), vget_low_u8(b), weight1);
+    const uint16x8_t high = vmlal_u8(vmull_u8(vget_high_u8(a), weight0), vget_high_u8(b), weight1);
+    vst1q_u8(destination + i, vcombine_u8(vrshrn_n_u16(low, 8), vrshrn_n_u16(high, 8)));
+  }
+  scalarScaleRowKernels().interpolateRow(row0 + i, row1 + i, destination + i, count - i, fraction);
+}
+
+static void halveColumnsNEON(const uint16_t *sums, uint16_t *output, int count, int channels)
+{
+  const int samples = count * channels;
+  int i = 0;
+  for (; i + 8 <= samples; i += 8) {
+    uint16x8_t halved;
+    if (channels == 1) {
+      const uint16x8x2_t pairs = vld2q_u16(sums + 2 * i);
+      halved = vaddq_u16(pairs.val[0], pairs.val[1]);
+    } else if (channels == 2) {
+      const uint32x4x2_t pairs = vld2q_u32(reinterpret_cast<const uint32_t *>(sums + 2 * i));
+      halved = vaddq_u16(vreinterpretq_u16_u32(pairs.val[0]), vreinterpretq_u16_u32(pairs.val[1]));
+    } else {
+      const uint16x8_t a = vld1q_u16(sums + 2 * i);
+      const uint16x8_t b = vld1q_u16(sums + 2 * i + 8);
+      halved = vcombine_u16(vadd_u16(vget_low_u16(a), vget_high_u16(a)), vadd_u16(vget_low_u16(b), vget_high_u16(b)));
+    }
+    vst1q_u16(output + i, halved);
+  }
+  scalarScaleRowKernels().halveColumns(sums + 2 * i, output + i, count - i / channels, channels);
+}
+
+static void shiftRowNEON(const uint16_t *sums, uint8_t *destination, int count, int shift)
+{
+  const int16x8_t bits = vdupq_n_s16(int16_t(-shift));
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const uint16x8_t low = vrshlq_u16(vld1q_u16(sums + i), bits);
+    const uint16x8_t high = vrshlq_u16(vld1q_u16(sums + i + 8), bits);
+    vst1q_u8(destination + i, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+  }
+  scalarScaleRowKernels().shiftRow(sums + i, destination + i, count - i, shift);
+}
+
+static void transpose8x8NEON(const uint8_t *source, ptrdiff_t sourceStride, uint8_t *destination, ptrdiff_t destinationStride)
+{
+  const uint8x8x2_t t0 = vtrn_u8(vld1_u8(source), vld1_u8(source + sourceStride));
+  const uint8x8x2_t t1 = vtrn_u8(vld1_u8(source + 2 * sourceStride), vld1_u8(source + 3 * sourceStride));
+  const uint8x8x2_t t2 = vtrn_u8(vld1_u8(source + 4 * sourceStride), vld1_u8(source + 5 * sourceStride));
+  const uint8x8x2_t t3 = vtrn_u8(vld1_u8(source + 6 * sourceStride), vld1_u8(source + 7 * sourceStride));
+  const uint16x4x2_t u0 = vtrn_u16(vreinterpret_u16_u8(t0.val[0]), vreinterpret_u16_u8(t1.val[0]));
+  const uint16x4x2_t u1 = vtrn_u16(vreinterpret_u16_u8(t0.val[1]), vreinterpret_u16_u8(t1.val[1]));
+  const uint16x4x2_t u2 = vtrn_u16(vreinterpret_u16_u8(t2.val[0]), vreinterpret_u16_u8(t3.val[0]));
+  const uint16x4x2_t u3 = vtrn_u16(vreinterpret_u16_u8(t2.val[1]), vreinterpret_u16_u8(t3.val[1]));
+  // v[k].val[0] is output row k, v[k].val[1] output row k + 4.
+  const uint32x2x2_t v[4] = {
+    vtrn_u32(vreinterpret_u32_u16(u0.val[0]), vreinterpret_u32_u16(u2.val[0])),
+    vtrn_u32(vreinterpret_u32_u16(u1.val[0]), vreinterpret_u32_u16(u3.val[0])),
+    vtrn_u32(vreinterpret_u32_u16(u0.val[1]), vreinterpret_u32_u16(u2.val[1])),
+    vtrn_u32(vreinterpret_u32_u16(u1.val[1]), vreinterpret_u32_u16(u3.val[1])),
+  };
+  for (int i = 0; i < 4; ++i) {
+    vst1_u8(destination + i * destinationStride, vreinterpret_u8_u32(v[i].val[0]));
+    vst1_u8(destination + (i + 4) * destinationStride, vreinterpret_u8_u32(v[i].val[1]));
+  }
+}
+
+static void transposePairs8x8NEON(const uint8_t *source, ptrdiff_t sourceStride, uint8_t *destination, ptrdiff_t destinationStride)
+{
+  uint16x8x2_t t[4];
+  for (int i = 0; i < 4; ++i) {
+    t[i] = vtrnq_u16(vreinterpretq_u16_u8(vld1q_u8(source + 2 * i * sourceStride)), vreinterpretq_u16_u8(vld1q_u8(source + (2 * i + 1) * sourceStride)));
+  }
+  // even0 holds pairs {0, 4} and {2, 6} of rows 0-3, even1 the same for
+  // rows 4-7; odd0 / odd1 likewise for pairs {1, 5} and {3, 7}.
+  const uint32x4x2_t even0 = vtrnq_u32(vreinterpretq_u32_u16(t[0].val[0]), vreinterpretq_u32_u16(t[1].val[0]));
+  const uint32x4x2_t even1 = vtrnq_u32(vreinterpretq_u32_u16(t[2].val[0]), vreinterpretq_u32_u16(t[3].val[0]));
+  const uint32x4x2_t odd0 = vtrnq_u32(vreinterpretq_u32_u16(t[0].val[1]), vreinterpretq_u32_u16(t[1].val[1]));
+  const uint32x4x2_t odd1 = vtrnq_u32(vreinterpretq_u32_u16(t[2].val[1]), vreinterpretq_u32_u16(t[3].val[1]));
+  const uint32x4_t rows[8] = {
+    vcombine_u32(vget_low_u32(even0.val[0]), vget_low_u32(even1.val[0])),
+    vcombine_u32(vget_low_u32(odd0.val[0]), vget_low_u32(odd1.val[0])),
+    vcombine_u32(vget_low_u32(even0.val[1]), vget_low_u32(even1.val[1])),
+    vcombine_u32(vget_low_u32(odd0.val[1]), vget_low_u32(odd1.val[1])),
+    vcombine_u32(vget_high_u32(even0.val[0]), vget_high_u32(even1.val[0])),
+    vcombine_u32(vget_high_u32(odd0.val[0]), vget_high_u32(odd1.val[0])),
+    vcombine_u32(vget_high_u32(even0.val[1]), vget_high_u32(even1.val[1])),
+    vcombine_u32(vget_high_u32(odd0.val[1]), vget_high_u32(odd1.val[1])),
+  };
+  for (int i = 0; i < 8; ++i) {
+    vst1q_u8(destination + i * destinationStride, vreinterpretq_u8_u32(rows[i]));
+  }
+}
+
+static void reverseRowNEON(const uint8_t *source, uint8_t *destination, int count)
+{
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const uint8x16_t value = vrev64q_u8(vld1q_u8(source + count - 16 - i));
+    vst1q_u8(destination + i, vcombine_u8(vget_high_u8(value), vget_low_u8(value)));
+  }
+  scalarScaleRowKernels().reverseRow(source, destination + i, count - i);
+}
+
+static void reversePairsNEON(const uint8_t *source, uint8_t *destination, int count)
+{
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const uint16x8_t value = vrev64q_u16(vreinterpretq_u16_u8(vld1q_u8(source + 2 * (count - 8 - i))));
+    vst1q_u8(destination + 2 * i, vreinterpretq_u8_u16(vcombine_u16(vget_high_u16(value), vget_low_u16(value))));
+  }
+  scalarScaleRowKernels().reversePairs(source, destination + 2 * i, count - i);
+}
+
+const ScaleRowKernels &neonScaleRowKernels()
+{
+  static const ScaleRowKernels kernels = {
+    accumulateRowNEON,
+    interpolateRowNEON,
+    halveColumnsNEON,
+    shiftRowNEON,
+    transpose8x8NEON,
+    transposePairs8x8NEON,
+    reverseRowNEON,
+    reversePairsNEON,
+  };
+  return kernels;
+}
+
+}
+
+#endif
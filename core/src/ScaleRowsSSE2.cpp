@@ -0,0 +1,192 @@
+//
+//  ScaleRowsSSE2.cpp
+//  ti.vonage
+//
+
+#include "ScaleRows.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <emmintrin.h>
+
+namespace tivonage {
+
+static void accumulateRowSSE2(const uint8_t *source, uint16_t *accumulator, int count)
+{
+  const __m128i zero = _mm_setzero_si128();
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+    __m128i *sums = reinterpret_cast<__m128i *>(accumulator + i);
+    _mm_storeu_si128(sums, _mm_add_epi16(_mm_loadu_si128(sums), _mm_unpacklo_epi8(bytes, zero)));
+    _mm_storeu_si128(sums + 1, _mm_add_epi16(_mm_loadu_si128(sums + 1), _mm_unpackhi_epi8(bytes, zero)));
+  }
+  scalarScaleRowKernels().accumulateRow(source + i, accumulator + i, count - i);
+}
+
+static void interpolateRowSSE2(const uint8_t *row0, const uint8_t *row1, uint8_t *destination, int count, int fraction)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i weight0 = _mm_set1_epi16(short(256 - fraction));
+  const __m128i weight1 = _mm_set1_epi16(short(fraction));
+  const __m128i rounding = _mm_set1_epi16(128);
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + i));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + i));
+    // At most 255 * 256 + 128, so unsigned 16-bit lanes are exact.
+    __m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), weight0), _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), weight1));
+    __m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), weight0), _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), weight1));
+    low = _mm_srli_epi16(_mm_add_epi16(low, rounding), 8);
+    high = _mm_srli_epi16(_mm_add_epi16(high, rounding), 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), _mm_packus_epi16(low, high));
+  }
+  scalarScaleRowKernels().interpolateRow(row0 + i, row1 + i, destination + i, count - i, fraction);
+}
+
+static void halveColumnsSSE2(const uint16_t *sums, uint16_t *output, int count, int channels)
+{
+  // Eight output samples per step from sixteen sums; the samples of a pixel
+  // sit in one word, dword or qword, so the pairs are neighbouring lanes of
+  // that size.
+  const int samples = count * channels;
+  int i = 0;
+  for (; i + 8 <= samples; i += 8) {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sums + 2 * i));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sums + 2 * i + 8));
+    __m128i halved;
+    if (channels == 1) {
+      // The low word of each dword gets the pair's sum; sign-extending it
+      // lets the saturating pack keep the bit pattern.
+      const __m128i low = _mm_srai_epi32(_mm_slli_epi32(_mm_add_epi16(a, _mm_srli_epi32(a, 16)), 16), 16);
+      const __m128i high = _mm_srai_epi32(_mm_slli_epi32(_mm_add_epi16(b, _mm_srli_epi32(b, 16)), 16), 16);
+      halved = _mm_packs_epi32(low, high);
+    } else if (channels == 2) {
+      const __m128 left = _mm_castsi128_ps(a);
+      const __m128 right = _mm_castsi128_ps(b);
+      halved = _mm_add_epi16(_mm_castps_si128(_mm_shuffle_ps(left, right, _MM_SHUFFLE(2, 0, 2, 0))),
+          _mm_castps_si128(_mm_shuffle_ps(left, right, _MM_SHUFFLE(3, 1, 3, 1))));
+    } else {
+      halved = _mm_add_epi16(_mm_unpacklo_epi64(a, b), _mm_unpackhi_epi64(a, b));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), halved);
+  }
+  scalarScaleRowKernels().halveColumns(sums + 2 * i, output + i, count - i / channels, channels);
+}
+
+static void shiftRowSSE2(const uint16_t *sums, uint8_t *destination, int count, int shift)
+{
+  const __m128i rounding = _mm_set1_epi16(short(1 << shift >> 1));
+  const __m128i bits = _mm_cvtsi32_si128(shift);
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    // At most 255 << shift plus the rounding, so the unsigned add is exact.
+    const __m128i low = _mm_srl_epi16(_mm_add_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(sums + i)), rounding), bits);
+    const __m128i high = _mm_srl_epi16(_mm_add_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(sums + i + 8)), rounding), bits);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), _mm_packus_epi16(low, high));
+  }
+  scalarScaleRowKernels().shiftRow(sums + i, destination + i, count - i, shift);
+}
+
+static void transpose8x8SSE2(const uint8_t *source, ptrdiff_t sourceStride, uint8_t *destination, ptrdiff_t destinationStride)
+{
+  __m128i rows[8];
+  for (int i = 0; i < 8; ++i) {
+    rows[i] = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(source + i * sourceStride));
+  }
+  const __m128i a0 = _mm_unpacklo_epi8(rows[0], rows[1]);
+  const __m128i a1 = _mm_unpacklo_epi8(rows[2], rows[3]);
+  const __m128i a2 = _mm_unpacklo_epi8(rows[4], rows[5]);
+  const __m128i a3 = _mm_unpacklo_epi8(rows[6], rows[7]);
+  const __m128i b0 = _mm_unpacklo_epi16(a0, a1);
+  const __m128i b1 = _mm_unpackhi_epi16(a0, a1);
+  const __m128i b2 = _mm_unpacklo_epi16(a2, a3);
+  const __m128i b3 = _mm_unpackhi_epi16(a2, a3);
+  // Each register now holds two output rows of eight bytes.
+  const __m128i columns[4] = {
+    _mm_unpacklo_epi32(b0, b2),
+    _mm_unpackhi_epi32(b0, b2),
+    _mm_unpacklo_epi32(b1, b3),
+    _mm_unpackhi_epi32(b1, b3),
+  };
+  for (int i = 0; i < 4; ++i) {
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(destination + 2 * i * destinationStride), columns[i]);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(destination + (2 * i + 1) * destinationStride), _mm_srli_si128(columns[i], 8));
+  }
+}
+
+static void transposePairs8x8SSE2(const uint8_t *source, ptrdiff_t sourceStride, uint8_t *destination, ptrdiff_t destinationStride)
+{
+  __m128i rows[8];
+  for (int i = 0; i < 8; ++i) {
+    rows[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i * sourceStride));
+  }
+  __m128i a[8];
+  for (int i = 0; i < 4; ++i) {
+    a[2 * i] = _mm_unpacklo_epi16(rows[2 * i], rows[2 * i + 1]);
+    a[2 * i + 1] = _mm_unpackhi_epi16(rows[2 * i], rows[2 * i + 1]);
+  }
+  // b[k] holds pairs 2k and 2k+1 of rows 0-3, b[k + 4] the same of rows 4-7.
+  const __m128i b[8] = {
+    _mm_unpacklo_epi32(a[0], a[2]),
+    _mm_unpackhi_epi32(a[0], a[2]),
+    _mm_unpacklo_epi32(a[1], a[3]),
+    _mm_unpackhi_epi32(a[1], a[3]),
+    _mm_unpacklo_epi32(a[4], a[6]),
+    _mm_unpackhi_epi32(a[4], a[6]),
+    _mm_unpacklo_epi32(a[5], a[7]),
+    _mm_unpackhi_epi32(a[5], a[7]),
+  };
+  for (int i = 0; i < 4; ++i) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + 2 * i * destinationStride), _mm_unpacklo_epi64(b[i], b[i + 4]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + (2 * i + 1) * destinationStride), _mm_unpackhi_epi64(b[i], b[i + 4]));
+  }
+}
+
+// Reverses the eight 16-bit lanes of a register.
+static inline __m128i reverseWords(__m128i value)
+{
+  value = _mm_shuffle_epi32(value, _MM_SHUFFLE(0, 1, 2, 3));
+  value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+  return _mm_shufflehi_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+static void reverseRowSSE2(const uint8_t *source, uint8_t *destination, int count)
+{
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m128i value = reverseWords(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + count - 16 - i)));
+    value = _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), value);
+  }
+  scalarScaleRowKernels().reverseRow(source, destination + i, count - i);
+}
+
+static void reversePairsSSE2(const uint8_t *source, uint8_t *destination, int count)
+{
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 2 * (count - 8 - i)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + 2 * i), reverseWords(value));
+  }
+  scalarScaleRowKernels().reversePairs(source, destination + 2 * i, count - i);
+}
+
+const ScaleRowKernels &sse2ScaleRowKernels()
+{
+  static const ScaleRowKernels kernels = {
+    accumulateRowSSE2,
+    interpolateRowSSE2,
+    halveColumnsSSE2,
+    shiftRowSSE2,
+    transpose8x8SSE2,
+    transposePairs8x8SSE2,
+    reverseRowSSE2,
+    reversePairsSSE2,
+  };
+  return kernels;
+}
+
+}
+
+#endif
@@ -0,0 +1,125 @@
+//
+//  ScaleRowsScalar.cpp
+//  ti.vonage
+//
+
+#include "ScaleRows.h"
+
+namespace tivonage {
+
+static void accumulateRowScalar(const uint8_t *source, uint16_t *accumulator, int count)
+{
+  for (int i = 0; i < count; ++i) {
+    accumulator[i] = uint16_t(accumulator[i] + source[i]);
+  }
+}
+
+static void interpolateRowScalar(const uint8_t *row0, const uint8_t *row1, uint8_t *destination, int count, int fraction)
+{
+  int inverse = 256 - fraction;
+  for (int i = 0; i < count; ++i) {
+    destination[i] = uint8_t((row0[i] * inverse + row1[i] * fraction + 128) >> 8);
+  }
+}
+
+template <int Channels>
+static void halveColumns(const uint16_t *sums, uint16_t *output, int count)
+{
+  for (int x = 0; x < count; ++x) {
+    for (int channel = 0; channel < Channels; ++channel) {
+      output[x * Channels + channel] = uint16_t(sums[2 * x * Channels + channel] + sums[(2 * x + 1) * Channels + channel]);
+    }
+  }
+}
+
+static void halveColumnsScalar(const uint16_t *sums, uint16_t *output, int count, int channels)
+{
+  switch (channels) {
+  case 1:
+    halveColumns<1>(sums, output, count);
+    break;
+  case 2:
+    halveColumns<2>(sums, output, count);
+    break;
+  default:
+    halveColumns<4>(sums, output, count);
+    break;
+  }
+}
+
+static void shiftRowScalar(const uint16_t *sums, uint8_t *destination, int count, int shift)
+{
+  const int rounding = 1 << shift >> 1;
+  for (int i = 0; i < count; ++i) {
+    destination[i] = uint8_t((sums[i] + rounding) >> shift);
+  }
+}
+
+static void transpose8x8Scalar(const uint8_t *source, ptrdiff_t sourceStride, uint8_t *destination, ptrdiff_t destinationStride)
+{
+  for (int i = 0; i < 8; ++i) {
+    for (int j = 0; j < 8; ++j) {
+      destination[i * destinationStride + j] = source[j * sourceStride + i];
+    }
+  }
+}
+
+static void transposePairs8x8Scalar(const uint8_t *source, ptrdiff_t sourceStride, uint8_t *destination, ptrdiff_t destinationStride)
+{
+  for (int i = 0; i < 8; ++i) {
+    for (int j = 0; j < 8; ++j) {
+      destination[i * destinationStride + 2 * j] = source[j * sourceStride + 2 * i];
+      destination[i * destinationStride + 2 * j + 1] = source[j * sourceStride + 2 * i + 1];
+    }
+  }
+}
+
+static void reverseRowScalar(const uint8_t *source, uint8_t *destination, int count)
+{
+  for (int i = 0; i < count; ++i) {
+    destination[i] = source[count - 1 - i];
+  }
+}
+
+static void reversePairsScalar(const uint8_t *source, uint8_t *destination, int count)
+{
+  for (int i = 0; i < count; ++i) {
+    destination[2 * i] = source[2 * (count - 1 - i)];
+    destination[2 * i + 1] = source[2 * (count - 1 - i) + 1];
+  }
+}
+
+const ScaleRowKernels &scalarScaleRowKernels()
+{
+  static const ScaleRowKernels kernels = {
+    accumulateRowScalar,
+    interpolateRowScalar,
+    halveColumnsScalar,
+    shiftRowScalar,
+    transpose8x8Scalar,
+    transposePairs8x8Scalar,
+    reverseRowScalar,
+    reversePairsScalar,
+  };
+  return kernels;
+}
+
+const ScaleRowKernels &scaleRowKernels(SimdLevel level)
+{
+  switch (level) {
+#if defined(__x86_64__) || defined(__i386__)
+  case SimdLevel::SSE2:
+    return sse2ScaleRowKernels();
+  case SimdLevel::AVX2:
+    return avx2ScaleRowKernels();
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  case SimdLevel::NEON:
+    return neonScaleRowKernels();
+#endif
+  default:
+    return scalarScaleRowKernels();
+  }
+}
+
+}
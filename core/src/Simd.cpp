@@ -0,0 +1,59 @@
+//
+//  Simd.cpp
+//  ti.vonage
+//
+
+#include "tivonage/Simd.h"
+
+#include <atomic>
+
+namespace tivonage {
+
+static std::atomic<int> simdLevelLimit { int(SimdLevel::NEON) };
+
+SimdLevel detectedSimdLevel()
+{
+#if defined(__aarch64__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+  return SimdLevel::NEON;
+#elif defined(__x86_64__) || defined(__i386__)
+  static const SimdLevel level = __builtin_cpu_supports("avx2") ? SimdLevel::AVX2 : SimdLevel::SSE2;
+  return level;
+#else
+  return SimdLevel::Scalar;
+#endif
+}
+
+SimdLevel activeSimdLevel()
+{
+  SimdLevel detected = detectedSimdLevel();
+  int limit = simdLevelLimit.load(std::memory_order_relaxed);
+  if (limit == int(SimdLevel::Scalar)) {
+    return SimdLevel::Scalar;
+  }
+  if (detected == SimdLevel::AVX2 && limit == int(SimdLevel::SSE2)) {
+    return SimdLevel::SSE2;
+  }
+  return detected;
+}
+
+void setSimdLevelLimit(SimdLevel limit)
+{
+  simdLevelLimit.store(int(limit), std::memory_order_relaxed);
+}
+
+const char *simdLevelName(SimdLevel level)
+{
+  switch (level) {
+  case SimdLevel::Scalar:
+    return "scalar";
+  case SimdLevel::SSE2:
+    return "sse2";
+  case SimdLevel::AVX2:
+    return "avx2";
+  case SimdLevel::NEON:
+    return "neon";
+  }
+  return "unknown";
+}
+
+}
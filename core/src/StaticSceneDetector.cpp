@@ -0,0 +1,101 @@
+//
+//  StaticSceneDetector.cpp
+//  ti.vonage
+//
+
+#include "tivonage/StaticSceneDetector.h"
+
+#include "CompareRows.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace tivonage {
+
+StaticSceneDetector::StaticSceneDetector()
+    : StaticSceneDetector(Config())
+{
+}
+
+StaticSceneDetector::StaticSceneDetector(const Config &config)
+    : m_config(config)
+{
+  m_config.rowStep = std::min(std::max(m_config.rowStep, 1), kTileSize);
+}
+
+void StaticSceneDetector::reset()
+{
+  m_hasPrevious = false;
+  m_static = false;
+  m_motion = 0.0;
+}
+
+float StaticSceneDetector::frameRate(float fullRate) const
+{
+  return m_static ? std::min(fullRate, m_config.staticFrameRate) : fullRate;
+}
+
+bool StaticSceneDetector::update(const VideoFrame &frame, int64_t nowUs)
+{
+  if (frame.format == PixelFormat::ARGB || frame.width <= 0 || frame.height <= 0 || !frame.planes[0].data) {
+    return false;
+  }
+  const bool wasStatic = m_static;
+  const int width = frame.width;
+  const int height = frame.height;
+  const int step = m_config.rowStep;
+  const int sampledRows = (height + step - 1) / step;
+  if (!m_hasPrevious || width != m_width || height != m_height) {
+    m_width = width;
+    m_height = height;
+    m_previous.resize(size_t(width) * size_t(sampledRows));
+    for (int row = 0; row < sampledRows; ++row) {
+      memcpy(&m_previous[size_t(row) * size_t(width)], frame.planes[0].data + row * step * frame.planes[0].stride, size_t(width));
+    }
+    m_hasPrevious = true;
+    m_static = false;
+    m_quietSinceUs = nowUs;
+    m_motion = 1.0;
+    return wasStatic;
+  }
+
+  const CompareRowKernels &kernels = compareRowKernels(activeSimdLevel());
+  const int columns = (width + kTileSize - 1) / kTileSize;
+  const int rows = (height + kTileSize - 1) / kTileSize;
+  m_tileSums.resize(size_t(columns));
+  int changed = 0;
+  for (int tileRow = 0; tileRow < rows; ++tileRow) {
+    std::fill(m_tileSums.begin(), m_tileSums.end(), 0u);
+    const int firstLine = tileRow * kTileSize;
+    const int lastLine = std::min(firstLine + kTileSize, height);
+    int lines = 0;
+    // Sampled lines are the multiples of step; start at the first one in
+    // this tile row.
+    for (int line = (firstLine + step - 1) / step * step; line < lastLine; line += step, ++lines) {
+      const uint8_t *current = frame.planes[0].data + line * frame.planes[0].stride;
+      uint8_t *previous = &m_previous[size_t(line / step) * size_t(width)];
+      for (int column = 0; column < columns; ++column) {
+        const int x = column * kTileSize;
+        m_tileSums[size_t(column)] += kernels.sadRow(current + x, previous + x, std::min(kTileSize, width - x));
+      }
+      memcpy(previous, current, size_t(width));
+    }
+    for (int column = 0; column < columns && lines > 0; ++column) {
+      const int tileWidth = std::min(kTileSize, width - column * kTileSize);
+      if (m_tileSums[size_t(column)] > uint32_t(m_config.tileThreshold * tileWidth * lines)) {
+        ++changed;
+      }
+    }
+  }
+
+  m_motion = double(changed) / double(columns * rows);
+  if (m_motion >= m_config.motionFraction) {
+    m_static = false;
+    m_quietSinceUs = nowUs;
+  } else if (nowUs - m_quietSinceUs >= m_config.staticDelayUs) {
+    m_static = true;
+  }
+  return m_static != wasStatic;
+}
+
+}
@@ -0,0 +1,131 @@
+//
+//  SubscriptionController.cpp
+//  ti.vonage
+//
+
+#include "tivonage/SubscriptionController.h"
+
+#include "tivonage/FrameScaler.h"
+
+#include <algorithm>
+
+namespace tivonage {
+
+SubscriptionController::SubscriptionController()
+    : SubscriptionController(Config())
+{
+}
+
+SubscriptionController::SubscriptionController(const Config &config)
+    : m_config(config)
+{
+}
+
+void SubscriptionController::setVisible(bool visible, int64_t nowUs)
+{
+  if (visible == m_visible) {
+    return;
+  }
+  m_visible = visible;
+  if (!visible) {
+    m_hiddenSinceUs = nowUs;
+  }
+}
+
+void SubscriptionController::setStreamSize(int width, int height)
+{
+  m_streamWidth = width;
+  m_streamHeight = height;
+}
+
+void SubscriptionController::setViewSize(int width, int height)
+{
+  m_viewWidth = width;
+  m_viewHeight = height;
+}
+
+void SubscriptionController::setHighPriority(bool highPriority)
+{
+  m_highPriority = highPriority;
+}
+
+// The smallest layer index priority allows; only applies once the stream's
+// size, and so its layers, are known.
+int SubscriptionController::priorityLayer() const
+{
+  if (m_highPriority || m_streamWidth <= 0 || m_streamHeight <= 0) {
+    return 0;
+  }
+  return std::clamp(m_config.lowPriorityLayer, 0, m_config.layerCount - 1);
+}
+
+int SubscriptionController::smallestFittingLayer(double tolerance) const
+{
+  if (m_streamWidth <= 0 || m_streamHeight <= 0 || m_viewWidth <= 0 || m_viewHeight <= 0) {
+    return 0;
+  }
+  // What an aspect-fill view of this size shows of the full-size stream.
+  int neededWidth = 0;
+  int neededHeight = 0;
+  scaledSizeToFill(m_streamWidth, m_streamHeight, m_viewWidth, m_viewHeight, neededWidth, neededHeight);
+
+  int layer = 0;
+  while (layer + 1 < m_config.layerCount) {
+    int width = m_streamWidth >> (layer + 1);
+    int height = m_streamHeight >> (layer + 1);
+    if (width < neededWidth * tolerance || height < neededHeight * tolerance) {
+      break;
+    }
+    ++layer;
+  }
+  return layer;
+}
+
+bool SubscriptionController::update(int64_t nowUs)
+{
+  Decision decision = m_decision;
+  decision.video = m_visible || nowUs - m_hiddenSinceUs < m_config.hideDelayUs;
+
+  int target = std::max(smallestFittingLayer(m_config.upscaleTolerance), priorityLayer());
+  bool sized = m_streamWidth > 0 && m_streamHeight > 0 && m_viewWidth > 0 && m_viewHeight > 0;
+  if (sized && !m_sized) {
+    // Nothing to be hysteretic about yet: start on the right layer.
+    m_layer = target;
+    m_pendingLayer = target;
+  } else if (target < m_layer) {
+    m_layer = target;
+    m_pendingLayer = target;
+  } else if (target > m_layer) {
+    int strict = std::max(smallestFittingLayer(1.0), priorityLayer());
+    if (strict <= m_layer) {
+      // Only fits thanks to the tolerance: inside the hysteresis band.
+      m_pendingLayer = m_layer;
+    } else if (strict != m_pendingLayer) {
+      m_pendingLayer = strict;
+      m_pendingSinceUs = nowUs;
+    } else if (nowUs - m_pendingSinceUs >= m_config.downgradeDelayUs) {
+      m_layer = strict;
+    }
+  } else {
+    m_pendingLayer = m_layer;
+  }
+
+  m_sized = sized;
+
+  if (m_layer == 0) {
+    decision.preferredWidth = 0;
+    decision.preferredHeight = 0;
+  } else {
+    decision.preferredWidth = m_streamWidth >> m_layer;
+    decision.preferredHeight = m_streamHeight >> m_layer;
+  }
+  decision.preferredFrameRate = m_layer > 0 && m_layer == m_config.layerCount - 1 ? m_config.smallestLayerFrameRate : 0.0f;
+
+  if (decision == m_decision) {
+    return false;
+  }
+  m_decision = decision;
+  return true;
+}
+
+}
@@ -0,0 +1,202 @@
+//
+//  SyntheticVideoSource.cpp
+//  ti.vonage
+//
+
+#include "tivonage/SyntheticVideoSource.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace tivonage {
+
+static const int kPatternWidth = 640;
+static const int kPatternHeight = 480;
+static const double kPatternFrameRate = 30.0;
+
+// 75% colour bars in video-range BT.601: white, yellow, cyan, green,
+// magenta, red, blue.
+static const uint8_t kBars[7][3] = {
+  { 180, 128, 128 },
+  { 162, 44, 142 },
+  { 131, 156, 44 },
+  { 112, 72, 58 },
+  { 84, 184, 198 },
+  { 65, 100, 212 },
+  { 35, 212, 114 },
+};
+
+void drawTestPattern(VideoFrame &frame, uint64_t index)
+{
+  if (frame.format == PixelFormat::ARGB || frame.width <= 0 || frame.height <= 0) {
+    return;
+  }
+  const int width = frame.width;
+  const int height = frame.height;
+  const int chromaWidth = (width + 1) / 2;
+  const int barRows = (height * 3 / 4) & ~1;
+  // The box crosses the frame in about two seconds at 30 fps.
+  const int boxWidth = std::max(2, (width / 8) & ~1);
+  const int step = std::max(2, (width / 60) & ~1);
+  const int boxX = int((index * uint64_t(step)) % uint64_t(width)) & ~1;
+
+  for (int y = 0; y < height; ++y) {
+    uint8_t *luma = frame.planes[0].data + y * frame.planes[0].stride;
+    if (y < barRows) {
+      for (int bar = 0; bar < 7; ++bar) {
+        const int left = width * bar / 7;
+        memset(luma + left, kBars[bar][0], size_t(width * (bar + 1) / 7 - left));
+      }
+      continue;
+    }
+    for (int x = 0; x < width; ++x) {
+      luma[x] = uint8_t(16 + 219 * x / std::max(width - 1, 1));
+    }
+    memset(luma + boxX, 235, size_t(std::min(boxWidth, width - boxX)));
+  }
+
+  for (int y = 0; y < (height + 1) / 2; ++y) {
+    const bool bars = 2 * y < barRows;
+    uint8_t *first = frame.planes[1].data + y * frame.planes[1].stride;
+    uint8_t *second = frame.format == PixelFormat::I420 ? frame.planes[2].data + y * frame.planes[2].stride : nullptr;
+    for (int x = 0; x < chromaWidth; ++x) {
+      const int bar = std::min(2 * x * 7 / width, 6);
+      const uint8_t u = bars ? kBars[bar][1] : 128;
+      const uint8_t v = bars ? kBars[bar][2] : 128;
+      if (second) {
+        first[x] = u;
+        second[x] = v;
+      } else {
+        first[2 * x] = u;
+        first[2 * x + 1] = v;
+      }
+    }
+  }
+}
+
+std::unique_ptr<SyntheticVideoSource> SyntheticVideoSource::create(const Config &config, Consumer consumer)
+{
+  if (!consumer || config.frameRate < 0) {
+    return nullptr;
+  }
+  std::unique_ptr<Y4mReader> reader;
+  int width = kPatternWidth;
+  int height = kPatternHeight;
+  double frameRate = kPatternFrameRate;
+  if (!config.path.empty()) {
+    reader = Y4mReader::open(config.path);
+    if (!reader) {
+      return nullptr;
+    }
+    width = reader->width();
+    height = reader->height();
+    frameRate = reader->frameRate();
+  }
+  if (config.width > 0 || config.height > 0) {
+    width = config.width;
+    height = config.height;
+  }
+  if (config.frameRate > 0) {
+    frameRate = config.frameRate;
+  }
+  if (width <= 0 || height <= 0 || (width & 1) || (height & 1)) {
+    return nullptr;
+  }
+  return std::unique_ptr<SyntheticVideoSource>(
+      new SyntheticVideoSource(config, std::move(consumer), std::move(reader), width, height, frameRate));
+}
+
+static DeadlinePacer::Config pacerConfig(const SyntheticVideoSource::Config &config, double frameRate)
+{
+  DeadlinePacer::Config pacer;
+  pacer.intervalUs = 1000000.0 / frameRate;
+  pacer.realTime = config.realTime;
+  pacer.tickLimit = config.frameLimit;
+  return pacer;
+}
+
+SyntheticVideoSource::SyntheticVideoSource(
+    const Config &config, Consumer consumer, std::unique_ptr<Y4mReader> reader, int width, int height, double frameRate)
+    : m_config(config)
+    , m_consumer(std::move(consumer))
+    , m_reader(std::move(reader))
+    , m_width(width)
+    , m_height(height)
+    , m_frameRate(frameRate)
+    , m_scaler(ScaleFilter::Bilinear)
+    , m_pacer(pacerConfig(config, frameRate), [this](uint64_t index) { produceFrame(index); })
+{
+  // Files of the output size are read straight from the mapping; anything
+  // else is drawn or scaled into one reused buffer.
+  if (!m_reader || m_reader->width() != width || m_reader->height() != height) {
+    m_buffer = FrameBuffer::create(PixelFormat::I420, width, height);
+  }
+}
+
+SyntheticVideoSource::~SyntheticVideoSource()
+{
+  stop();
+}
+
+bool SyntheticVideoSource::start()
+{
+  return m_pacer.start();
+}
+
+void SyntheticVideoSource::stop()
+{
+  m_pacer.stop();
+}
+
+void SyntheticVideoSource::wait()
+{
+  m_pacer.wait();
+}
+
+SyntheticVideoSource::Stats SyntheticVideoSource::stats() const
+{
+  DeadlinePacer::Stats pacer = m_pacer.stats();
+  Stats stats;
+  stats.frames = pacer.ticks;
+  stats.skipped = pacer.skipped;
+  stats.meanLatenessUs = pacer.meanLatenessUs;
+  stats.maxLatenessUs = pacer.maxLatenessUs;
+  stats.elapsedUs = pacer.elapsedUs;
+  return stats;
+}
+
+bool SyntheticVideoSource::renderFrame(uint64_t index, VideoFrame &frame)
+{
+  if (m_reader) {
+    VideoFrame source;
+    if (!m_reader->frame(size_t(index % m_reader->frameCount()), source)) {
+      return false;
+    }
+    if (!m_buffer) {
+      frame = source;
+    } else if (m_scaler.scale(source, m_buffer->frame())) {
+      frame = m_buffer->frame();
+    } else {
+      return false;
+    }
+  } else {
+    if (!m_buffer) {
+      return false;
+    }
+    drawTestPattern(m_buffer->frame(), index);
+    frame = m_buffer->frame();
+  }
+  frame.timestampUs = int64_t(std::llround(double(index) * 1000000.0 / m_frameRate));
+  return true;
+}
+
+void SyntheticVideoSource::produceFrame(uint64_t index)
+{
+  VideoFrame frame;
+  if (renderFrame(index, frame)) {
+    m_consumer(frame);
+  }
+}
+
+}
@@ -0,0 +1,81 @@
+//
+//  TileHasher.cpp
+//  ti.vonage
+//
+
+#include "tivonage/TileHasher.h"
+
+#include "CompareRows.h"
+
+#include <algorithm>
+
+namespace tivonage {
+
+static uint32_t finishHash(const uint32_t lanes[kHashLanes])
+{
+  uint32_t hash = 0;
+  for (int lane = 0; lane < kHashLanes; ++lane) {
+    hash = (hash ^ lanes[lane]) * 0x9E3779B1u;
+  }
+  return hash ^ (hash >> 16);
+}
+
+void TileHasher::reset()
+{
+  m_valid = false;
+}
+
+int TileHasher::update(const VideoFrame &frame)
+{
+  if (frame.width <= 0 || frame.height <= 0 || !frame.planes[0].data) {
+    return 0;
+  }
+  const int columns = (frame.width + kTileSize - 1) / kTileSize;
+  const int rows = (frame.height + kTileSize - 1) / kTileSize;
+  const bool sameGrid = m_valid && frame.format == m_format && frame.width == m_width && frame.height == m_height;
+  if (!sameGrid) {
+    m_format = frame.format;
+    m_width = frame.width;
+    m_height = frame.height;
+    m_columns = columns;
+    m_rows = rows;
+    m_hashes.resize(size_t(columns * rows));
+    m_dirty.resize(size_t(columns * rows));
+    m_lanes.resize(size_t(columns * kHashLanes));
+  }
+
+  const CompareRowKernels &kernels = compareRowKernels(activeSimdLevel());
+  const int rowBytes = planeRowBytes(frame.format, 0, frame.width);
+  const int tileBytes = rowBytes / frame.width * kTileSize;
+  const VideoPlane &plane = frame.planes[0];
+  int dirtyCount = 0;
+  for (int row = 0; row < rows; ++row) {
+    // Seeding each lane differently keeps identical words in different lanes
+    // from cancelling out.
+    for (int column = 0; column < columns; ++column) {
+      for (int lane = 0; lane < kHashLanes; ++lane) {
+        m_lanes[size_t(column * kHashLanes + lane)] = uint32_t(lane + 1) * 0x85EBCA77u;
+      }
+    }
+    const int lastLine = std::min((row + 1) * kTileSize, frame.height);
+    for (int line = row * kTileSize; line < lastLine; ++line) {
+      const uint8_t *data = plane.data + size_t(line) * size_t(plane.stride);
+      for (int column = 0; column < columns; ++column) {
+        const int offset = column * tileBytes;
+        kernels.hashRow(data + offset, std::min(tileBytes, rowBytes - offset), &m_lanes[size_t(column * kHashLanes)]);
+      }
+    }
+    for (int column = 0; column < columns; ++column) {
+      const size_t tile = size_t(row * columns + column);
+      const uint32_t hash = finishHash(&m_lanes[size_t(column * kHashLanes)]);
+      const bool dirty = !sameGrid || hash != m_hashes[tile];
+      m_hashes[tile] = hash;
+      m_dirty[tile] = dirty;
+      dirtyCount += dirty;
+    }
+  }
+  m_valid = true;
+  return dirtyCount;
+}
+
+}
@@ -0,0 +1,40 @@
+//
+//  VideoFrame.cpp
+//  ti.vonage
+//
+
+#include "tivonage/VideoFrame.h"
+
+#include <cstring>
+
+namespace tivonage {
+
+bool copyFrame(const VideoFrame &source, VideoFrame &destination)
+{
+  if (source.format != destination.format || source.width != destination.width || source.height != destination.height) {
+    return false;
+  }
+
+  for (int plane = 0; plane < planeCount(source.format); ++plane) {
+    const VideoPlane &from = source.planes[plane];
+    VideoPlane &to = destination.planes[plane];
+    if (!from.data || !to.data) {
+      return false;
+    }
+    size_t rowBytes = size_t(planeRowBytes(source.format, plane, source.width));
+    int rows = planeRows(source.format, plane, source.height);
+    if (from.stride == to.stride && size_t(from.stride) == rowBytes) {
+      memcpy(to.data, from.data, rowBytes * size_t(rows));
+      continue;
+    }
+    for (int y = 0; y < rows; ++y) {
+      memcpy(to.data + y * to.stride, from.data + y * from.stride, rowBytes);
+    }
+  }
+
+  destination.orientation = source.orientation;
+  destination.timestampUs = source.timestampUs;
+  return true;
+}
+
+}
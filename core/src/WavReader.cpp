@@ -0,0 +1,126 @@
+//
+//  WavReader.cpp
+//  ti.vonage
+//
+
+#include "tivonage/WavReader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tivonage {
+
+static const uint16_t kFormatPcm = 1;
+static const uint16_t kFormatExtensible = 0xFFFE;
+
+static uint32_t loadLittleEndian(const uint8_t *data, int bytes)
+{
+  uint32_t value = 0;
+  for (int i = 0; i < bytes; ++i) {
+    value |= uint32_t(data[i]) << (8 * i);
+  }
+  return value;
+}
+
+std::unique_ptr<WavReader> WavReader::open(const std::string &path)
+{
+  int descriptor = ::open(path.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    return nullptr;
+  }
+  struct stat info;
+  if (fstat(descriptor, &info) != 0 || info.st_size <= 0) {
+    ::close(descriptor);
+    return nullptr;
+  }
+  const size_t size = size_t(info.st_size);
+  void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  // The mapping keeps the file alive.
+  ::close(descriptor);
+  if (mapping == MAP_FAILED) {
+    return nullptr;
+  }
+  // Audio is read front to back, and usually looped.
+  madvise(mapping, size, MADV_SEQUENTIAL);
+
+  std::unique_ptr<WavReader> reader(new WavReader(static_cast<const uint8_t *>(mapping), size));
+  const uint8_t *data = reader->m_mapping;
+  if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+    return nullptr;
+  }
+
+  // Chunks are an id, a size and the payload, padded to an even length.
+  bool hasFormat = false;
+  size_t offset = 12;
+  while (offset + 8 <= size) {
+    const uint8_t *chunk = data + offset;
+    const size_t chunkSize = loadLittleEndian(chunk + 4, 4);
+    const size_t payload = offset + 8;
+    if (memcmp(chunk, "fmt ", 4) == 0) {
+      if (chunkSize < 16 || payload + 16 > size) {
+        return nullptr;
+      }
+      const uint16_t format = uint16_t(loadLittleEndian(data + payload, 2));
+      reader->m_channels = int(loadLittleEndian(data + payload + 2, 2));
+      reader->m_sampleRate = int(loadLittleEndian(data + payload + 4, 4));
+      const uint32_t bits = loadLittleEndian(data + payload + 14, 2);
+      if ((format != kFormatPcm && format != kFormatExtensible) || bits != 16) {
+        return nullptr;
+      }
+      hasFormat = true;
+    } else if (memcmp(chunk, "data", 4) == 0) {
+      if (!hasFormat || reader->m_channels < 1 || reader->m_channels > 8 || reader->m_sampleRate <= 0) {
+        return nullptr;
+      }
+      const size_t frameBytes = sizeof(int16_t) * size_t(reader->m_channels);
+      reader->m_dataOffset = payload;
+      reader->m_frameCount = std::min(chunkSize, size - payload) / frameBytes;
+      return reader;
+    }
+    offset = payload + chunkSize + (chunkSize & 1);
+  }
+  return nullptr;
+}
+
+WavReader::WavReader(const uint8_t *mapping, size_t size)
+    : m_mapping(mapping)
+    , m_size(size)
+{
+}
+
+WavReader::~WavReader()
+{
+  munmap(const_cast<uint8_t *>(m_mapping), m_size);
+}
+
+size_t WavReader::readMono(size_t index, int16_t *samples, size_t count) const
+{
+  if (index >= m_frameCount) {
+    return 0;
+  }
+  count = std::min(count, m_frameCount - index);
+  // The data chunk need not be 2-byte aligned in the mapping. WAV is little
+  // endian, as are all the platforms this runs on.
+  const uint8_t *source = m_mapping + m_dataOffset + index * sizeof(int16_t) * size_t(m_channels);
+  if (m_channels == 1) {
+    memcpy(samples, source, count * sizeof(int16_t));
+    return count;
+  }
+  for (size_t frame = 0; frame < count; ++frame) {
+    int32_t sum = 0;
+    for (int channel = 0; channel < m_channels; ++channel) {
+      int16_t value;
+      memcpy(&value, source, sizeof(value));
+      sum += value;
+      source += sizeof(int16_t);
+    }
+    samples[frame] = int16_t(sum / m_channels);
+  }
+  return count;
+}
+
+}
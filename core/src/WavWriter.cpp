@@ -0,0 +1,113 @@
+//
+//  WavWriter.cpp
+//  ti.vonage
+//
+
+#include "tivonage/WavWriter.h"
+
+#include <cstring>
+
+namespace tivonage {
+
+static const size_t kHeaderSize = 44;
+static const uint64_t kMaxDataBytes = 0xFFFFFFFFull - (kHeaderSize - 8);
+
+static void storeLittleEndian(uint8_t *data, uint32_t value, int bytes)
+{
+  for (int i = 0; i < bytes; ++i) {
+    data[i] = uint8_t(value >> (8 * i));
+  }
+}
+
+static void fillHeader(uint8_t header[kHeaderSize], int sampleRate, int channels, uint32_t dataBytes)
+{
+  const uint32_t blockAlign = uint32_t(channels) * sizeof(int16_t);
+  memcpy(header, "RIFF", 4);
+  storeLittleEndian(header + 4, dataBytes + uint32_t(kHeaderSize - 8), 4);
+  memcpy(header + 8, "WAVEfmt ", 8);
+  storeLittleEndian(header + 16, 16, 4);
+  storeLittleEndian(header + 20, 1, 2); // PCM
+  storeLittleEndian(header + 22, uint32_t(channels), 2);
+  storeLittleEndian(header + 24, uint32_t(sampleRate), 4);
+  storeLittleEndian(header + 28, uint32_t(sampleRate) * blockAlign, 4);
+  storeLittleEndian(header + 32, blockAlign, 2);
+  storeLittleEndian(header + 34, 16, 2);
+  memcpy(header + 36, "data", 4);
+  storeLittleEndian(header + 40, dataBytes, 4);
+}
+
+std::unique_ptr<WavWriter> WavWriter::create(const std::string &path, int sampleRate, int channels)
+{
+  if (sampleRate <= 0 || channels <= 0 || channels > 8) {
+    return nullptr;
+  }
+  FILE *file = fopen(path.c_str(), "wb");
+  if (!file) {
+    return nullptr;
+  }
+  uint8_t header[kHeaderSize];
+  fillHeader(header, sampleRate, channels, uint32_t(kMaxDataBytes));
+  if (fwrite(header, 1, kHeaderSize, file) != kHeaderSize) {
+    fclose(file);
+    return nullptr;
+  }
+  return std::unique_ptr<WavWriter>(new WavWriter(file, sampleRate, channels));
+}
+
+WavWriter::WavWriter(FILE *file, int sampleRate, int channels)
+    : m_file(file)
+    , m_sampleRate(sampleRate)
+    , m_channels(channels)
+{
+}
+
+WavWriter::~WavWriter()
+{
+  close();
+}
+
+bool WavWriter::write(const int16_t *samples, size_t count)
+{
+  const uint64_t bytes = uint64_t(count) * sizeof(int16_t);
+  if (!m_file || m_failed || m_dataBytes + bytes > kMaxDataBytes) {
+    return false;
+  }
+  // WAV is little endian, as are all the platforms this runs on.
+  if (fwrite(samples, sizeof(int16_t), count, m_file) != count) {
+    m_failed = true;
+    return false;
+  }
+  m_dataBytes += bytes;
+  return true;
+}
+
+bool WavWriter::flush()
+{
+  if (!m_file || m_failed) {
+    return false;
+  }
+  uint8_t header[kHeaderSize];
+  fillHeader(header, m_sampleRate, m_channels, uint32_t(m_dataBytes));
+  if (fseek(m_file, 0, SEEK_SET) != 0 || fwrite(header, 1, kHeaderSize, m_file) != kHeaderSize
+      || fseek(m_file, 0, SEEK_END) != 0 || fflush(m_file) != 0) {
+    m_failed = true;
+  }
+  return !m_failed;
+}
+
+bool WavWriter::close()
+{
+  if (!m_file) {
+    return !m_failed;
+  }
+  if (!m_failed) {
+    flush();
+  }
+  if (fclose(m_file) != 0) {
+    m_failed = true;
+  }
+  m_file = nullptr;
+  return !m_failed;
+}
+
+}
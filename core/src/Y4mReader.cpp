@@ -0,0 +1,149 @@
+//
+//  Y4mReader.cpp
+//  ti.vonage
+//
+
+#include "tivonage/Y4mReader.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tivonage {
+
+static const char kStreamMagic[] = "YUV4MPEG2";
+static const char kFrameMagic[] = "FRAME";
+
+// Offset just past the next '\n' at or after offset, or 0 if there is none.
+static size_t nextLine(const uint8_t *data, size_t size, size_t offset)
+{
+  const void *newline = memchr(data + offset, '\n', size - offset);
+  return newline ? size_t(static_cast<const uint8_t *>(newline) - data) + 1 : 0;
+}
+
+std::unique_ptr<Y4mReader> Y4mReader::open(const std::string &path)
+{
+  int descriptor = ::open(path.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    return nullptr;
+  }
+  struct stat info;
+  if (fstat(descriptor, &info) != 0 || info.st_size <= 0) {
+    ::close(descriptor);
+    return nullptr;
+  }
+  const size_t size = size_t(info.st_size);
+  void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  // The mapping keeps the file alive.
+  ::close(descriptor);
+  if (mapping == MAP_FAILED) {
+    return nullptr;
+  }
+  // Frames are read front to back, and usually looped.
+  madvise(mapping, size, MADV_SEQUENTIAL);
+
+  std::unique_ptr<Y4mReader> reader(new Y4mReader(static_cast<const uint8_t *>(mapping), size));
+  const uint8_t *data = reader->m_mapping;
+  size_t headerEnd = nextLine(data, size, 0);
+  if (!headerEnd || size < sizeof(kStreamMagic) || memcmp(data, kStreamMagic, sizeof(kStreamMagic) - 1) != 0) {
+    return nullptr;
+  }
+
+  // Tags are space separated, a letter followed by its value.
+  std::string header(reinterpret_cast<const char *>(data) + sizeof(kStreamMagic) - 1, headerEnd - sizeof(kStreamMagic));
+  size_t position = 0;
+  while (position < header.size()) {
+    size_t end = header.find(' ', position);
+    if (end == std::string::npos) {
+      end = header.size();
+    }
+    if (end > position) {
+      const std::string tag = header.substr(position, end - position);
+      const char *value = tag.c_str() + 1;
+      switch (tag[0]) {
+      case 'W':
+        reader->m_width = atoi(value);
+        break;
+      case 'H':
+        reader->m_height = atoi(value);
+        break;
+      case 'F': {
+        int numerator = 0;
+        int denominator = 0;
+        if (sscanf(value, "%d:%d", &numerator, &denominator) == 2 && numerator > 0 && denominator > 0) {
+          reader->m_frameRate = double(numerator) / double(denominator);
+        }
+        break;
+      }
+      case 'C':
+        // 420jpeg, 420mpeg2 and 420paldv only differ in chroma siting.
+        if (tag.compare(1, 3, "420") != 0) {
+          return nullptr;
+        }
+        break;
+      default:
+        break;
+      }
+    }
+    position = end + 1;
+  }
+  const int width = reader->m_width;
+  const int height = reader->m_height;
+  if (width <= 0 || height <= 0 || (width & 1) || (height & 1)) {
+    return nullptr;
+  }
+
+  const size_t frameBytes = size_t(width) * size_t(height) * 3 / 2;
+  size_t offset = headerEnd;
+  while (offset + sizeof(kFrameMagic) - 1 <= size && memcmp(data + offset, kFrameMagic, sizeof(kFrameMagic) - 1) == 0) {
+    // Frame headers may carry their own tags; only their length matters.
+    size_t planes = nextLine(data, size, offset);
+    if (!planes || planes + frameBytes > size) {
+      break;
+    }
+    reader->m_frames.push_back(planes);
+    offset = planes + frameBytes;
+  }
+  if (reader->m_frames.empty()) {
+    return nullptr;
+  }
+  return reader;
+}
+
+Y4mReader::Y4mReader(const uint8_t *mapping, size_t size)
+    : m_mapping(mapping)
+    , m_size(size)
+{
+}
+
+Y4mReader::~Y4mReader()
+{
+  munmap(const_cast<uint8_t *>(m_mapping), m_size);
+}
+
+bool Y4mReader::frame(size_t index, VideoFrame &frame) const
+{
+  if (index >= m_frames.size()) {
+    return false;
+  }
+  // The mapping is read-only; VideoFrame's planes are not const, but nothing
+  // downstream of a capturer writes to its source.
+  uint8_t *luma = const_cast<uint8_t *>(m_mapping + m_frames[index]);
+  const int chromaWidth = m_width / 2;
+  const size_t lumaBytes = size_t(m_width) * size_t(m_height);
+  const size_t chromaBytes = size_t(chromaWidth) * size_t(m_height / 2);
+  frame.format = PixelFormat::I420;
+  frame.width = m_width;
+  frame.height = m_height;
+  frame.orientation = VideoOrientation::Up;
+  frame.planes[0] = { luma, m_width };
+  frame.planes[1] = { luma + lumaBytes, chromaWidth };
+  frame.planes[2] = { luma + lumaBytes + chromaBytes, chromaWidth };
+  return true;
+}
+
+}
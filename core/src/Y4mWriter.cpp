@@ -0,0 +1,78 @@
+//
+//  Y4mWriter.cpp
+//  ti.vonage
+//
+
+#include "tivonage/Y4mWriter.h"
+
+namespace tivonage {
+
+// Large enough that a frame goes to the kernel in a few writes.
+static const size_t kFileBufferSize = 1 << 20;
+
+std::unique_ptr<Y4mWriter> Y4mWriter::create(const std::string &path, int width, int height, int frameRate)
+{
+  if (width <= 0 || height <= 0 || (width & 1) || (height & 1) || frameRate <= 0) {
+    return nullptr;
+  }
+  FILE *file = fopen(path.c_str(), "wb");
+  if (!file) {
+    return nullptr;
+  }
+  setvbuf(file, nullptr, _IOFBF, kFileBufferSize);
+  // C420jpeg is plain 4:2:0 with centred chroma, which is what every player
+  // assumes for I420.
+  if (fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, frameRate) < 0) {
+    fclose(file);
+    return nullptr;
+  }
+  return std::unique_ptr<Y4mWriter>(new Y4mWriter(file, width, height));
+}
+
+Y4mWriter::Y4mWriter(FILE *file, int width, int height)
+    : m_file(file)
+    , m_width(width)
+    , m_height(height)
+{
+}
+
+Y4mWriter::~Y4mWriter()
+{
+  close();
+}
+
+bool Y4mWriter::writeFrame(const VideoFrame &frame)
+{
+  if (!m_file || m_failed || frame.format != PixelFormat::I420 || frame.width != m_width || frame.height != m_height) {
+    return false;
+  }
+  static const char kFrameHeader[] = "FRAME\n";
+  bool written = fwrite(kFrameHeader, 1, sizeof(kFrameHeader) - 1, m_file) == sizeof(kFrameHeader) - 1;
+  for (int plane = 0; plane < 3 && written; ++plane) {
+    const size_t rowBytes = size_t(planeRowBytes(frame.format, plane, frame.width));
+    const int rows = planeRows(frame.format, plane, frame.height);
+    for (int y = 0; y < rows && written; ++y) {
+      written = fwrite(frame.planes[plane].data + ptrdiff_t(y) * frame.planes[plane].stride, 1, rowBytes, m_file) == rowBytes;
+    }
+  }
+  if (!written) {
+    m_failed = true;
+    return false;
+  }
+  ++m_frameCount;
+  return true;
+}
+
+bool Y4mWriter::close()
+{
+  if (!m_file) {
+    return !m_failed;
+  }
+  if (fclose(m_file) != 0) {
+    m_failed = true;
+  }
+  m_file = nullptr;
+  return !m_failed;
+}
+
+}
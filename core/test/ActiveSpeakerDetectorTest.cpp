@@ -0,0 +1,128 @@
+//
+//  ActiveSpeakerDetectorTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/ActiveSpeakerDetector.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace tivonage;
+
+namespace {
+
+const int64_t kLevelUs = 50000;
+const float kSpeech = 0.2f;
+const float kLoudSpeech = 0.5f;
+const float kSilence = 0.001f;
+
+// Feeds every stream its level every 50 ms until untilUs, updating every
+// 250 ms as the UI tick does; returns how often update() reported a change.
+struct Room {
+  ActiveSpeakerDetector detector;
+  int64_t nowUs = 0;
+
+  int run(int64_t untilUs, const std::vector<std::pair<std::string, float>> &levels)
+  {
+    int changes = 0;
+    for (; nowUs < untilUs; nowUs += kLevelUs) {
+      for (const auto &level : levels) {
+        detector.addLevel(level.first, level.second, nowUs);
+      }
+      if (nowUs % 250000 == 0 && detector.update(nowUs)) {
+        ++changes;
+      }
+    }
+    return changes;
+  }
+};
+
+}
+
+TEST(ActiveSpeakerDetectorTest, ShortNoiseDoesNotCount)
+{
+  Room room;
+  room.run(1000000, { { "a", kSilence }, { "b", kSilence } });
+  // One 100 ms click is shorter than the attack.
+  room.run(1100000, { { "a", kLoudSpeech }, { "b", kSilence } });
+  room.run(2000000, { { "a", kSilence }, { "b", kSilence } });
+  EXPECT_FALSE(room.detector.isSpeaking("a"));
+  EXPECT_TRUE(room.detector.activeSpeaker().empty());
+  EXPECT_TRUE(room.detector.ranking().empty());
+}
+
+TEST(ActiveSpeakerDetectorTest, PausesBetweenWordsKeepTheSpeaker)
+{
+  Room room;
+  EXPECT_EQ(room.run(1000000, { { "a", kSpeech }, { "b", kSilence } }), 1);
+  EXPECT_EQ(room.detector.activeSpeaker(), "a");
+
+  // 400 ms pauses are inside the hangover.
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(room.run(room.nowUs + 400000, { { "a", kSilence }, { "b", kSilence } }), 0);
+    EXPECT_TRUE(room.detector.isSpeaking("a"));
+    room.run(room.nowUs + 600000, { { "a", kSpeech }, { "b", kSilence } });
+  }
+  room.run(room.nowUs + 1000000, { { "a", kSilence }, { "b", kSilence } });
+  EXPECT_FALSE(room.detector.isSpeaking("a"));
+  // The last speaker stays active and ranked until someone else talks.
+  EXPECT_EQ(room.detector.activeSpeaker(), "a");
+  EXPECT_EQ(room.detector.ranking(), std::vector<std::string>({ "a" }));
+}
+
+TEST(ActiveSpeakerDetectorTest, ActiveSpeakerHoldsItsSpotForTheMinimumTime)
+{
+  Room room;
+  room.run(1000000, { { "a", kSpeech }, { "b", kSilence } });
+  ASSERT_EQ(room.detector.activeSpeaker(), "a");
+
+  // b interrupts loudly while a keeps talking: a keeps the spot until its
+  // hold ran out, then the clearly louder b takes over.
+  room.run(2000000, { { "a", kSpeech }, { "b", kLoudSpeech } });
+  EXPECT_EQ(room.detector.activeSpeaker(), "a");
+  EXPECT_EQ(room.detector.ranking(), std::vector<std::string>({ "a", "b" }));
+  room.run(6000000, { { "a", kSpeech }, { "b", kLoudSpeech } });
+  EXPECT_EQ(room.detector.activeSpeaker(), "b");
+  EXPECT_EQ(room.detector.ranking(), std::vector<std::string>({ "b", "a" }));
+
+  // A similar voice doesn't take over while b talks.
+  room.run(12000000, { { "a", kLoudSpeech }, { "b", kLoudSpeech } });
+  EXPECT_EQ(room.detector.activeSpeaker(), "b");
+}
+
+TEST(ActiveSpeakerDetectorTest, RankingKeepsTheMostRecentSpeakers)
+{
+  ActiveSpeakerDetector::Config config;
+  config.maxRanked = 2;
+  Room room { ActiveSpeakerDetector(config) };
+  room.run(3000000, { { "a", kSpeech }, { "b", kSilence }, { "c", kSilence } });
+  room.run(6000000, { { "a", kSilence }, { "b", kSpeech }, { "c", kSilence } });
+  EXPECT_EQ(room.detector.activeSpeaker(), "b");
+  EXPECT_EQ(room.detector.ranking(), std::vector<std::string>({ "b", "a" }));
+  EXPECT_FALSE(room.detector.isRanked("c"));
+
+  // c replaces a, the silent one, not b.
+  room.run(9000000, { { "a", kSilence }, { "b", kSilence }, { "c", kSpeech } });
+  EXPECT_EQ(room.detector.activeSpeaker(), "c");
+  EXPECT_EQ(room.detector.ranking(), std::vector<std::string>({ "c", "b" }));
+}
+
+TEST(ActiveSpeakerDetectorTest, SilencedOrRemovedStreamsGiveUpTheirPlace)
+{
+  Room room;
+  room.run(3000000, { { "a", kSpeech }, { "b", kSilence } });
+  ASSERT_TRUE(room.detector.isSpeaking("a"));
+
+  // a's levels stop (muted): it stops speaking after the hangover.
+  room.run(4000000, { { "b", kSilence } });
+  EXPECT_FALSE(room.detector.isSpeaking("a"));
+
+  room.detector.removeStream("a");
+  EXPECT_TRUE(room.detector.update(room.nowUs));
+  EXPECT_TRUE(room.detector.activeSpeaker().empty());
+  EXPECT_TRUE(room.detector.ranking().empty());
+  EXPECT_FALSE(room.detector.update(room.nowUs));
+}
@@ -0,0 +1,193 @@
+//
+//  AudioBridgeTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/AudioBridge.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace tivonage;
+
+namespace {
+
+AudioBridge::Config manualConfig()
+{
+  AudioBridge::Config config;
+  config.pumpThread = false;
+  return config;
+}
+
+std::vector<int16_t> ramp(size_t count, int16_t first)
+{
+  std::vector<int16_t> samples(count);
+  for (size_t i = 0; i < count; ++i) {
+    samples[i] = int16_t(first + int16_t(i));
+  }
+  return samples;
+}
+
+}
+
+TEST(AudioBridgeTest, RejectsBadConfig)
+{
+  AudioBridge::Config config = manualConfig();
+  config.sampleRate = 0;
+  EXPECT_EQ(AudioBridge::create(config, [](const int16_t *, size_t) {}, [](int16_t *, size_t) { return size_t(0); }), nullptr);
+  EXPECT_EQ(AudioBridge::create(manualConfig(), nullptr, [](int16_t *, size_t) { return size_t(0); }), nullptr);
+}
+
+TEST(AudioBridgeTest, CaptureReachesTheSinkInWholeChunks)
+{
+  std::vector<int16_t> received;
+  std::vector<size_t> chunks;
+  auto bridge = AudioBridge::create(manualConfig(), [&](const int16_t *samples, size_t count) {
+    received.insert(received.end(), samples, samples + count);
+    chunks.push_back(count);
+  }, [](int16_t *, size_t) { return size_t(0); });
+  ASSERT_NE(bridge, nullptr);
+  ASSERT_EQ(bridge->chunkSamples(), 160u);
+  bridge->setCapturing(true);
+
+  std::vector<int16_t> input = ramp(400, 1);
+  bridge->writeCapture(input.data(), 250);
+  bridge->pump();
+  EXPECT_EQ(chunks, std::vector<size_t>({ 160 }));
+  EXPECT_EQ(bridge->captureDelayMs(), 5);
+
+  bridge->writeCapture(input.data() + 250, 150);
+  bridge->pump();
+  ASSERT_EQ(received.size(), 320u);
+  EXPECT_EQ(received, std::vector<int16_t>(input.begin(), input.begin() + 320));
+
+  AudioBridge::Stats stats = bridge->stats();
+  EXPECT_EQ(stats.capturedSamples, 400u);
+  EXPECT_EQ(stats.captureChunks, 2u);
+  EXPECT_EQ(stats.captureOverflows, 0u);
+}
+
+TEST(AudioBridgeTest, CaptureOverflowIsCountedNotBlocking)
+{
+  AudioBridge::Config config = manualConfig();
+  config.captureBufferMs = 20;
+  auto bridge = AudioBridge::create(config, [](const int16_t *, size_t) {}, [](int16_t *, size_t) { return size_t(0); });
+  bridge->setCapturing(true);
+
+  std::vector<int16_t> input(1000, 7);
+  bridge->writeCapture(input.data(), input.size());
+  AudioBridge::Stats stats = bridge->stats();
+  EXPECT_EQ(stats.capturedSamples, 512u);
+  EXPECT_EQ(stats.captureOverflows, 488u);
+}
+
+TEST(AudioBridgeTest, RenderIsQueuedAheadAndUnderflowPlaysSilence)
+{
+  int16_t next = 1;
+  auto bridge = AudioBridge::create(manualConfig(), [](const int16_t *, size_t) {}, [&](int16_t *samples, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      samples[i] = next++;
+    }
+    return count;
+  });
+  bridge->setRendering(true);
+  bridge->pump();
+  EXPECT_EQ(bridge->stats().renderChunks, 4u);
+  EXPECT_EQ(bridge->renderDelayMs(), 40);
+
+  // Topped up again, in whole chunks, once the callback took some.
+  std::vector<int16_t> output(200);
+  bridge->readRender(output.data(), output.size());
+  EXPECT_EQ(output, ramp(200, 1));
+  bridge->pump();
+  EXPECT_EQ(bridge->stats().renderChunks, 6u);
+  EXPECT_EQ(bridge->renderDelayMs(), 47);
+
+  output.assign(900, -1);
+  bridge->readRender(output.data(), output.size());
+  EXPECT_EQ(std::vector<int16_t>(output.begin(), output.begin() + 760), ramp(760, 201));
+  EXPECT_EQ(std::vector<int16_t>(output.begin() + 760, output.end()), std::vector<int16_t>(140, 0));
+
+  AudioBridge::Stats stats = bridge->stats();
+  EXPECT_EQ(stats.renderedSamples, 960u);
+  EXPECT_EQ(stats.renderUnderflows, 140u);
+}
+
+TEST(AudioBridgeTest, ShortRenderChunksArePaddedWithSilence)
+{
+  auto bridge = AudioBridge::create(manualConfig(), [](const int16_t *, size_t) {}, [](int16_t *samples, size_t count) {
+    std::fill(samples, samples + count, int16_t(5));
+    return count / 2;
+  });
+  bridge->setRendering(true);
+  bridge->pump();
+
+  std::vector<int16_t> output(160);
+  bridge->readRender(output.data(), output.size());
+  EXPECT_EQ(std::vector<int16_t>(output.begin(), output.begin() + 80), std::vector<int16_t>(80, 5));
+  EXPECT_EQ(std::vector<int16_t>(output.begin() + 80, output.end()), std::vector<int16_t>(80, 0));
+}
+
+TEST(AudioBridgeTest, NothingMovesWhileOffAndRestartsDropStaleAudio)
+{
+  int captured = 0;
+  auto bridge = AudioBridge::create(manualConfig(), [&](const int16_t *, size_t) { ++captured; }, [](int16_t *samples, size_t count) {
+    std::fill(samples, samples + count, int16_t(9));
+    return count;
+  });
+
+  std::vector<int16_t> input(320, 1);
+  bridge->writeCapture(input.data(), input.size());
+  bridge->pump();
+  EXPECT_EQ(captured, 0);
+  std::vector<int16_t> output(160, -1);
+  bridge->readRender(output.data(), output.size());
+  EXPECT_EQ(output, std::vector<int16_t>(160, 0));
+
+  bridge->setRendering(true);
+  bridge->pump();
+  bridge->setRendering(false);
+  bridge->setRendering(true);
+  bridge->readRender(output.data(), output.size());
+  EXPECT_EQ(output, std::vector<int16_t>(160, 0));
+  EXPECT_EQ(bridge->stats().renderUnderflows, 160u);
+
+  bridge->setCapturing(true);
+  bridge->writeCapture(input.data(), 100);
+  bridge->setCapturing(false);
+  bridge->setCapturing(true);
+  bridge->writeCapture(input.data(), 100);
+  bridge->pump();
+  EXPECT_EQ(captured, 0);
+}
+
+TEST(AudioBridgeTest, PumpThreadMovesBothDirections)
+{
+  std::atomic<size_t> captured { 0 };
+  std::atomic<size_t> requested { 0 };
+  auto bridge = AudioBridge::create(AudioBridge::Config(), [&](const int16_t *, size_t count) { captured += count; },
+      [&](int16_t *samples, size_t count) {
+        std::fill(samples, samples + count, int16_t(3));
+        requested += count;
+        return count;
+      });
+  ASSERT_NE(bridge, nullptr);
+  bridge->setCapturing(true);
+  bridge->setRendering(true);
+
+  std::vector<int16_t> input(160, 1);
+  std::vector<int16_t> output(160);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (captured < 1600 && std::chrono::steady_clock::now() < deadline) {
+    bridge->writeCapture(input.data(), input.size());
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    bridge->readRender(output.data(), output.size());
+  }
+  EXPECT_GE(captured.load(), 1600u);
+  EXPECT_GE(requested.load(), 1600u);
+  EXPECT_EQ(bridge->stats().captureOverflows, 0u);
+}
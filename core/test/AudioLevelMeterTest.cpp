@@ -0,0 +1,74 @@
+//
+//  AudioLevelMeterTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/AudioLevelMeter.h"
+
+#include <gtest/gtest.h>
+
+using namespace tivonage;
+
+namespace {
+
+const int64_t kTickUs = 100000;
+
+}
+
+TEST(AudioLevelMeterTest, ScalesAmplitudeOntoTheDbRange)
+{
+  AudioLevelMeter meter;
+  EXPECT_FLOAT_EQ(meter.scale(1.0f), 1.0f);
+  EXPECT_NEAR(meter.scale(0.1f), 0.6f, 1e-5);
+  EXPECT_FLOAT_EQ(meter.scale(0.001f), 0.0f);
+  EXPECT_FLOAT_EQ(meter.scale(0.0f), 0.0f);
+}
+
+TEST(AudioLevelMeterTest, RisesAtOnceAndDecaysAfterThePeak)
+{
+  AudioLevelMeter meter;
+  meter.addLevel("a", 1.0f, 0);
+  meter.addLevel("a", 0.01f, 50000);
+  ASSERT_TRUE(meter.tick(kTickUs));
+  ASSERT_EQ(meter.levels().size(), 1u);
+  EXPECT_EQ(meter.levels()[0].streamId, "a");
+  EXPECT_NEAR(meter.levels()[0].level, 0.9f, 1e-5);
+  EXPECT_FLOAT_EQ(meter.levels()[0].peak, 1.0f);
+
+  // Quieter levels than the decaying meter don't pull it down faster.
+  meter.addLevel("a", 0.01f, 150000);
+  ASSERT_TRUE(meter.tick(2 * kTickUs));
+  EXPECT_NEAR(meter.levels()[0].level, 0.8f, 1e-5);
+  EXPECT_NEAR(meter.levels()[0].peak, 0.2f, 1e-5);
+
+  ASSERT_TRUE(meter.tick(20 * kTickUs));
+  EXPECT_FLOAT_EQ(meter.levels()[0].level, 0.0f);
+}
+
+TEST(AudioLevelMeterTest, ReportsOnlyWhenSomethingMoved)
+{
+  AudioLevelMeter meter;
+  meter.addLevel("a", 0.0f, 0);
+  meter.addLevel("b", 0.0f, 0);
+  EXPECT_TRUE(meter.tick(kTickUs));
+  meter.addLevel("a", 0.0f, kTickUs + 1000);
+  EXPECT_FALSE(meter.tick(2 * kTickUs));
+
+  meter.addLevel("b", 0.5f, 2 * kTickUs + 1000);
+  ASSERT_TRUE(meter.tick(3 * kTickUs));
+  ASSERT_EQ(meter.levels().size(), 2u);
+  EXPECT_EQ(meter.levels()[0].streamId, "a");
+  EXPECT_FLOAT_EQ(meter.levels()[0].level, 0.0f);
+  EXPECT_EQ(meter.levels()[1].streamId, "b");
+  EXPECT_NEAR(meter.levels()[1].level, 0.88f - 0.099f, 1e-3);
+
+  meter.removeStream("a");
+  ASSERT_TRUE(meter.tick(3 * kTickUs));
+  ASSERT_EQ(meter.levels().size(), 1u);
+  EXPECT_EQ(meter.levels()[0].streamId, "b");
+
+  meter.clear();
+  ASSERT_TRUE(meter.tick(4 * kTickUs));
+  EXPECT_TRUE(meter.levels().empty());
+  EXPECT_FALSE(meter.tick(5 * kTickUs));
+}
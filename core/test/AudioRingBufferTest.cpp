@@ -0,0 +1,88 @@
+//
+//  AudioRingBufferTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/AudioRingBuffer.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace tivonage;
+
+TEST(AudioRingBufferTest, RoundsCapacityToPowerOfTwo)
+{
+  auto ring = AudioRingBuffer::create(1000);
+  ASSERT_NE(ring, nullptr);
+  EXPECT_EQ(ring->capacity(), 1024u);
+  EXPECT_EQ(ring->availableToWrite(), 1024u);
+  EXPECT_EQ(ring->availableToRead(), 0u);
+}
+
+TEST(AudioRingBufferTest, WrapsAround)
+{
+  auto ring = AudioRingBuffer::create(8);
+  int16_t input[6] = { 1, 2, 3, 4, 5, 6 };
+  int16_t output[8] = {};
+
+  EXPECT_EQ(ring->write(input, 6), 6u);
+  EXPECT_EQ(ring->read(output, 4), 4u);
+  EXPECT_EQ(ring->write(input, 6), 6u);
+  EXPECT_EQ(ring->availableToRead(), 8u);
+
+  EXPECT_EQ(ring->read(output, 8), 8u);
+  int16_t expected[8] = { 5, 6, 1, 2, 3, 4, 5, 6 };
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(output[i], expected[i]);
+  }
+}
+
+TEST(AudioRingBufferTest, NeverOverwritesUnreadSamples)
+{
+  auto ring = AudioRingBuffer::create(4);
+  int16_t input[6] = { 1, 2, 3, 4, 5, 6 };
+  EXPECT_EQ(ring->write(input, 6), 4u);
+  EXPECT_EQ(ring->write(input, 1), 0u);
+  EXPECT_EQ(ring->skip(3), 3u);
+
+  int16_t sample = 0;
+  EXPECT_EQ(ring->read(&sample, 1), 1u);
+  EXPECT_EQ(sample, 4);
+  EXPECT_EQ(ring->read(&sample, 1), 0u);
+}
+
+TEST(AudioRingBufferTest, PreservesOrderAcrossThreads)
+{
+  auto ring = AudioRingBuffer::create(256);
+  constexpr int kTotal = 200000;
+
+  std::thread producer([&] {
+    int16_t chunk[37];
+    int next = 0;
+    while (next < kTotal) {
+      int count = std::min(37, kTotal - next);
+      for (int i = 0; i < count; ++i) {
+        chunk[i] = int16_t(next + i);
+      }
+      size_t written = 0;
+      while (written < size_t(count)) {
+        written += ring->write(chunk + written, size_t(count) - written);
+      }
+      next += count;
+    }
+  });
+
+  int expected = 0;
+  bool ordered = true;
+  int16_t chunk[53];
+  while (expected < kTotal) {
+    size_t count = ring->read(chunk, 53);
+    for (size_t i = 0; i < count; ++i) {
+      ordered &= chunk[i] == int16_t(expected++);
+    }
+  }
+  producer.join();
+  EXPECT_TRUE(ordered);
+}
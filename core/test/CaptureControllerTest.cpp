@@ -0,0 +1,196 @@
+//
+//  CaptureControllerTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/CaptureController.h"
+
+#include <gtest/gtest.h>
+
+using namespace tivonage;
+
+namespace {
+
+const int64_t kSecond = 1000000;
+
+// Feeds one stats interval per second with the given loss and bitrate, the
+// way the SDK's network stats delegate reports them.
+class Link {
+public:
+  explicit Link(CaptureController &controller)
+      : m_controller(controller)
+  {
+    m_controller.addStats(0, 0, 0, 0);
+  }
+
+  // Runs for the given number of seconds; returns how many times the level
+  // changed.
+  int run(int seconds, double loss, double kbps)
+  {
+    int changes = 0;
+    for (int i = 0; i < seconds; ++i) {
+      m_now += kSecond;
+      m_sent += 100;
+      m_lost += int64_t(100 * loss);
+      m_bytes += int64_t(kbps * 1000 / 8);
+      m_controller.addStats(m_lost, m_sent, m_bytes, m_now);
+      changes += m_controller.update(m_now);
+    }
+    return changes;
+  }
+
+  int64_t now() const { return m_now; }
+
+private:
+  CaptureController &m_controller;
+  int64_t m_now = 0;
+  int64_t m_lost = 0;
+  int64_t m_sent = 0;
+  int64_t m_bytes = 0;
+};
+
+CaptureController makeController()
+{
+  CaptureController controller;
+  controller.setBaseFormat(640, 480, 30.0f);
+  return controller;
+}
+
+}
+
+TEST(CaptureControllerTest, LadderBelowTheBaseFormat)
+{
+  CaptureController controller = makeController();
+  EXPECT_EQ(controller.level(), 0);
+  EXPECT_EQ(controller.format(), (CaptureController::Format { 640, 480, 30.0f }));
+  EXPECT_EQ(controller.format(1), (CaptureController::Format { 480, 360, 30.0f }));
+  EXPECT_EQ(controller.format(2), (CaptureController::Format { 480, 360, 15.0f }));
+  EXPECT_EQ(controller.format(3), (CaptureController::Format { 320, 240, 15.0f }));
+  EXPECT_EQ(controller.format(4), (CaptureController::Format { 320, 240, 7.5f }));
+  EXPECT_EQ(controller.format(9), controller.format(4));
+}
+
+TEST(CaptureControllerTest, SustainedLossStepsDownOneLevelAtATime)
+{
+  CaptureController controller = makeController();
+  Link link(controller);
+  link.run(5, 0.0, 1000);
+  EXPECT_EQ(controller.level(), 0);
+
+  // The smoothed loss crosses 5% on the first lossy interval; stepping down
+  // waits for it to last two seconds, and so does every further step.
+  EXPECT_EQ(link.run(1, 0.2, 1000), 0);
+  EXPECT_EQ(link.run(2, 0.2, 1000), 1);
+  EXPECT_EQ(controller.level(), 1);
+  EXPECT_EQ(link.run(1, 0.2, 1000), 0);
+  EXPECT_EQ(link.run(1, 0.2, 1000), 1);
+  EXPECT_EQ(link.run(20, 0.2, 1000), 2);
+  EXPECT_EQ(controller.level(), CaptureController::kLevelCount - 1);
+}
+
+TEST(CaptureControllerTest, BriefLossDoesNotStepDown)
+{
+  CaptureController controller = makeController();
+  Link link(controller);
+  link.run(5, 0.0, 1000);
+  EXPECT_EQ(link.run(1, 0.3, 1000), 0);
+  EXPECT_EQ(link.run(10, 0.0, 1000), 0);
+  EXPECT_EQ(controller.level(), 0);
+}
+
+TEST(CaptureControllerTest, ModerateLossHoldsTheLevel)
+{
+  CaptureController controller = makeController();
+  Link link(controller);
+  link.run(3, 0.2, 1000);
+  ASSERT_EQ(controller.level(), 1);
+
+  // 3% is neither congested nor clean, once the smoothed loss gets there.
+  link.run(3, 0.03, 1000);
+  ASSERT_EQ(controller.level(), 2);
+  EXPECT_EQ(link.run(60, 0.03, 1000), 0);
+}
+
+TEST(CaptureControllerTest, CleanLinkStepsBackUpSlowly)
+{
+  CaptureController controller = makeController();
+  Link link(controller);
+  link.run(5, 0.2, 1000);
+  ASSERT_EQ(controller.level(), 2);
+
+  // The smoothed loss is clean from the fifth second on; stepping up waits
+  // ten more, and so does every further step.
+  EXPECT_EQ(link.run(14, 0.0, 1000), 0);
+  EXPECT_EQ(link.run(1, 0.0, 1000), 1);
+  EXPECT_EQ(controller.level(), 1);
+  EXPECT_EQ(link.run(9, 0.0, 1000), 0);
+  EXPECT_EQ(link.run(1, 0.0, 1000), 1);
+  EXPECT_EQ(controller.level(), 0);
+}
+
+TEST(CaptureControllerTest, StarvedEncoderStepsDownOnSlightLoss)
+{
+  CaptureController controller = makeController();
+  Link link(controller);
+  // 0.04 bits per pixel of 640x480 at 30 fps is about 369 kbps; 480x360 at
+  // 15 fps needs about 104. 2% loss alone would hold the level.
+  link.run(30, 0.02, 150);
+  EXPECT_EQ(controller.level(), 2);
+}
+
+TEST(CaptureControllerTest, CleanLinkAtALowBitrateHoldsTheLevel)
+{
+  // A still scene, or the reduced frame rate of a static one, encodes to
+  // far less than the floor without anything wrong with the link.
+  CaptureController controller = makeController();
+  Link link(controller);
+  EXPECT_EQ(link.run(60, 0.0, 50), 0);
+  EXPECT_EQ(controller.level(), 0);
+
+  // Nor does it count against a step back up.
+  link.run(3, 0.2, 1000);
+  ASSERT_EQ(controller.level(), 1);
+  EXPECT_EQ(link.run(20, 0.0, 50), 1);
+  EXPECT_EQ(controller.level(), 0);
+  link.run(15, 0.0, 50);
+  EXPECT_EQ(controller.upgradeDelayUs(), 10 * kSecond);
+}
+
+TEST(CaptureControllerTest, FailedProbeDoublesTheUpgradeDelay)
+{
+  CaptureController controller = makeController();
+  Link link(controller);
+  link.run(3, 0.2, 1000);
+  ASSERT_EQ(controller.level(), 1);
+  link.run(15, 0.0, 1000);
+  ASSERT_EQ(controller.level(), 0);
+
+  // Congestion right after the step up: the link can't carry level 0.
+  link.run(3, 0.2, 1000);
+  ASSERT_EQ(controller.level(), 1);
+  EXPECT_EQ(controller.upgradeDelayUs(), 20 * kSecond);
+
+  EXPECT_EQ(link.run(24, 0.0, 1000), 0);
+  EXPECT_EQ(link.run(1, 0.0, 1000), 1);
+  EXPECT_EQ(controller.level(), 0);
+  // Holding for the whole delay restores the normal delay.
+  link.run(25, 0.0, 1000);
+  EXPECT_EQ(controller.upgradeDelayUs(), 10 * kSecond);
+}
+
+TEST(CaptureControllerTest, IdleOrRestartedCountersAreIgnored)
+{
+  CaptureController controller = makeController();
+  controller.addStats(0, 0, 0, 0);
+  // Video muted: nothing sent, nothing judged.
+  for (int64_t t = 1; t < 30; ++t) {
+    controller.addStats(0, 0, 0, t * kSecond);
+    EXPECT_FALSE(controller.update(t * kSecond));
+  }
+  controller.addStats(50, 1000, 100000, 30 * kSecond);
+  EXPECT_DOUBLE_EQ(controller.lossRate(), 0.05);
+  // A new stream's counters start from zero again; that interval is skipped.
+  controller.addStats(0, 10, 1000, 31 * kSecond);
+  EXPECT_FALSE(controller.update(31 * kSecond));
+  EXPECT_DOUBLE_EQ(controller.lossRate(), 0.05);
+}
@@ -0,0 +1,116 @@
+//
+//  DeadlinePacerTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/Clock.h"
+#include "tivonage/DeadlinePacer.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace tivonage;
+
+TEST(DeadlinePacerTest, FreeRunningRunsEveryTickUpToTheLimit)
+{
+  std::vector<uint64_t> indices;
+  DeadlinePacer::Config config;
+  config.intervalUs = 1000000.0;
+  config.realTime = false;
+  config.tickLimit = 50;
+  DeadlinePacer pacer(config, [&](uint64_t index) { indices.push_back(index); });
+  ASSERT_TRUE(pacer.start());
+  EXPECT_FALSE(pacer.start());
+  pacer.wait();
+  pacer.stop();
+
+  ASSERT_EQ(indices.size(), 50u);
+  EXPECT_EQ(indices.front(), 0u);
+  EXPECT_EQ(indices.back(), 49u);
+  DeadlinePacer::Stats stats = pacer.stats();
+  EXPECT_EQ(stats.ticks, 50u);
+  EXPECT_EQ(stats.skipped, 0u);
+  EXPECT_LT(stats.elapsedUs, 1000000);
+}
+
+TEST(DeadlinePacerTest, RealTimeKeepsToTheInterval)
+{
+  DeadlinePacer::Config config;
+  config.intervalUs = 10000.0;
+  config.tickLimit = 21;
+  DeadlinePacer pacer(config, [](uint64_t) {});
+  ASSERT_TRUE(pacer.start());
+  pacer.wait();
+
+  // 20 intervals after the first tick.
+  DeadlinePacer::Stats stats = pacer.stats();
+  EXPECT_EQ(stats.ticks, 21u);
+  EXPECT_GE(stats.elapsedUs, 200000);
+  EXPECT_LT(stats.elapsedUs, 260000);
+  EXPECT_LT(stats.meanLatenessUs, 5000.0);
+}
+
+TEST(DeadlinePacerTest, ALateWakeupSkipsTheMissedDeadlines)
+{
+  int64_t latenessUs = -1;
+  // On time, or late by less than an interval: the tick runs as it is.
+  EXPECT_EQ(DeadlinePacer::dueTick(1, 10000.0, 10000, latenessUs), 1u);
+  EXPECT_EQ(latenessUs, 0);
+  EXPECT_EQ(DeadlinePacer::dueTick(1, 10000.0, 19999, latenessUs), 1u);
+  EXPECT_EQ(latenessUs, 9999);
+  // Woken early (a spurious wakeup) counts as on time.
+  EXPECT_EQ(DeadlinePacer::dueTick(1, 10000.0, 9000, latenessUs), 1u);
+  EXPECT_EQ(latenessUs, 0);
+
+  // Tick 1 woken 35 ms in, after a slow tick 0: ticks 1 and 2 are skipped
+  // and tick 3 runs 5 ms late, instead of a burst of three.
+  EXPECT_EQ(DeadlinePacer::dueTick(1, 10000.0, 35000, latenessUs), 3u);
+  EXPECT_EQ(latenessUs, 5000);
+  // Deadlines are rounded from the start, so a fractional interval doesn't
+  // drift: tick 3 of 33333.3 us is due at 100000 us.
+  EXPECT_EQ(DeadlinePacer::dueTick(3, 100000.0 / 3.0, 100000, latenessUs), 3u);
+  EXPECT_EQ(latenessUs, 0);
+}
+
+TEST(DeadlinePacerTest, ASlowTickDoesNotRunABurst)
+{
+  std::vector<uint64_t> indices;
+  DeadlinePacer::Config config;
+  config.intervalUs = 10000.0;
+  config.tickLimit = 3;
+  DeadlinePacer pacer(config, [&](uint64_t index) {
+    indices.push_back(index);
+    if (indices.size() == 1) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(35));
+    }
+  });
+  ASSERT_TRUE(pacer.start());
+  pacer.wait();
+
+  // The two ticks after the slow first one were due over an interval before
+  // it returned, however loaded the machine; a loaded machine may skip more
+  // (even the first tick), so only the lower bounds are exact.
+  ASSERT_EQ(indices.size(), 3u);
+  EXPECT_GE(indices[1], indices[0] + 3);
+  EXPECT_GT(indices[2], indices[1]);
+  EXPECT_EQ(pacer.stats().skipped, indices[2] - 2);
+}
+
+TEST(DeadlinePacerTest, StopInterruptsTheWait)
+{
+  int ticks = 0;
+  DeadlinePacer::Config config;
+  config.intervalUs = 2000000.0;
+  DeadlinePacer pacer(config, [&](uint64_t) { ++ticks; });
+  ASSERT_TRUE(pacer.start());
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  const int64_t stopUs = monotonicMicros();
+  pacer.stop();
+  pacer.stop();
+  EXPECT_LT(monotonicMicros() - stopUs, 500000);
+  EXPECT_EQ(ticks, 1);
+  EXPECT_TRUE(pacer.start());
+}
@@ -0,0 +1,220 @@
+//
+//  FileAudioDeviceTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FileAudioDevice.h"
+#include "tivonage/LoopbackAudioBus.h"
+#include "tivonage/WavReader.h"
+#include "tivonage/WavWriter.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace tivonage;
+
+namespace {
+
+std::vector<int16_t> pattern(size_t count)
+{
+  std::vector<int16_t> samples(count);
+  for (size_t i = 0; i < count; ++i) {
+    samples[i] = int16_t(int(i % 997) * 29 + 1);
+  }
+  return samples;
+}
+
+std::string writeWav(const std::string &name, int sampleRate, int channels, const std::vector<int16_t> &samples)
+{
+  const std::string path = testing::TempDir() + name;
+  auto writer = WavWriter::create(path, sampleRate, channels);
+  writer->write(samples.data(), samples.size());
+  writer->close();
+  return path;
+}
+
+std::unique_ptr<FileAudioDevice> createDevice(const FileAudioDevice::Config &config, LoopbackAudioBus &bus)
+{
+  return FileAudioDevice::create(config, [&bus](const int16_t *samples, size_t count) { bus.writeCaptureData(samples, count); },
+      [&bus](int16_t *samples, size_t count) { return bus.readRenderData(samples, count); });
+}
+
+}
+
+TEST(FileAudioDeviceTest, RejectsWhatItCannotOpen)
+{
+  auto bus = LoopbackAudioBus::create(16000, 0);
+  FileAudioDevice::Config config;
+  config.capturePath = testing::TempDir() + "file_audio_device_missing.wav";
+  EXPECT_EQ(createDevice(config, *bus), nullptr);
+  config.capturePath.clear();
+  config.renderPath = testing::TempDir() + "missing/dir/render.wav";
+  EXPECT_EQ(createDevice(config, *bus), nullptr);
+  config.renderPath.clear();
+  config.sampleRate = 0;
+  EXPECT_EQ(createDevice(config, *bus), nullptr);
+}
+
+TEST(FileAudioDeviceTest, LoopbackRendersTheCaptureFileAfterTheDelay)
+{
+  const std::vector<int16_t> input = pattern(16000);
+  FileAudioDevice::Config config;
+  config.capturePath = writeWav("file_audio_device_capture.wav", 16000, 1, input);
+  config.renderPath = testing::TempDir() + "file_audio_device_render.wav";
+  config.loop = false;
+  auto bus = LoopbackAudioBus::create(16000, 40);
+  auto device = createDevice(config, *bus);
+  ASSERT_NE(device, nullptr);
+  device->setCapturing(true);
+  device->setRendering(true);
+  for (int i = 0; i < 120; ++i) {
+    device->processChunk();
+  }
+  FileAudioDevice::Stats stats = device->stats();
+  EXPECT_EQ(stats.capturedFrames, 16000u);
+  EXPECT_EQ(stats.renderedSamples, 120u * 160u);
+  EXPECT_EQ(stats.bridge.renderUnderflows, 0u);
+  ASSERT_TRUE(device->closeRenderFile());
+
+  // The bus's 40 ms of silence fill the render queue at first; from then
+  // on every chunk is captured audio, with no gaps.
+  auto reader = WavReader::open(config.renderPath);
+  ASSERT_NE(reader, nullptr);
+  ASSERT_EQ(reader->frameCount(), 120u * 160u);
+  std::vector<int16_t> output(reader->frameCount());
+  reader->readMono(0, output.data(), output.size());
+  EXPECT_EQ(std::vector<int16_t>(output.begin(), output.begin() + 640), std::vector<int16_t>(640, 0));
+  EXPECT_EQ(std::vector<int16_t>(output.begin() + 640, output.begin() + 640 + 16000), input);
+  EXPECT_EQ(std::vector<int16_t>(output.begin() + 640 + 16000, output.end()), std::vector<int16_t>(output.size() - 16640, 0));
+  remove(config.capturePath.c_str());
+  remove(config.renderPath.c_str());
+}
+
+TEST(FileAudioDeviceTest, RenderingResumesAfterAFlush)
+{
+  FileAudioDevice::Config config;
+  config.renderPath = testing::TempDir() + "file_audio_device_resume.wav";
+  auto bus = LoopbackAudioBus::create(16000, 0);
+  auto device = createDevice(config, *bus);
+  ASSERT_NE(device, nullptr);
+  device->setRendering(true);
+  for (int i = 0; i < 5; ++i) {
+    device->processChunk();
+  }
+  // The SDK stops rendering, which completes the file as it stands...
+  device->setRendering(false);
+  ASSERT_TRUE(device->flushRenderFile());
+  auto reader = WavReader::open(config.renderPath);
+  ASSERT_NE(reader, nullptr);
+  EXPECT_EQ(reader->frameCount(), 5u * 160u);
+
+  // ...and starts again, which appends to it.
+  device->setRendering(true);
+  for (int i = 0; i < 3; ++i) {
+    device->processChunk();
+  }
+  ASSERT_TRUE(device->closeRenderFile());
+  reader = WavReader::open(config.renderPath);
+  ASSERT_NE(reader, nullptr);
+  EXPECT_EQ(reader->frameCount(), 8u * 160u);
+  remove(config.renderPath.c_str());
+}
+
+TEST(FileAudioDeviceTest, ConvertsAndLoopsTheCaptureFile)
+{
+  // 50 ms of 48 kHz stereo, looped into a 16 kHz bus.
+  std::vector<int16_t> input(2 * 2400, 1000);
+  FileAudioDevice::Config config;
+  config.capturePath = writeWav("file_audio_device_stereo.wav", 48000, 2, input);
+  auto bus = LoopbackAudioBus::create(16000, 0, 2000);
+  auto device = createDevice(config, *bus);
+  ASSERT_NE(device, nullptr);
+  device->setCapturing(true);
+  for (int i = 0; i < 20; ++i) {
+    device->processChunk();
+  }
+  EXPECT_EQ(device->stats().capturedFrames, 20u * 480u);
+  EXPECT_EQ(bus->capturedSamples(), 20u * 160u);
+
+  // Past the filter's start-up, the constant comes through unchanged.
+  std::vector<int16_t> output(3200);
+  ASSERT_EQ(bus->readRenderData(output.data(), output.size()), 3200u);
+  for (size_t i = 400; i < output.size(); ++i) {
+    ASSERT_NEAR(output[i], 1000, 2) << i;
+  }
+}
+
+TEST(FileAudioDeviceTest, NothingMovesWhileOff)
+{
+  auto bus = LoopbackAudioBus::create(16000, 0);
+  auto device = createDevice(FileAudioDevice::Config(), *bus);
+  ASSERT_NE(device, nullptr);
+  device->processChunk();
+  EXPECT_EQ(bus->capturedSamples(), 0u);
+  EXPECT_EQ(device->stats().renderedSamples, 0u);
+
+  // Without a capture file the device captures silence.
+  device->setCapturing(true);
+  device->processChunk();
+  EXPECT_EQ(bus->capturedSamples(), 160u);
+  EXPECT_EQ(device->stats().capturedFrames, 0u);
+}
+
+TEST(FileAudioDeviceTest, RealTimeChunksArePaced)
+{
+  auto bus = LoopbackAudioBus::create(16000, 0);
+  FileAudioDevice::Config config;
+  config.chunkLimit = 20;
+  auto device = createDevice(config, *bus);
+  device->setCapturing(true);
+  device->setRendering(true);
+  ASSERT_TRUE(device->start());
+  EXPECT_FALSE(device->start());
+  device->wait();
+  device->stop();
+
+  // The last chunk is due 190 ms after the first.
+  FileAudioDevice::Stats stats = device->stats();
+  EXPECT_EQ(stats.chunks, 20u);
+  EXPECT_GE(stats.elapsedUs, 190000);
+  EXPECT_LT(stats.elapsedUs, 2000000);
+  EXPECT_EQ(bus->capturedSamples(), stats.chunks * 160u);
+}
+
+TEST(FileAudioDeviceTest, FreeRunningIsFasterThanRealTime)
+{
+  auto bus = LoopbackAudioBus::create(16000, 40);
+  FileAudioDevice::Config config;
+  config.capturePath = writeWav("file_audio_device_free.wav", 16000, 1, pattern(1600));
+  config.realTime = false;
+  config.chunkLimit = 1000;
+  auto device = createDevice(config, *bus);
+  device->setCapturing(true);
+  device->setRendering(true);
+  ASSERT_TRUE(device->start());
+  device->wait();
+  device->stop();
+
+  // 10 s of audio.
+  FileAudioDevice::Stats stats = device->stats();
+  EXPECT_EQ(stats.chunks, 1000u);
+  EXPECT_EQ(stats.skipped, 0u);
+  EXPECT_EQ(stats.capturedFrames, 160000u);
+  EXPECT_LT(stats.elapsedUs, 5000000);
+  EXPECT_EQ(stats.bridge.renderUnderflows, 0u);
+  remove(config.capturePath.c_str());
+}
+
+TEST(FileAudioDeviceTest, StopsPromptly)
+{
+  auto bus = LoopbackAudioBus::create(16000, 0);
+  auto device = createDevice(FileAudioDevice::Config(), *bus);
+  ASSERT_TRUE(device->start());
+  device->stop();
+  device->stop();
+  EXPECT_TRUE(device->start());
+  device->stop();
+}
@@ -0,0 +1,95 @@
+//
+//  FrameBufferTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/Memory.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace tivonage;
+
+TEST(FrameBufferTest, RejectsEmptyDimensions)
+{
+  EXPECT_EQ(FrameBuffer::create(PixelFormat::I420, 0, 480), nullptr);
+  EXPECT_EQ(FrameBuffer::create(PixelFormat::I420, 640, -1), nullptr);
+}
+
+TEST(FrameBufferTest, LaysOutI420Planes)
+{
+  auto buffer = FrameBuffer::create(PixelFormat::I420, 641, 361);
+  ASSERT_NE(buffer, nullptr);
+
+  const VideoFrame &frame = buffer->frame();
+  EXPECT_EQ(frame.width, 641);
+  EXPECT_EQ(frame.height, 361);
+  EXPECT_GE(frame.planes[0].stride, 641);
+  EXPECT_GE(frame.planes[1].stride, 321);
+  EXPECT_GE(frame.planes[2].stride, 321);
+  for (int plane = 0; plane < 3; ++plane) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(frame.planes[plane].data) % kSimdAlignment, 0u);
+    EXPECT_EQ(frame.planes[plane].stride % int(kSimdAlignment), 0);
+  }
+  EXPECT_EQ(frame.planes[1].data, frame.planes[0].data + frame.planes[0].stride * 361);
+  EXPECT_EQ(frame.planes[2].data, frame.planes[1].data + frame.planes[1].stride * 181);
+}
+
+TEST(FrameBufferTest, LaysOutNV12AndARGBPlanes)
+{
+  auto nv12 = FrameBuffer::create(PixelFormat::NV12, 640, 480);
+  ASSERT_NE(nv12, nullptr);
+  EXPECT_GE(nv12->frame().planes[1].stride, 640);
+  EXPECT_EQ(nv12->frame().planes[2].data, nullptr);
+
+  auto argb = FrameBuffer::create(PixelFormat::ARGB, 100, 10);
+  ASSERT_NE(argb, nullptr);
+  EXPECT_GE(argb->frame().planes[0].stride, 400);
+  EXPECT_EQ(argb->frame().planes[1].data, nullptr);
+}
+
+TEST(FrameBufferTest, PlanesAreWritable)
+{
+  auto buffer = FrameBuffer::create(PixelFormat::I420, 64, 64);
+  ASSERT_NE(buffer, nullptr);
+  VideoFrame &frame = buffer->frame();
+  for (int plane = 0; plane < 3; ++plane) {
+    int rows = planeRows(frame.format, plane, frame.height);
+    for (int y = 0; y < rows; ++y) {
+      memset(frame.planes[plane].data + y * frame.planes[plane].stride, plane + 1, size_t(planeRowBytes(frame.format, plane, frame.width)));
+    }
+  }
+  EXPECT_EQ(frame.planes[0].data[63 * frame.planes[0].stride + 63], 1);
+  EXPECT_EQ(frame.planes[2].data[31 * frame.planes[2].stride + 31], 3);
+}
+
+TEST(FrameBufferTest, CopyFrameHonoursStrides)
+{
+  std::vector<uint8_t> luma(20 * 4), chroma(12 * 2 * 2);
+  for (size_t i = 0; i < luma.size(); ++i) {
+    luma[i] = uint8_t(i);
+  }
+  VideoFrame source;
+  source.format = PixelFormat::I420;
+  source.width = 16;
+  source.height = 4;
+  source.planes[0] = { luma.data(), 20 };
+  source.planes[1] = { chroma.data(), 12 };
+  source.planes[2] = { chroma.data() + 24, 12 };
+  source.timestampUs = 1234;
+
+  auto buffer = FrameBuffer::create(PixelFormat::I420, 16, 4);
+  ASSERT_TRUE(copyFrame(source, buffer->frame()));
+  const VideoPlane &y = buffer->frame().planes[0];
+  EXPECT_EQ(y.data[0], 0);
+  EXPECT_EQ(y.data[15], 15);
+  EXPECT_EQ(y.data[y.stride], 20);
+  EXPECT_EQ(y.data[3 * y.stride + 15], 75);
+  EXPECT_EQ(buffer->frame().timestampUs, 1234);
+
+  auto other = FrameBuffer::create(PixelFormat::NV12, 16, 4);
+  EXPECT_FALSE(copyFrame(source, other->frame()));
+}
@@ -0,0 +1,108 @@
+//
+//  FrameMailboxTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameMailbox.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace tivonage;
+
+namespace {
+
+FrameHandle numberedFrame(FramePool &pool, int64_t number)
+{
+  FrameHandle handle = pool.acquire(PixelFormat::I420, 16, 16);
+  if (handle) {
+    handle.frame().timestampUs = number;
+  }
+  return handle;
+}
+
+}
+
+TEST(FrameMailboxTest, TakesNothingUntilPublished)
+{
+  FrameMailbox mailbox;
+  FrameHandle frame;
+  EXPECT_FALSE(mailbox.hasFrame());
+  EXPECT_FALSE(mailbox.take(frame));
+  EXPECT_FALSE(frame);
+}
+
+TEST(FrameMailboxTest, LatestFrameWins)
+{
+  auto pool = FramePool::create(4);
+  FrameMailbox mailbox;
+  EXPECT_TRUE(mailbox.publish(numberedFrame(*pool, 1)));
+  EXPECT_FALSE(mailbox.publish(numberedFrame(*pool, 2)));
+  EXPECT_FALSE(mailbox.publish(numberedFrame(*pool, 3)));
+
+  // Replaced frames go straight back to the pool.
+  EXPECT_EQ(pool->inFlight(), 1u);
+
+  FrameHandle frame;
+  ASSERT_TRUE(mailbox.take(frame));
+  EXPECT_EQ(frame.frame().timestampUs, 3);
+  EXPECT_FALSE(mailbox.take(frame));
+  EXPECT_EQ(frame.frame().timestampUs, 3);
+
+  FrameMailbox::Counters counters = mailbox.counters();
+  EXPECT_EQ(counters.published, 3u);
+  EXPECT_EQ(counters.taken, 1u);
+  EXPECT_EQ(counters.dropped, 2u);
+}
+
+TEST(FrameMailboxTest, HoldsAtMostOneFramePerSide)
+{
+  auto pool = FramePool::create(3);
+  FrameMailbox mailbox;
+  FrameHandle shown;
+  for (int64_t i = 1; i <= 100; ++i) {
+    ASSERT_TRUE(mailbox.publish(numberedFrame(*pool, i)));
+    ASSERT_TRUE(mailbox.take(shown));
+    ASSERT_EQ(shown.frame().timestampUs, i);
+    ASSERT_LE(pool->inFlight(), 2u);
+  }
+  EXPECT_EQ(mailbox.counters().dropped, 0u);
+}
+
+TEST(FrameMailboxTest, ConsumerSeesIncreasingFramesUnderContention)
+{
+  auto pool = FramePool::create(5);
+  FrameMailbox mailbox;
+  const int64_t count = 200000;
+  std::atomic<bool> done { false };
+
+  std::thread producer([&] {
+    for (int64_t i = 1; i <= count; ++i) {
+      FrameHandle frame = numberedFrame(*pool, i);
+      // Producer holds one, the mailbox at most three: the pool can't run dry.
+      ASSERT_TRUE(frame);
+      mailbox.publish(std::move(frame));
+    }
+    done.store(true);
+  });
+
+  int64_t last = 0;
+  uint64_t taken = 0;
+  FrameHandle frame;
+  while (!done.load() || mailbox.hasFrame()) {
+    if (mailbox.take(frame)) {
+      ASSERT_GT(frame.frame().timestampUs, last);
+      last = frame.frame().timestampUs;
+      ++taken;
+    }
+  }
+  producer.join();
+
+  EXPECT_EQ(last, count);
+  FrameMailbox::Counters counters = mailbox.counters();
+  EXPECT_EQ(counters.published, uint64_t(count));
+  EXPECT_EQ(counters.taken, taken);
+  EXPECT_EQ(counters.taken + counters.dropped, counters.published);
+}
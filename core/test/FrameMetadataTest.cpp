@@ -0,0 +1,66 @@
+//
+//  FrameMetadataTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameMetadata.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+using namespace tivonage;
+
+TEST(FrameMetadataTest, RoundTripsWithinThirtyTwoBytes)
+{
+  FrameMetadata metadata;
+  metadata.sequence = 0xDEADBEEF;
+  metadata.captureTimeUs = 1700000000123456;
+  metadata.payloadSize = FrameMetadata::kMaxPayloadSize;
+  memcpy(metadata.payload, "0123456789abcdef", FrameMetadata::kMaxPayloadSize);
+
+  uint8_t data[FrameMetadata::kMaxEncodedSize];
+  size_t size = encodeFrameMetadata(metadata, data, sizeof(data));
+  EXPECT_EQ(size, FrameMetadata::kMaxEncodedSize);
+
+  FrameMetadata decoded;
+  ASSERT_TRUE(decodeFrameMetadata(data, size, decoded));
+  EXPECT_EQ(decoded.sequence, metadata.sequence);
+  EXPECT_EQ(decoded.captureTimeUs, metadata.captureTimeUs);
+  EXPECT_EQ(decoded.payloadSize, metadata.payloadSize);
+  EXPECT_EQ(memcmp(decoded.payload, metadata.payload, metadata.payloadSize), 0);
+}
+
+TEST(FrameMetadataTest, EncodesWithoutPayload)
+{
+  FrameMetadata metadata;
+  metadata.sequence = 7;
+  uint8_t data[FrameMetadata::kMaxEncodedSize];
+  size_t size = encodeFrameMetadata(metadata, data, sizeof(data));
+  EXPECT_EQ(size, 16u);
+
+  FrameMetadata decoded;
+  ASSERT_TRUE(decodeFrameMetadata(data, size, decoded));
+  EXPECT_EQ(decoded.sequence, 7u);
+  EXPECT_EQ(decoded.payloadSize, 0);
+}
+
+TEST(FrameMetadataTest, RejectsForeignOrTruncatedData)
+{
+  FrameMetadata metadata;
+  metadata.payloadSize = 4;
+  uint8_t data[FrameMetadata::kMaxEncodedSize];
+  size_t size = encodeFrameMetadata(metadata, data, sizeof(data));
+
+  FrameMetadata decoded;
+  EXPECT_FALSE(decodeFrameMetadata(data, size - 1, decoded));
+  EXPECT_FALSE(decodeFrameMetadata(data, 3, decoded));
+
+  const uint8_t foreign[20] = { 'X', 'Y', 1 };
+  EXPECT_FALSE(decodeFrameMetadata(foreign, sizeof(foreign), decoded));
+
+  metadata.payloadSize = FrameMetadata::kMaxPayloadSize + 1;
+  EXPECT_EQ(encodeFrameMetadata(metadata, data, sizeof(data)), 0u);
+  metadata.payloadSize = 0;
+  EXPECT_EQ(encodeFrameMetadata(metadata, data, 8), 0u);
+}
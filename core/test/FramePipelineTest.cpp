@@ -0,0 +1,157 @@
+//
+//  FramePipelineTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/Clock.h"
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/FramePipeline.h"
+
+#include <gtest/gtest.h>
+
+using namespace tivonage;
+
+namespace {
+
+class TestStage : public FrameStage {
+public:
+  TestStage(int64_t costUs, bool skippable, bool keep = true)
+      : m_costUs(costUs)
+      , m_skippable(skippable)
+      , m_keep(keep)
+  {
+  }
+
+  void setCostUs(int64_t costUs) { m_costUs = costUs; }
+
+  const char *name() const override { return "test"; }
+  bool skippable() const override { return m_skippable; }
+  bool process(VideoFrame &) override
+  {
+    ++calls;
+    const int64_t endUs = monotonicMicros() + m_costUs;
+    while (monotonicMicros() < endUs) {
+    }
+    return m_keep;
+  }
+
+  int calls = 0;
+
+private:
+  int64_t m_costUs;
+  bool m_skippable;
+  bool m_keep;
+};
+
+}
+
+TEST(FramePipelineTest, RunsEveryStageWithoutABudget)
+{
+  auto buffer = FrameBuffer::create(PixelFormat::I420, 16, 16);
+  FramePipeline pipeline;
+  auto *first = new TestStage(0, true);
+  auto *second = new TestStage(0, true);
+  pipeline.addStage(std::unique_ptr<FrameStage>(first));
+  pipeline.addStage(std::unique_ptr<FrameStage>(second));
+
+  for (int i = 0; i < 3; ++i) {
+    VideoFrame frame = buffer->frame();
+    EXPECT_TRUE(pipeline.run(frame));
+  }
+  EXPECT_EQ(first->calls, 3);
+  EXPECT_EQ(second->calls, 3);
+  EXPECT_EQ(pipeline.frames(), 3u);
+  EXPECT_EQ(pipeline.overBudgetFrames(), 0u);
+}
+
+TEST(FramePipelineTest, SkipsSkippableStagesOnceTheBudgetIsSpent)
+{
+  auto buffer = FrameBuffer::create(PixelFormat::I420, 16, 16);
+  FramePipeline pipeline(2000);
+  auto *slow = new TestStage(3000, false);
+  auto *effect = new TestStage(0, true);
+  auto *required = new TestStage(0, false);
+  pipeline.addStage(std::unique_ptr<FrameStage>(slow));
+  pipeline.addStage(std::unique_ptr<FrameStage>(effect));
+  pipeline.addStage(std::unique_ptr<FrameStage>(required));
+
+  VideoFrame frame = buffer->frame();
+  EXPECT_TRUE(pipeline.run(frame));
+  EXPECT_EQ(slow->calls, 1);
+  EXPECT_EQ(effect->calls, 0);
+  EXPECT_EQ(required->calls, 1);
+  EXPECT_EQ(pipeline.overBudgetFrames(), 1u);
+
+  std::vector<FramePipeline::StageStats> stats = pipeline.stageStats();
+  ASSERT_EQ(stats.size(), 3u);
+  EXPECT_EQ(stats[0].runs, 1u);
+  EXPECT_GE(stats[0].averageUs, 3000.0);
+  EXPECT_EQ(stats[1].skips, 1u);
+  EXPECT_EQ(stats[2].runs, 1u);
+}
+
+TEST(FramePipelineTest, ASkippedStageComesBackOnceItFitsAgain)
+{
+  auto buffer = FrameBuffer::create(PixelFormat::I420, 16, 16);
+  FramePipeline pipeline(2000);
+  auto *expensive = new TestStage(3000, true);
+  pipeline.addStage(std::unique_ptr<FrameStage>(expensive));
+  auto runFrames = [&](uint64_t count) {
+    for (uint64_t i = 0; i < count; ++i) {
+      VideoFrame frame = buffer->frame();
+      EXPECT_TRUE(pipeline.run(frame));
+    }
+  };
+
+  // The cold first run doesn't count; the second measures it, and from then
+  // on it no longer fits.
+  runFrames(5);
+  EXPECT_EQ(expensive->calls, 2);
+  EXPECT_EQ(pipeline.stageStats()[0].skips, 3u);
+
+  // Still too slow when probed: skipped for another round.
+  runFrames(FramePipeline::kProbeFrames - 3 + 1);
+  EXPECT_EQ(expensive->calls, 3);
+
+  // Cheap again: the next probe brings it back for good.
+  expensive->setCostUs(0);
+  runFrames(FramePipeline::kProbeFrames + 10);
+  EXPECT_EQ(expensive->calls, 3 + 10);
+  EXPECT_LT(pipeline.stageStats()[0].averageUs, 2000.0);
+}
+
+TEST(FramePipelineTest, AColdFirstRunDoesNotSwitchAStageOff)
+{
+  auto buffer = FrameBuffer::create(PixelFormat::I420, 16, 16);
+  FramePipeline pipeline(2000);
+  auto *stage = new TestStage(3000, true);
+  pipeline.addStage(std::unique_ptr<FrameStage>(stage));
+
+  VideoFrame frame = buffer->frame();
+  EXPECT_TRUE(pipeline.run(frame));
+  stage->setCostUs(0);
+  for (int i = 0; i < 5; ++i) {
+    frame = buffer->frame();
+    EXPECT_TRUE(pipeline.run(frame));
+  }
+  EXPECT_EQ(stage->calls, 6);
+  EXPECT_EQ(pipeline.stageStats()[0].skips, 0u);
+}
+
+TEST(FramePipelineTest, ADroppedFrameStopsTheChain)
+{
+  auto buffer = FrameBuffer::create(PixelFormat::I420, 16, 16);
+  FramePipeline pipeline;
+  auto *dropping = new TestStage(0, true, false);
+  auto *after = new TestStage(0, true);
+  pipeline.addStage(std::unique_ptr<FrameStage>(dropping));
+  pipeline.addStage(std::unique_ptr<FrameStage>(after));
+
+  VideoFrame frame = buffer->frame();
+  EXPECT_FALSE(pipeline.run(frame));
+  EXPECT_EQ(after->calls, 0);
+
+  pipeline.clear();
+  EXPECT_EQ(pipeline.stageCount(), 0u);
+  EXPECT_TRUE(pipeline.run(frame));
+}
@@ -0,0 +1,100 @@
+//
+//  FramePoolTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FramePool.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace tivonage;
+
+TEST(FramePoolTest, ReusesBuffersOfTheSameGeometry)
+{
+  auto pool = FramePool::create(2);
+  uint8_t *first = nullptr;
+  {
+    FrameHandle handle = pool->acquire(PixelFormat::I420, 640, 480);
+    ASSERT_TRUE(handle);
+    first = handle.frame().planes[0].data;
+  }
+  FrameHandle again = pool->acquire(PixelFormat::I420, 640, 480);
+  EXPECT_EQ(again.frame().planes[0].data, first);
+
+  FramePool::Counters counters = pool->counters();
+  EXPECT_EQ(counters.acquired, 2u);
+  EXPECT_EQ(counters.allocated, 1u);
+  EXPECT_EQ(counters.reused, 1u);
+}
+
+TEST(FramePoolTest, ReportsExhaustionInsteadOfGrowing)
+{
+  auto pool = FramePool::create(2);
+  FrameHandle a = pool->acquire(PixelFormat::I420, 320, 240);
+  FrameHandle b = pool->acquire(PixelFormat::I420, 320, 240);
+  FrameHandle c = pool->acquire(PixelFormat::I420, 320, 240);
+  EXPECT_TRUE(a);
+  EXPECT_TRUE(b);
+  EXPECT_FALSE(c);
+  EXPECT_EQ(pool->inFlight(), 2u);
+  EXPECT_EQ(pool->counters().exhausted, 1u);
+
+  a.reset();
+  EXPECT_EQ(pool->inFlight(), 1u);
+  EXPECT_TRUE(pool->acquire(PixelFormat::I420, 320, 240));
+}
+
+TEST(FramePoolTest, ReplacesIdleBuffersWhenGeometryChanges)
+{
+  auto pool = FramePool::create(1);
+  pool->acquire(PixelFormat::I420, 320, 240);
+  FrameHandle larger = pool->acquire(PixelFormat::I420, 1280, 720);
+  ASSERT_TRUE(larger);
+  EXPECT_EQ(larger.frame().width, 1280);
+  EXPECT_EQ(pool->counters().allocated, 2u);
+  EXPECT_FALSE(pool->acquire(PixelFormat::NV12, 1280, 720));
+}
+
+TEST(FramePoolTest, CopiesShareOneLease)
+{
+  auto pool = FramePool::create(1);
+  FrameHandle original = pool->acquire(PixelFormat::ARGB, 16, 16);
+  FrameHandle copy = original;
+  original.reset();
+  EXPECT_EQ(pool->inFlight(), 1u);
+  copy.reset();
+  EXPECT_EQ(pool->inFlight(), 0u);
+}
+
+TEST(FramePoolTest, DetachedLeaseSurvivesUntilAdopted)
+{
+  auto pool = FramePool::create(1);
+  void *opaque = pool->acquire(PixelFormat::I420, 64, 64).detach();
+  EXPECT_EQ(pool->inFlight(), 1u);
+  FrameHandle::adopt(opaque);
+  EXPECT_EQ(pool->inFlight(), 0u);
+}
+
+TEST(FramePoolTest, HandlesOutliveThePoolOwner)
+{
+  auto pool = FramePool::create(1);
+  FrameHandle handle = pool->acquire(PixelFormat::I420, 64, 64);
+  pool.reset();
+  handle.frame().planes[0].data[0] = 42;
+  handle.reset();
+}
+
+TEST(FramePoolTest, ReleasesFromAnotherThread)
+{
+  auto pool = FramePool::create(3);
+  std::vector<FrameHandle> handles;
+  for (int i = 0; i < 1000; ++i) {
+    FrameHandle handle = pool->acquire(PixelFormat::I420, 32, 32);
+    ASSERT_TRUE(handle);
+    std::thread([handle = std::move(handle)]() mutable { handle.reset(); }).join();
+  }
+  EXPECT_EQ(pool->counters().allocated, 1u);
+}
@@ -0,0 +1,139 @@
+//
+//  FrameProcessorTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/FrameProcessor.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace tivonage;
+
+namespace {
+
+struct Sink {
+  std::mutex mutex;
+  std::condition_variable changed;
+  int frames = 0;
+  int width = 0;
+  uint8_t firstLuma = 0;
+  int64_t timestampUs = 0;
+
+  FrameProcessor::Output output()
+  {
+    return [this](const VideoFrame &frame) {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++frames;
+      width = frame.width;
+      firstLuma = frame.planes[0].data[0];
+      timestampUs = frame.timestampUs;
+      changed.notify_all();
+    };
+  }
+
+  bool waitFor(int count)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    return changed.wait_for(lock, std::chrono::seconds(5), [&] { return frames >= count; });
+  }
+};
+
+std::unique_ptr<FrameBuffer> grey(uint8_t luma)
+{
+  auto buffer = FrameBuffer::create(PixelFormat::I420, 32, 32);
+  VideoFrame &frame = buffer->frame();
+  std::fill_n(frame.planes[0].data, frame.planes[0].stride * 32, luma);
+  std::fill_n(frame.planes[1].data, frame.planes[1].stride * 16, uint8_t(128));
+  std::fill_n(frame.planes[2].data, frame.planes[2].stride * 16, uint8_t(128));
+  return buffer;
+}
+
+}
+
+TEST(FrameProcessorTest, PassesFramesThroughWithoutStages)
+{
+  Sink sink;
+  auto processor = FrameProcessor::create(sink.output());
+  ASSERT_NE(processor, nullptr);
+
+  auto source = grey(77);
+  source->frame().timestampUs = 42;
+  ASSERT_TRUE(processor->submit(source->frame()));
+  ASSERT_TRUE(sink.waitFor(1));
+  EXPECT_EQ(sink.firstLuma, 77);
+  EXPECT_EQ(sink.width, 32);
+  EXPECT_EQ(sink.timestampUs, 42);
+  EXPECT_EQ(processor->counters().submitted, 1u);
+}
+
+TEST(FrameProcessorTest, RunsTheStagesOnTheWorker)
+{
+  Sink sink;
+  auto processor = FrameProcessor::create(sink.output());
+  std::vector<std::unique_ptr<FrameStage>> stages;
+  stages.push_back(std::unique_ptr<FrameStage>(new CropStage(0, 0, 16, 16)));
+  stages.push_back(LutStage::adjust(1.0f, 1.0f, 1.0f));
+  processor->setStages(std::move(stages));
+
+  auto source = grey(100);
+  for (int i = 1; i <= 5; ++i) {
+    ASSERT_TRUE(processor->submit(source->frame()));
+    ASSERT_TRUE(sink.waitFor(i));
+  }
+  EXPECT_EQ(sink.width, 16);
+  EXPECT_EQ(sink.firstLuma, 235);
+
+  std::vector<FramePipeline::StageStats> stats = processor->stageStats();
+  ASSERT_EQ(stats.size(), 2u);
+  EXPECT_EQ(stats[0].name, "crop");
+  EXPECT_EQ(stats[1].name, "lut");
+  EXPECT_EQ(stats[1].runs, 5u);
+  EXPECT_EQ(processor->counters().processed, 5u);
+}
+
+TEST(FrameProcessorTest, KeepsOnlyTheNewestFrameWhileBusy)
+{
+  Sink sink;
+  std::mutex gate;
+  std::unique_lock<std::mutex> hold(gate);
+  auto processor = FrameProcessor::create([&](const VideoFrame &frame) {
+    std::lock_guard<std::mutex> wait(gate);
+    sink.output()(frame);
+  });
+
+  // The first frame blocks the worker in the output; the rest queue up.
+  auto source = grey(1);
+  processor->submit(source->frame());
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  for (uint8_t luma = 2; luma <= 10; ++luma) {
+    auto next = grey(luma);
+    processor->submit(next->frame());
+  }
+  hold.unlock();
+
+  ASSERT_TRUE(sink.waitFor(2));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(sink.frames, 2);
+  EXPECT_EQ(sink.firstLuma, 10);
+  FrameProcessor::Counters counters = processor->counters();
+  EXPECT_EQ(counters.submitted, 10u);
+  EXPECT_EQ(counters.processed, 2u);
+  EXPECT_EQ(counters.dropped, 8u);
+}
+
+TEST(FrameProcessorTest, RejectsFramesAfterStop)
+{
+  Sink sink;
+  auto processor = FrameProcessor::create(sink.output());
+  processor->stop();
+  processor->stop();
+  auto source = grey(5);
+  EXPECT_FALSE(processor->submit(source->frame()));
+}
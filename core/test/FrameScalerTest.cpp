@@ -0,0 +1,319 @@
+//
+//  FrameScalerTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/FrameScaler.h"
+#include "tivonage/PixelConvert.h"
+#include "tivonage/Simd.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace tivonage;
+
+namespace {
+
+std::vector<SimdLevel> availableLevels()
+{
+  std::vector<SimdLevel> levels = { SimdLevel::Scalar };
+  SimdLevel detected = detectedSimdLevel();
+  if (detected == SimdLevel::AVX2) {
+    levels.push_back(SimdLevel::SSE2);
+  }
+  if (detected != SimdLevel::Scalar) {
+    levels.push_back(detected);
+  }
+  return levels;
+}
+
+void fillRandom(VideoFrame &frame, uint32_t seed)
+{
+  std::mt19937 random(seed);
+  for (int plane = 0; plane < planeCount(frame.format); ++plane) {
+    int rows = planeRows(frame.format, plane, frame.height);
+    for (int y = 0; y < rows; ++y) {
+      for (int x = 0; x < frame.planes[plane].stride; ++x) {
+        frame.planes[plane].data[y * frame.planes[plane].stride + x] = uint8_t(random());
+      }
+    }
+  }
+}
+
+void fillConstant(VideoFrame &frame, uint8_t value)
+{
+  for (int plane = 0; plane < planeCount(frame.format); ++plane) {
+    memset(frame.planes[plane].data, value, size_t(frame.planes[plane].stride * planeRows(frame.format, plane, frame.height)));
+  }
+}
+
+bool samePixels(const VideoFrame &a, const VideoFrame &b)
+{
+  for (int plane = 0; plane < planeCount(a.format); ++plane) {
+    int rowBytes = planeRowBytes(a.format, plane, a.width);
+    for (int y = 0; y < planeRows(a.format, plane, a.height); ++y) {
+      if (memcmp(a.planes[plane].data + y * a.planes[plane].stride, b.planes[plane].data + y * b.planes[plane].stride, size_t(rowBytes)) != 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Reference rotation, one sample at a time, of an upright plane.
+void rotatePlane(const VideoPlane &source, int width, int height, VideoPlane &destination, int channels, Rotation rotation)
+{
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      int outX = x;
+      int outY = y;
+      switch (rotation) {
+      case Rotation::None:
+        break;
+      case Rotation::Clockwise90:
+        outX = height - 1 - y;
+        outY = x;
+        break;
+      case Rotation::Clockwise180:
+        outX = width - 1 - x;
+        outY = height - 1 - y;
+        break;
+      case Rotation::Clockwise270:
+        outX = y;
+        outY = width - 1 - x;
+        break;
+      }
+      memcpy(destination.data + outY * destination.stride + outX * channels, source.data + y * source.stride + x * channels, size_t(channels));
+    }
+  }
+}
+
+class FrameScalerTest : public ::testing::TestWithParam<ScaleFilter> {
+protected:
+  void TearDown() override { setSimdLevelLimit(SimdLevel::NEON); }
+};
+
+}
+
+TEST_P(FrameScalerTest, SimdMatchesScalarReference)
+{
+  const PixelFormat formats[] = { PixelFormat::I420, PixelFormat::NV12, PixelFormat::ARGB };
+  const int sizes[][4] = { { 1280, 720, 320, 180 }, { 1280, 720, 640, 360 }, { 640, 480, 254, 190 }, { 67, 35, 20, 12 }, { 33, 33, 32, 32 }, { 100, 50, 150, 76 } };
+
+  for (PixelFormat format : formats) {
+    for (const auto &size : sizes) {
+      auto source = FrameBuffer::create(format, size[0], size[1]);
+      fillRandom(source->frame(), uint32_t(size[0] + size[2]));
+
+      setSimdLevelLimit(SimdLevel::Scalar);
+      FrameScaler reference(GetParam());
+      auto expected = FrameBuffer::create(format, size[2], size[3]);
+      ASSERT_TRUE(reference.scale(source->frame(), expected->frame()));
+
+      for (SimdLevel level : availableLevels()) {
+        setSimdLevelLimit(level);
+        FrameScaler scaler(GetParam());
+        auto actual = FrameBuffer::create(format, size[2], size[3]);
+        ASSERT_TRUE(scaler.scale(source->frame(), actual->frame()));
+        EXPECT_TRUE(samePixels(expected->frame(), actual->frame()))
+            << simdLevelName(level) << " " << size[0] << "x" << size[1] << "->" << size[2] << "x" << size[3];
+      }
+    }
+  }
+}
+
+TEST_P(FrameScalerTest, PreservesConstantColor)
+{
+  auto source = FrameBuffer::create(PixelFormat::ARGB, 641, 479);
+  fillConstant(source->frame(), 0x5A);
+  auto destination = FrameBuffer::create(PixelFormat::ARGB, 97, 61);
+
+  FrameScaler scaler(GetParam());
+  ASSERT_TRUE(scaler.scale(source->frame(), destination->frame()));
+  const VideoPlane &plane = destination->frame().planes[0];
+  for (int y = 0; y < 61; ++y) {
+    for (int x = 0; x < 97 * 4; ++x) {
+      ASSERT_EQ(plane.data[y * plane.stride + x], 0x5A) << x << "," << y;
+    }
+  }
+}
+
+TEST_P(FrameScalerTest, ScalesAndInterleavesI420ToNV12)
+{
+  auto source = FrameBuffer::create(PixelFormat::I420, 320, 240);
+  fillRandom(source->frame(), 7);
+
+  FrameScaler scaler(GetParam());
+  auto scaled = FrameBuffer::create(PixelFormat::I420, 160, 90);
+  ASSERT_TRUE(scaler.scale(source->frame(), scaled->frame()));
+  auto expected = FrameBuffer::create(PixelFormat::NV12, 160, 90);
+  ASSERT_TRUE(convertFrame(scaled->frame(), expected->frame()));
+
+  auto actual = FrameBuffer::create(PixelFormat::NV12, 160, 90);
+  ASSERT_TRUE(scaler.scale(source->frame(), actual->frame()));
+  EXPECT_TRUE(samePixels(expected->frame(), actual->frame()));
+}
+
+TEST_P(FrameScalerTest, RotationMatchesScaleThenRotate)
+{
+  const PixelFormat formats[] = { PixelFormat::I420, PixelFormat::NV12, PixelFormat::ARGB };
+  const Rotation rotations[] = { Rotation::Clockwise90, Rotation::Clockwise180, Rotation::Clockwise270 };
+  // Source size, then the upright (unrotated) scaled size.
+  const int sizes[][4] = { { 640, 480, 320, 240 }, { 64, 48, 64, 48 }, { 70, 38, 30, 18 }, { 37, 21, 37, 21 } };
+
+  for (PixelFormat format : formats) {
+    for (Rotation rotation : rotations) {
+      for (const auto &size : sizes) {
+        auto source = FrameBuffer::create(format, size[0], size[1]);
+        fillRandom(source->frame(), uint32_t(size[0] * 3 + size[2]));
+
+        setSimdLevelLimit(SimdLevel::Scalar);
+        FrameScaler reference(GetParam());
+        auto upright = FrameBuffer::create(format, size[2], size[3]);
+        ASSERT_TRUE(reference.scale(source->frame(), upright->frame()));
+        const bool swap = swapsDimensions(rotation);
+        const int width = swap ? size[3] : size[2];
+        const int height = swap ? size[2] : size[3];
+        auto expected = FrameBuffer::create(format, width, height);
+        for (int plane = 0; plane < planeCount(format); ++plane) {
+          int channels = format == PixelFormat::ARGB ? 4 : (format == PixelFormat::NV12 && plane == 1 ? 2 : 1);
+          int planeWidth = plane == 0 ? size[2] : (size[2] + 1) / 2;
+          rotatePlane(upright->frame().planes[plane], planeWidth, planeRows(format, plane, size[3]), expected->frame().planes[plane], channels, rotation);
+        }
+
+        for (SimdLevel level : availableLevels()) {
+          setSimdLevelLimit(level);
+          FrameScaler scaler(GetParam());
+          auto actual = FrameBuffer::create(format, width, height);
+          ASSERT_TRUE(scaler.scale(source->frame(), actual->frame(), rotation));
+          EXPECT_EQ(actual->frame().orientation, VideoOrientation::Up);
+          EXPECT_TRUE(samePixels(expected->frame(), actual->frame()))
+              << simdLevelName(level) << " " << int(format) << " rotation " << int(rotation) << " " << size[0] << "x" << size[1];
+        }
+      }
+    }
+  }
+}
+
+TEST_P(FrameScalerTest, RotatesAndInterleavesI420ToNV12)
+{
+  auto source = FrameBuffer::create(PixelFormat::I420, 320, 240);
+  fillRandom(source->frame(), 11);
+
+  FrameScaler scaler(GetParam());
+  auto rotated = FrameBuffer::create(PixelFormat::I420, 90, 160);
+  ASSERT_TRUE(scaler.scale(source->frame(), rotated->frame(), Rotation::Clockwise90));
+  auto expected = FrameBuffer::create(PixelFormat::NV12, 90, 160);
+  ASSERT_TRUE(convertFrame(rotated->frame(), expected->frame()));
+
+  auto actual = FrameBuffer::create(PixelFormat::NV12, 90, 160);
+  ASSERT_TRUE(scaler.scale(source->frame(), actual->frame(), Rotation::Clockwise90));
+  EXPECT_TRUE(samePixels(expected->frame(), actual->frame()));
+}
+
+INSTANTIATE_TEST_SUITE_P(AllFilters, FrameScalerTest, ::testing::Values(ScaleFilter::Box, ScaleFilter::Bilinear));
+
+TEST(FrameScalerBoxTest, AveragesEachBlock)
+{
+  auto source = FrameBuffer::create(PixelFormat::I420, 4, 2);
+  VideoPlane &luma = source->frame().planes[0];
+  const uint8_t rows[2][4] = { { 10, 20, 100, 200 }, { 30, 40, 50, 51 } };
+  for (int y = 0; y < 2; ++y) {
+    memcpy(luma.data + y * luma.stride, rows[y], 4);
+  }
+
+  uint8_t output[2];
+  FrameScaler scaler(ScaleFilter::Box);
+  scaler.scalePlane(luma.data, luma.stride, 4, 2, output, 2, 2, 1, 1);
+  EXPECT_EQ(output[0], 25);
+  EXPECT_EQ(output[1], 100);
+}
+
+TEST(FrameScalerBoxTest, PowerOfTwoBoxesMatchTheRoundedAverage)
+{
+  // 2x2, 4x4 and 1x1 boxes take the halving kernels; the 8x64 box (area 512)
+  // is too large for them and takes the reciprocal path.
+  const int sizes[][4] = { { 74, 6, 37, 3 }, { 148, 12, 37, 3 }, { 296, 512, 37, 8 }, { 32, 4, 32, 4 } };
+  std::mt19937 random(7);
+  for (int channels : { 1, 2, 4 }) {
+    for (const auto &size : sizes) {
+      const int sourceWidth = size[0];
+      const int sourceHeight = size[1];
+      const int width = size[2];
+      const int height = size[3];
+      std::vector<uint8_t> source(size_t(sourceWidth * sourceHeight * channels));
+      for (uint8_t &sample : source) {
+        sample = uint8_t(random());
+      }
+
+      const int boxWidth = sourceWidth / width;
+      const int boxHeight = sourceHeight / height;
+      std::vector<uint8_t> expected(size_t(width * height * channels));
+      for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+          for (int channel = 0; channel < channels; ++channel) {
+            int sum = 0;
+            for (int row = y * boxHeight; row < (y + 1) * boxHeight; ++row) {
+              for (int column = x * boxWidth; column < (x + 1) * boxWidth; ++column) {
+                sum += source[size_t((row * sourceWidth + column) * channels + channel)];
+              }
+            }
+            const int area = boxWidth * boxHeight;
+            expected[size_t((y * width + x) * channels + channel)] = uint8_t((sum + area / 2) / area);
+          }
+        }
+      }
+
+      for (SimdLevel level : availableLevels()) {
+        setSimdLevelLimit(level);
+        std::vector<uint8_t> actual(expected.size());
+        FrameScaler scaler(ScaleFilter::Box);
+        scaler.scalePlane(source.data(), sourceWidth * channels, sourceWidth, sourceHeight, actual.data(), width * channels, width, height, channels);
+        EXPECT_EQ(actual, expected) << simdLevelName(level) << " " << channels << " channels " << sourceWidth << "x" << sourceHeight;
+      }
+      setSimdLevelLimit(SimdLevel::NEON);
+    }
+  }
+}
+
+TEST(FrameScalerSizeTest, FillsBoundsWithoutUpscaling)
+{
+  int width = 0;
+  int height = 0;
+  scaledSizeToFill(1280, 720, 320, 180, width, height);
+  EXPECT_EQ(width, 320);
+  EXPECT_EQ(height, 180);
+
+  // Portrait tile over a landscape frame: height decides, width overflows.
+  scaledSizeToFill(640, 480, 190, 190, width, height);
+  EXPECT_EQ(width, 254);
+  EXPECT_EQ(height, 190);
+
+  scaledSizeToFill(640, 480, 1920, 1080, width, height);
+  EXPECT_EQ(width, 640);
+  EXPECT_EQ(height, 480);
+
+  scaledSizeToFill(640, 480, 0, 0, width, height);
+  EXPECT_EQ(width, 640);
+  EXPECT_EQ(height, 480);
+}
+
+TEST(FrameScalerSizeTest, MapsOrientationToUprightRotation)
+{
+  EXPECT_EQ(uprightRotation(VideoOrientation::Up), Rotation::None);
+  EXPECT_EQ(uprightRotation(VideoOrientation::Down), Rotation::Clockwise180);
+  EXPECT_EQ(uprightRotation(VideoOrientation::Left), Rotation::Clockwise90);
+  EXPECT_EQ(uprightRotation(VideoOrientation::Right), Rotation::Clockwise270);
+}
+
+TEST(FrameScalerSizeTest, RejectsFormatChanges)
+{
+  auto source = FrameBuffer::create(PixelFormat::ARGB, 64, 64);
+  auto destination = FrameBuffer::create(PixelFormat::I420, 32, 32);
+  FrameScaler scaler;
+  EXPECT_FALSE(scaler.scale(source->frame(), destination->frame()));
+}
@@ -0,0 +1,212 @@
+//
+//  FrameStageTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/FrameStage.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace tivonage;
+
+namespace {
+
+void fillRandom(VideoFrame &frame, uint32_t seed)
+{
+  std::mt19937 random(seed);
+  for (int plane = 0; plane < planeCount(frame.format); ++plane) {
+    for (int y = 0; y < planeRows(frame.format, plane, frame.height); ++y) {
+      for (int x = 0; x < planeRowBytes(frame.format, plane, frame.width); ++x) {
+        frame.planes[plane].data[y * frame.planes[plane].stride + x] = uint8_t(random());
+      }
+    }
+  }
+}
+
+void fillPlanes(VideoFrame &frame, uint8_t y, uint8_t u, uint8_t v)
+{
+  for (int row = 0; row < frame.height; ++row) {
+    std::fill_n(frame.planes[0].data + row * frame.planes[0].stride, frame.width, y);
+  }
+  for (int row = 0; row < (frame.height + 1) / 2; ++row) {
+    std::fill_n(frame.planes[1].data + row * frame.planes[1].stride, (frame.width + 1) / 2, u);
+    std::fill_n(frame.planes[2].data + row * frame.planes[2].stride, (frame.width + 1) / 2, v);
+  }
+}
+
+uint8_t sample(const VideoFrame &frame, int plane, int x, int y)
+{
+  return frame.planes[plane].data[y * frame.planes[plane].stride + x];
+}
+
+// Straightforward clamped box blur with the same per-pass rounding.
+std::vector<uint8_t> referenceBlur(const VideoFrame &frame, int radius)
+{
+  const int width = frame.width;
+  const int height = frame.height;
+  const int window = 2 * radius + 1;
+  const uint32_t reciprocal = (65536u + uint32_t(window) / 2) / uint32_t(window);
+  auto clamp = [](int value, int limit) { return std::min(std::max(value, 0), limit - 1); };
+  std::vector<uint8_t> horizontal(size_t(width * height));
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      uint32_t sum = 0;
+      for (int k = -radius; k <= radius; ++k) {
+        sum += sample(frame, 0, clamp(x + k, width), y);
+      }
+      horizontal[size_t(y * width + x)] = uint8_t((sum * reciprocal + 32768u) >> 16);
+    }
+  }
+  std::vector<uint8_t> result(size_t(width * height));
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      uint32_t sum = 0;
+      for (int k = -radius; k <= radius; ++k) {
+        sum += horizontal[size_t(clamp(y + k, height) * width + x)];
+      }
+      result[size_t(y * width + x)] = uint8_t((sum * reciprocal + 32768u) >> 16);
+    }
+  }
+  return result;
+}
+
+}
+
+TEST(FrameStageTest, CropMovesPlanePointersWithoutCopying)
+{
+  auto buffer = FrameBuffer::create(PixelFormat::I420, 64, 48);
+  fillRandom(buffer->frame(), 1);
+  VideoFrame frame = buffer->frame();
+
+  CropStage crop(9, 4, 30, 100);
+  ASSERT_TRUE(crop.process(frame));
+  EXPECT_EQ(frame.width, 30);
+  EXPECT_EQ(frame.height, 44);
+  EXPECT_EQ(frame.planes[0].data, buffer->frame().planes[0].data + 4 * buffer->frame().planes[0].stride + 8);
+  EXPECT_EQ(frame.planes[1].data, buffer->frame().planes[1].data + 2 * buffer->frame().planes[1].stride + 4);
+  EXPECT_EQ(frame.planes[2].data, buffer->frame().planes[2].data + 2 * buffer->frame().planes[2].stride + 4);
+
+  VideoFrame outside = buffer->frame();
+  CropStage empty(80, 0, 16, 16);
+  EXPECT_FALSE(empty.process(outside));
+}
+
+TEST(FrameStageTest, ScaleResizesIntoItsOwnBuffer)
+{
+  auto buffer = FrameBuffer::create(PixelFormat::NV12, 64, 48);
+  fillRandom(buffer->frame(), 4);
+  VideoFrame frame = buffer->frame();
+  frame.timestampUs = 1234;
+
+  ScaleStage scale(32, 24);
+  ASSERT_TRUE(scale.process(frame));
+  EXPECT_EQ(frame.format, PixelFormat::NV12);
+  EXPECT_EQ(frame.width, 32);
+  EXPECT_EQ(frame.height, 24);
+  EXPECT_EQ(frame.timestampUs, 1234);
+  EXPECT_NE(frame.planes[0].data, buffer->frame().planes[0].data);
+}
+
+TEST(FrameStageTest, NeutralAdjustmentKeepsVideoRangeSamples)
+{
+  auto buffer = FrameBuffer::create(PixelFormat::I420, 16, 16);
+  fillPlanes(buffer->frame(), 100, 60, 200);
+  VideoFrame frame = buffer->frame();
+
+  ASSERT_TRUE(LutStage::adjust(0.0f, 1.0f, 1.0f)->process(frame));
+  EXPECT_EQ(sample(frame, 0, 3, 3), 100);
+  EXPECT_EQ(sample(frame, 1, 3, 3), 60);
+  EXPECT_EQ(sample(frame, 2, 3, 3), 200);
+
+  // No saturation makes every pixel grey; full brightness clips to white.
+  ASSERT_TRUE(LutStage::adjust(1.0f, 1.0f, 0.0f)->process(frame));
+  EXPECT_EQ(sample(frame, 0, 3, 3), 235);
+  EXPECT_EQ(sample(frame, 1, 3, 3), 128);
+  EXPECT_EQ(sample(frame, 2, 3, 3), 128);
+}
+
+TEST(FrameStageTest, OverlayBlendsByAlphaAndClipsToTheFrame)
+{
+  // White where opaque, a transparent right half.
+  auto image = FrameBuffer::create(PixelFormat::ARGB, 8, 8);
+  for (int y = 0; y < 8; ++y) {
+    uint8_t *pixels = image->frame().planes[0].data + y * image->frame().planes[0].stride;
+    for (int x = 0; x < 8; ++x) {
+      pixels[4 * x + 0] = pixels[4 * x + 1] = pixels[4 * x + 2] = 255;
+      pixels[4 * x + 3] = x < 4 ? 255 : 0;
+    }
+  }
+  auto buffer = FrameBuffer::create(PixelFormat::I420, 16, 16);
+  fillPlanes(buffer->frame(), 16, 128, 128);
+  VideoFrame frame = buffer->frame();
+
+  auto overlay = OverlayStage::create(image->frame(), 12, 4, 1.0f);
+  ASSERT_NE(overlay, nullptr);
+  ASSERT_TRUE(overlay->process(frame));
+  EXPECT_EQ(sample(frame, 0, 12, 4), 235);
+  EXPECT_EQ(sample(frame, 0, 15, 11), 235);
+  EXPECT_EQ(sample(frame, 0, 11, 4), 16);
+  EXPECT_EQ(sample(frame, 0, 12, 12), 16);
+
+  auto half = OverlayStage::create(image->frame(), 0, 0, 0.5f);
+  ASSERT_TRUE(half->process(frame));
+  EXPECT_NEAR(sample(frame, 0, 0, 0), (16 + 235) / 2, 1);
+  EXPECT_EQ(sample(frame, 0, 5, 0), 16);
+}
+
+TEST(FrameStageTest, BlurMatchesAReferenceBoxBlur)
+{
+  auto buffer = FrameBuffer::create(PixelFormat::I420, 40, 30);
+  fillRandom(buffer->frame(), 2);
+  for (int radius : { 1, 3, 7, 20 }) {
+    auto copy = FrameBuffer::create(PixelFormat::I420, 40, 30);
+    fillRandom(copy->frame(), 2);
+    std::vector<uint8_t> expected = referenceBlur(copy->frame(), radius);
+
+    VideoFrame frame = copy->frame();
+    BlurStage blur(0, 0, 0, 0, radius);
+    ASSERT_TRUE(blur.process(frame));
+    for (int y = 0; y < frame.height; ++y) {
+      for (int x = 0; x < frame.width; ++x) {
+        ASSERT_EQ(sample(frame, 0, x, y), expected[size_t(y * frame.width + x)]) << "radius " << radius << " at " << x << "," << y;
+      }
+    }
+  }
+}
+
+TEST(FrameStageTest, BlurOnlyTouchesItsRectangle)
+{
+  auto buffer = FrameBuffer::create(PixelFormat::NV12, 32, 32);
+  fillRandom(buffer->frame(), 3);
+  auto original = FrameBuffer::create(PixelFormat::NV12, 32, 32);
+  fillRandom(original->frame(), 3);
+
+  VideoFrame frame = buffer->frame();
+  BlurStage blur(8, 8, 16, 16, 4);
+  ASSERT_TRUE(blur.process(frame));
+  int changed = 0;
+  for (int y = 0; y < 32; ++y) {
+    for (int x = 0; x < 32; ++x) {
+      bool inside = x >= 8 && x < 24 && y >= 8 && y < 24;
+      if (!inside) {
+        ASSERT_EQ(sample(frame, 0, x, y), sample(original->frame(), 0, x, y));
+      } else if (sample(frame, 0, x, y) != sample(original->frame(), 0, x, y)) {
+        ++changed;
+      }
+    }
+  }
+  EXPECT_GT(changed, 200);
+  for (int y = 0; y < 16; ++y) {
+    for (int x = 0; x < 32; ++x) {
+      bool inside = x >= 8 && x < 24 && y >= 4 && y < 12;
+      if (!inside) {
+        ASSERT_EQ(sample(frame, 1, x, y), sample(original->frame(), 1, x, y));
+      }
+    }
+  }
+}
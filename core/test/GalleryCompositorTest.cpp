@@ -0,0 +1,127 @@
+//
+//  GalleryCompositorTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/GalleryCompositor.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace tivonage;
+
+namespace {
+
+std::unique_ptr<FrameBuffer> solidFrame(PixelFormat format, int width, int height, uint8_t luma, uint8_t chroma)
+{
+  auto buffer = FrameBuffer::create(format, width, height);
+  VideoFrame &frame = buffer->frame();
+  for (int plane = 0; plane < planeCount(format); ++plane) {
+    for (int y = 0; y < planeRows(format, plane, height); ++y) {
+      memset(frame.planes[plane].data + y * frame.planes[plane].stride, plane ? chroma : luma, size_t(planeRowBytes(format, plane, width)));
+    }
+  }
+  return buffer;
+}
+
+uint8_t lumaAt(const VideoFrame &frame, int x, int y)
+{
+  return frame.planes[0].data[y * frame.planes[0].stride + x];
+}
+
+uint8_t chromaAt(const VideoFrame &frame, int x, int y)
+{
+  return frame.planes[1].data[(y / 2) * frame.planes[1].stride + (x & ~1)];
+}
+
+}
+
+TEST(GalleryCompositorTest, DrawsEachFrameIntoItsTileAndBlacksOutTheRest)
+{
+  GalleryLayout layout;
+  layout.update(640, 480, 3);
+  auto surface = solidFrame(PixelFormat::NV12, 640, 480, 0xEE, 0xEE);
+
+  std::vector<std::unique_ptr<FrameBuffer>> buffers;
+  buffers.push_back(solidFrame(PixelFormat::I420, 640, 480, 100, 60));
+  buffers.push_back(solidFrame(PixelFormat::NV12, 320, 240, 150, 90));
+  VideoFrame frames[3] = { buffers[0]->frame(), buffers[1]->frame(), VideoFrame() };
+
+  GalleryCompositor compositor;
+  ASSERT_TRUE(compositor.compose(layout.tiles(), frames, 3, surface->frame()));
+
+  const auto &tiles = layout.tiles();
+  const VideoFrame &out = surface->frame();
+  for (int y = 0; y < out.height; ++y) {
+    for (int x = 0; x < out.width; ++x) {
+      int tile = layout.tileAt(x, y);
+      uint8_t luma = tile == 0 ? 100 : tile == 1 ? 150 : GalleryCompositor::kBackgroundLuma;
+      uint8_t chroma = tile == 0 ? 60 : tile == 1 ? 90 : GalleryCompositor::kBackgroundChroma;
+      ASSERT_EQ(lumaAt(out, x, y), luma) << x << "," << y;
+      ASSERT_EQ(chromaAt(out, x, y), chroma) << x << "," << y;
+    }
+  }
+  EXPECT_GT(tiles[2].width, 0);
+}
+
+TEST(GalleryCompositorTest, CentreCropsToTheTileAspect)
+{
+  // A wide source with a bright centre column band: cropping to a square tile
+  // keeps only the centre.
+  auto source = solidFrame(PixelFormat::NV12, 400, 100, 20, 128);
+  for (int y = 0; y < 100; ++y) {
+    memset(source->frame().planes[0].data + y * source->frame().planes[0].stride + 150, 200, 100);
+  }
+  auto surface = solidFrame(PixelFormat::NV12, 100, 100, 0, 0);
+  GalleryTile tile;
+  tile.width = 100;
+  tile.height = 100;
+
+  GalleryCompositor compositor;
+  ASSERT_TRUE(compositor.drawTile(source->frame(), tile, surface->frame()));
+  for (int y = 0; y < 100; y += 9) {
+    for (int x = 0; x < 100; x += 7) {
+      ASSERT_EQ(lumaAt(surface->frame(), x, y), 200) << x << "," << y;
+    }
+  }
+}
+
+TEST(GalleryCompositorTest, TurnsRotatedFramesUpright)
+{
+  // Left is turned upright by a clockwise quarter turn, which takes the
+  // bright right half of the buffer to the bottom of the tile.
+  auto source = solidFrame(PixelFormat::NV12, 64, 64, 10, 128);
+  for (int y = 0; y < 64; ++y) {
+    memset(source->frame().planes[0].data + y * source->frame().planes[0].stride + 32, 240, 32);
+  }
+  VideoFrame frame = source->frame();
+  frame.orientation = VideoOrientation::Left;
+
+  auto surface = solidFrame(PixelFormat::NV12, 32, 32, 0, 0);
+  GalleryTile tile;
+  tile.width = 32;
+  tile.height = 32;
+  GalleryCompositor compositor;
+  ASSERT_TRUE(compositor.drawTile(frame, tile, surface->frame()));
+  EXPECT_EQ(lumaAt(surface->frame(), 16, 4), 10);
+  EXPECT_EQ(lumaAt(surface->frame(), 16, 28), 240);
+}
+
+TEST(GalleryCompositorTest, RejectsTilesOutsideTheSurface)
+{
+  auto source = solidFrame(PixelFormat::NV12, 64, 64, 10, 128);
+  auto surface = solidFrame(PixelFormat::NV12, 64, 64, 0, 0);
+  GalleryTile tile;
+  tile.x = 32;
+  tile.width = 64;
+  tile.height = 32;
+  GalleryCompositor compositor;
+  EXPECT_FALSE(compositor.drawTile(source->frame(), tile, surface->frame()));
+  tile.x = 1;
+  tile.width = 32;
+  EXPECT_FALSE(compositor.drawTile(source->frame(), tile, surface->frame()));
+}
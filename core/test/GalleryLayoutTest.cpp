@@ -0,0 +1,118 @@
+//
+//  GalleryLayoutTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/GalleryLayout.h"
+
+#include <gtest/gtest.h>
+
+using namespace tivonage;
+
+namespace {
+
+bool overlaps(const GalleryTile &a, const GalleryTile &b)
+{
+  return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+}
+
+TEST(GalleryLayoutTest, EmptyGalleryHasNoTiles)
+{
+  GalleryLayout layout;
+  EXPECT_FALSE(layout.update(0, 0, 0));
+  EXPECT_TRUE(layout.tiles().empty());
+  EXPECT_EQ(layout.tileAt(10, 10), -1);
+}
+
+TEST(GalleryLayoutTest, SingleTileFillsTheNarrowSide)
+{
+  GalleryLayout layout;
+  EXPECT_TRUE(layout.update(1170, 2532, 1));
+  ASSERT_EQ(layout.tiles().size(), 1u);
+  const GalleryTile &tile = layout.tiles()[0];
+  EXPECT_EQ(tile.width, 1170 - 16);
+  EXPECT_EQ(tile.height, 1170 - 16);
+  EXPECT_EQ(tile.x, 8);
+  // Vertically centred.
+  EXPECT_NEAR(tile.y, (2532 - tile.height) / 2, 1);
+}
+
+TEST(GalleryLayoutTest, PicksTheColumnCountWithTheLargestTiles)
+{
+  GalleryLayout layout;
+  // Square tiles on a tall screen: four still fit stacked, six don't.
+  layout.update(1170, 2532, 4);
+  EXPECT_EQ(layout.columns(), 1);
+  layout.update(1170, 2532, 6);
+  EXPECT_EQ(layout.columns(), 2);
+  EXPECT_EQ(layout.rows(), 3);
+
+  layout.update(2532, 1170, 4);
+  EXPECT_EQ(layout.columns(), 4);
+
+  layout.update(1170, 1170, 25);
+  EXPECT_EQ(layout.columns(), 5);
+  EXPECT_EQ(layout.rows(), 5);
+}
+
+TEST(GalleryLayoutTest, TilesAreEvenAlignedInsideAndApart)
+{
+  GalleryLayout::Config config;
+  config.spacing = 5;
+  config.tileAspect = 16.0 / 9.0;
+  GalleryLayout layout(config);
+  for (size_t count = 1; count <= 30; ++count) {
+    layout.update(1171, 2531, count);
+    const auto &tiles = layout.tiles();
+    ASSERT_EQ(tiles.size(), count);
+    for (size_t i = 0; i < count; ++i) {
+      const GalleryTile &tile = tiles[i];
+      EXPECT_EQ(tile.x % 2, 0);
+      EXPECT_EQ(tile.y % 2, 0);
+      EXPECT_EQ(tile.width % 2, 0);
+      EXPECT_EQ(tile.height % 2, 0);
+      EXPECT_GT(tile.width, 0);
+      EXPECT_LE(tile.x + tile.width, 1171);
+      EXPECT_LE(tile.y + tile.height, 2531);
+      for (size_t j = 0; j < i; ++j) {
+        EXPECT_FALSE(overlaps(tile, tiles[j])) << count << ": " << i << " and " << j;
+      }
+    }
+  }
+}
+
+TEST(GalleryLayoutTest, LastRowIsCentred)
+{
+  GalleryLayout layout;
+  layout.update(1000, 1000, 7);
+  ASSERT_EQ(layout.columns(), 3);
+  const auto &tiles = layout.tiles();
+  int leftGap = tiles[6].x;
+  int rightGap = 1000 - (tiles[6].x + tiles[6].width);
+  EXPECT_NEAR(leftGap, rightGap, 2);
+  EXPECT_EQ(tiles[6].x, tiles[1].x);
+}
+
+TEST(GalleryLayoutTest, HitTestsTilesAndGaps)
+{
+  GalleryLayout layout;
+  layout.update(1000, 1000, 4);
+  const auto &tiles = layout.tiles();
+  for (size_t i = 0; i < tiles.size(); ++i) {
+    EXPECT_EQ(layout.tileAt(tiles[i].x, tiles[i].y), int(i));
+    EXPECT_EQ(layout.tileAt(tiles[i].x + tiles[i].width - 1, tiles[i].y + tiles[i].height - 1), int(i));
+  }
+  EXPECT_EQ(layout.tileAt(0, 0), -1);
+  EXPECT_EQ(layout.tileAt(tiles[0].x + tiles[0].width, tiles[0].y), -1);
+}
+
+TEST(GalleryLayoutTest, ReportsChangesOnly)
+{
+  GalleryLayout layout;
+  EXPECT_TRUE(layout.update(800, 600, 3));
+  EXPECT_FALSE(layout.update(800, 600, 3));
+  EXPECT_TRUE(layout.update(800, 600, 4));
+  EXPECT_TRUE(layout.update(600, 800, 4));
+}
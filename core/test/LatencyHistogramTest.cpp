@@ -0,0 +1,100 @@
+//
+//  LatencyHistogramTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/LatencyHistogram.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace tivonage;
+
+TEST(LatencyHistogramTest, EmptyReportsZero)
+{
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.count(), 0u);
+  EXPECT_EQ(histogram.percentile(50), 0);
+  EXPECT_EQ(histogram.min(), 0);
+  EXPECT_EQ(histogram.max(), 0);
+  EXPECT_EQ(histogram.mean(), 0);
+}
+
+TEST(LatencyHistogramTest, BucketsCoverTheRangeWithoutGaps)
+{
+  EXPECT_EQ(LatencyHistogram::bucketLowest(0), 0);
+  for (size_t i = 1; i < LatencyHistogram::kBucketCount; ++i) {
+    ASSERT_EQ(LatencyHistogram::bucketLowest(i), LatencyHistogram::bucketHighest(i - 1) + 1) << i;
+  }
+  EXPECT_EQ(LatencyHistogram::bucketHighest(LatencyHistogram::kBucketCount - 1), LatencyHistogram::kMaxValueUs);
+
+  for (int64_t value : { 0, 31, 32, 63, 64, 1000, 33333, 250000, 1 << 29 }) {
+    size_t index = LatencyHistogram::bucketIndex(value);
+    EXPECT_LE(LatencyHistogram::bucketLowest(index), value);
+    EXPECT_GE(LatencyHistogram::bucketHighest(index), value);
+  }
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact)
+{
+  LatencyHistogram histogram;
+  for (int value = 1; value <= 20; ++value) {
+    histogram.record(value);
+  }
+  EXPECT_EQ(histogram.percentile(50), 10);
+  EXPECT_EQ(histogram.percentile(100), 20);
+  EXPECT_EQ(histogram.min(), 1);
+  EXPECT_EQ(histogram.mean(), 10);
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinRelativeError)
+{
+  std::mt19937 random(7);
+  std::lognormal_distribution<double> distribution(11.0, 0.6); // around 60 ms
+  std::vector<int64_t> values(20000);
+  LatencyHistogram histogram;
+  for (auto &value : values) {
+    value = int64_t(distribution(random));
+    histogram.record(value);
+  }
+  std::sort(values.begin(), values.end());
+
+  for (double percent : { 50.0, 95.0, 99.0 }) {
+    int64_t exact = values[size_t(percent / 100.0 * double(values.size())) - 1];
+    int64_t reported = histogram.percentile(percent);
+    EXPECT_GE(reported, exact) << percent;
+    EXPECT_LE(double(reported), double(exact) * 1.035) << percent;
+  }
+  EXPECT_EQ(histogram.max(), values.back());
+  EXPECT_EQ(histogram.percentile(100), values.back());
+}
+
+TEST(LatencyHistogramTest, ClampsOutOfRangeValues)
+{
+  LatencyHistogram histogram;
+  histogram.record(-5000);
+  histogram.record(int64_t(1) << 40);
+  EXPECT_EQ(histogram.count(), 2u);
+  EXPECT_EQ(histogram.min(), 0);
+  EXPECT_EQ(histogram.max(), LatencyHistogram::kMaxValueUs);
+}
+
+TEST(LatencyHistogramTest, SummaryAndReset)
+{
+  LatencyHistogram histogram;
+  for (int i = 0; i < 100; ++i) {
+    histogram.record(i < 99 ? 40000 : 400000);
+  }
+  LatencyHistogram::Summary summary = histogram.summary();
+  EXPECT_EQ(summary.count, 100u);
+  EXPECT_NEAR(double(summary.p50Us), 40000.0, 40000.0 * 0.035);
+  EXPECT_NEAR(double(summary.p99Us), 40000.0, 40000.0 * 0.035);
+  EXPECT_EQ(summary.maxUs, 400000);
+
+  histogram.reset();
+  EXPECT_EQ(histogram.count(), 0u);
+  EXPECT_EQ(histogram.summary().p99Us, 0);
+}
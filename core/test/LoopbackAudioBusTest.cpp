@@ -0,0 +1,39 @@
+//
+//  LoopbackAudioBusTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/LoopbackAudioBus.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace tivonage;
+
+TEST(LoopbackAudioBusTest, CaptureComesBackAfterTheDelay)
+{
+  auto bus = LoopbackAudioBus::create(16000, 10);
+  ASSERT_NE(bus, nullptr);
+  std::vector<int16_t> input(100, 7);
+  bus->writeCaptureData(input.data(), input.size());
+
+  std::vector<int16_t> output(300, -1);
+  EXPECT_EQ(bus->readRenderData(output.data(), output.size()), 260u);
+  EXPECT_EQ(std::vector<int16_t>(output.begin(), output.begin() + 160), std::vector<int16_t>(160, 0));
+  EXPECT_EQ(std::vector<int16_t>(output.begin() + 160, output.begin() + 260), input);
+  EXPECT_EQ(bus->capturedSamples(), 100u);
+  EXPECT_EQ(bus->renderedSamples(), 260u);
+}
+
+TEST(LoopbackAudioBusTest, DropsWhatDoesNotFit)
+{
+  auto bus = LoopbackAudioBus::create(8000, 0, 10);
+  // The ring rounds 80 samples up to 128.
+  std::vector<int16_t> input(200, 1);
+  bus->writeCaptureData(input.data(), input.size());
+  EXPECT_EQ(bus->capturedSamples(), 128u);
+  EXPECT_EQ(bus->droppedSamples(), 72u);
+  EXPECT_EQ(LoopbackAudioBus::create(0, 10), nullptr);
+  EXPECT_EQ(LoopbackAudioBus::create(16000, -1), nullptr);
+}
@@ -0,0 +1,200 @@
+//
+//  MediaRecorderTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/MediaRecorder.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tivonage;
+
+namespace {
+
+std::string readFile(const std::string &path)
+{
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+std::unique_ptr<FrameBuffer> solidFrame(PixelFormat format, int width, int height, uint8_t value)
+{
+  auto buffer = FrameBuffer::create(format, width, height);
+  memset(buffer->frame().planes[0].data, value, buffer->byteSize());
+  return buffer;
+}
+
+// The first luma sample of each frame of a 64x48 .y4m.
+std::vector<uint8_t> frameValues(const std::string &video)
+{
+  std::vector<uint8_t> values;
+  const size_t frameSize = 6 + 64 * 48 * 3 / 2;
+  for (size_t start = video.find('\n') + 1; start + frameSize <= video.size(); start += frameSize) {
+    values.push_back(uint8_t(video[start + 6]));
+  }
+  return values;
+}
+
+// Writes count frames timestamped periodUs apart, each a different shade,
+// waiting for the I/O thread after each so none is dropped for queueing.
+void writeTimedFrames(MediaRecorder &recorder, int count, int64_t periodUs)
+{
+  for (int i = 0; i < count; ++i) {
+    auto frame = solidFrame(PixelFormat::I420, 64, 48, uint8_t(10 * (i + 1)));
+    frame->frame().timestampUs = 5000000 + i * periodUs;
+    EXPECT_TRUE(recorder.writeVideoFrame(frame->frame()));
+    for (;;) {
+      MediaRecorder::Counters counters = recorder.counters();
+      if (counters.recordedFrames + counters.droppedFrames == uint64_t(i + 1)) {
+        break;
+      }
+      std::this_thread::yield();
+    }
+  }
+}
+
+}
+
+TEST(MediaRecorderTest, RecordsVideoAndAudio)
+{
+  const std::string videoPath = testing::TempDir() + "media_recorder.y4m";
+  const std::string audioPath = testing::TempDir() + "media_recorder.wav";
+  MediaRecorder::Config config;
+  config.audioSampleRate = 8000;
+  auto recorder = MediaRecorder::create(videoPath, audioPath, config);
+  ASSERT_NE(recorder, nullptr);
+
+  auto frame = solidFrame(PixelFormat::NV12, 64, 48, 0x50);
+  std::vector<int16_t> samples(800, 7);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(recorder->writeVideoFrame(frame->frame()));
+    EXPECT_EQ(recorder->writeAudio(samples.data(), samples.size()), samples.size());
+    // Let the I/O thread keep up so nothing is dropped.
+    while (recorder->counters().recordedFrames < uint64_t(i + 1)) {
+      std::this_thread::yield();
+    }
+  }
+  recorder->stop();
+  EXPECT_FALSE(recorder->writeVideoFrame(frame->frame()));
+
+  MediaRecorder::Counters counters = recorder->counters();
+  EXPECT_EQ(counters.recordedFrames, 5u);
+  EXPECT_EQ(counters.droppedFrames, 0u);
+  EXPECT_EQ(counters.recordedSamples, 4000u);
+  EXPECT_FALSE(counters.failed);
+
+  const std::string header = "YUV4MPEG2 W64 H48 F30:1 Ip A1:1 C420jpeg\n";
+  std::string video = readFile(videoPath);
+  EXPECT_EQ(video.size(), header.size() + 5 * (6 + 64 * 48 * 3 / 2));
+  EXPECT_EQ(video.compare(0, header.size(), header), 0);
+  EXPECT_EQ(readFile(audioPath).size(), 44u + 8000u);
+  remove(videoPath.c_str());
+  remove(audioPath.c_str());
+}
+
+TEST(MediaRecorderTest, KeepsTheFirstUprightSize)
+{
+  const std::string videoPath = testing::TempDir() + "media_recorder_size.y4m";
+  auto recorder = MediaRecorder::create(videoPath, "");
+  ASSERT_NE(recorder, nullptr);
+
+  auto portrait = solidFrame(PixelFormat::I420, 48, 64, 0x30);
+  VideoFrame rotated = portrait->frame();
+  rotated.orientation = VideoOrientation::Left;
+  EXPECT_TRUE(recorder->writeVideoFrame(rotated));
+  auto larger = solidFrame(PixelFormat::NV12, 128, 96, 0x30);
+  EXPECT_TRUE(recorder->writeVideoFrame(larger->frame()));
+  recorder->stop();
+
+  EXPECT_EQ(recorder->counters().recordedFrames, 2u);
+  const std::string header = "YUV4MPEG2 W64 H48 ";
+  std::string video = readFile(videoPath);
+  EXPECT_EQ(video.compare(0, header.size(), header), 0);
+  remove(videoPath.c_str());
+}
+
+TEST(MediaRecorderTest, RepeatsFramesOfASlowerSource)
+{
+  const std::string videoPath = testing::TempDir() + "media_recorder_15fps.y4m";
+  auto recorder = MediaRecorder::create(videoPath, "");
+  ASSERT_NE(recorder, nullptr);
+
+  // 15 fps into the 30 fps file: every frame stays on screen for two slots.
+  writeTimedFrames(*recorder, 10, 66667);
+  recorder->stop();
+
+  MediaRecorder::Counters counters = recorder->counters();
+  EXPECT_EQ(counters.recordedFrames, 10u);
+  EXPECT_EQ(counters.repeatedFrames, 9u);
+  EXPECT_EQ(counters.droppedFrames, 0u);
+  std::vector<uint8_t> expected;
+  for (int i = 0; i < 10; ++i) {
+    expected.push_back(uint8_t(10 * (i + 1)));
+    if (i < 9) {
+      expected.push_back(uint8_t(10 * (i + 1)));
+    }
+  }
+  EXPECT_EQ(frameValues(readFile(videoPath)), expected);
+  remove(videoPath.c_str());
+}
+
+TEST(MediaRecorderTest, DropsFramesOfAFasterSource)
+{
+  const std::string videoPath = testing::TempDir() + "media_recorder_60fps.y4m";
+  auto recorder = MediaRecorder::create(videoPath, "");
+  ASSERT_NE(recorder, nullptr);
+
+  // 60 fps into the 30 fps file: frame 0 takes slot 0, then each odd frame
+  // rounds up onto the slot its even successor would take.
+  writeTimedFrames(*recorder, 20, 16667);
+  recorder->stop();
+
+  MediaRecorder::Counters counters = recorder->counters();
+  EXPECT_EQ(counters.recordedFrames, 11u);
+  EXPECT_EQ(counters.repeatedFrames, 0u);
+  EXPECT_EQ(counters.droppedFrames, 9u);
+  std::vector<uint8_t> expected = { 10 };
+  for (int i = 1; i < 20; i += 2) {
+    expected.push_back(uint8_t(10 * (i + 1)));
+  }
+  EXPECT_EQ(frameValues(readFile(videoPath)), expected);
+  remove(videoPath.c_str());
+}
+
+TEST(MediaRecorderTest, DropsInsteadOfQueueingWithoutBound)
+{
+  const std::string videoPath = testing::TempDir() + "media_recorder_drop.y4m";
+  MediaRecorder::Config config;
+  config.queuedFrames = 2;
+  auto recorder = MediaRecorder::create(videoPath, "", config);
+  ASSERT_NE(recorder, nullptr);
+
+  // Far more frames than the pool holds, faster than a disk would take them
+  // if it stalled: whatever doesn't fit is dropped and counted.
+  auto frame = solidFrame(PixelFormat::I420, 1280, 720, 0x10);
+  int accepted = 0;
+  for (int i = 0; i < 200; ++i) {
+    accepted += recorder->writeVideoFrame(frame->frame());
+  }
+  recorder->stop();
+
+  MediaRecorder::Counters counters = recorder->counters();
+  EXPECT_EQ(counters.recordedFrames, uint64_t(accepted));
+  EXPECT_EQ(counters.recordedFrames + counters.droppedFrames, 200u);
+  remove(videoPath.c_str());
+}
+
+TEST(MediaRecorderTest, FailsWhenTheAudioFileCannotBeCreated)
+{
+  EXPECT_EQ(MediaRecorder::create(testing::TempDir() + "x.y4m", testing::TempDir() + "missing/dir/x.wav"), nullptr);
+  EXPECT_EQ(MediaRecorder::create("", ""), nullptr);
+}
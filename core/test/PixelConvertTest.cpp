@@ -0,0 +1,205 @@
+//
+//  PixelConvertTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/PixelConvert.h"
+#include "tivonage/Simd.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace tivonage;
+
+namespace {
+
+const PixelFormat kFormats[] = { PixelFormat::I420, PixelFormat::NV12, PixelFormat::ARGB };
+
+std::vector<SimdLevel> availableLevels()
+{
+  std::vector<SimdLevel> levels = { SimdLevel::Scalar };
+  SimdLevel detected = detectedSimdLevel();
+  if (detected == SimdLevel::AVX2) {
+    levels.push_back(SimdLevel::SSE2);
+  }
+  if (detected != SimdLevel::Scalar) {
+    levels.push_back(detected);
+  }
+  return levels;
+}
+
+void fillRandom(VideoFrame &frame, uint32_t seed)
+{
+  std::mt19937 random(seed);
+  for (int plane = 0; plane < planeCount(frame.format); ++plane) {
+    int rows = planeRows(frame.format, plane, frame.height);
+    for (int y = 0; y < rows; ++y) {
+      for (int x = 0; x < frame.planes[plane].stride; ++x) {
+        frame.planes[plane].data[y * frame.planes[plane].stride + x] = uint8_t(random());
+      }
+    }
+  }
+}
+
+bool samePixels(const VideoFrame &a, const VideoFrame &b)
+{
+  for (int plane = 0; plane < planeCount(a.format); ++plane) {
+    int rowBytes = planeRowBytes(a.format, plane, a.width);
+    for (int y = 0; y < planeRows(a.format, plane, a.height); ++y) {
+      if (memcmp(a.planes[plane].data + y * a.planes[plane].stride, b.planes[plane].data + y * b.planes[plane].stride, size_t(rowBytes)) != 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+class PixelConvertTest : public ::testing::TestWithParam<std::tuple<PixelFormat, PixelFormat>> {
+protected:
+  void TearDown() override { setSimdLevelLimit(SimdLevel::NEON); }
+};
+
+}
+
+TEST_P(PixelConvertTest, SimdMatchesScalarReference)
+{
+  PixelFormat from = std::get<0>(GetParam());
+  PixelFormat to = std::get<1>(GetParam());
+  const int sizes[][2] = { { 1, 1 }, { 2, 2 }, { 17, 3 }, { 33, 33 }, { 67, 35 }, { 640, 8 }, { 1282, 5 } };
+
+  for (const auto &size : sizes) {
+    auto source = FrameBuffer::create(from, size[0], size[1]);
+    fillRandom(source->frame(), uint32_t(size[0] * 31 + size[1]));
+
+    setSimdLevelLimit(SimdLevel::Scalar);
+    auto expected = FrameBuffer::create(to, size[0], size[1]);
+    ASSERT_TRUE(convertFrame(source->frame(), expected->frame()));
+
+    for (SimdLevel level : availableLevels()) {
+      setSimdLevelLimit(level);
+      auto actual = FrameBuffer::create(to, size[0], size[1]);
+      ASSERT_TRUE(convertFrame(source->frame(), actual->frame()));
+      EXPECT_TRUE(samePixels(expected->frame(), actual->frame()))
+          << simdLevelName(level) << " " << size[0] << "x" << size[1];
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(AllFormatPairs, PixelConvertTest,
+    ::testing::Combine(::testing::ValuesIn(kFormats), ::testing::ValuesIn(kFormats)));
+
+TEST(PixelConvertColorTest, ConvertsPrimaryColors)
+{
+  struct Sample {
+    uint8_t b, g, r;
+    uint8_t y, u, v;
+  };
+  // BT.601 video range reference values.
+  const Sample samples[] = {
+    { 0, 0, 0, 16, 128, 128 },
+    { 255, 255, 255, 235, 128, 128 },
+    { 0, 0, 255, 82, 90, 240 },
+    { 0, 255, 0, 145, 54, 34 },
+    { 255, 0, 0, 41, 240, 110 },
+  };
+
+  for (const Sample &sample : samples) {
+    auto argb = FrameBuffer::create(PixelFormat::ARGB, 32, 2);
+    for (int y = 0; y < 2; ++y) {
+      for (int x = 0; x < 32; ++x) {
+        uint8_t *pixel = argb->frame().planes[0].data + y * argb->frame().planes[0].stride + 4 * x;
+        pixel[0] = sample.b;
+        pixel[1] = sample.g;
+        pixel[2] = sample.r;
+        pixel[3] = 255;
+      }
+    }
+
+    auto i420 = FrameBuffer::create(PixelFormat::I420, 32, 2);
+    ASSERT_TRUE(convertFrame(argb->frame(), i420->frame()));
+    EXPECT_NEAR(i420->frame().planes[0].data[0], sample.y, 1);
+    EXPECT_NEAR(i420->frame().planes[1].data[0], sample.u, 1);
+    EXPECT_NEAR(i420->frame().planes[2].data[0], sample.v, 1);
+
+    auto back = FrameBuffer::create(PixelFormat::ARGB, 32, 2);
+    ASSERT_TRUE(convertFrame(i420->frame(), back->frame()));
+    const uint8_t *pixel = back->frame().planes[0].data;
+    EXPECT_NEAR(pixel[0], sample.b, 3);
+    EXPECT_NEAR(pixel[1], sample.g, 3);
+    EXPECT_NEAR(pixel[2], sample.r, 3);
+    EXPECT_EQ(pixel[3], 255);
+  }
+}
+
+TEST(PixelConvertColorTest, RejectsMismatchedDimensions)
+{
+  auto source = FrameBuffer::create(PixelFormat::I420, 64, 64);
+  auto destination = FrameBuffer::create(PixelFormat::NV12, 64, 32);
+  EXPECT_FALSE(convertFrame(source->frame(), destination->frame()));
+}
+
+TEST(PixelConvertFlexibleYuvTest, PacksEveryChromaLayout)
+{
+  const int width = 37;
+  const int height = 9;
+  const int chromaWidth = 19;
+  const int chromaRows = 5;
+  auto expected = FrameBuffer::create(PixelFormat::I420, width, height);
+  fillRandom(expected->frame(), 7);
+  const VideoFrame &reference = expected->frame();
+
+  // Lay the reference out planar, interleaved U first (NV12), interleaved V
+  // first (NV21) and with a chroma pixel stride of 3.
+  for (int layout = 0; layout < 4; ++layout) {
+    const int pixelStride = layout == 0 ? 1 : layout == 3 ? 3 : 2;
+    const int uvStride = chromaWidth * pixelStride + 5;
+    std::vector<uint8_t> chroma(size_t(uvStride * chromaRows * 2 + 2));
+    FlexibleYuvImage image;
+    image.width = width;
+    image.height = height;
+    image.y = reference.planes[0].data;
+    image.yStride = reference.planes[0].stride;
+    image.uvStride = uvStride;
+    image.uvPixelStride = pixelStride;
+    if (layout == 0 || layout == 3) {
+      image.u = chroma.data();
+      image.v = chroma.data() + uvStride * chromaRows;
+    } else {
+      image.u = chroma.data() + (layout == 2 ? 1 : 0);
+      image.v = chroma.data() + (layout == 2 ? 0 : 1);
+    }
+    for (int y = 0; y < chromaRows; ++y) {
+      for (int x = 0; x < chromaWidth; ++x) {
+        const_cast<uint8_t *>(image.u)[y * uvStride + x * pixelStride] = reference.planes[1].data[y * reference.planes[1].stride + x];
+        const_cast<uint8_t *>(image.v)[y * uvStride + x * pixelStride] = reference.planes[2].data[y * reference.planes[2].stride + x];
+      }
+    }
+
+    auto actual = FrameBuffer::create(PixelFormat::I420, width, height);
+    ASSERT_TRUE(convertFlexibleYuv(image, actual->frame()));
+    EXPECT_TRUE(samePixels(reference, actual->frame())) << "layout " << layout;
+  }
+}
+
+TEST(PixelConvertFlexibleYuvTest, RejectsNonI420Destinations)
+{
+  auto source = FrameBuffer::create(PixelFormat::I420, 16, 16);
+  FlexibleYuvImage image;
+  image.width = 16;
+  image.height = 16;
+  image.y = source->frame().planes[0].data;
+  image.yStride = source->frame().planes[0].stride;
+  image.u = source->frame().planes[1].data;
+  image.v = source->frame().planes[2].data;
+  image.uvStride = source->frame().planes[1].stride;
+
+  auto nv12 = FrameBuffer::create(PixelFormat::NV12, 16, 16);
+  EXPECT_FALSE(convertFlexibleYuv(image, nv12->frame()));
+  auto smaller = FrameBuffer::create(PixelFormat::I420, 16, 8);
+  EXPECT_FALSE(convertFlexibleYuv(image, smaller->frame()));
+}
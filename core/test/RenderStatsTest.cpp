@@ -0,0 +1,108 @@
+//
+//  RenderStatsTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/RenderStats.h"
+
+#include <gtest/gtest.h>
+
+using namespace tivonage;
+
+namespace {
+
+const int64_t kStart = 1000000;
+
+}
+
+TEST(RenderStatsTest, EmptyWindowReportsNothing)
+{
+  FrameIntervalWindow window;
+  FrameIntervalWindow::Summary summary = window.summary(kStart);
+  EXPECT_EQ(summary.intervals, 0u);
+  EXPECT_EQ(summary.fps, 0.0);
+
+  window.add(kStart);
+  EXPECT_EQ(window.summary(kStart).intervals, 0u);
+}
+
+TEST(RenderStatsTest, SteadyFramesHaveNoJitter)
+{
+  FrameIntervalWindow window;
+  for (int i = 0; i < 31; ++i) {
+    window.add(kStart + i * 33333);
+  }
+  FrameIntervalWindow::Summary summary = window.summary(kStart + 30 * 33333);
+  EXPECT_EQ(summary.intervals, 30u);
+  EXPECT_NEAR(summary.fps, 30.0, 0.01);
+  EXPECT_NEAR(summary.meanIntervalMs, 33.333, 0.001);
+  EXPECT_EQ(summary.jitterMs, 0.0);
+  EXPECT_NEAR(summary.maxIntervalMs, 33.333, 0.001);
+}
+
+TEST(RenderStatsTest, AlternatingIntervalsShowAsJitter)
+{
+  FrameIntervalWindow window;
+  int64_t now = kStart;
+  window.add(now);
+  for (int i = 0; i < 40; ++i) {
+    now += i % 2 ? 20000 : 40000;
+    window.add(now);
+  }
+  FrameIntervalWindow::Summary summary = window.summary(now);
+  EXPECT_NEAR(summary.meanIntervalMs, 30.0, 0.001);
+  EXPECT_NEAR(summary.jitterMs, 10.0, 0.001);
+  EXPECT_NEAR(summary.maxIntervalMs, 40.0, 0.001);
+}
+
+TEST(RenderStatsTest, WindowKeepsOnlyTheLatestIntervals)
+{
+  FrameIntervalWindow window;
+  int64_t now = kStart;
+  window.add(now);
+  for (size_t i = 0; i < FrameIntervalWindow::kCapacity; ++i) {
+    now += 100000;
+    window.add(now);
+  }
+  for (size_t i = 0; i < FrameIntervalWindow::kCapacity; ++i) {
+    now += 50000;
+    window.add(now);
+  }
+  FrameIntervalWindow::Summary summary = window.summary(now);
+  EXPECT_EQ(summary.intervals, FrameIntervalWindow::kCapacity);
+  EXPECT_NEAR(summary.fps, 20.0, 0.01);
+}
+
+TEST(RenderStatsTest, PausesRestartTheWindow)
+{
+  FrameIntervalWindow window;
+  window.add(kStart);
+  window.add(kStart + 100000);
+  // A stalled stream reports nothing...
+  EXPECT_EQ(window.summary(kStart + 3000000).fps, 0.0);
+  // ...and the gap doesn't count as one very slow frame once it resumes.
+  window.add(kStart + 3000000);
+  window.add(kStart + 3050000);
+  FrameIntervalWindow::Summary summary = window.summary(kStart + 3050000);
+  EXPECT_EQ(summary.intervals, 1u);
+  EXPECT_NEAR(summary.fps, 20.0, 0.01);
+}
+
+TEST(RenderStatsTest, CountsReceivedDisplayedAndDropped)
+{
+  RenderStats stats;
+  for (int i = 0; i < 10; ++i) {
+    stats.frameReceived(kStart + i * 33333);
+    if (i % 3 == 2) {
+      stats.frameDropped();
+    } else {
+      stats.frameDisplayed(kStart + i * 33333 + 5000);
+    }
+  }
+  RenderStats::Snapshot snapshot = stats.snapshot(kStart + 9 * 33333);
+  EXPECT_EQ(snapshot.received, 10u);
+  EXPECT_EQ(snapshot.displayed, 7u);
+  EXPECT_EQ(snapshot.dropped, 3u);
+  EXPECT_NEAR(snapshot.receiving.fps, 30.0, 0.01);
+  EXPECT_GT(snapshot.displaying.jitterMs, 0.0);
+}
@@ -0,0 +1,195 @@
+//
+//  ResamplerTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/Resampler.h"
+#include "tivonage/Simd.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace tivonage;
+
+namespace {
+
+std::vector<int16_t> tone(int rate, double frequency, double amplitude, size_t count)
+{
+  std::vector<int16_t> samples(count);
+  for (size_t i = 0; i < count; ++i) {
+    samples[i] = int16_t(std::lround(amplitude * std::sin(2.0 * M_PI * frequency * double(i) / rate)));
+  }
+  return samples;
+}
+
+std::vector<int16_t> convert(Resampler &resampler, const std::vector<int16_t> &input)
+{
+  std::vector<int16_t> output(resampler.maxOutput(input.size()));
+  output.resize(resampler.process(input.data(), input.size(), output.data()));
+  return output;
+}
+
+// Fits a sinusoid of the given frequency, whatever its phase (the filter
+// delays it), to output past the filter's warm-up. The fitted sinusoid is
+// the reference: the rest is distortion, aliasing and quantization noise.
+struct Fit {
+  double signalPower;
+  double noisePower;
+  double snrDb() const { return 10.0 * std::log10(signalPower / noisePower); }
+};
+
+Fit fitTone(const std::vector<int16_t> &samples, size_t skip, int rate, double frequency)
+{
+  double ss = 0.0, sc = 0.0, cc = 0.0, ys = 0.0, yc = 0.0;
+  for (size_t i = skip; i < samples.size(); ++i) {
+    double w = 2.0 * M_PI * frequency * double(i) / rate;
+    double s = std::sin(w), c = std::cos(w), y = samples[i];
+    ss += s * s;
+    sc += s * c;
+    cc += c * c;
+    ys += y * s;
+    yc += y * c;
+  }
+  double determinant = ss * cc - sc * sc;
+  double a = (ys * cc - yc * sc) / determinant;
+  double b = (yc * ss - ys * sc) / determinant;
+  double signal = 0.0, noise = 0.0;
+  for (size_t i = skip; i < samples.size(); ++i) {
+    double w = 2.0 * M_PI * frequency * double(i) / rate;
+    double reference = a * std::sin(w) + b * std::cos(w);
+    signal += reference * reference;
+    noise += (samples[i] - reference) * (samples[i] - reference);
+  }
+  size_t count = samples.size() - skip;
+  return { signal / double(count), noise / double(count) };
+}
+
+class ResamplerTest : public ::testing::Test {
+protected:
+  void TearDown() override { setSimdLevelLimit(SimdLevel::NEON); }
+};
+
+}
+
+TEST_F(ResamplerTest, RejectsBadRates)
+{
+  EXPECT_EQ(Resampler::create(0, 16000), nullptr);
+  EXPECT_EQ(Resampler::create(48000, -1), nullptr);
+  EXPECT_EQ(Resampler::create(48000, 16001), nullptr);
+  EXPECT_NE(Resampler::create(44100, 16000), nullptr);
+}
+
+TEST_F(ResamplerTest, EqualRatesCopyThrough)
+{
+  auto resampler = Resampler::create(16000, 16000);
+  std::vector<int16_t> input = tone(16000, 440.0, 9000.0, 500);
+  EXPECT_EQ(convert(*resampler, input), input);
+}
+
+TEST_F(ResamplerTest, TenMillisecondsGiveTenMilliseconds)
+{
+  const int rates[][2] = { { 48000, 16000 }, { 44100, 16000 }, { 16000, 48000 }, { 16000, 44100 }, { 44100, 8000 }, { 32000, 48000 } };
+  for (const auto &rate : rates) {
+    auto resampler = Resampler::create(rate[0], rate[1]);
+    std::vector<int16_t> input(size_t(rate[0] / 100), 100);
+    std::vector<int16_t> output(resampler->maxOutput(input.size()));
+    for (int chunk = 0; chunk < 20; ++chunk) {
+      EXPECT_EQ(resampler->process(input.data(), input.size(), output.data()), size_t(rate[1] / 100)) << rate[0] << " -> " << rate[1];
+    }
+    // Unity gain at DC.
+    EXPECT_EQ(output[0], 100);
+  }
+}
+
+TEST_F(ResamplerTest, InBandTonesKeepHighSnr)
+{
+  struct Case {
+    int inputRate;
+    int outputRate;
+    double frequency;
+  };
+  const Case cases[] = {
+    { 48000, 16000, 1000.0 },
+    { 48000, 16000, 5500.0 },
+    { 44100, 16000, 1000.0 },
+    { 44100, 16000, 3300.0 },
+    { 16000, 48000, 1000.0 },
+    { 16000, 48000, 5500.0 },
+    { 16000, 44100, 1000.0 },
+    { 16000, 44100, 3300.0 },
+  };
+  for (const Case &c : cases) {
+    auto resampler = Resampler::create(c.inputRate, c.outputRate);
+    std::vector<int16_t> output = convert(*resampler, tone(c.inputRate, c.frequency, 16000.0, size_t(c.inputRate / 2)));
+    Fit fit = fitTone(output, size_t(c.outputRate / 100), c.outputRate, c.frequency);
+    EXPECT_NEAR(std::sqrt(fit.signalPower * 2.0), 16000.0, 16000.0 * 0.01) << c.inputRate << " -> " << c.outputRate << " at " << c.frequency;
+    EXPECT_GT(fit.snrDb(), 65.0) << c.inputRate << " -> " << c.outputRate << " at " << c.frequency;
+  }
+}
+
+TEST_F(ResamplerTest, DownsamplingRejectsTonesAboveTheNewNyquist)
+{
+  // 10 kHz would alias to 6 kHz at 16 kHz, and 15 kHz to 1 kHz.
+  for (double frequency : { 10000.0, 15000.0 }) {
+    auto resampler = Resampler::create(48000, 16000);
+    std::vector<int16_t> output = convert(*resampler, tone(48000, frequency, 16000.0, 24000));
+    double power = 0.0;
+    for (size_t i = 160; i < output.size(); ++i) {
+      power += double(output[i]) * output[i];
+    }
+    double rms = std::sqrt(power / double(output.size() - 160));
+    EXPECT_LT(20.0 * std::log10(rms / (16000.0 / std::sqrt(2.0))), -60.0) << frequency;
+  }
+}
+
+TEST_F(ResamplerTest, StreamingInPiecesMatchesOneCall)
+{
+  std::mt19937 random(7);
+  std::uniform_int_distribution<int> sample(-32768, 32767);
+  std::vector<int16_t> input(20000);
+  for (int16_t &value : input) {
+    value = int16_t(sample(random));
+  }
+
+  auto whole = Resampler::create(44100, 16000);
+  std::vector<int16_t> expected = convert(*whole, input);
+
+  auto pieces = Resampler::create(44100, 16000);
+  std::uniform_int_distribution<size_t> length(0, 3000);
+  std::vector<int16_t> output;
+  std::vector<int16_t> chunk(pieces->maxOutput(3000));
+  for (size_t offset = 0; offset < input.size();) {
+    size_t count = std::min(length(random), input.size() - offset);
+    size_t written = pieces->process(input.data() + offset, count, chunk.data());
+    ASSERT_LE(written, pieces->maxOutput(count));
+    output.insert(output.end(), chunk.begin(), chunk.begin() + std::ptrdiff_t(written));
+    offset += count;
+  }
+  EXPECT_EQ(output, expected);
+
+  pieces->reset();
+  EXPECT_EQ(convert(*pieces, input), expected);
+}
+
+TEST_F(ResamplerTest, SimdMatchesScalar)
+{
+  std::mt19937 random(11);
+  std::uniform_int_distribution<int> sample(-32768, 32767);
+  std::vector<int16_t> input(9000);
+  for (int16_t &value : input) {
+    value = int16_t(sample(random));
+  }
+  const int rates[][2] = { { 48000, 16000 }, { 44100, 16000 }, { 16000, 44100 }, { 8000, 48000 } };
+  for (const auto &rate : rates) {
+    setSimdLevelLimit(SimdLevel::Scalar);
+    std::vector<int16_t> expected = convert(*Resampler::create(rate[0], rate[1]), input);
+    for (SimdLevel level : { SimdLevel::SSE2, detectedSimdLevel() }) {
+      setSimdLevelLimit(level);
+      EXPECT_EQ(convert(*Resampler::create(rate[0], rate[1]), input), expected) << simdLevelName(level) << " " << rate[0] << " -> " << rate[1];
+    }
+    setSimdLevelLimit(SimdLevel::NEON);
+  }
+}
@@ -0,0 +1,36 @@
+//
+//  RunningStatsTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/RunningStats.h"
+
+#include <gtest/gtest.h>
+
+using namespace tivonage;
+
+TEST(RunningStatsTest, EmptyStatsAreZero)
+{
+  RunningStats stats;
+  EXPECT_EQ(stats.count(), 0u);
+  EXPECT_EQ(stats.mean(), 0.0);
+  EXPECT_EQ(stats.min(), 0.0);
+  EXPECT_EQ(stats.max(), 0.0);
+  EXPECT_EQ(stats.variance(), 0.0);
+}
+
+TEST(RunningStatsTest, TracksMeanVarianceAndRange)
+{
+  RunningStats stats;
+  for (double value : { 2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0 }) {
+    stats.add(value);
+  }
+  EXPECT_EQ(stats.count(), 8u);
+  EXPECT_DOUBLE_EQ(stats.mean(), 5.0);
+  EXPECT_NEAR(stats.variance(), 32.0 / 7.0, 1e-12);
+  EXPECT_EQ(stats.min(), 2.0);
+  EXPECT_EQ(stats.max(), 9.0);
+
+  stats.reset();
+  EXPECT_EQ(stats.count(), 0u);
+}
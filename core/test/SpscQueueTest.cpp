@@ -0,0 +1,57 @@
+//
+//  SpscQueueTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/SpscQueue.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace tivonage;
+
+TEST(SpscQueueTest, RoundsCapacityAndRejectsWhenFull)
+{
+  SpscQueue<int> queue(5);
+  EXPECT_EQ(queue.capacity(), 8u);
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_TRUE(queue.push(i));
+  }
+  EXPECT_FALSE(queue.push(8));
+  EXPECT_EQ(queue.size(), 8u);
+
+  int value = -1;
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(queue.pop(value));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueueTest, PreservesOrderAcrossThreads)
+{
+  SpscQueue<uint64_t> queue(64);
+  const uint64_t count = 100000;
+
+  std::thread producer([&] {
+    for (uint64_t i = 0; i < count; ++i) {
+      while (!queue.push(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint64_t expected = 0;
+  uint64_t value = 0;
+  while (expected < count) {
+    if (!queue.pop(value)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(value, expected);
+    ++expected;
+  }
+  producer.join();
+}
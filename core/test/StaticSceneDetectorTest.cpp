@@ -0,0 +1,157 @@
+//
+//  StaticSceneDetectorTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/Simd.h"
+#include "tivonage/StaticSceneDetector.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace tivonage;
+
+namespace {
+
+const int64_t kFrameUs = 33333;
+
+// A scene plus sensor noise of up to +-noise levels.
+void fillScene(VideoFrame &frame, std::mt19937 &random, int noise)
+{
+  std::uniform_int_distribution<int> jitter(-noise, noise);
+  for (int y = 0; y < frame.height; ++y) {
+    uint8_t *row = frame.planes[0].data + y * frame.planes[0].stride;
+    for (int x = 0; x < frame.width; ++x) {
+      row[x] = uint8_t(std::min(std::max(60 + (x * 3 + y * 2) % 120 + jitter(random), 0), 255));
+    }
+  }
+}
+
+void drawBox(VideoFrame &frame, int left, int top, int size)
+{
+  for (int y = top; y < std::min(top + size, frame.height); ++y) {
+    std::fill_n(frame.planes[0].data + y * frame.planes[0].stride + left, std::min(size, frame.width - left), uint8_t(235));
+  }
+}
+
+class StaticSceneDetectorTest : public ::testing::Test {
+protected:
+  void TearDown() override { setSimdLevelLimit(SimdLevel::NEON); }
+};
+
+}
+
+TEST_F(StaticSceneDetectorTest, NoisyStillSceneTurnsStaticAfterTheDelay)
+{
+  auto frame = FrameBuffer::create(PixelFormat::NV12, 480, 640);
+  std::mt19937 random(1);
+  StaticSceneDetector detector;
+  int64_t nowUs = 0;
+  int changes = 0;
+  for (; nowUs < 1400000; nowUs += kFrameUs) {
+    fillScene(frame->frame(), random, 3);
+    changes += detector.update(frame->frame(), nowUs);
+  }
+  EXPECT_EQ(changes, 0);
+  EXPECT_FALSE(detector.isStatic());
+  EXPECT_FLOAT_EQ(detector.frameRate(30.0f), 30.0f);
+
+  for (; nowUs < 1600000; nowUs += kFrameUs) {
+    fillScene(frame->frame(), random, 3);
+    changes += detector.update(frame->frame(), nowUs);
+  }
+  EXPECT_EQ(changes, 1);
+  EXPECT_TRUE(detector.isStatic());
+  EXPECT_DOUBLE_EQ(detector.motion(), 0.0);
+  EXPECT_FLOAT_EQ(detector.frameRate(30.0f), 5.0f);
+  EXPECT_FLOAT_EQ(detector.frameRate(3.0f), 3.0f);
+}
+
+TEST_F(StaticSceneDetectorTest, MotionEndsStaticOnTheFirstFrame)
+{
+  auto frame = FrameBuffer::create(PixelFormat::I420, 480, 640);
+  std::mt19937 random(2);
+  StaticSceneDetector detector;
+  int64_t nowUs = 0;
+  for (; nowUs < 2000000; nowUs += kFrameUs) {
+    fillScene(frame->frame(), random, 2);
+    detector.update(frame->frame(), nowUs);
+  }
+  ASSERT_TRUE(detector.isStatic());
+
+  // A hand-sized object entering a corner.
+  fillScene(frame->frame(), random, 2);
+  drawBox(frame->frame(), 0, 0, 96);
+  EXPECT_TRUE(detector.update(frame->frame(), nowUs));
+  EXPECT_FALSE(detector.isStatic());
+  EXPECT_GT(detector.motion(), 0.01);
+
+  // Staying put, it has to be still for the whole delay again.
+  nowUs += kFrameUs;
+  fillScene(frame->frame(), random, 2);
+  drawBox(frame->frame(), 0, 0, 96);
+  EXPECT_FALSE(detector.update(frame->frame(), nowUs));
+  EXPECT_FALSE(detector.update(frame->frame(), nowUs + 1400000));
+  EXPECT_TRUE(detector.update(frame->frame(), nowUs + 1500000));
+}
+
+TEST_F(StaticSceneDetectorTest, NewSizeStartsOver)
+{
+  auto large = FrameBuffer::create(PixelFormat::I420, 64, 64);
+  auto small = FrameBuffer::create(PixelFormat::I420, 32, 32);
+  std::mt19937 random(3);
+  fillScene(large->frame(), random, 0);
+  fillScene(small->frame(), random, 0);
+  StaticSceneDetector detector;
+  for (int64_t nowUs = 0; nowUs <= 2000000; nowUs += kFrameUs) {
+    detector.update(large->frame(), nowUs);
+  }
+  ASSERT_TRUE(detector.isStatic());
+  EXPECT_TRUE(detector.update(small->frame(), 2100000));
+  EXPECT_FALSE(detector.isStatic());
+
+  detector.reset();
+  EXPECT_FALSE(detector.update(small->frame(), 2200000));
+}
+
+TEST_F(StaticSceneDetectorTest, SimdMatchesScalarDifferences)
+{
+  std::vector<SimdLevel> levels = { SimdLevel::Scalar, SimdLevel::SSE2, detectedSimdLevel() };
+  for (int width : { 24, 101, 480, 1283 }) {
+    auto first = FrameBuffer::create(PixelFormat::I420, width & ~1, 96);
+    auto second = FrameBuffer::create(PixelFormat::I420, width & ~1, 96);
+    std::mt19937 random(static_cast<uint32_t>(width));
+    fillScene(first->frame(), random, 0);
+    // Differences around the tile threshold, so any error in the sums shows:
+    // from tile to tile the mean difference goes from 7 to 10.
+    VideoFrame &noisy = second->frame();
+    for (int y = 0; y < noisy.height; ++y) {
+      for (int x = 0; x < noisy.width; ++x) {
+        const int amplitude = 14 + (x + y) / StaticSceneDetector::kTileSize % 6;
+        const int value = first->frame().planes[0].data[y * first->frame().planes[0].stride + x]
+            + std::uniform_int_distribution<int>(-amplitude, amplitude)(random);
+        noisy.planes[0].data[y * noisy.planes[0].stride + x] = uint8_t(std::min(std::max(value, 0), 255));
+      }
+    }
+
+    std::vector<double> motions;
+    for (SimdLevel level : levels) {
+      setSimdLevelLimit(level);
+      StaticSceneDetector::Config config;
+      config.rowStep = 1;
+      StaticSceneDetector detector(config);
+      detector.update(first->frame(), 0);
+      detector.update(second->frame(), kFrameUs);
+      motions.push_back(detector.motion());
+    }
+    for (size_t i = 1; i < motions.size(); ++i) {
+      EXPECT_DOUBLE_EQ(motions[i], motions[0]) << simdLevelName(levels[i]) << " width " << width;
+    }
+    EXPECT_GT(motions[0], 0.0);
+    EXPECT_LT(motions[0], 1.0);
+  }
+}
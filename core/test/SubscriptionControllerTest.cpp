@@ -0,0 +1,193 @@
+//
+//  SubscriptionControllerTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/SubscriptionController.h"
+
+#include <gtest/gtest.h>
+
+using namespace tivonage;
+
+namespace {
+
+const int64_t kSecond = 1000000;
+
+}
+
+TEST(SubscriptionControllerTest, StartsWithVideo)
+{
+  SubscriptionController controller;
+  EXPECT_TRUE(controller.visible());
+  EXPECT_FALSE(controller.update(0));
+  EXPECT_TRUE(controller.decision().video);
+}
+
+TEST(SubscriptionControllerTest, PausesVideoAfterHideDelay)
+{
+  SubscriptionController controller;
+  controller.setVisible(false, 10 * kSecond);
+  EXPECT_FALSE(controller.update(10 * kSecond + kSecond / 2));
+  EXPECT_TRUE(controller.decision().video);
+
+  EXPECT_TRUE(controller.update(11 * kSecond));
+  EXPECT_FALSE(controller.decision().video);
+  EXPECT_FALSE(controller.update(12 * kSecond));
+}
+
+TEST(SubscriptionControllerTest, ScrollingPastDoesNotToggle)
+{
+  SubscriptionController controller;
+  for (int64_t t = 0; t < 10 * kSecond; t += kSecond / 4) {
+    controller.setVisible((t / (kSecond / 2)) % 2 == 0, t);
+    EXPECT_FALSE(controller.update(t));
+    EXPECT_TRUE(controller.decision().video);
+  }
+}
+
+TEST(SubscriptionControllerTest, RestoresVideoAsSoonAsVisible)
+{
+  SubscriptionController::Config config;
+  config.hideDelayUs = 0;
+  SubscriptionController controller(config);
+  controller.setVisible(false, kSecond);
+  EXPECT_TRUE(controller.update(kSecond));
+  EXPECT_FALSE(controller.decision().video);
+
+  controller.setVisible(true, 5 * kSecond);
+  EXPECT_TRUE(controller.update(5 * kSecond));
+  EXPECT_TRUE(controller.decision().video);
+}
+
+TEST(SubscriptionControllerTest, HideDelayRestartsWhenHiddenAgain)
+{
+  SubscriptionController controller;
+  controller.setVisible(false, 0);
+  controller.setVisible(true, kSecond / 2);
+  controller.setVisible(false, kSecond);
+  // Still hidden only half a second since the last change.
+  EXPECT_FALSE(controller.update(kSecond + kSecond / 2));
+  EXPECT_TRUE(controller.update(2 * kSecond));
+  EXPECT_FALSE(controller.decision().video);
+}
+
+TEST(SubscriptionControllerTest, NoPreferenceUntilSizesAreKnown)
+{
+  SubscriptionController controller;
+  controller.setViewSize(200, 120);
+  controller.update(0);
+  EXPECT_EQ(controller.decision().preferredWidth, 0);
+  EXPECT_EQ(controller.decision().preferredFrameRate, 0.0f);
+}
+
+TEST(SubscriptionControllerTest, SmallTilesAskForSmallLayers)
+{
+  SubscriptionController controller;
+  controller.setStreamSize(1280, 720);
+
+  controller.setViewSize(1170, 658);
+  controller.update(0);
+  EXPECT_EQ(controller.layer(), 0);
+  EXPECT_EQ(controller.decision().preferredWidth, 0);
+
+  // A 3x tile of 200x112 points needs 600x336 pixels: the half layer.
+  SubscriptionController half;
+  half.setStreamSize(1280, 720);
+  half.setViewSize(600, 336);
+  EXPECT_TRUE(half.update(0));
+  EXPECT_EQ(half.decision().preferredWidth, 640);
+  EXPECT_EQ(half.decision().preferredHeight, 360);
+  EXPECT_EQ(half.decision().preferredFrameRate, 0.0f);
+
+  SubscriptionController thumbnail;
+  thumbnail.setStreamSize(1280, 720);
+  thumbnail.setViewSize(300, 168);
+  EXPECT_TRUE(thumbnail.update(0));
+  EXPECT_EQ(thumbnail.decision().preferredWidth, 320);
+  EXPECT_EQ(thumbnail.decision().preferredHeight, 180);
+  EXPECT_EQ(thumbnail.decision().preferredFrameRate, 15.0f);
+}
+
+TEST(SubscriptionControllerTest, UpgradesImmediatelyAndDowngradesAfterDelay)
+{
+  SubscriptionController controller;
+  controller.setStreamSize(1280, 720);
+  controller.setViewSize(1280, 720);
+  controller.update(0);
+  EXPECT_EQ(controller.layer(), 0);
+
+  // Shrinking waits for the downgrade delay...
+  controller.setViewSize(320, 180);
+  EXPECT_FALSE(controller.update(kSecond));
+  EXPECT_FALSE(controller.update(2 * kSecond));
+  EXPECT_TRUE(controller.update(3 * kSecond));
+  EXPECT_EQ(controller.layer(), 2);
+
+  // ...growing doesn't.
+  controller.setViewSize(1000, 560);
+  EXPECT_TRUE(controller.update(3 * kSecond + 1));
+  EXPECT_EQ(controller.layer(), 0);
+}
+
+TEST(SubscriptionControllerTest, ResizesInsideTheToleranceDoNotChurn)
+{
+  SubscriptionController controller;
+  controller.setStreamSize(1280, 720);
+  controller.setViewSize(640, 360);
+  controller.update(0);
+  controller.update(3 * kSecond);
+  ASSERT_EQ(controller.layer(), 1);
+
+  // Oscillating between slightly above and below the half layer: the larger
+  // size is within the upscale tolerance, the smaller never fits the
+  // quarter layer, so nothing changes.
+  for (int i = 0; i < 20; ++i) {
+    controller.setViewSize(i % 2 ? 700 : 600, i % 2 ? 394 : 338);
+    EXPECT_FALSE(controller.update(3 * kSecond + i * kSecond));
+  }
+  EXPECT_EQ(controller.layer(), 1);
+}
+
+TEST(SubscriptionControllerTest, BriefShrinkDoesNotDowngrade)
+{
+  SubscriptionController controller;
+  controller.setStreamSize(1280, 720);
+  controller.setViewSize(1280, 720);
+  controller.update(0);
+
+  controller.setViewSize(320, 180);
+  controller.update(kSecond);
+  controller.setViewSize(1280, 720);
+  controller.update(2 * kSecond);
+  controller.setViewSize(320, 180);
+  EXPECT_FALSE(controller.update(3 * kSecond + kSecond / 2));
+  EXPECT_EQ(controller.layer(), 0);
+}
+
+TEST(SubscriptionControllerTest, LowPriorityStreamsAreCappedBelowFullSize)
+{
+  SubscriptionController controller;
+  controller.setStreamSize(1280, 720);
+  controller.setViewSize(1280, 720);
+  controller.update(0);
+  ASSERT_EQ(controller.layer(), 0);
+
+  // Dropping out of the active speakers downgrades after the usual delay...
+  controller.setHighPriority(false);
+  EXPECT_FALSE(controller.update(kSecond));
+  EXPECT_TRUE(controller.update(3 * kSecond));
+  EXPECT_EQ(controller.layer(), 1);
+  EXPECT_EQ(controller.decision().preferredWidth, 640);
+
+  // ...a small view still gets its smaller layer...
+  controller.setViewSize(320, 180);
+  controller.update(4 * kSecond);
+  EXPECT_TRUE(controller.update(6 * kSecond));
+  EXPECT_EQ(controller.layer(), 2);
+
+  // ...and speaking again restores full size at once.
+  controller.setViewSize(1280, 720);
+  controller.setHighPriority(true);
+  EXPECT_TRUE(controller.update(6 * kSecond + 1));
+  EXPECT_EQ(controller.layer(), 0);
+}
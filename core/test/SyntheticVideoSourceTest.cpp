@@ -0,0 +1,167 @@
+//
+//  SyntheticVideoSourceTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/Clock.h"
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/SyntheticVideoSource.h"
+#include "tivonage/Y4mWriter.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace tivonage;
+
+namespace {
+
+bool sameLuma(const VideoFrame &a, const VideoFrame &b)
+{
+  for (int y = 0; y < a.height; ++y) {
+    if (memcmp(a.planes[0].data + y * a.planes[0].stride, b.planes[0].data + y * b.planes[0].stride, size_t(a.width)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+TEST(SyntheticVideoSourceTest, PatternMovesFromFrameToFrame)
+{
+  auto first = FrameBuffer::create(PixelFormat::I420, 64, 48);
+  auto second = FrameBuffer::create(PixelFormat::I420, 64, 48);
+  auto again = FrameBuffer::create(PixelFormat::I420, 64, 48);
+  drawTestPattern(first->frame(), 0);
+  drawTestPattern(second->frame(), 1);
+  drawTestPattern(again->frame(), 0);
+  EXPECT_FALSE(sameLuma(first->frame(), second->frame()));
+  EXPECT_TRUE(sameLuma(first->frame(), again->frame()));
+
+  // Same picture in NV12, chroma interleaved.
+  auto nv12 = FrameBuffer::create(PixelFormat::NV12, 64, 48);
+  drawTestPattern(nv12->frame(), 0);
+  EXPECT_TRUE(sameLuma(first->frame(), nv12->frame()));
+  EXPECT_EQ(nv12->frame().planes[1].data[2 * 10], first->frame().planes[1].data[10]);
+  EXPECT_EQ(nv12->frame().planes[1].data[2 * 10 + 1], first->frame().planes[2].data[10]);
+}
+
+TEST(SyntheticVideoSourceTest, FreeRunningStopsAtTheFrameLimit)
+{
+  std::vector<int64_t> timestamps;
+  SyntheticVideoSource::Config config;
+  config.width = 320;
+  config.height = 240;
+  config.frameRate = 25;
+  config.realTime = false;
+  config.frameLimit = 40;
+  auto source = SyntheticVideoSource::create(config, [&](const VideoFrame &frame) {
+    EXPECT_EQ(frame.width, 320);
+    EXPECT_EQ(frame.height, 240);
+    timestamps.push_back(frame.timestampUs);
+  });
+  ASSERT_NE(source, nullptr);
+  ASSERT_TRUE(source->start());
+  EXPECT_FALSE(source->start());
+  source->wait();
+  source->stop();
+
+  ASSERT_EQ(timestamps.size(), 40u);
+  EXPECT_EQ(timestamps[1], 40000);
+  EXPECT_EQ(timestamps[39], 39 * 40000);
+  EXPECT_EQ(source->stats().frames, 40u);
+  EXPECT_EQ(source->stats().skipped, 0u);
+}
+
+TEST(SyntheticVideoSourceTest, RealTimeKeepsToTheFrameRate)
+{
+  std::vector<int64_t> timestamps;
+  SyntheticVideoSource::Config config;
+  config.frameRate = 50;
+  config.frameLimit = 26;
+  auto source = SyntheticVideoSource::create(config, [&](const VideoFrame &frame) { timestamps.push_back(frame.timestampUs); });
+  ASSERT_NE(source, nullptr);
+  ASSERT_TRUE(source->start());
+  source->wait();
+
+  // A loaded machine may skip frames, but never stretches the timeline:
+  // every frame keeps the timestamp of its 20 ms slot, runs less than an
+  // interval late, and the run ends with the last slot's deadline. The
+  // pacing arithmetic itself is tested exactly in DeadlinePacerTest.
+  SyntheticVideoSource::Stats stats = source->stats();
+  ASSERT_EQ(stats.frames, 26u);
+  ASSERT_EQ(timestamps.size(), 26u);
+  for (size_t i = 1; i < timestamps.size(); ++i) {
+    EXPECT_GT(timestamps[i], timestamps[i - 1]);
+    EXPECT_EQ(timestamps[i] % 20000, 0);
+  }
+  const int64_t lastSlotUs = timestamps.back();
+  EXPECT_EQ(uint64_t(lastSlotUs / 20000), stats.frames + stats.skipped - 1);
+  EXPECT_GE(stats.elapsedUs, lastSlotUs);
+  EXPECT_LT(stats.maxLatenessUs, 20000);
+  // Plus one interval of lateness and the last frame's own (preemptible)
+  // run time.
+  EXPECT_LT(stats.elapsedUs, lastSlotUs + 20000 + 250000);
+}
+
+TEST(SyntheticVideoSourceTest, StopInterruptsTheWait)
+{
+  SyntheticVideoSource::Config config;
+  config.frameRate = 0.5;
+  auto source = SyntheticVideoSource::create(config, [](const VideoFrame &) {});
+  ASSERT_TRUE(source->start());
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  const int64_t stopUs = monotonicMicros();
+  source->stop();
+  // The second frame is due two seconds after the first.
+  EXPECT_LT(monotonicMicros() - stopUs, 500000);
+  EXPECT_EQ(source->stats().frames, 1u);
+  EXPECT_TRUE(source->start());
+}
+
+TEST(SyntheticVideoSourceTest, LoopsAndScalesAFile)
+{
+  const std::string path = testing::TempDir() + "synthetic_source.y4m";
+  auto frame = FrameBuffer::create(PixelFormat::I420, 16, 16);
+  auto writer = Y4mWriter::create(path, 16, 16, 10);
+  for (int index = 0; index < 3; ++index) {
+    drawTestPattern(frame->frame(), uint64_t(index) * 4);
+    ASSERT_TRUE(writer->writeFrame(frame->frame()));
+  }
+  writer->close();
+
+  SyntheticVideoSource::Config config;
+  config.path = path;
+  auto source = SyntheticVideoSource::create(config, [](const VideoFrame &) {});
+  ASSERT_NE(source, nullptr);
+  EXPECT_EQ(source->width(), 16);
+  EXPECT_DOUBLE_EQ(source->frameRate(), 10.0);
+
+  VideoFrame first;
+  VideoFrame looped;
+  ASSERT_TRUE(source->renderFrame(0, first));
+  ASSERT_TRUE(source->renderFrame(3, looped));
+  EXPECT_EQ(first.planes[0].data, looped.planes[0].data);
+  EXPECT_EQ(looped.timestampUs, 300000);
+
+  config.width = 8;
+  config.height = 8;
+  auto scaled = SyntheticVideoSource::create(config, [](const VideoFrame &) {});
+  ASSERT_NE(scaled, nullptr);
+  VideoFrame small;
+  ASSERT_TRUE(scaled->renderFrame(1, small));
+  EXPECT_EQ(small.width, 8);
+  EXPECT_EQ(small.height, 8);
+
+  config.width = 7;
+  EXPECT_EQ(SyntheticVideoSource::create(config, [](const VideoFrame &) {}), nullptr);
+  config.path += ".missing";
+  config.width = 8;
+  EXPECT_EQ(SyntheticVideoSource::create(config, [](const VideoFrame &) {}), nullptr);
+  remove(path.c_str());
+}
@@ -0,0 +1,115 @@
+//
+//  TileHasherTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/Simd.h"
+#include "tivonage/TileHasher.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace tivonage;
+
+namespace {
+
+void fillRandom(VideoFrame &frame, uint32_t seed)
+{
+  std::mt19937 random(seed);
+  for (int plane = 0; plane < planeCount(frame.format); ++plane) {
+    for (int y = 0; y < planeRows(frame.format, plane, frame.height); ++y) {
+      for (int x = 0; x < planeRowBytes(frame.format, plane, frame.width); ++x) {
+        frame.planes[plane].data[y * frame.planes[plane].stride + x] = uint8_t(random());
+      }
+    }
+  }
+}
+
+class TileHasherTest : public ::testing::Test {
+protected:
+  void TearDown() override { setSimdLevelLimit(SimdLevel::NEON); }
+};
+
+}
+
+TEST_F(TileHasherTest, FirstFrameIsAllDirtyAndRepeatsAreClean)
+{
+  auto frame = FrameBuffer::create(PixelFormat::ARGB, 100, 70);
+  fillRandom(frame->frame(), 1);
+  TileHasher hasher;
+  EXPECT_EQ(hasher.update(frame->frame()), 4 * 3);
+  EXPECT_EQ(hasher.columns(), 4);
+  EXPECT_EQ(hasher.rows(), 3);
+  EXPECT_EQ(hasher.update(frame->frame()), 0);
+  EXPECT_FALSE(hasher.isDirty(3, 2));
+}
+
+TEST_F(TileHasherTest, OneChangedPixelDirtiesOnlyItsTile)
+{
+  auto frame = FrameBuffer::create(PixelFormat::ARGB, 100, 70);
+  fillRandom(frame->frame(), 2);
+  TileHasher hasher;
+  hasher.update(frame->frame());
+
+  // Every byte of the last, partial tile column and row counts.
+  const int points[][2] = { { 0, 0 }, { 31, 31 }, { 32, 0 }, { 99, 69 }, { 64, 40 } };
+  for (const auto &point : points) {
+    for (int byte = 0; byte < 4; ++byte) {
+      uint8_t &value = frame->frame().planes[0].data[point[1] * frame->frame().planes[0].stride + point[0] * 4 + byte];
+      value ^= 0x01;
+      ASSERT_EQ(hasher.update(frame->frame()), 1) << point[0] << "," << point[1] << " byte " << byte;
+      EXPECT_TRUE(hasher.isDirty(point[0] / TileHasher::kTileSize, point[1] / TileHasher::kTileSize));
+      value ^= 0x01;
+      EXPECT_EQ(hasher.update(frame->frame()), 1);
+    }
+  }
+}
+
+TEST_F(TileHasherTest, IgnoresRowPadding)
+{
+  auto frame = FrameBuffer::create(PixelFormat::I420, 40, 40);
+  ASSERT_GT(frame->frame().planes[0].stride, 40);
+  fillRandom(frame->frame(), 3);
+  TileHasher hasher;
+  hasher.update(frame->frame());
+  frame->frame().planes[0].data[40] ^= 0xFF;
+  EXPECT_EQ(hasher.update(frame->frame()), 0);
+}
+
+TEST_F(TileHasherTest, SizeChangeAndResetMarkEverythingDirty)
+{
+  auto frame = FrameBuffer::create(PixelFormat::I420, 64, 64);
+  fillRandom(frame->frame(), 4);
+  TileHasher hasher;
+  hasher.update(frame->frame());
+  hasher.reset();
+  EXPECT_EQ(hasher.update(frame->frame()), 4);
+
+  auto larger = FrameBuffer::create(PixelFormat::I420, 96, 64);
+  fillRandom(larger->frame(), 4);
+  EXPECT_EQ(hasher.update(larger->frame()), 6);
+  EXPECT_EQ(hasher.update(larger->frame()), 0);
+}
+
+TEST_F(TileHasherTest, SimdMatchesScalarHashes)
+{
+  std::vector<SimdLevel> levels = { SimdLevel::Scalar, SimdLevel::SSE2, detectedSimdLevel() };
+  const int sizes[][2] = { { 1, 1 }, { 33, 17 }, { 257, 65 }, { 1170, 40 } };
+  for (const auto &size : sizes) {
+    for (PixelFormat format : { PixelFormat::I420, PixelFormat::ARGB }) {
+      auto frame = FrameBuffer::create(format, size[0], size[1]);
+      fillRandom(frame->frame(), uint32_t(size[0]));
+      setSimdLevelLimit(SimdLevel::Scalar);
+      TileHasher hasher;
+      hasher.update(frame->frame());
+      // Hashes from every level must agree, or an unchanged frame would
+      // look dirty.
+      for (SimdLevel level : levels) {
+        setSimdLevelLimit(level);
+        EXPECT_EQ(hasher.update(frame->frame()), 0) << simdLevelName(level) << " " << size[0] << "x" << size[1];
+      }
+    }
+  }
+}
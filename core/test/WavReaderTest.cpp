@@ -0,0 +1,105 @@
+//
+//  WavReaderTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/WavReader.h"
+#include "tivonage/WavWriter.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace tivonage;
+
+TEST(WavReaderTest, ReadsWhatWavWriterWrote)
+{
+  const std::string path = testing::TempDir() + "wav_reader_mono.wav";
+  std::vector<int16_t> samples(1000);
+  for (size_t i = 0; i < samples.size(); ++i) {
+    samples[i] = int16_t(int(i) * 37 - 18000);
+  }
+  auto writer = WavWriter::create(path, 16000, 1);
+  ASSERT_NE(writer, nullptr);
+  writer->write(samples.data(), samples.size());
+  ASSERT_TRUE(writer->close());
+
+  auto reader = WavReader::open(path);
+  ASSERT_NE(reader, nullptr);
+  EXPECT_EQ(reader->sampleRate(), 16000);
+  EXPECT_EQ(reader->channels(), 1);
+  EXPECT_EQ(reader->frameCount(), 1000u);
+
+  std::vector<int16_t> read(400);
+  EXPECT_EQ(reader->readMono(0, read.data(), 400), 400u);
+  EXPECT_EQ(read, std::vector<int16_t>(samples.begin(), samples.begin() + 400));
+  EXPECT_EQ(reader->readMono(900, read.data(), 400), 100u);
+  EXPECT_EQ(std::vector<int16_t>(read.begin(), read.begin() + 100), std::vector<int16_t>(samples.begin() + 900, samples.end()));
+  EXPECT_EQ(reader->readMono(1000, read.data(), 400), 0u);
+  remove(path.c_str());
+}
+
+TEST(WavReaderTest, AveragesChannels)
+{
+  const std::string path = testing::TempDir() + "wav_reader_stereo.wav";
+  auto writer = WavWriter::create(path, 48000, 2);
+  const int16_t samples[6] = { 100, 300, -32768, -32768, 32767, -32767 };
+  writer->write(samples, 6);
+  writer->close();
+
+  auto reader = WavReader::open(path);
+  ASSERT_NE(reader, nullptr);
+  EXPECT_EQ(reader->channels(), 2);
+  EXPECT_EQ(reader->frameCount(), 3u);
+  int16_t mono[3];
+  ASSERT_EQ(reader->readMono(0, mono, 3), 3u);
+  EXPECT_EQ(mono[0], 200);
+  EXPECT_EQ(mono[1], -32768);
+  EXPECT_EQ(mono[2], 0);
+  remove(path.c_str());
+}
+
+TEST(WavReaderTest, ReadsAnUnclosedFileToTheEnd)
+{
+  // A writer that never closed leaves the sizes at their maximum.
+  const std::string path = testing::TempDir() + "wav_reader_unclosed.wav";
+  {
+    const unsigned char header[44] = { 'R', 'I', 'F', 'F', 0xFF, 0xFF, 0xFF, 0xFF, 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0, 1,
+      0, 0x40, 0x1F, 0, 0, 0x80, 0x3E, 0, 0, 2, 0, 16, 0, 'd', 'a', 't', 'a', 0xFF, 0xFF, 0xFF, 0xFF };
+    std::vector<int16_t> samples(251, 42);
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    // And an odd trailing byte, half a sample.
+    file.write(reinterpret_cast<const char *>(samples.data()), std::streamsize(250 * sizeof(int16_t) + 1));
+  }
+  auto reader = WavReader::open(path);
+  ASSERT_NE(reader, nullptr);
+  EXPECT_EQ(reader->sampleRate(), 8000);
+  EXPECT_EQ(reader->frameCount(), 250u);
+  remove(path.c_str());
+}
+
+TEST(WavReaderTest, RejectsWhatItCannotRead)
+{
+  EXPECT_EQ(WavReader::open(testing::TempDir() + "wav_reader_missing.wav"), nullptr);
+
+  const std::string path = testing::TempDir() + "wav_reader_invalid.wav";
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << "RIFF\x10\0\0\0WAVEjunk";
+  }
+  EXPECT_EQ(WavReader::open(path), nullptr);
+
+  // 8-bit PCM.
+  {
+    const unsigned char header[44] = { 'R', 'I', 'F', 'F', 36, 0, 0, 0, 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0, 1, 0,
+      0x40, 0x1F, 0, 0, 0x40, 0x1F, 0, 0, 1, 0, 8, 0, 'd', 'a', 't', 'a', 0, 0, 0, 0 };
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+  }
+  EXPECT_EQ(WavReader::open(path), nullptr);
+  remove(path.c_str());
+}
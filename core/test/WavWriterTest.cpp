@@ -0,0 +1,96 @@
+//
+//  WavWriterTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/WavWriter.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using namespace tivonage;
+
+namespace {
+
+std::string readFile(const std::string &path)
+{
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+uint32_t loadLittleEndian(const std::string &data, size_t offset, int bytes)
+{
+  uint32_t value = 0;
+  for (int i = 0; i < bytes; ++i) {
+    value |= uint32_t(uint8_t(data[offset + size_t(i)])) << (8 * i);
+  }
+  return value;
+}
+
+}
+
+TEST(WavWriterTest, PatchesSizesOnClose)
+{
+  const std::string path = testing::TempDir() + "wav_writer_test.wav";
+  auto writer = WavWriter::create(path, 16000, 2);
+  ASSERT_NE(writer, nullptr);
+  const int16_t samples[6] = { 1, -1, 2, -2, 300, -300 };
+  EXPECT_TRUE(writer->write(samples, 6));
+  EXPECT_TRUE(writer->write(samples, 2));
+  EXPECT_EQ(writer->frameCount(), 4u);
+  EXPECT_TRUE(writer->close());
+
+  std::string data = readFile(path);
+  ASSERT_EQ(data.size(), 44u + 16u);
+  EXPECT_EQ(data.substr(0, 4), "RIFF");
+  EXPECT_EQ(loadLittleEndian(data, 4, 4), 36u + 16u);
+  EXPECT_EQ(data.substr(8, 8), "WAVEfmt ");
+  EXPECT_EQ(loadLittleEndian(data, 20, 2), 1u);
+  EXPECT_EQ(loadLittleEndian(data, 22, 2), 2u);
+  EXPECT_EQ(loadLittleEndian(data, 24, 4), 16000u);
+  EXPECT_EQ(loadLittleEndian(data, 28, 4), 64000u);
+  EXPECT_EQ(loadLittleEndian(data, 32, 2), 4u);
+  EXPECT_EQ(loadLittleEndian(data, 34, 2), 16u);
+  EXPECT_EQ(data.substr(36, 4), "data");
+  EXPECT_EQ(loadLittleEndian(data, 40, 4), 16u);
+  EXPECT_EQ(memcmp(data.data() + 44, samples, 12), 0);
+  remove(path.c_str());
+}
+
+TEST(WavWriterTest, FlushCompletesTheFileAndKeepsWriting)
+{
+  const std::string path = testing::TempDir() + "wav_writer_flush_test.wav";
+  auto writer = WavWriter::create(path, 8000, 1);
+  ASSERT_NE(writer, nullptr);
+  const int16_t samples[4] = { 5, 6, 7, 8 };
+  EXPECT_TRUE(writer->write(samples, 4));
+  EXPECT_TRUE(writer->flush());
+
+  std::string data = readFile(path);
+  ASSERT_EQ(data.size(), 44u + 8u);
+  EXPECT_EQ(loadLittleEndian(data, 4, 4), 36u + 8u);
+  EXPECT_EQ(loadLittleEndian(data, 40, 4), 8u);
+
+  EXPECT_TRUE(writer->write(samples, 2));
+  EXPECT_TRUE(writer->close());
+  data = readFile(path);
+  ASSERT_EQ(data.size(), 44u + 12u);
+  EXPECT_EQ(loadLittleEndian(data, 40, 4), 12u);
+  EXPECT_EQ(memcmp(data.data() + 44, samples, 8), 0);
+  EXPECT_EQ(memcmp(data.data() + 52, samples, 4), 0);
+  EXPECT_FALSE(writer->flush());
+  remove(path.c_str());
+}
+
+TEST(WavWriterTest, RejectsInvalidFormats)
+{
+  const std::string path = testing::TempDir() + "wav_writer_invalid.wav";
+  EXPECT_EQ(WavWriter::create(path, 0, 1), nullptr);
+  EXPECT_EQ(WavWriter::create(path, 48000, 0), nullptr);
+  EXPECT_EQ(WavWriter::create(testing::TempDir() + "missing/dir/file.wav", 48000, 1), nullptr);
+}
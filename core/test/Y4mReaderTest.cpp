@@ -0,0 +1,91 @@
+//
+//  Y4mReaderTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/Y4mReader.h"
+#include "tivonage/Y4mWriter.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+using namespace tivonage;
+
+namespace {
+
+void writeFile(const std::string &path, const std::string &contents)
+{
+  std::ofstream file(path, std::ios::binary);
+  file << contents;
+}
+
+}
+
+TEST(Y4mReaderTest, ReadsWhatTheWriterWrote)
+{
+  const std::string path = testing::TempDir() + "y4m_reader_roundtrip.y4m";
+  auto frame = FrameBuffer::create(PixelFormat::I420, 8, 6);
+  auto writer = Y4mWriter::create(path, 8, 6, 25);
+  ASSERT_NE(writer, nullptr);
+  for (int index = 0; index < 3; ++index) {
+    for (int plane = 0; plane < 3; ++plane) {
+      VideoPlane &data = frame->frame().planes[plane];
+      memset(data.data, 10 * index + plane, size_t(data.stride * planeRows(PixelFormat::I420, plane, 6)));
+    }
+    ASSERT_TRUE(writer->writeFrame(frame->frame()));
+  }
+  ASSERT_TRUE(writer->close());
+
+  auto reader = Y4mReader::open(path);
+  ASSERT_NE(reader, nullptr);
+  EXPECT_EQ(reader->width(), 8);
+  EXPECT_EQ(reader->height(), 6);
+  EXPECT_DOUBLE_EQ(reader->frameRate(), 25.0);
+  ASSERT_EQ(reader->frameCount(), 3u);
+
+  VideoFrame read;
+  ASSERT_TRUE(reader->frame(2, read));
+  EXPECT_EQ(read.format, PixelFormat::I420);
+  EXPECT_EQ(read.planes[0].stride, 8);
+  EXPECT_EQ(read.planes[1].stride, 4);
+  EXPECT_EQ(read.planes[0].data[47], 20);
+  EXPECT_EQ(read.planes[1].data[11], 21);
+  EXPECT_EQ(read.planes[2].data[0], 22);
+  EXPECT_FALSE(reader->frame(3, read));
+  remove(path.c_str());
+}
+
+TEST(Y4mReaderTest, AcceptsFrameTagsAndIgnoresATruncatedFrame)
+{
+  const std::string path = testing::TempDir() + "y4m_reader_tags.y4m";
+  const std::string planes(2 * 2 + 2, 'x');
+  writeFile(path, "YUV4MPEG2 W2 H2 F30000:1001 It A0:0 C420mpeg2 XYSCSS=420MPEG2\n"
+                  "FRAME Ixyz\n" + planes + "FRAME\n" + planes + "FRAME\n" + planes.substr(0, 3));
+
+  auto reader = Y4mReader::open(path);
+  ASSERT_NE(reader, nullptr);
+  EXPECT_EQ(reader->frameCount(), 2u);
+  EXPECT_NEAR(reader->frameRate(), 29.97, 0.01);
+  remove(path.c_str());
+}
+
+TEST(Y4mReaderTest, RejectsUnsupportedFiles)
+{
+  const std::string path = testing::TempDir() + "y4m_reader_bad.y4m";
+  EXPECT_EQ(Y4mReader::open(path + ".missing"), nullptr);
+
+  writeFile(path, "YUV4MPEG2 W2 H2 F30:1 C444\nFRAME\n" + std::string(12, 'x'));
+  EXPECT_EQ(Y4mReader::open(path), nullptr);
+  writeFile(path, "YUV4MPEG2 W3 H2 F30:1\nFRAME\n" + std::string(12, 'x'));
+  EXPECT_EQ(Y4mReader::open(path), nullptr);
+  writeFile(path, "RIFF");
+  EXPECT_EQ(Y4mReader::open(path), nullptr);
+  writeFile(path, "YUV4MPEG2 W2 H2 F30:1\n");
+  EXPECT_EQ(Y4mReader::open(path), nullptr);
+  remove(path.c_str());
+}
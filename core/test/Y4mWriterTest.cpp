@@ -0,0 +1,65 @@
+//
+//  Y4mWriterTest.cpp
+//  ti.vonage
+//
+
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/Y4mWriter.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using namespace tivonage;
+
+namespace {
+
+std::string readFile(const std::string &path)
+{
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+}
+
+TEST(Y4mWriterTest, WritesHeaderAndTightlyPackedFrames)
+{
+  const std::string path = testing::TempDir() + "y4m_writer_test.y4m";
+  auto frame = FrameBuffer::create(PixelFormat::I420, 6, 4);
+  VideoFrame &planes = frame->frame();
+  for (int plane = 0; plane < 3; ++plane) {
+    memset(planes.planes[plane].data, 'a' + plane, size_t(planes.planes[plane].stride * planeRows(PixelFormat::I420, plane, 4)));
+  }
+
+  auto writer = Y4mWriter::create(path, 6, 4, 25);
+  ASSERT_NE(writer, nullptr);
+  EXPECT_TRUE(writer->writeFrame(planes));
+  EXPECT_TRUE(writer->writeFrame(planes));
+  EXPECT_EQ(writer->frameCount(), 2u);
+  EXPECT_TRUE(writer->close());
+
+  const std::string header = "YUV4MPEG2 W6 H4 F25:1 Ip A1:1 C420jpeg\n";
+  const std::string body = "FRAME\n" + std::string(24, 'a') + std::string(6, 'b') + std::string(6, 'c');
+  EXPECT_EQ(readFile(path), header + body + body);
+  remove(path.c_str());
+}
+
+TEST(Y4mWriterTest, RejectsMismatchedFrames)
+{
+  const std::string path = testing::TempDir() + "y4m_writer_mismatch.y4m";
+  EXPECT_EQ(Y4mWriter::create(path, 5, 4, 30), nullptr);
+
+  auto writer = Y4mWriter::create(path, 4, 4, 30);
+  ASSERT_NE(writer, nullptr);
+  auto other = FrameBuffer::create(PixelFormat::I420, 8, 4);
+  auto nv12 = FrameBuffer::create(PixelFormat::NV12, 4, 4);
+  EXPECT_FALSE(writer->writeFrame(other->frame()));
+  EXPECT_FALSE(writer->writeFrame(nv12->frame()));
+  EXPECT_EQ(writer->frameCount(), 0u);
+  writer.reset();
+  remove(path.c_str());
+}
@@ -15,3 +15,16 @@ FOUNDATION_EXPORT double TiVonageVersionNumber;
 FOUNDATION_EXPORT const unsigned char TiVonageVersionString[];
 
 #import "TiVonageModuleAssets.h"
+#import "TiVonageActiveSpeakerDetector.h"
+#import "TiVonageAudioDevice.h"
+#import "TiVonageAudioLevelMeter.h"
+#import "TiVonageCaptureController.h"
+#import "TiVonageCore.h"
+#import "TiVonageFileAudioDevice.h"
+#import "TiVonageGallery.h"
+#import "TiVonageRecorder.h"
+#import "TiVonageScreenCapturer.h"
+#import "TiVonageSubscriptionController.h"
+#import "TiVonageSyntheticCapturer.h"
+#import "TiVonageVideoCapturer.h"
+#import "TiVonageVideoRenderer.h"
@@ -0,0 +1,44 @@
+//
+//  TiVonageActiveSpeakerDetector.h
+//  ti.vonage
+//
+//  Objective-C facade over tivonage::ActiveSpeakerDetector (see core/).
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Tells from the subscribed streams' audio levels who is talking: the
+ * active speaker, and a ranking of the most recent speakers that decides
+ * which streams get full-size video. Call -update on the UI tick. Main
+ * thread only.
+ */
+@interface TiVonageActiveSpeakerDetector : NSObject
+
+/// The ranking holds at most this many streams, the active speaker first.
+- (instancetype)initWithMaxRanked:(NSInteger)maxRanked;
+
+@property (nonatomic, readonly) NSInteger maxRanked;
+
+/// A level from an audio level delegate (0 to 1 amplitude).
+- (void)addLevel:(float)level forStream:(NSString *)streamId;
+
+- (void)removeStream:(NSString *)streamId;
+
+- (void)removeAllStreams;
+
+/// Re-evaluates the active speaker and the ranking; YES if either changed.
+- (BOOL)update;
+
+/// nil until someone spoke.
+@property (nonatomic, readonly, nullable) NSString *activeSpeaker;
+
+@property (nonatomic, readonly) NSArray<NSString *> *ranking;
+
+- (BOOL)isRanked:(NSString *)streamId;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,72 @@
+//
+//  TiVonageActiveSpeakerDetector.mm
+//  ti.vonage
+//
+
+#import "TiVonageActiveSpeakerDetector.h"
+
+#include "tivonage/ActiveSpeakerDetector.h"
+#include "tivonage/Clock.h"
+
+#include <memory>
+
+@implementation TiVonageActiveSpeakerDetector {
+  std::unique_ptr<tivonage::ActiveSpeakerDetector> _detector;
+}
+
+- (instancetype)initWithMaxRanked:(NSInteger)maxRanked
+{
+  if (self = [super init]) {
+    tivonage::ActiveSpeakerDetector::Config config;
+    config.maxRanked = int(MAX(maxRanked, 1));
+    _detector.reset(new tivonage::ActiveSpeakerDetector(config));
+  }
+  return self;
+}
+
+- (NSInteger)maxRanked
+{
+  return _detector->config().maxRanked;
+}
+
+- (void)addLevel:(float)level forStream:(NSString *)streamId
+{
+  _detector->addLevel(streamId.UTF8String, level, tivonage::monotonicMicros());
+}
+
+- (void)removeStream:(NSString *)streamId
+{
+  _detector->removeStream(streamId.UTF8String);
+}
+
+- (void)removeAllStreams
+{
+  _detector->clear();
+}
+
+- (BOOL)update
+{
+  return _detector->update(tivonage::monotonicMicros());
+}
+
+- (NSString *)activeSpeaker
+{
+  const std::string &streamId = _detector->activeSpeaker();
+  return streamId.empty() ? nil : @(streamId.c_str());
+}
+
+- (NSArray<NSString *> *)ranking
+{
+  NSMutableArray<NSString *> *ranking = [NSMutableArray arrayWithCapacity:_detector->ranking().size()];
+  for (const std::string &streamId : _detector->ranking()) {
+    [ranking addObject:@(streamId.c_str())];
+  }
+  return ranking;
+}
+
+- (BOOL)isRanked:(NSString *)streamId
+{
+  return _detector->isRanked(streamId.UTF8String);
+}
+
+@end
@@ -0,0 +1,50 @@
+//
+//  TiVonageAudioDevice.h
+//  ti.vonage
+//
+
+#import <OpenTok/OpenTok.h>
+
+#import "TiVonageRecorder.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * OTAudioDevice owned by the module: a voice-processing I/O unit whose
+ * real-time callbacks only copy mono PCM in and out of lock-free rings,
+ * while a pump thread of its own writes captured audio to the bus and reads
+ * render audio from it (see core/include/tivonage/AudioBridge.h), converting
+ * between the hardware's rate and the bus's (tivonage::Resampler). The
+ * callbacks never lock, allocate or wait on the SDK. Register it with
+ * +[OTAudioDeviceManager setAudioDevice:] before the first session or
+ * publisher is created.
+ */
+@interface TiVonageAudioDevice : NSObject <OTAudioDevice>
+
+/// A 16 kHz bus.
+- (instancetype)init;
+
+/// The bus runs at sampleRate (8000, 16000 or 32000), whatever the hardware
+/// does.
+- (instancetype)initWithSampleRate:(int)sampleRate NS_DESIGNATED_INITIALIZER;
+
+/// Rendered audio (every subscribed stream, mixed) is also written to this
+/// recorder's .wav file. Any thread.
+@property (atomic, weak, nullable) TiVonageRecorder *recorder;
+
+/// The bus's rate: both directions and recorded audio.
+@property (nonatomic, readonly) int sampleRate;
+
+/// The I/O unit's rate: the hardware's when the device converts, otherwise
+/// sampleRate. Read from the active session when the unit is set up, and
+/// again whenever a route change moves the hardware to another rate.
+@property (nonatomic, readonly) int ioSampleRate;
+
+/// capturedSamples, captureOverflows, renderedSamples, renderUnderflows
+/// (at ioSampleRate), captureDelay and renderDelay (milliseconds),
+/// sampleRate and ioSampleRate.
+@property (atomic, readonly) NSDictionary<NSString *, NSNumber *> *stats;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,468 @@
+//
+//  TiVonageAudioDevice.mm
+//  ti.vonage
+//
+
+#import "TiVonageAudioDevice.h"
+
+#import <AVFoundation/AVFoundation.h>
+#import <AudioToolbox/AudioToolbox.h>
+
+#include "tivonage/AudioBridge.h"
+#include "tivonage/Resampler.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// OTAudioKit.h asks for 8, 16 or 32 kHz.
+static const int TiVonageDefaultSampleRate = 16000;
+
+// The most the unit hands a callback at once; the capture buffer is sized
+// for it up front.
+static const UInt32 TiVonageMaxFramesPerSlice = 4096;
+
+static const AudioUnitElement TiVonageOutputBus = 0;
+static const AudioUnitElement TiVonageInputBus = 1;
+
+// What the real-time callbacks touch: plain C++, so they never message an
+// Objective-C object or retain anything.
+struct TiVonageAudioIO {
+  AudioUnit unit = NULL;
+  tivonage::AudioBridge *bridge = nullptr;
+  std::unique_ptr<int16_t[]> captureBuffer;
+};
+
+// Converts between the I/O unit's rate and the bus's on the pump thread, one
+// 10 ms chunk at a time: with both rates multiples of 100 Hz a chunk always
+// converts to exactly one chunk.
+struct TiVonageAudioConversion {
+  std::unique_ptr<tivonage::Resampler> capture;
+  std::unique_ptr<tivonage::Resampler> render;
+  std::vector<int16_t> captureChunk;
+  std::vector<int16_t> renderChunk;
+};
+
+static OSStatus TiVonageCaptureCallback(void *refCon, AudioUnitRenderActionFlags *flags, const AudioTimeStamp *timeStamp, UInt32 bus,
+    UInt32 frameCount, AudioBufferList *ioData)
+{
+  TiVonageAudioIO *io = static_cast<TiVonageAudioIO *>(refCon);
+  if (frameCount > TiVonageMaxFramesPerSlice) {
+    return kAudioUnitErr_TooManyFramesToProcess;
+  }
+  AudioBufferList list;
+  list.mNumberBuffers = 1;
+  list.mBuffers[0].mNumberChannels = 1;
+  list.mBuffers[0].mDataByteSize = frameCount * sizeof(int16_t);
+  list.mBuffers[0].mData = io->captureBuffer.get();
+  OSStatus status = AudioUnitRender(io->unit, flags, timeStamp, bus, frameCount, &list);
+  if (status == noErr) {
+    io->bridge->writeCapture(io->captureBuffer.get(), frameCount);
+  }
+  return status;
+}
+
+static OSStatus TiVonageRenderCallback(void *refCon, AudioUnitRenderActionFlags *flags, const AudioTimeStamp *timeStamp, UInt32 bus,
+    UInt32 frameCount, AudioBufferList *ioData)
+{
+  TiVonageAudioIO *io = static_cast<TiVonageAudioIO *>(refCon);
+  io->bridge->readRender(static_cast<int16_t *>(ioData->mBuffers[0].mData), frameCount);
+  return noErr;
+}
+
+static BOOL TiVonageCheck(OSStatus status, NSString *what)
+{
+  if (status != noErr) {
+    NSLog(@"[ERROR] Audio device: cannot %@ (%d)", what, int(status));
+    return NO;
+  }
+  return YES;
+}
+
+@interface TiVonageAudioDevice ()
+@property (atomic, strong) id<OTAudioBus> audioBus;
+@end
+
+@implementation TiVonageAudioDevice {
+  OTAudioFormat *_format;
+  // The hardware's rate the unit was set up for, and the unit's own.
+  int _hardwareSampleRate;
+  int _ioSampleRate;
+  // Replaced with the unit; guarded by @synchronized(self).
+  std::unique_ptr<tivonage::AudioBridge> _bridge;
+  TiVonageAudioIO _io;
+  id<NSObject> _routeObserver;
+  BOOL _captureInitialized;
+  BOOL _renderInitialized;
+  // What the SDK asked for, carried over to a rebuilt bridge.
+  BOOL _capturing;
+  BOOL _rendering;
+  BOOL _unitRunning;
+}
+
+- (instancetype)init
+{
+  return [self initWithSampleRate:TiVonageDefaultSampleRate];
+}
+
+- (instancetype)initWithSampleRate:(int)sampleRate
+{
+  if (self = [super init]) {
+    _format = [[OTAudioFormat alloc] init];
+    _format.sampleRate = sampleRate;
+    _format.numChannels = 1;
+    _ioSampleRate = sampleRate;
+    _io.captureBuffer.reset(new int16_t[TiVonageMaxFramesPerSlice]);
+
+    // A new route (a Bluetooth headset, say) may run the hardware at another
+    // rate; the unit is then set up again for it.
+    __weak TiVonageAudioDevice *weakSelf = self;
+    _routeObserver = [[NSNotificationCenter defaultCenter] addObserverForName:AVAudioSessionRouteChangeNotification
+                                                                       object:nil
+                                                                        queue:nil
+                                                                   usingBlock:^(NSNotification *notification) {
+                                                                     [weakSelf routeDidChange];
+                                                                   }];
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  [[NSNotificationCenter defaultCenter] removeObserver:_routeObserver];
+  [self tearDownAudioUnit];
+}
+
+- (int)sampleRate
+{
+  return int(_format.sampleRate);
+}
+
+- (int)ioSampleRate
+{
+  @synchronized(self) {
+    return _ioSampleRate;
+  }
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)stats
+{
+  @synchronized(self) {
+    tivonage::AudioBridge::Stats stats = _bridge ? _bridge->stats() : tivonage::AudioBridge::Stats();
+    return @{
+      @"capturedSamples" : @(stats.capturedSamples),
+      @"captureOverflows" : @(stats.captureOverflows),
+      @"renderedSamples" : @(stats.renderedSamples),
+      @"renderUnderflows" : @(stats.renderUnderflows),
+      @"captureDelay" : @(_bridge ? _bridge->captureDelayMs() : 0),
+      @"renderDelay" : @(_bridge ? _bridge->renderDelayMs() : 0),
+      @"sampleRate" : @(self.sampleRate),
+      @"ioSampleRate" : @(_ioSampleRate),
+    };
+  }
+}
+
+// The unit runs at the hardware's rate (44.1 kHz in the simulator, 48 kHz on
+// most devices), which spares it a conversion of its own. That rate is only
+// known once the session is active, so the bridge and the conversion are
+// built with the unit. Rates that do not convert in whole chunks leave the
+// conversion to the unit.
+- (void)createBridgeForHardwareRate:(int)hardwareRate
+{
+  const int sampleRate = self.sampleRate;
+  auto conversion = std::make_shared<TiVonageAudioConversion>();
+  _hardwareSampleRate = hardwareRate;
+  _ioSampleRate = sampleRate;
+  if (hardwareRate != sampleRate && hardwareRate % 100 == 0 && sampleRate % 100 == 0) {
+    conversion->capture = tivonage::Resampler::create(hardwareRate, sampleRate);
+    conversion->render = tivonage::Resampler::create(sampleRate, hardwareRate);
+    if (conversion->capture && conversion->render) {
+      _ioSampleRate = hardwareRate;
+      conversion->captureChunk.resize(conversion->capture->maxOutput(size_t(hardwareRate / 100)));
+      conversion->renderChunk.resize(size_t(sampleRate / 100));
+    } else {
+      conversion->capture.reset();
+      conversion->render.reset();
+    }
+  }
+
+  // The bridge's pump thread is the only one talking to the bus.
+  __weak TiVonageAudioDevice *weakSelf = self;
+  tivonage::AudioBridge::Config config;
+  config.sampleRate = _ioSampleRate;
+  _bridge = tivonage::AudioBridge::create(config,
+      [weakSelf, conversion](const int16_t *samples, size_t count) {
+        if (conversion->capture) {
+          count = conversion->capture->process(samples, count, conversion->captureChunk.data());
+          samples = conversion->captureChunk.data();
+        }
+        [weakSelf.audioBus writeCaptureData:(void *)samples numberOfSamples:uint32_t(count)];
+      },
+      [weakSelf, conversion](int16_t *samples, size_t count) -> size_t {
+        TiVonageAudioDevice *device = weakSelf;
+        id<OTAudioBus> bus = device.audioBus;
+        if (bus == nil) {
+          return 0;
+        }
+        if (!conversion->render) {
+          size_t read = MIN(size_t([bus readRenderData:samples numberOfSamples:uint32_t(count)]), count);
+          [device.recorder writeAudio:samples count:read];
+          return read;
+        }
+        // A short read is padded before converting, so the filter's
+        // history stays continuous.
+        std::vector<int16_t> &chunk = conversion->renderChunk;
+        size_t read = MIN(size_t([bus readRenderData:chunk.data() numberOfSamples:uint32_t(chunk.size())]), chunk.size());
+        std::fill(chunk.begin() + std::ptrdiff_t(read), chunk.end(), int16_t(0));
+        [device.recorder writeAudio:chunk.data() count:read];
+        return conversion->render->process(chunk.data(), chunk.size(), samples);
+      });
+  _bridge->setCapturing(_capturing);
+  _bridge->setRendering(_rendering);
+  _io.bridge = _bridge.get();
+}
+
+// One voice-processing unit serves both directions; it runs while either
+// does.
+- (BOOL)setUpAudioUnit
+{
+  if (_io.unit != NULL) {
+    return YES;
+  }
+
+  NSError *error = nil;
+  AVAudioSession *session = [AVAudioSession sharedInstance];
+  AVAudioSessionCategoryOptions options = AVAudioSessionCategoryOptionAllowBluetooth | AVAudioSessionCategoryOptionDefaultToSpeaker;
+  if (![session setCategory:AVAudioSessionCategoryPlayAndRecord mode:AVAudioSessionModeVoiceChat options:options error:&error]
+      || ![session setActive:YES error:&error]) {
+    NSLog(@"[ERROR] Audio device: cannot configure the audio session: %@", error.localizedDescription);
+    return NO;
+  }
+  [self createBridgeForHardwareRate:int(session.sampleRate)];
+
+  AudioComponentDescription description = { kAudioUnitType_Output, kAudioUnitSubType_VoiceProcessingIO, kAudioUnitManufacturer_Apple, 0, 0 };
+  AudioComponent component = AudioComponentFindNext(NULL, &description);
+  AudioUnit unit = NULL;
+  if (component == NULL || !TiVonageCheck(AudioComponentInstanceNew(component, &unit), @"create the I/O unit")) {
+    return NO;
+  }
+
+  UInt32 enable = 1;
+  UInt32 maxFrames = TiVonageMaxFramesPerSlice;
+  AudioStreamBasicDescription format = {};
+  format.mSampleRate = _ioSampleRate;
+  format.mFormatID = kAudioFormatLinearPCM;
+  format.mFormatFlags = kLinearPCMFormatFlagIsSignedInteger | kLinearPCMFormatFlagIsPacked;
+  format.mBytesPerPacket = sizeof(int16_t);
+  format.mFramesPerPacket = 1;
+  format.mBytesPerFrame = sizeof(int16_t);
+  format.mChannelsPerFrame = 1;
+  format.mBitsPerChannel = 16;
+  AURenderCallbackStruct capture = { TiVonageCaptureCallback, &_io };
+  AURenderCallbackStruct render = { TiVonageRenderCallback, &_io };
+
+  BOOL configured = TiVonageCheck(AudioUnitSetProperty(unit, kAudioOutputUnitProperty_EnableIO, kAudioUnitScope_Input, TiVonageInputBus, &enable, sizeof(enable)), @"enable input")
+      && TiVonageCheck(AudioUnitSetProperty(unit, kAudioOutputUnitProperty_EnableIO, kAudioUnitScope_Output, TiVonageOutputBus, &enable, sizeof(enable)), @"enable output")
+      && TiVonageCheck(AudioUnitSetProperty(unit, kAudioUnitProperty_StreamFormat, kAudioUnitScope_Output, TiVonageInputBus, &format, sizeof(format)), @"set the capture format")
+      && TiVonageCheck(AudioUnitSetProperty(unit, kAudioUnitProperty_StreamFormat, kAudioUnitScope_Input, TiVonageOutputBus, &format, sizeof(format)), @"set the render format")
+      && TiVonageCheck(AudioUnitSetProperty(unit, kAudioUnitProperty_MaximumFramesPerSlice, kAudioUnitScope_Global, 0, &maxFrames, sizeof(maxFrames)), @"set the slice size")
+      && TiVonageCheck(AudioUnitSetProperty(unit, kAudioOutputUnitProperty_SetInputCallback, kAudioUnitScope_Global, TiVonageInputBus, &capture, sizeof(capture)), @"set the capture callback")
+      && TiVonageCheck(AudioUnitSetProperty(unit, kAudioUnitProperty_SetRenderCallback, kAudioUnitScope_Input, TiVonageOutputBus, &render, sizeof(render)), @"set the render callback");
+  _io.unit = unit;
+  if (!configured || !TiVonageCheck(AudioUnitInitialize(unit), @"initialize the I/O unit")) {
+    AudioComponentInstanceDispose(unit);
+    _io.unit = NULL;
+    return NO;
+  }
+  return YES;
+}
+
+- (void)tearDownAudioUnit
+{
+  if (_io.unit == NULL) {
+    return;
+  }
+  // Stopping waits for the callbacks in flight, so the bridge is free to go.
+  AudioOutputUnitStop(_io.unit);
+  AudioUnitUninitialize(_io.unit);
+  AudioComponentInstanceDispose(_io.unit);
+  _io.unit = NULL;
+  _io.bridge = nullptr;
+  _bridge.reset();
+  _unitRunning = NO;
+}
+
+- (void)routeDidChange
+{
+  @synchronized(self) {
+    int hardwareRate = int([AVAudioSession sharedInstance].sampleRate);
+    if (_io.unit == NULL || hardwareRate == _hardwareSampleRate) {
+      return;
+    }
+    // Queued audio and the filters' history belong to the old rate; both
+    // directions restart from silence.
+    [self tearDownAudioUnit];
+    if ([self setUpAudioUnit]) {
+      [self updateAudioUnit];
+    } else {
+      _captureInitialized = NO;
+      _renderInitialized = NO;
+    }
+  }
+}
+
+- (void)updateAudioUnit
+{
+  BOOL running = _capturing || _rendering;
+  if (running == _unitRunning || _io.unit == NULL) {
+    return;
+  }
+  if (running ? TiVonageCheck(AudioOutputUnitStart(_io.unit), @"start the I/O unit") : TiVonageCheck(AudioOutputUnitStop(_io.unit), @"stop the I/O unit")) {
+    _unitRunning = running;
+  }
+}
+
+// The hardware's share of the delay, on top of what the rings hold.
+static uint16_t TiVonageDelayMs(int queuedMs, NSTimeInterval latency)
+{
+  NSTimeInterval buffer = [AVAudioSession sharedInstance].IOBufferDuration;
+  return uint16_t(MIN(queuedMs + int((latency + buffer) * 1000.0), int(UINT16_MAX)));
+}
+
+#pragma mark OTAudioDevice
+
+- (BOOL)setAudioBus:(id<OTAudioBus>)audioBus
+{
+  self.audioBus = audioBus;
+  return YES;
+}
+
+- (OTAudioFormat *)captureFormat
+{
+  return _format;
+}
+
+- (OTAudioFormat *)renderFormat
+{
+  return _format;
+}
+
+- (BOOL)renderingIsAvailable
+{
+  return YES;
+}
+
+- (BOOL)initializeRendering
+{
+  @synchronized(self) {
+    _renderInitialized = [self setUpAudioUnit];
+    return _renderInitialized;
+  }
+}
+
+- (BOOL)renderingIsInitialized
+{
+  @synchronized(self) {
+    return _renderInitialized;
+  }
+}
+
+- (BOOL)startRendering
+{
+  @synchronized(self) {
+    if (!_renderInitialized) {
+      return NO;
+    }
+    _rendering = YES;
+    _bridge->setRendering(true);
+    [self updateAudioUnit];
+    return _unitRunning;
+  }
+}
+
+- (BOOL)stopRendering
+{
+  @synchronized(self) {
+    _rendering = NO;
+    if (_bridge) {
+      _bridge->setRendering(false);
+    }
+    [self updateAudioUnit];
+    return YES;
+  }
+}
+
+- (BOOL)isRendering
+{
+  @synchronized(self) {
+    return _rendering;
+  }
+}
+
+- (uint16_t)estimatedRenderDelay
+{
+  @synchronized(self) {
+    return TiVonageDelayMs(_bridge ? _bridge->renderDelayMs() : 0, [AVAudioSession sharedInstance].outputLatency);
+  }
+}
+
+- (BOOL)captureIsAvailable
+{
+  return YES;
+}
+
+- (BOOL)initializeCapture
+{
+  @synchronized(self) {
+    _captureInitialized = [self setUpAudioUnit];
+    return _captureInitialized;
+  }
+}
+
+- (BOOL)captureIsInitialized
+{
+  @synchronized(self) {
+    return _captureInitialized;
+  }
+}
+
+- (BOOL)startCapture
+{
+  @synchronized(self) {
+    if (!_captureInitialized) {
+      return NO;
+    }
+    _capturing = YES;
+    _bridge->setCapturing(true);
+    [self updateAudioUnit];
+    return _unitRunning;
+  }
+}
+
+- (BOOL)stopCapture
+{
+  @synchronized(self) {
+    _capturing = NO;
+    if (_bridge) {
+      _bridge->setCapturing(false);
+    }
+    [self updateAudioUnit];
+    return YES;
+  }
+}
+
+- (BOOL)isCapturing
+{
+  @synchronized(self) {
+    return _capturing;
+  }
+}
+
+- (uint16_t)estimatedCaptureDelay
+{
+  @synchronized(self) {
+    return TiVonageDelayMs(_bridge ? _bridge->captureDelayMs() : 0, [AVAudioSession sharedInstance].inputLatency);
+  }
+}
+
+@end
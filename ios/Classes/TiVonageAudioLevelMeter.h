@@ -0,0 +1,32 @@
+//
+//  TiVonageAudioLevelMeter.h
+//  ti.vonage
+//
+//  Objective-C facade over tivonage::AudioLevelMeter (see core/).
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Collects the audio levels the SDK reports for every published and
+ * subscribed stream and turns them into one talking-indicator batch per UI
+ * tick. Main thread only.
+ */
+@interface TiVonageAudioLevelMeter : NSObject
+
+/// A level from an audio level delegate (0 to 1 amplitude).
+- (void)addLevel:(float)level forStream:(NSString *)streamId;
+
+- (void)removeStream:(NSString *)streamId;
+
+- (void)removeAllStreams;
+
+/// { streams: [streamId], levels: [0 to 1, two decimals] } in the order the
+/// streams appeared, or nil while no meter moved since the last batch.
+- (nullable NSDictionary<NSString *, NSArray *> *)tick;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,47 @@
+//
+//  TiVonageAudioLevelMeter.mm
+//  ti.vonage
+//
+
+#import "TiVonageAudioLevelMeter.h"
+
+#include "tivonage/AudioLevelMeter.h"
+#include "tivonage/Clock.h"
+
+#include <cmath>
+
+@implementation TiVonageAudioLevelMeter {
+  tivonage::AudioLevelMeter _meter;
+}
+
+- (void)addLevel:(float)level forStream:(NSString *)streamId
+{
+  _meter.addLevel(streamId.UTF8String, level, tivonage::monotonicMicros());
+}
+
+- (void)removeStream:(NSString *)streamId
+{
+  _meter.removeStream(streamId.UTF8String);
+}
+
+- (void)removeAllStreams
+{
+  _meter.clear();
+}
+
+- (NSDictionary<NSString *, NSArray *> *)tick
+{
+  if (!_meter.tick(tivonage::monotonicMicros())) {
+    return nil;
+  }
+  const std::vector<tivonage::AudioLevelMeter::Level> &levels = _meter.levels();
+  NSMutableArray<NSString *> *streams = [NSMutableArray arrayWithCapacity:levels.size()];
+  NSMutableArray<NSNumber *> *values = [NSMutableArray arrayWithCapacity:levels.size()];
+  for (const tivonage::AudioLevelMeter::Level &level : levels) {
+    [streams addObject:@(level.streamId.c_str())];
+    [values addObject:@(std::round(level.level * 100.0f) / 100.0f)];
+  }
+  return @{ @"streams" : streams, @"levels" : values };
+}
+
+@end
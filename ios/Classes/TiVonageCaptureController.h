@@ -0,0 +1,41 @@
+//
+//  TiVonageCaptureController.h
+//  ti.vonage
+//
+//  Objective-C facade over tivonage::CaptureController (see core/).
+//
+
+#import <CoreGraphics/CoreGraphics.h>
+#import <OpenTok/OpenTok.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Picks the publisher's capture size and frame rate from its uplink's
+ * network stats, stepping down quickly on congestion and back up slowly.
+ * Feed it every video stats update and apply captureSize / captureFrameRate
+ * to the capturer when -update returns YES. Main thread only.
+ */
+@interface TiVonageCaptureController : NSObject
+
+- (instancetype)initWithBaseSize:(CGSize)size frameRate:(double)frameRate;
+
+/// Sums the entries (one per subscriber in relayed sessions).
+- (void)addVideoNetworkStats:(NSArray<OTPublisherKitVideoNetworkStats *> *)stats;
+
+/// Re-evaluates the capture format; YES if it changed since the last call.
+- (BOOL)update;
+
+@property (nonatomic, readonly) CGSize captureSize;
+@property (nonatomic, readonly) double captureFrameRate;
+
+/// 0 for the base format, higher for smaller ones.
+@property (nonatomic, readonly) NSInteger level;
+
+/// Smoothed packet loss (0-1) and sent video bitrate (bits per second).
+@property (nonatomic, readonly) double packetLoss;
+@property (nonatomic, readonly) double bitrate;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,67 @@
+//
+//  TiVonageCaptureController.mm
+//  ti.vonage
+//
+
+#import "TiVonageCaptureController.h"
+
+#include "tivonage/CaptureController.h"
+#include "tivonage/Clock.h"
+
+@implementation TiVonageCaptureController {
+  tivonage::CaptureController _controller;
+}
+
+- (instancetype)initWithBaseSize:(CGSize)size frameRate:(double)frameRate
+{
+  if (self = [super init]) {
+    _controller.setBaseFormat(int(size.width), int(size.height), float(frameRate));
+  }
+  return self;
+}
+
+- (void)addVideoNetworkStats:(NSArray<OTPublisherKitVideoNetworkStats *> *)stats
+{
+  int64_t packetsLost = 0;
+  int64_t packetsSent = 0;
+  int64_t bytesSent = 0;
+  for (OTPublisherKitVideoNetworkStats *entry in stats) {
+    packetsLost += entry.videoPacketsLost;
+    packetsSent += entry.videoPacketsSent;
+    bytesSent += entry.videoBytesSent;
+  }
+  _controller.addStats(packetsLost, packetsSent, bytesSent, tivonage::monotonicMicros());
+}
+
+- (BOOL)update
+{
+  return _controller.update(tivonage::monotonicMicros());
+}
+
+- (CGSize)captureSize
+{
+  tivonage::CaptureController::Format format = _controller.format();
+  return CGSizeMake(format.width, format.height);
+}
+
+- (double)captureFrameRate
+{
+  return _controller.format().frameRate;
+}
+
+- (NSInteger)level
+{
+  return _controller.level();
+}
+
+- (double)packetLoss
+{
+  return _controller.lossRate();
+}
+
+- (double)bitrate
+{
+  return _controller.bitrate();
+}
+
+@end
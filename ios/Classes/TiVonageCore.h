@@ -0,0 +1,22 @@
+//
+//  TiVonageCore.h
+//  ti.vonage
+//
+//  Objective-C facade over the portable C++ media core (see core/), so the
+//  Swift module can use it without importing C++.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface TiVonageCore : NSObject
+
++ (NSString *)version;
+
+/// Instruction set the pixel kernels dispatch to ("neon", "avx2", "sse2" or "scalar").
++ (NSString *)simdLevel;
+
+@end
+
+NS_ASSUME_NONNULL_END
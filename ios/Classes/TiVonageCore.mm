@@ -0,0 +1,23 @@
+//
+//  TiVonageCore.mm
+//  ti.vonage
+//
+
+#import "TiVonageCore.h"
+
+#include "tivonage/Core.h"
+#include "tivonage/Simd.h"
+
+@implementation TiVonageCore
+
++ (NSString *)version
+{
+  return [NSString stringWithUTF8String:tivonage::coreVersion()];
+}
+
++ (NSString *)simdLevel
+{
+  return [NSString stringWithUTF8String:tivonage::simdLevelName(tivonage::activeSimdLevel())];
+}
+
+@end
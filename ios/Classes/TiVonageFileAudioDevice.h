@@ -0,0 +1,41 @@
+//
+//  TiVonageFileAudioDevice.h
+//  ti.vonage
+//
+
+#import <OpenTok/OpenTok.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * OTAudioDevice without the microphone and speaker, for reproducible load
+ * tests and profiling of the audio path: captured audio comes from a
+ * memory-mapped .wav file (looped) and rendered audio goes to one, a chunk
+ * every 10 ms on a thread of its own, paced against absolute deadlines or
+ * free-running (see core/include/tivonage/FileAudioDevice.h). Register it
+ * with +[OTAudioDeviceManager setAudioDevice:] before the first session or
+ * publisher is created.
+ */
+@interface TiVonageFileAudioDevice : NSObject <OTAudioDevice>
+
+/// A nil capturePath captures silence; any rate and channel count is mixed
+/// down and converted to sampleRate (8000, 16000 or 32000). A nil
+/// renderPath discards rendered audio; the file is complete whenever
+/// rendering stops, and rendering started again appends to it. realTime NO
+/// runs chunks back to back. Returns nil if either file can't be opened.
+- (nullable instancetype)initWithCapturePath:(nullable NSString *)capturePath
+                                  renderPath:(nullable NSString *)renderPath
+                                  sampleRate:(int)sampleRate
+                                    realTime:(BOOL)realTime;
+
+@property (nonatomic, readonly) int sampleRate;
+
+/// chunks, skipped, meanLateness and maxLateness (milliseconds), speed
+/// (audio time over wall time), capturedSamples, captureOverflows,
+/// renderedSamples, renderUnderflows, captureDelay and renderDelay
+/// (milliseconds) and sampleRate, since the device last started.
+@property (atomic, readonly) NSDictionary<NSString *, NSNumber *> *stats;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,227 @@
+//
+//  TiVonageFileAudioDevice.mm
+//  ti.vonage
+//
+
+#import "TiVonageFileAudioDevice.h"
+
+#include "tivonage/FileAudioDevice.h"
+
+#include <memory>
+
+@interface TiVonageFileAudioDevice ()
+@property (atomic, strong) id<OTAudioBus> audioBus;
+@end
+
+@implementation TiVonageFileAudioDevice {
+  OTAudioFormat *_format;
+  std::unique_ptr<tivonage::FileAudioDevice> _device;
+  BOOL _captureInitialized;
+  BOOL _renderInitialized;
+  BOOL _running;
+}
+
+- (nullable instancetype)initWithCapturePath:(NSString *)capturePath renderPath:(NSString *)renderPath sampleRate:(int)sampleRate realTime:(BOOL)realTime
+{
+  if (self = [super init]) {
+    _format = [[OTAudioFormat alloc] init];
+    _format.sampleRate = sampleRate;
+    _format.numChannels = 1;
+
+    tivonage::FileAudioDevice::Config config;
+    if (capturePath != nil) {
+      config.capturePath = capturePath.fileSystemRepresentation;
+    }
+    if (renderPath != nil) {
+      config.renderPath = renderPath.fileSystemRepresentation;
+    }
+    config.sampleRate = sampleRate;
+    config.realTime = realTime;
+
+    // The device's thread is the only one talking to the bus.
+    __weak TiVonageFileAudioDevice *weakSelf = self;
+    _device = tivonage::FileAudioDevice::create(config,
+        [weakSelf](const int16_t *samples, size_t count) {
+          [weakSelf.audioBus writeCaptureData:(void *)samples numberOfSamples:uint32_t(count)];
+        },
+        [weakSelf](int16_t *samples, size_t count) -> size_t {
+          id<OTAudioBus> bus = weakSelf.audioBus;
+          return bus != nil ? MIN(size_t([bus readRenderData:samples numberOfSamples:uint32_t(count)]), count) : 0;
+        });
+    if (!_device) {
+      NSLog(@"[ERROR] File audio device: cannot open %@ or %@", capturePath ?: @"(silence)", renderPath ?: @"(no render file)");
+      return nil;
+    }
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  _device->stop();
+}
+
+- (int)sampleRate
+{
+  return int(_format.sampleRate);
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)stats
+{
+  tivonage::FileAudioDevice::Stats stats = _device->stats();
+  double audioUs = double(stats.chunks) * double(_device->config().chunkMs) * 1000.0;
+  return @{
+    @"chunks" : @(stats.chunks),
+    @"skipped" : @(stats.skipped),
+    @"meanLateness" : @(stats.meanLatenessUs / 1000.0),
+    @"maxLateness" : @(double(stats.maxLatenessUs) / 1000.0),
+    @"speed" : @(stats.elapsedUs > 0 ? audioUs / double(stats.elapsedUs) : 0.0),
+    @"capturedSamples" : @(stats.bridge.capturedSamples),
+    @"captureOverflows" : @(stats.bridge.captureOverflows),
+    @"renderedSamples" : @(stats.bridge.renderedSamples),
+    @"renderUnderflows" : @(stats.bridge.renderUnderflows),
+    @"captureDelay" : @(_device->captureDelayMs()),
+    @"renderDelay" : @(_device->renderDelayMs()),
+    @"sampleRate" : @(self.sampleRate),
+  };
+}
+
+// One thread serves both directions; it runs while either does.
+- (void)updateThread
+{
+  BOOL running = _device->isCapturing() || _device->isRendering();
+  if (running == _running) {
+    return;
+  }
+  if (running) {
+    _device->start();
+  } else {
+    _device->stop();
+  }
+  _running = running;
+}
+
+#pragma mark OTAudioDevice
+
+- (BOOL)setAudioBus:(id<OTAudioBus>)audioBus
+{
+  self.audioBus = audioBus;
+  return YES;
+}
+
+- (OTAudioFormat *)captureFormat
+{
+  return _format;
+}
+
+- (OTAudioFormat *)renderFormat
+{
+  return _format;
+}
+
+- (BOOL)renderingIsAvailable
+{
+  return YES;
+}
+
+- (BOOL)initializeRendering
+{
+  @synchronized(self) {
+    _renderInitialized = YES;
+    return YES;
+  }
+}
+
+- (BOOL)renderingIsInitialized
+{
+  @synchronized(self) {
+    return _renderInitialized;
+  }
+}
+
+- (BOOL)startRendering
+{
+  @synchronized(self) {
+    if (!_renderInitialized) {
+      return NO;
+    }
+    _device->setRendering(true);
+    [self updateThread];
+    return YES;
+  }
+}
+
+- (BOOL)stopRendering
+{
+  @synchronized(self) {
+    _device->setRendering(false);
+    [self updateThread];
+    // The SDK stops and restarts rendering, e.g. around interruptions, so
+    // the file is only completed here; the device closes it when it goes.
+    _device->flushRenderFile();
+    return YES;
+  }
+}
+
+- (BOOL)isRendering
+{
+  return _device->isRendering();
+}
+
+- (uint16_t)estimatedRenderDelay
+{
+  return uint16_t(_device->renderDelayMs());
+}
+
+- (BOOL)captureIsAvailable
+{
+  return YES;
+}
+
+- (BOOL)initializeCapture
+{
+  @synchronized(self) {
+    _captureInitialized = YES;
+    return YES;
+  }
+}
+
+- (BOOL)captureIsInitialized
+{
+  @synchronized(self) {
+    return _captureInitialized;
+  }
+}
+
+- (BOOL)startCapture
+{
+  @synchronized(self) {
+    if (!_captureInitialized) {
+      return NO;
+    }
+    _device->setCapturing(true);
+    [self updateThread];
+    return YES;
+  }
+}
+
+- (BOOL)stopCapture
+{
+  @synchronized(self) {
+    _device->setCapturing(false);
+    [self updateThread];
+    return YES;
+  }
+}
+
+- (BOOL)isCapturing
+{
+  return _device->isCapturing();
+}
+
+- (uint16_t)estimatedCaptureDelay
+{
+  return uint16_t(_device->captureDelayMs());
+}
+
+@end
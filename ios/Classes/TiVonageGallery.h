@@ -0,0 +1,43 @@
+//
+//  TiVonageGallery.h
+//  ti.vonage
+//
+
+#import <UIKit/UIKit.h>
+
+#import "TiVonageVideoRenderer.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Composites several subscribed streams into one surface laid out as a grid
+ * (see core/include/tivonage/GalleryLayout.h), so a large room costs one
+ * display layer instead of one per participant. Each stream's renderer
+ * scales its frames straight to the tile size; the gallery copies them into
+ * place on the display refresh. Main thread only.
+ */
+@interface TiVonageGallery : NSObject
+
+@property (nonatomic, readonly) UIView *view;
+
+/// Size of every tile in device pixels; zero until the view is laid out.
+@property (nonatomic, readonly) CGSize tilePixelSize;
+
+/// Streams in tile order.
+@property (nonatomic, readonly) NSArray<NSString *> *streamIds;
+
+/// Called with the stream whose tile was tapped.
+@property (nonatomic, copy, nullable) void (^tileTapped)(NSString *streamId);
+
+- (instancetype)init;
+
+/// Adds a tile for the stream and routes the renderer's frames to it.
+- (void)addStream:(NSString *)streamId renderer:(TiVonageVideoRenderer *)renderer;
+- (void)removeStream:(NSString *)streamId;
+
+/// The stream shown at a point in the view's coordinates, if any.
+- (nullable NSString *)streamIdAtPoint:(CGPoint)point;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,279 @@
+//
+//  TiVonageGallery.mm
+//  ti.vonage
+//
+
+#import "TiVonageGallery.h"
+
+#import "TiVonageRenderView.h"
+
+#include "tivonage/Clock.h"
+#include "tivonage/GalleryCompositor.h"
+#include "tivonage/GalleryLayout.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Composed surfaces in flight: one on screen, one queued in the display
+// layer and one being composed.
+static const NSUInteger TiVonageGallerySurfaceCount = 3;
+
+#pragma mark - Tiles
+
+// The frame target of one stream's renderer: the tile size to scale to, and
+// a mailbox for the newest frame. The frame last taken stays with the tile so
+// it can be composed again while the stream sends nothing new.
+@interface TiVonageGalleryTile : NSObject <TiVonageFrameTarget>
+
+@property (nonatomic, readonly) NSString *streamId;
+@property (nonatomic, weak) TiVonageVideoRenderer *renderer;
+
+- (instancetype)initWithStreamId:(NSString *)streamId;
+- (void)setPixelWidth:(int)width height:(int)height;
+
+// Main thread. YES if a new frame replaced the current one.
+- (BOOL)takeFrame;
+// Main thread, once the current frame was composed and reached the layer:
+// counts it as displayed, the first time only.
+- (void)frameWasDisplayed;
+- (tivonage::VideoFrame)currentFrame;
+
+@end
+
+@implementation TiVonageGalleryTile {
+  std::atomic<uint64_t> _pixelSize;
+  tivonage::FrameMailbox _mailbox;
+  tivonage::FrameHandle _current;
+  BOOL _currentDisplayed;
+  std::shared_ptr<tivonage::RenderStats> _stats;
+}
+
+- (instancetype)initWithStreamId:(NSString *)streamId
+{
+  if (self = [super init]) {
+    _streamId = [streamId copy];
+    _pixelSize.store(0, std::memory_order_relaxed);
+  }
+  return self;
+}
+
+- (void)setPixelWidth:(int)width height:(int)height
+{
+  _pixelSize.store(uint64_t(width) << 32 | uint64_t(height), std::memory_order_relaxed);
+}
+
+- (void)getPixelWidth:(int *)width height:(int *)height
+{
+  uint64_t size = _pixelSize.load(std::memory_order_relaxed);
+  *width = int(size >> 32);
+  *height = int(size & 0xFFFFFFFF);
+}
+
+- (BOOL)publishFrame:(tivonage::FrameHandle)frame
+{
+  return _mailbox.publish(std::move(frame));
+}
+
+- (void)setRenderStats:(std::shared_ptr<tivonage::RenderStats>)stats
+{
+  @synchronized(self) {
+    _stats = std::move(stats);
+  }
+}
+
+- (BOOL)takeFrame
+{
+  if (!_mailbox.take(_current)) {
+    return NO;
+  }
+  _currentDisplayed = NO;
+  return YES;
+}
+
+- (void)frameWasDisplayed
+{
+  if (!_current || _currentDisplayed) {
+    return;
+  }
+  _currentDisplayed = YES;
+  std::shared_ptr<tivonage::RenderStats> stats;
+  @synchronized(self) {
+    stats = _stats;
+  }
+  if (stats) {
+    stats->frameDisplayed(tivonage::monotonicMicros());
+  }
+}
+
+- (tivonage::VideoFrame)currentFrame
+{
+  return _current ? _current.frame() : tivonage::VideoFrame();
+}
+
+@end
+
+#pragma mark - View
+
+@interface TiVonageGallery ()
+- (void)composeForDisplay;
+@end
+
+@interface TiVonageGalleryView : TiVonageRenderView
+@property (nonatomic, weak) TiVonageGallery *gallery;
+@end
+
+@implementation TiVonageGalleryView
+
+- (void)displayRefresh:(CADisplayLink *)displayLink
+{
+  [self.gallery composeForDisplay];
+}
+
+@end
+
+#pragma mark - Gallery
+
+@implementation TiVonageGallery {
+  TiVonageGalleryView *_view;
+  NSMutableArray<TiVonageGalleryTile *> *_tiles;
+  tivonage::GalleryLayout _layout;
+  tivonage::GalleryCompositor _compositor;
+  std::shared_ptr<tivonage::FramePool> _surfaces;
+  std::vector<tivonage::VideoFrame> _frames;
+  BOOL _needsCompose;
+}
+
+- (instancetype)init
+{
+  if (self = [super init]) {
+    _tiles = [NSMutableArray array];
+    _surfaces = tivonage::FramePool::create(TiVonageGallerySurfaceCount);
+    _view = [[TiVonageGalleryView alloc] initWithFrame:CGRectZero];
+    _view.gallery = self;
+    [_view addGestureRecognizer:[[UITapGestureRecognizer alloc] initWithTarget:self action:@selector(handleTap:)]];
+  }
+  return self;
+}
+
+- (UIView *)view
+{
+  return _view;
+}
+
+- (CGSize)tilePixelSize
+{
+  const auto &tiles = _layout.tiles();
+  return tiles.empty() ? CGSizeZero : CGSizeMake(tiles[0].width, tiles[0].height);
+}
+
+- (NSArray<NSString *> *)streamIds
+{
+  return [_tiles valueForKey:@"streamId"];
+}
+
+- (void)addStream:(NSString *)streamId renderer:(TiVonageVideoRenderer *)renderer
+{
+  [self removeStream:streamId];
+  TiVonageGalleryTile *tile = [[TiVonageGalleryTile alloc] initWithStreamId:streamId];
+  tile.renderer = renderer;
+  [_tiles addObject:tile];
+  [self relayout];
+  [renderer setFrameTarget:tile];
+  _needsCompose = YES;
+}
+
+- (void)removeStream:(NSString *)streamId
+{
+  NSUInteger index = [_tiles indexOfObjectPassingTest:^BOOL(TiVonageGalleryTile *tile, NSUInteger idx, BOOL *stop) {
+    return [tile.streamId isEqualToString:streamId];
+  }];
+  if (index == NSNotFound) {
+    return;
+  }
+  [_tiles[index].renderer setFrameTarget:nil];
+  [_tiles removeObjectAtIndex:index];
+  [self relayout];
+  _needsCompose = YES;
+}
+
+- (NSString *)streamIdAtPoint:(CGPoint)point
+{
+  CGFloat scale = _view.window != nil ? _view.window.screen.scale : [UIScreen mainScreen].scale;
+  int index = _layout.tileAt(int(point.x * scale), int(point.y * scale));
+  return index >= 0 && NSUInteger(index) < _tiles.count ? _tiles[NSUInteger(index)].streamId : nil;
+}
+
+- (void)handleTap:(UITapGestureRecognizer *)recognizer
+{
+  NSString *streamId = [self streamIdAtPoint:[recognizer locationInView:_view]];
+  if (streamId != nil && self.tileTapped != nil) {
+    self.tileTapped(streamId);
+  }
+}
+
+// Lays the tiles out for the view's current size and tells each renderer its
+// tile size. Returns YES if anything moved.
+- (BOOL)relayout
+{
+  int width = 0;
+  int height = 0;
+  [_view getPixelWidth:&width height:&height];
+  if (!_layout.update(width, height, _tiles.count)) {
+    return NO;
+  }
+  const auto &tiles = _layout.tiles();
+  for (NSUInteger i = 0; i < _tiles.count; i++) {
+    [_tiles[i] setPixelWidth:tiles[i].width height:tiles[i].height];
+  }
+  return YES;
+}
+
+- (void)composeForDisplay
+{
+  BOOL changed = [self relayout] || _needsCompose;
+  for (TiVonageGalleryTile *tile in _tiles) {
+    changed |= [tile takeFrame];
+  }
+  if (!changed) {
+    return;
+  }
+
+  int width = 0;
+  int height = 0;
+  [_view getPixelWidth:&width height:&height];
+  tivonage::FrameHandle surface = width >= 2 && height >= 2 ? _surfaces->acquire(tivonage::PixelFormat::NV12, width, height) : tivonage::FrameHandle();
+  // Still on screen or queued; try again on the next refresh.
+  _needsCompose = !surface;
+  if (!surface) {
+    return;
+  }
+
+  // Renderers deliver frames already scaled to the tile, so in steady state
+  // this is a row copy per tile plus filling the gaps.
+  _frames.resize(_tiles.count);
+  for (NSUInteger i = 0; i < _tiles.count; i++) {
+    _frames[i] = [_tiles[i] currentFrame];
+  }
+  _compositor.compose(_layout.tiles(), _frames.data(), _frames.size(), surface.frame());
+
+  CMTime timestamp = CMTimeMakeWithSeconds(CACurrentMediaTime(), 1000000);
+  CVPixelBufferRef pixelBuffer = TiVonageCreatePixelBuffer(std::move(surface));
+  if (pixelBuffer == NULL) {
+    _needsCompose = YES;
+    return;
+  }
+  BOOL displayed = [_view enqueuePixelBuffer:pixelBuffer timestamp:timestamp];
+  CVPixelBufferRelease(pixelBuffer);
+  // A tile's frame counts once it is on screen; one taken while the
+  // composition failed counts with the next that succeeds, unless a newer
+  // frame replaced it first.
+  _needsCompose = !displayed;
+  if (displayed) {
+    for (TiVonageGalleryTile *tile in _tiles) {
+      [tile frameWasDisplayed];
+    }
+  }
+}
+
+@end
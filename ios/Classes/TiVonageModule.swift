@@ -15,10 +15,23 @@ class TiVonageModule: TiModule {
 
   var session: OTSession!
 
-  var publisher: OTPublisher?
+  /// The implicit publisher, configured by the module's properties and
+  /// created on connect when the app made none with createPublisher().
+  var defaultPublication: TiVonagePublication?
+
+  var publisher: OTPublisher? {
+    return defaultPublication?.publisher
+  }
+
+  /// Publishers created by the app, until destroyed.
+  var publications: [TiVonagePublication] = []
 
   var subscriber: OTSubscriber?
 
+  var subscriptions: [String: TiVonageSubscription] = [:]
+
+  var subscriptionTimer: Timer?
+
   var apiKey: String?
 
   var sessionId: String?
@@ -27,6 +40,76 @@ class TiVonageModule: TiModule {
   
   var audioOnly: Bool = false
 
+  var customRenderer: Bool = false
+
+  var customCapturer: Bool = false
+
+  var adaptiveCapture: Bool = false
+
+  var staticSceneDetection: Bool = false
+
+  var customAudioDevice: Bool = false
+
+  var audioSampleRate: Int = 16000
+
+  var fileAudio: [String: Any]?
+
+  /// Registered with the SDK once, before the first session or publisher.
+  var audioDevice: TiVonageAudioDevice?
+
+  var fileAudioDevice: TiVonageFileAudioDevice?
+
+  var processingStages: [[String: Any]] = []
+
+  var processingBudget: Double = 20
+
+  var syntheticVideo: [String: Any]?
+
+  var screenShare: Bool = false
+
+  var screenContentHint: String = "text"
+
+  var pauseHiddenVideo: Bool = true
+
+  var adaptVideoToView: Bool = true
+
+  var frameMetadata: Bool = false
+
+  var measureLatency: Bool = false
+
+  var galleryMode: Bool = false
+
+  var gallery: TiVonageGallery?
+
+  var galleryProxy: TiVonageVideoProxy?
+
+  var renderStatsInterval: Double = 0
+
+  var lastRenderStatsEvent: Date = .distantPast
+
+  var audioLevelInterval: Double = 0
+
+  let audioLevelMeter = TiVonageAudioLevelMeter()
+
+  var audioLevelTimer: Timer?
+
+  var activeSpeakerCount: Int = 0
+
+  var prioritizeActiveSpeakers: Bool = false
+
+  var activeSpeakerDetector: TiVonageActiveSpeakerDetector?
+
+  /// Whether subscribers report their audio levels at all.
+  var metersSubscriberAudio: Bool {
+    return audioLevelInterval > 0 || activeSpeakerDetector != nil
+  }
+
+  var recorder: TiVonageRecorder?
+
+  var recordedStreamId: String?
+
+  var subscriptionTicks: Int = 0
+
   func moduleGUID() -> String {
     return "8669e6e4-ff3a-4a19-b85a-ead686c4c18c"
   }
@@ -47,6 +130,7 @@ class TiVonageModule: TiModule {
       NSLog("[ERROR] Missing apiKey, sessionId or token property! Please set before calling \"connect()\"")
       return
     }
+    installAudioDevice()
 
     session = OTSession(apiKey: apiKey, sessionId: sessionId, delegate: self)
     var error: OTError?
@@ -112,6 +196,611 @@ class TiVonageModule: TiModule {
   func audioOnly(unused: Any?) -> Bool {
     return audioOnly
   }
+
+  @objc(setCustomRenderer:)
+  func setCustomRenderer(customRenderer: Bool) {
+    self.customRenderer = customRenderer
+    replaceValue(customRenderer, forKey: "customRenderer", notification: false)
+  }
+
+  @objc(customRenderer:)
+  func customRenderer(unused: Any?) -> Bool {
+    return customRenderer
+  }
+
+  @objc(setCustomCapturer:)
+  func setCustomCapturer(customCapturer: Bool) {
+    self.customCapturer = customCapturer
+    replaceValue(customCapturer, forKey: "customCapturer", notification: false)
+  }
+
+  @objc(customCapturer:)
+  func customCapturer(unused: Any?) -> Bool {
+    return customCapturer
+  }
+
+  @objc(setAdaptiveCapture:)
+  func setAdaptiveCapture(adaptiveCapture: Bool) {
+    self.adaptiveCapture = adaptiveCapture
+    replaceValue(adaptiveCapture, forKey: "adaptiveCapture", notification: false)
+  }
+
+  @objc(adaptiveCapture:)
+  func adaptiveCapture(unused: Any?) -> Bool {
+    return adaptiveCapture
+  }
+
+  @objc(setCustomAudioDevice:)
+  func setCustomAudioDevice(customAudioDevice: Bool) {
+    self.customAudioDevice = customAudioDevice
+    replaceValue(customAudioDevice, forKey: "customAudioDevice", notification: false)
+  }
+
+  @objc(customAudioDevice:)
+  func customAudioDevice(unused: Any?) -> Bool {
+    return customAudioDevice
+  }
+
+  @objc(setAudioSampleRate:)
+  func setAudioSampleRate(audioSampleRate: Any) {
+    let rate = TiUtils.intValue(audioSampleRate, def: 16000)
+    guard [8000, 16000, 32000].contains(Int(rate)) else {
+      NSLog("[ERROR] audioSampleRate must be 8000, 16000 or 32000")
+      return
+    }
+    self.audioSampleRate = Int(rate)
+    replaceValue(self.audioSampleRate, forKey: "audioSampleRate", notification: false)
+  }
+
+  @objc(audioSampleRate:)
+  func audioSampleRate(unused: Any?) -> Int {
+    return audioSampleRate
+  }
+
+  @objc(setFileAudio:)
+  func setFileAudio(fileAudio: [String: Any]?) {
+    self.fileAudio = fileAudio
+    replaceValue(fileAudio, forKey: "fileAudio", notification: false)
+  }
+
+  @objc(fileAudio:)
+  func fileAudio(unused: Any?) -> [String: Any]? {
+    return fileAudio
+  }
+
+  @objc(getAudioStats:)
+  func getAudioStats(unused: Any?) -> [String: Any]? {
+    return audioDevice?.stats ?? fileAudioDevice?.stats
+  }
+
+  // The SDK picks its audio device when the first session or publisher is
+  // created and keeps it for the life of the app.
+  private func installAudioDevice() {
+    guard audioDevice == nil, fileAudioDevice == nil else {
+      return
+    }
+    if let fileAudio = fileAudio {
+      // Accept native paths as well as file:// URLs (e.g. Ti.Filesystem nativePath).
+      let nativePath = { (value: Any?) -> String? in
+        (value as? String).map { path in URL(string: path).flatMap { $0.isFileURL ? $0.path : nil } ?? path }
+      }
+      guard let device = TiVonageFileAudioDevice(capturePath: nativePath(fileAudio["capturePath"]),
+                                                 renderPath: nativePath(fileAudio["renderPath"]),
+                                                 sampleRate: Int32(audioSampleRate),
+                                                 realTime: TiUtils.boolValue(fileAudio["realTime"], def: true)) else {
+        NSLog("[ERROR] Cannot open the files of \"fileAudio\"")
+        return
+      }
+      OTAudioDeviceManager.setAudioDevice(device)
+      fileAudioDevice = device
+      return
+    }
+    guard customAudioDevice else {
+      return
+    }
+    let device = TiVonageAudioDevice(sampleRate: Int32(audioSampleRate))
+    OTAudioDeviceManager.setAudioDevice(device)
+    audioDevice = device
+  }
+
+  @objc(setStaticSceneDetection:)
+  func setStaticSceneDetection(staticSceneDetection: Bool) {
+    self.staticSceneDetection = staticSceneDetection
+    replaceValue(staticSceneDetection, forKey: "staticSceneDetection", notification: false)
+    (publisher?.videoCapture as? TiVonageVideoCapturer)?.detectsStaticScene = staticSceneDetection
+  }
+
+  @objc(staticSceneDetection:)
+  func staticSceneDetection(unused: Any?) -> Bool {
+    return staticSceneDetection
+  }
+
+  @objc(setSyntheticVideo:)
+  func setSyntheticVideo(syntheticVideo: [String: Any]?) {
+    self.syntheticVideo = syntheticVideo
+    replaceValue(syntheticVideo, forKey: "syntheticVideo", notification: false)
+  }
+
+  @objc(syntheticVideo:)
+  func syntheticVideo(unused: Any?) -> [String: Any]? {
+    return syntheticVideo
+  }
+
+  @objc(getSyntheticVideoStats:)
+  func getSyntheticVideoStats(unused: Any?) -> [String: Any]? {
+    return (publisher?.videoCapture as? TiVonageSyntheticCapturer)?.stats
+  }
+
+  @objc(setScreenShare:)
+  func setScreenShare(screenShare: Bool) {
+    self.screenShare = screenShare
+    replaceValue(screenShare, forKey: "screenShare", notification: false)
+  }
+
+  @objc(screenShare:)
+  func screenShare(unused: Any?) -> Bool {
+    return screenShare
+  }
+
+  @objc(setScreenContentHint:)
+  func setScreenContentHint(screenContentHint: String) {
+    self.screenContentHint = screenContentHint
+    replaceValue(screenContentHint, forKey: "screenContentHint", notification: false)
+    (publisher?.videoCapture as? TiVonageScreenCapturer)?.videoContentHint = screenContentHint == "detail" ? .detail : .text
+  }
+
+  @objc(screenContentHint:)
+  func screenContentHint(unused: Any?) -> String {
+    return screenContentHint
+  }
+
+  @objc(setPauseHiddenVideo:)
+  func setPauseHiddenVideo(pauseHiddenVideo: Bool) {
+    self.pauseHiddenVideo = pauseHiddenVideo
+    replaceValue(pauseHiddenVideo, forKey: "pauseHiddenVideo", notification: false)
+  }
+
+  @objc(pauseHiddenVideo:)
+  func pauseHiddenVideo(unused: Any?) -> Bool {
+    return pauseHiddenVideo
+  }
+
+  @objc(setAdaptVideoToView:)
+  func setAdaptVideoToView(adaptVideoToView: Bool) {
+    self.adaptVideoToView = adaptVideoToView
+    replaceValue(adaptVideoToView, forKey: "adaptVideoToView", notification: false)
+  }
+
+  @objc(adaptVideoToView:)
+  func adaptVideoToView(unused: Any?) -> Bool {
+    return adaptVideoToView
+  }
+
+  @objc(setFrameMetadata:)
+  func setFrameMetadata(frameMetadata: Bool) {
+    self.frameMetadata = frameMetadata
+    replaceValue(frameMetadata, forKey: "frameMetadata", notification: false)
+  }
+
+  @objc(frameMetadata:)
+  func frameMetadata(unused: Any?) -> Bool {
+    return frameMetadata
+  }
+
+  @objc(setMeasureLatency:)
+  func setMeasureLatency(measureLatency: Bool) {
+    self.measureLatency = measureLatency
+    replaceValue(measureLatency, forKey: "measureLatency", notification: false)
+  }
+
+  @objc(measureLatency:)
+  func measureLatency(unused: Any?) -> Bool {
+    return measureLatency
+  }
+
+  @objc(setRenderStatsInterval:)
+  func setRenderStatsInterval(renderStatsInterval: Double) {
+    self.renderStatsInterval = renderStatsInterval
+    replaceValue(renderStatsInterval, forKey: "renderStatsInterval", notification: false)
+  }
+
+  @objc(renderStatsInterval:)
+  func renderStatsInterval(unused: Any?) -> Double {
+    return renderStatsInterval
+  }
+
+  @objc(setAudioLevelInterval:)
+  func setAudioLevelInterval(audioLevelInterval: Double) {
+    self.audioLevelInterval = max(audioLevelInterval, 0)
+    replaceValue(self.audioLevelInterval, forKey: "audioLevelInterval", notification: false)
+    updateAudioLevelMetering()
+  }
+
+  @objc(audioLevelInterval:)
+  func audioLevelInterval(unused: Any?) -> Double {
+    return audioLevelInterval
+  }
+
+  @objc(setActiveSpeakerCount:)
+  func setActiveSpeakerCount(activeSpeakerCount: Int) {
+    self.activeSpeakerCount = max(activeSpeakerCount, 0)
+    replaceValue(self.activeSpeakerCount, forKey: "activeSpeakerCount", notification: false)
+    activeSpeakerDetector = self.activeSpeakerCount > 0 ? TiVonageActiveSpeakerDetector(maxRanked: self.activeSpeakerCount) : nil
+    updateAudioLevelMetering()
+  }
+
+  @objc(activeSpeakerCount:)
+  func activeSpeakerCount(unused: Any?) -> Int {
+    return activeSpeakerCount
+  }
+
+  @objc(setPrioritizeActiveSpeakers:)
+  func setPrioritizeActiveSpeakers(prioritizeActiveSpeakers: Bool) {
+    self.prioritizeActiveSpeakers = prioritizeActiveSpeakers
+    replaceValue(prioritizeActiveSpeakers, forKey: "prioritizeActiveSpeakers", notification: false)
+  }
+
+  @objc(prioritizeActiveSpeakers:)
+  func prioritizeActiveSpeakers(unused: Any?) -> Bool {
+    return prioritizeActiveSpeakers
+  }
+
+  @objc(getActiveSpeakers:)
+  func getActiveSpeakers(unused: Any?) -> [String] {
+    return activeSpeakerDetector?.ranking ?? []
+  }
+
+  @objc(getRenderStats:)
+  func getRenderStats(arguments: Array<Any>?) -> [String: Any]? {
+    guard let streamId = arguments?.first as? String else {
+      NSLog("[ERROR] Missing streamId for \"getRenderStats()\"")
+      return nil
+    }
+    return subscriptions[streamId]?.renderer?.renderStats()
+  }
+
+  @objc(getLatencyStats:)
+  func getLatencyStats(arguments: Array<Any>?) -> [String: Any]? {
+    guard let streamId = arguments?.first as? String else {
+      NSLog("[ERROR] Missing streamId for \"getLatencyStats()\"")
+      return nil
+    }
+    guard measureLatency, let renderer = subscriptions[streamId]?.renderer else {
+      return nil
+    }
+    return renderer.latencyStats()
+  }
+
+  @objc(setGalleryMode:)
+  func setGalleryMode(galleryMode: Bool) {
+    self.galleryMode = galleryMode
+    replaceValue(galleryMode, forKey: "galleryMode", notification: false)
+  }
+
+  @objc(galleryMode:)
+  func galleryMode(unused: Any?) -> Bool {
+    return galleryMode
+  }
+
+  @objc(galleryView:)
+  func galleryView(unused: Any?) -> TiVonageVideoProxy? {
+    guard galleryMode else {
+      NSLog("[ERROR] The gallery view is only available when \"galleryMode\" is enabled")
+      return nil
+    }
+    if let galleryProxy = galleryProxy {
+      return galleryProxy
+    }
+
+    let gallery = TiVonageGallery()
+    gallery.tileTapped = { [weak self] streamId in
+      self?.fireEvent("galleryClick", with: ["streamId": streamId])
+    }
+    self.gallery = gallery
+    galleryProxy = TiVonageVideoProxy()._init(withPageContext: pageContext, videoView: gallery.view)
+    return galleryProxy
+  }
+
+  // MARK: Capture processing
+
+  @objc(setProcessingStages:)
+  func setProcessingStages(processingStages: [[String: Any]]) {
+    self.processingStages = processingStages
+    replaceValue(processingStages, forKey: "processingStages", notification: false)
+    defaultPublication?.setProcessingStages(processingStages)
+  }
+
+  @objc(processingStages:)
+  func processingStages(unused: Any?) -> [[String: Any]] {
+    return processingStages
+  }
+
+  @objc(setProcessingBudget:)
+  func setProcessingBudget(processingBudget: Double) {
+    self.processingBudget = processingBudget
+    replaceValue(processingBudget, forKey: "processingBudget", notification: false)
+    (publisher?.videoCapture as? TiVonageVideoCapturer)?.processingBudget = processingBudget
+  }
+
+  @objc(processingBudget:)
+  func processingBudget(unused: Any?) -> Double {
+    return processingBudget
+  }
+
+  @objc(getProcessingStats:)
+  func getProcessingStats(unused: Any?) -> [[String: Any]] {
+    return (publisher?.videoCapture as? TiVonageVideoCapturer)?.processingStats ?? []
+  }
+
+  // MARK: Publishing
+
+  @objc(createPublisher:)
+  func createPublisher(arguments: Array<Any>?) -> TiVonagePublisherProxy? {
+    installAudioDevice()
+    // The implicit publisher only stands in while the app has none of its
+    // own; it goes first so the camera is free for the new one.
+    if let implicit = defaultPublication {
+      destroy(implicit)
+      defaultPublication = nil
+    }
+    let options = TiVonagePublisherOptions(arguments?.first as? [String: Any] ?? [:])
+    guard let publication = TiVonagePublication(options: options) else {
+      NSLog("[ERROR] Cannot create the publisher")
+      return nil
+    }
+    publications.append(publication)
+    meterAudioLevels(of: publication)
+    return TiVonagePublisherProxy()._init(withPageContext: pageContext, module: self, publication: publication)
+  }
+
+  /// Publishes now if the session is connected, otherwise once it is.
+  func publish(_ publication: TiVonagePublication) {
+    publication.wantsPublishing = true
+    if let session = session, session.sessionConnectionStatus == .connected, !publication.isPublished {
+      startPublishing(publication, in: session)
+    }
+  }
+
+  func unpublish(_ publication: TiVonagePublication) {
+    publication.wantsPublishing = false
+    guard let session = session, publication.isPublished else {
+      return
+    }
+    if let streamId = publication.publisher.stream?.streamId {
+      audioLevelMeter.removeStream(streamId)
+    }
+    var error: OTError?
+    session.unpublish(publication.publisher, error: &error)
+    if let error = error {
+      NSLog("[ERROR] Cannot unpublish: \(error.localizedDescription)")
+    }
+  }
+
+  func destroy(_ publication: TiVonagePublication) {
+    unpublish(publication)
+    publication.audioLevelHandler = nil
+    publications.removeAll { $0 === publication }
+  }
+
+  @discardableResult
+  private func startPublishing(_ publication: TiVonagePublication, in session: OTSession) -> Bool {
+    var error: OTError?
+    session.publish(publication.publisher, error: &error)
+    if let error = error {
+      NSLog("[ERROR] Cannot publish: \(error.localizedDescription)")
+      publication.fireEvent("error", ["message": error.localizedDescription])
+      return false
+    }
+    return true
+  }
+
+  /// The implicit publisher's settings, from the module's properties.
+  private func defaultPublisherOptions() -> TiVonagePublisherOptions {
+    var options = TiVonagePublisherOptions()
+    options.videoSource = syntheticVideo != nil ? "synthetic" : screenShare ? "screen" : "camera"
+    options.videoTrack = !audioOnly
+    options.customCapturer = customCapturer
+    options.customRenderer = customRenderer
+    options.adaptiveCapture = adaptiveCapture
+    options.staticSceneDetection = staticSceneDetection
+    // Latency is measured against the capture time in the frame metadata.
+    options.frameMetadata = frameMetadata || measureLatency
+    options.processingStages = processingStages
+    options.processingBudget = processingBudget
+    options.screenContentHint = screenContentHint
+    options.syntheticVideo = syntheticVideo
+    return options
+  }
+
+  // MARK: Recording
+
+  @objc(startRecording:)
+  func startRecording(arguments: Array<Any>?) -> Bool {
+    guard let arguments = arguments, arguments.count >= 2,
+          let streamId = arguments[0] as? String, let path = arguments[1] as? String else {
+      NSLog("[ERROR] Missing streamId or path for \"startRecording()\"")
+      return false
+    }
+    guard let renderer = subscriptions[streamId]?.renderer else {
+      NSLog("[ERROR] Stream \(streamId) is not subscribed or not rendered by the module (enable \"customRenderer\" before \"connect()\")")
+      return false
+    }
+    if recorder != nil {
+      _ = stopRecording(unused: nil)
+    }
+
+    // Accept native paths as well as file:// URLs (e.g. Ti.Filesystem nativePath).
+    var videoPath = URL(string: path).flatMap { $0.isFileURL ? $0.path : nil } ?? path
+    if (videoPath as NSString).pathExtension.lowercased() != "y4m" {
+      videoPath += ".y4m"
+    }
+    // With the module's audio device, what is played is recorded next to the
+    // video.
+    let audioPath = audioDevice.map { _ in ((videoPath as NSString).deletingPathExtension as NSString).appendingPathExtension("wav")! }
+    guard let recorder = TiVonageRecorder(videoPath: videoPath, audioPath: audioPath, audioSampleRate: audioDevice?.sampleRate ?? 48000) else {
+      NSLog("[ERROR] Cannot create a recording at \(videoPath)")
+      return false
+    }
+    recorder.record(renderer)
+    audioDevice?.recorder = recorder
+    self.recorder = recorder
+    recordedStreamId = streamId
+    return true
+  }
+
+  @objc(stopRecording:)
+  func stopRecording(unused: Any?) -> [String: Any]? {
+    guard let recorder = recorder else {
+      return nil
+    }
+    audioDevice?.recorder = nil
+    recorder.stop()
+    self.recorder = nil
+
+    var result: [String: Any] = [
+      "streamId": recordedStreamId ?? "",
+      "path": recorder.videoPath,
+      "recordedFrames": recorder.recordedFrames,
+      "repeatedFrames": recorder.repeatedFrames,
+      "droppedFrames": recorder.droppedFrames,
+      "success": !recorder.failed
+    ]
+    if let audioPath = recorder.audioPath {
+      result["audioPath"] = audioPath
+      result["recordedSamples"] = recorder.recordedSamples
+      result["droppedSamples"] = recorder.droppedSamples
+    }
+    recordedStreamId = nil
+    return result
+  }
+
+  @objc(setFrameMetadataPayload:)
+  func setFrameMetadataPayload(arguments: Array<Any>?) {
+    guard let capturer = publisher?.videoCapture as? TiVonageVideoCapturer else {
+      NSLog("[ERROR] Frame metadata is only sent when \"frameMetadata\" is enabled before \"connect()\"")
+      return
+    }
+    guard let payload = arguments?.first as? String else {
+      capturer.metadataPayload = nil
+      return
+    }
+    capturer.metadataPayload = TiVonageModule.frameMetadataPayload(payload)
+  }
+
+  // The UTF-8 of a metadata payload, at most 16 bytes. Longer strings lose
+  // whole characters from the end, so receivers still decode valid UTF-8.
+  static func frameMetadataPayload(_ payload: String) -> Data {
+    var text = payload
+    if text.utf8.count > 16 {
+      NSLog("[ERROR] Frame metadata payload is limited to 16 bytes of UTF-8 (got \(text.utf8.count)), it will be truncated")
+      while text.utf8.count > 16 {
+        text.removeLast()
+      }
+    }
+    return Data(text.utf8)
+  }
+
+  // MARK: Subscription tracking
+
+  // Views don't report being scrolled out of sight, so their on-screen state
+  // and size are sampled a few times per second while there are subscriptions.
+  private func startSubscriptionTimer() {
+    guard subscriptionTimer == nil else {
+      return
+    }
+    subscriptionTimer = Timer.scheduledTimer(withTimeInterval: 0.25, repeats: true) { [weak self] _ in
+      guard let self = self else {
+        return
+      }
+      if let detector = self.activeSpeakerDetector, detector.update() {
+        self.fireEvent("activeSpeakerChanged", with: ["streamId": detector.activeSpeaker ?? NSNull(), "ranking": detector.ranking])
+      }
+
+      // With prioritizeActiveSpeakers only the ranked speakers get full-size
+      // video.
+      for (streamId, subscription) in self.subscriptions {
+        let highPriority = !self.prioritizeActiveSpeakers || (self.activeSpeakerDetector?.isRanked(streamId) ?? true)
+        subscription.refresh(pauseHiddenVideo: self.pauseHiddenVideo, adaptVideoToView: self.adaptVideoToView, highPriority: highPriority)
+      }
+
+      // Frame metadata goes out in one batch per stream and second.
+      self.subscriptionTicks += 1
+      if self.frameMetadata && self.subscriptionTicks % 4 == 0 {
+        self.fireFrameMetadata()
+      }
+
+      if self.renderStatsInterval > 0 && -self.lastRenderStatsEvent.timeIntervalSinceNow >= self.renderStatsInterval {
+        self.lastRenderStatsEvent = Date()
+        self.fireRenderStats()
+      }
+    }
+  }
+
+  // One event for all streams, at most every renderStatsInterval seconds
+  // (rounded up to the 0.25 s timer).
+  private func fireRenderStats() {
+    let streams: [[String: Any]] = subscriptions.compactMap { streamId, subscription in
+      guard var stats: [String: Any] = subscription.renderer?.renderStats() else {
+        return nil
+      }
+      stats["streamId"] = streamId
+      return stats
+    }
+    if !streams.isEmpty {
+      fireEvent("renderStats", with: ["streams": streams])
+    }
+  }
+
+  private func fireFrameMetadata() {
+    for (streamId, subscription) in subscriptions {
+      guard let frames = subscription.renderer?.drainFrameMetadata(), !frames.isEmpty else {
+        continue
+      }
+      fireEvent("frameMetadata", with: ["streamId": streamId, "frames": frames])
+    }
+  }
+
+  private func stopSubscriptionTimer() {
+    subscriptionTimer?.invalidate()
+    subscriptionTimer = nil
+  }
+
+  // MARK: Audio levels
+
+  // The SDK reports every stream's level many times per second; they are
+  // collected here and leave for JavaScript as one "audioLevels" event per
+  // audioLevelInterval, and only when a meter moved. Subscribers' levels
+  // also feed the active speaker detector.
+  private func updateAudioLevelMetering() {
+    subscriptions.values.forEach { $0.subscriber.audioLevelDelegate = metersSubscriberAudio ? self : nil }
+    publications.forEach { meterAudioLevels(of: $0) }
+    if let publication = defaultPublication {
+      meterAudioLevels(of: publication)
+    }
+
+    audioLevelTimer?.invalidate()
+    audioLevelTimer = nil
+    guard audioLevelInterval > 0 else {
+      audioLevelMeter.removeAllStreams()
+      return
+    }
+    audioLevelTimer = Timer.scheduledTimer(withTimeInterval: audioLevelInterval, repeats: true) { [weak self] _ in
+      guard let self = self, let levels = self.audioLevelMeter.tick() else {
+        return
+      }
+      self.fireEvent("audioLevels", with: levels)
+    }
+  }
+
+  private func meterAudioLevels(of publication: TiVonagePublication) {
+    guard audioLevelInterval > 0 else {
+      publication.audioLevelHandler = nil
+      return
+    }
+    publication.audioLevelHandler = { [weak self] streamId, level in
+      self?.audioLevelMeter.addLevel(level, forStream: streamId)
+    }
+  }
 }
 
 // MARK: OTSessionDelegate
@@ -127,26 +816,24 @@ extension TiVonageModule : OTSessionDelegate {
   }
   
   func sessionDidConnect(_ session: OTSession) {
-    let settings = OTPublisherSettings()
-    settings.name = UIDevice.current.name
-    settings.videoTrack = !audioOnly;
-
-    guard let publisher = OTPublisher(delegate: self, settings: settings) else {
-        return
+    // Apps that create their own publishers publish them when they like;
+    // otherwise the module's properties describe one implicit publisher.
+    publications.filter { $0.wantsPublishing && !$0.isPublished }.forEach { startPublishing($0, in: session) }
+    guard publications.isEmpty else {
+      return
     }
 
-    var error: OTError?
-    session.publish(publisher, error: &error)
-
-    guard error == nil else {
-        print(error!)
+    guard let publication = TiVonagePublication(options: defaultPublisherOptions()) else {
         return
     }
-
-    guard let publisherView = publisher.view else {
+    publication.fireEvent = { [weak self] name, event in
+      self?.fireEvent(name, with: event)
+    }
+    defaultPublication = publication
+    meterAudioLevels(of: publication)
+    guard startPublishing(publication, in: session), let publisherView = publication.view else {
         return
     }
-    let screenBounds = UIScreen.main.bounds
     publisherView.frame = CGRect(x: 0, y: 0, width: 512, height: 512)
 
     let viewProxy = TiVonageVideoProxy()._init(withPageContext: pageContext,
@@ -161,6 +848,15 @@ extension TiVonageModule : OTSessionDelegate {
   }
   
   func sessionDidDisconnect(_ session: OTSession) {
+    if let result = stopRecording(unused: nil) {
+      fireEvent("recordingStopped", with: result)
+    }
+    stopSubscriptionTimer()
+    subscriptions.keys.forEach { gallery?.removeStream($0) }
+    subscriptions.removeAll()
+    audioLevelMeter.removeAllStreams()
+    activeSpeakerDetector?.removeAllStreams()
+    defaultPublication = nil
     fireEvent("disconnected")
   }
   
@@ -174,6 +870,18 @@ extension TiVonageModule : OTSessionDelegate {
         return
     }
 
+    // Frame metadata is only readable from frames the module renders itself.
+    if customRenderer || frameMetadata || measureLatency || galleryMode {
+      let renderer = TiVonageVideoRenderer()
+      renderer.collectsFrameMetadata = frameMetadata
+      renderer.measuresLatency = measureLatency
+      subscriber.videoRender = renderer
+    }
+
+    if metersSubscriberAudio {
+      subscriber.audioLevelDelegate = self
+    }
+
     var error: OTError?
     session.subscribe(subscriber, error: &error)
     guard error == nil else {
@@ -181,13 +889,21 @@ extension TiVonageModule : OTSessionDelegate {
         return
     }
 
-    guard let subscriberView = subscriber.view else {
+    if galleryMode, let renderer = subscriber.videoRender as? TiVonageVideoRenderer {
+      addToGallery(stream: stream, subscriber: subscriber, renderer: renderer)
+      return
+    }
+
+    guard let subscriberView = (subscriber.videoRender as? TiVonageVideoRenderer)?.view ?? subscriber.view else {
         return
     }
     subscriberView.frame = UIScreen.main.bounds
 
     let viewProxy = TiVonageVideoProxy()._init(withPageContext: pageContext,
                                                videoView: subscriberView)
+
+    subscriptions[stream.streamId] = TiVonageSubscription(subscriber: subscriber, viewProxy: viewProxy)
+    startSubscriptionTimer()
     
     let event: [String: Any] = [
       "view": viewProxy!,
@@ -201,29 +917,56 @@ extension TiVonageModule : OTSessionDelegate {
     fireEvent("streamReceived", with: event)
   }
   
+  // In gallery mode a stream becomes a tile of the one gallery view instead
+  // of a view of its own, so "streamReceived" comes without a view.
+  private func addToGallery(stream: OTStream, subscriber: OTSubscriber, renderer: TiVonageVideoRenderer) {
+    _ = galleryView(unused: nil)
+    guard let gallery = gallery else {
+      return
+    }
+    gallery.addStream(stream.streamId, renderer: renderer)
+
+    let subscription = TiVonageSubscription(subscriber: subscriber, viewProxy: galleryProxy)
+    subscription.gallery = gallery
+    subscriptions[stream.streamId] = subscription
+    startSubscriptionTimer()
+
+    fireEvent("streamReceived", with: [
+      "userType": "subscriber",
+      "streamId": stream.streamId,
+      "connectionData": stream.connection.data ?? "",
+      "connectionId": stream.connection.connectionId,
+      "connectionCreationTime": stream.connection.creationTime
+    ])
+  }
+
   func session(_ session: OTSession, streamDestroyed stream: OTStream) {
     // MARK: Also fire the "streamDestroyed" event here?
+    gallery?.removeStream(stream.streamId)
+    if stream.streamId == recordedStreamId, let result = stopRecording(unused: nil) {
+      fireEvent("recordingStopped", with: result)
+    }
+    subscriptions.removeValue(forKey: stream.streamId)
+    audioLevelMeter.removeStream(stream.streamId)
+    activeSpeakerDetector?.removeStream(stream.streamId)
+    if subscriptions.isEmpty {
+      stopSubscriptionTimer()
+    }
   }
 }
 
-// MARK: OTPublisherDelegate
+// MARK: OTSubscriberKitAudioLevelDelegate
 
-extension TiVonageModule : OTPublisherDelegate {
+extension TiVonageModule : OTSubscriberKitAudioLevelDelegate {
 
-  func publisher(_ publisher: OTPublisherKit, didFailWithError error: OTError) {
-    if error.code == 1022 {
-      fireEvent("streamDropped")
-    } else {
-      fireEvent("error", with: ["message": error.localizedDescription])
+  func subscriber(_ subscriber: OTSubscriberKit, audioLevelUpdated audioLevel: Float) {
+    guard let streamId = subscriber.stream?.streamId else {
+      return
     }
-  }
-  
-  func publisher(_ publisher: OTPublisherKit, streamCreated stream: OTStream) {
-    fireEvent("streamCreated")
-  }
-  
-  func publisher(_ publisher: OTPublisherKit, streamDestroyed stream: OTStream) {
-    fireEvent("streamDestroyed")
+    if audioLevelInterval > 0 {
+      audioLevelMeter.addLevel(audioLevel, forStream: streamId)
+    }
+    activeSpeakerDetector?.addLevel(audioLevel, forStream: streamId)
   }
 }
 
@@ -0,0 +1,24 @@
+//
+//  TiVonageProcessingStages.h
+//  ti.vonage
+//
+//  Builds the capture processing chain from its JavaScript description.
+//  Objective-C++ only; not part of the public headers.
+//
+
+#import <Foundation/Foundation.h>
+
+#include "tivonage/FrameStage.h"
+
+#include <memory>
+#include <vector>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// One dictionary per stage, in order, with a "type" of "crop", "scale",
+// "lut", "overlay" or "blur" and that stage's options (see the README).
+// Returns NO, with the reason in *error, for an unknown type or missing
+// options; stages is then left empty.
+BOOL TiVonageMakeProcessingStages(NSArray *specs, std::vector<std::unique_ptr<tivonage::FrameStage>> &stages, NSString *_Nullable *_Nullable error);
+
+NS_ASSUME_NONNULL_END
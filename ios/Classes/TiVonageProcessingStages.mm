@@ -0,0 +1,129 @@
+//
+//  TiVonageProcessingStages.mm
+//  ti.vonage
+//
+
+#import "TiVonageProcessingStages.h"
+
+#import <UIKit/UIKit.h>
+
+#include "tivonage/FrameBuffer.h"
+
+static int TiVonageIntOption(NSDictionary *spec, NSString *key, int fallback)
+{
+  id value = spec[key];
+  return [value isKindOfClass:[NSNumber class]] ? [value intValue] : fallback;
+}
+
+static float TiVonageFloatOption(NSDictionary *spec, NSString *key, float fallback)
+{
+  id value = spec[key];
+  return [value isKindOfClass:[NSNumber class]] ? [value floatValue] : fallback;
+}
+
+// Draws the image into straight-alpha BGRA, the layout of the core's ARGB.
+static std::unique_ptr<tivonage::FrameBuffer> TiVonageLoadOverlayImage(NSString *path)
+{
+  // Accept native paths as well as file:// URLs, and resources by name.
+  NSURL *url = [NSURL URLWithString:path];
+  NSString *filePath = url.isFileURL ? url.path : path;
+  if (!filePath.isAbsolutePath) {
+    filePath = [[NSBundle mainBundle].resourcePath stringByAppendingPathComponent:filePath];
+  }
+  CGImageRef image = [UIImage imageWithContentsOfFile:filePath].CGImage;
+  if (image == NULL) {
+    return nullptr;
+  }
+  int width = int(CGImageGetWidth(image));
+  int height = int(CGImageGetHeight(image));
+  auto bitmap = tivonage::FrameBuffer::create(tivonage::PixelFormat::ARGB, width, height);
+  if (!bitmap) {
+    return nullptr;
+  }
+  tivonage::VideoFrame &frame = bitmap->frame();
+  CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+  CGContextRef context = CGBitmapContextCreate(frame.planes[0].data, size_t(width), size_t(height), 8, size_t(frame.planes[0].stride), colorSpace,
+      kCGImageAlphaPremultipliedFirst | kCGBitmapByteOrder32Little);
+  CGColorSpaceRelease(colorSpace);
+  if (context == NULL) {
+    return nullptr;
+  }
+  CGContextClearRect(context, CGRectMake(0, 0, width, height));
+  CGContextDrawImage(context, CGRectMake(0, 0, width, height), image);
+  CGContextRelease(context);
+
+  // CoreGraphics only draws premultiplied; the overlay blends straight alpha.
+  for (int y = 0; y < height; ++y) {
+    uint8_t *pixels = frame.planes[0].data + y * frame.planes[0].stride;
+    for (int x = 0; x < width; ++x) {
+      uint8_t *pixel = pixels + 4 * x;
+      if (pixel[3] != 0 && pixel[3] != 255) {
+        for (int channel = 0; channel < 3; ++channel) {
+          pixel[channel] = uint8_t(MIN(255, (pixel[channel] * 255 + pixel[3] / 2) / pixel[3]));
+        }
+      }
+    }
+  }
+  return bitmap;
+}
+
+static std::unique_ptr<tivonage::FrameStage> TiVonageMakeStage(NSDictionary *spec, NSString **error)
+{
+  NSString *type = [spec[@"type"] isKindOfClass:[NSString class]] ? spec[@"type"] : @"";
+  int x = TiVonageIntOption(spec, @"x", 0);
+  int y = TiVonageIntOption(spec, @"y", 0);
+  int width = TiVonageIntOption(spec, @"width", 0);
+  int height = TiVonageIntOption(spec, @"height", 0);
+
+  if ([type isEqualToString:@"crop"] || [type isEqualToString:@"scale"]) {
+    if (width <= 0 || height <= 0) {
+      *error = [NSString stringWithFormat:@"\"%@\" needs a width and a height", type];
+      return nullptr;
+    }
+    if ([type isEqualToString:@"crop"]) {
+      return std::unique_ptr<tivonage::FrameStage>(new tivonage::CropStage(x, y, width, height));
+    }
+    return std::unique_ptr<tivonage::FrameStage>(new tivonage::ScaleStage(width, height));
+  }
+  if ([type isEqualToString:@"lut"]) {
+    return tivonage::LutStage::adjust(TiVonageFloatOption(spec, @"brightness", 0.0f), TiVonageFloatOption(spec, @"contrast", 1.0f),
+        TiVonageFloatOption(spec, @"saturation", 1.0f));
+  }
+  if ([type isEqualToString:@"overlay"]) {
+    NSString *path = [spec[@"image"] isKindOfClass:[NSString class]] ? spec[@"image"] : nil;
+    std::unique_ptr<tivonage::FrameBuffer> image = path != nil ? TiVonageLoadOverlayImage(path) : nullptr;
+    if (!image) {
+      *error = [NSString stringWithFormat:@"Cannot load the overlay image %@", path ?: @"(missing)"];
+      return nullptr;
+    }
+    return tivonage::OverlayStage::create(image->frame(), x, y, TiVonageFloatOption(spec, @"opacity", 1.0f));
+  }
+  if ([type isEqualToString:@"blur"]) {
+    return std::unique_ptr<tivonage::FrameStage>(new tivonage::BlurStage(x, y, width, height, TiVonageIntOption(spec, @"radius", 8)));
+  }
+  *error = [NSString stringWithFormat:@"Unknown processing stage type \"%@\"", type];
+  return nullptr;
+}
+
+BOOL TiVonageMakeProcessingStages(NSArray *specs, std::vector<std::unique_ptr<tivonage::FrameStage>> &stages, NSString **error)
+{
+  stages.clear();
+  NSString *reason = nil;
+  for (id spec in specs) {
+    std::unique_ptr<tivonage::FrameStage> stage;
+    if ([spec isKindOfClass:[NSDictionary class]]) {
+      stage = TiVonageMakeStage(spec, &reason);
+    } else {
+      reason = @"Processing stages must be objects";
+    }
+    if (!stage) {
+      stages.clear();
+      if (error != NULL) {
+        *error = reason;
+      }
+      return NO;
+    }
+    stages.push_back(std::move(stage));
+  }
+  return YES;
+}
@@ -0,0 +1,280 @@
+//
+//  TiVonagePublication.swift
+//  ti.vonage
+//
+
+import OpenTok
+import TitaniumKit
+
+/// What one published stream sends and how. The implicit publisher takes
+/// these from the module's properties; createPublisher() from its options.
+struct TiVonagePublisherOptions {
+
+  /// "camera", "screen" or "synthetic".
+  var videoSource = "camera"
+
+  var name = UIDevice.current.name
+
+  var audioTrack = true
+
+  var videoTrack = true
+
+  var customCapturer = false
+
+  var customRenderer = false
+
+  var adaptiveCapture = false
+
+  var staticSceneDetection = false
+
+  var frameMetadata = false
+
+  var processingStages: [[String: Any]] = []
+
+  var processingBudget: Double = 20
+
+  var screenContentHint = "text"
+
+  var syntheticVideo: [String: Any]?
+
+  init() {
+  }
+
+  init(_ options: [String: Any]) {
+    videoSource = options["videoSource"] as? String ?? videoSource
+    name = options["name"] as? String ?? name
+    audioTrack = TiUtils.boolValue(options["audioTrack"], def: audioTrack)
+    videoTrack = TiUtils.boolValue(options["videoTrack"], def: videoTrack)
+    customCapturer = TiUtils.boolValue(options["customCapturer"], def: customCapturer)
+    customRenderer = TiUtils.boolValue(options["customRenderer"], def: customRenderer)
+    adaptiveCapture = TiUtils.boolValue(options["adaptiveCapture"], def: adaptiveCapture)
+    staticSceneDetection = TiUtils.boolValue(options["staticSceneDetection"], def: staticSceneDetection)
+    frameMetadata = TiUtils.boolValue(options["frameMetadata"], def: frameMetadata)
+    processingStages = options["processingStages"] as? [[String: Any]] ?? processingStages
+    processingBudget = TiUtils.doubleValue(options["processingBudget"], def: processingBudget)
+    screenContentHint = options["screenContentHint"] as? String ?? screenContentHint
+    syntheticVideo = options["syntheticVideo"] as? [String: Any]
+    if syntheticVideo != nil && options["videoSource"] == nil {
+      videoSource = "synthetic"
+    }
+  }
+
+  /// Whether camera frames go through the module's capturer.
+  var usesModuleCapturer: Bool {
+    return customCapturer || adaptiveCapture || frameMetadata || staticSceneDetection || !processingStages.isEmpty
+  }
+}
+
+/// Book-keeping for one published stream: the SDK publisher, its capturer
+/// and the controller adapting it to the uplink. It is created (and its
+/// camera started) independently of the session; the module publishes it
+/// whenever it is wanted and the session is connected.
+class TiVonagePublication: NSObject {
+
+  let publisher: OTPublisher
+
+  let options: TiVonagePublisherOptions
+
+  private(set) var captureController: TiVonageCaptureController?
+
+  /// Fires one of the publisher's events: on its handle, or on the module
+  /// for the implicit publisher. Main thread.
+  var fireEvent: (String, [String: Any]) -> Void = { _, _ in }
+
+  /// Receives the published stream's audio levels (0 to 1 amplitude) while
+  /// set; the SDK only measures them while someone listens. Main thread.
+  var audioLevelHandler: ((String, Float) -> Void)? {
+    didSet {
+      publisher.audioLevelDelegate = audioLevelHandler != nil ? self : nil
+    }
+  }
+
+  /// Whether the app asked for the stream to be published. It then is on
+  /// every connect until unpublished.
+  var wantsPublishing = false
+
+  var isPublished: Bool {
+    return publisher.session != nil
+  }
+
+  var videoCapturer: TiVonageVideoCapturer? {
+    return publisher.videoCapture as? TiVonageVideoCapturer
+  }
+
+  var screenCapturer: TiVonageScreenCapturer? {
+    return publisher.videoCapture as? TiVonageScreenCapturer
+  }
+
+  var syntheticCapturer: TiVonageSyntheticCapturer? {
+    return publisher.videoCapture as? TiVonageSyntheticCapturer
+  }
+
+  /// The preview, rendered by the module when customRenderer is set.
+  var view: UIView? {
+    return (publisher.videoRender as? TiVonageVideoRenderer)?.view ?? publisher.view
+  }
+
+  init?(options: TiVonagePublisherOptions) {
+    let settings = OTPublisherSettings()
+    settings.name = options.name
+    settings.audioTrack = options.audioTrack
+    settings.videoTrack = options.videoTrack
+    guard let publisher = OTPublisher(delegate: nil, settings: settings) else {
+      return nil
+    }
+    self.publisher = publisher
+    self.options = options
+    super.init()
+    publisher.delegate = self
+
+    if options.videoTrack {
+      attachCapturer()
+    }
+    if options.customRenderer {
+      publisher.videoRender = TiVonageVideoRenderer()
+    }
+  }
+
+  private func attachCapturer() {
+    if options.videoSource == "synthetic" {
+      let syntheticVideo = options.syntheticVideo ?? [:]
+      // Accept native paths as well as file:// URLs (e.g. Ti.Filesystem nativePath).
+      let path = (syntheticVideo["path"] as? String).map { URL(string: $0).flatMap { $0.isFileURL ? $0.path : nil } ?? $0 }
+      if let capturer = TiVonageSyntheticCapturer(path: path,
+                                                  width: TiUtils.intValue(syntheticVideo["width"], def: 0),
+                                                  height: TiUtils.intValue(syntheticVideo["height"], def: 0),
+                                                  frameRate: TiUtils.doubleValue(syntheticVideo["frameRate"], def: 0),
+                                                  realTime: TiUtils.boolValue(syntheticVideo["realTime"], def: true)) {
+        publisher.videoCapture = capturer
+        return
+      }
+      NSLog("[ERROR] Cannot read the synthetic video \(path ?? "pattern") (a 4:2:0 .y4m file with an even size is required), publishing the camera")
+    } else if options.videoSource == "screen" {
+      let capturer = TiVonageScreenCapturer()
+      capturer.videoContentHint = options.screenContentHint == "detail" ? .detail : .text
+      publisher.videoType = .screen
+      publisher.audioFallbackEnabled = false
+      publisher.videoCapture = capturer
+      return
+    }
+
+    guard options.usesModuleCapturer else {
+      return
+    }
+    let capturer = TiVonageVideoCapturer()
+    capturer.stampsFrameMetadata = options.frameMetadata
+    capturer.detectsStaticScene = options.staticSceneDetection
+    capturer.staticSceneHandler = { [weak self] isStatic, frameRate in
+      DispatchQueue.main.async {
+        self?.fireEvent("staticSceneChanged", ["static": isStatic, "frameRate": frameRate])
+      }
+    }
+    capturer.processingBudget = options.processingBudget
+    publisher.videoCapture = capturer
+    setProcessingStages(options.processingStages)
+
+    if options.adaptiveCapture {
+      captureController = TiVonageCaptureController(baseSize: CGSize(width: 480, height: 640), frameRate: 30)
+      publisher.networkStatsDelegate = self
+    }
+  }
+
+  func setProcessingStages(_ stages: [[String: Any]]) {
+    guard let capturer = videoCapturer else {
+      NSLog("[ERROR] Processing stages need the module's capturer (set them, or enable \"customCapturer\", before the publisher is created)")
+      return
+    }
+    do {
+      try capturer.setProcessingStages(stages)
+    } catch {
+      NSLog("[ERROR] Cannot set the processing stages: \(error.localizedDescription)")
+    }
+  }
+
+  /// Counters of whichever capturer the stream has, plus its state.
+  func stats() -> [String: Any] {
+    var stats: [String: Any] = [
+      "published": isPublished,
+      "streamId": publisher.stream?.streamId ?? "",
+      "publishAudio": publisher.publishAudio,
+      "publishVideo": publisher.publishVideo
+    ]
+    if let capturer = videoCapturer {
+      stats["capturedFrames"] = capturer.capturedFrames
+      stats["droppedFrames"] = capturer.droppedFrames
+      stats["staticScene"] = capturer.sceneIsStatic
+      stats["processing"] = capturer.processingStats
+    } else if let capturer = screenCapturer {
+      stats["capturedFrames"] = capturer.sentFrames
+      stats["skippedFrames"] = capturer.skippedFrames
+    } else if let capturer = syntheticCapturer {
+      stats["synthetic"] = capturer.stats
+    }
+    if let controller = captureController {
+      stats["captureFormat"] = captureFormat(controller)
+    }
+    return stats
+  }
+
+  private func captureFormat(_ controller: TiVonageCaptureController) -> [String: Any] {
+    return [
+      "width": Int(controller.captureSize.width),
+      "height": Int(controller.captureSize.height),
+      "frameRate": controller.captureFrameRate,
+      "level": controller.level,
+      "packetLoss": controller.packetLoss,
+      "bitrate": controller.bitrate
+    ]
+  }
+}
+
+// MARK: OTPublisherDelegate
+
+extension TiVonagePublication : OTPublisherDelegate {
+
+  func publisher(_ publisher: OTPublisherKit, didFailWithError error: OTError) {
+    if error.code == 1022 {
+      fireEvent("streamDropped", [:])
+    } else {
+      fireEvent("error", ["message": error.localizedDescription])
+    }
+  }
+
+  func publisher(_ publisher: OTPublisherKit, streamCreated stream: OTStream) {
+    fireEvent("streamCreated", ["streamId": stream.streamId])
+  }
+
+  func publisher(_ publisher: OTPublisherKit, streamDestroyed stream: OTStream) {
+    fireEvent("streamDestroyed", ["streamId": stream.streamId])
+  }
+}
+
+// MARK: OTPublisherKitAudioLevelDelegate
+
+extension TiVonagePublication : OTPublisherKitAudioLevelDelegate {
+
+  func publisher(_ publisher: OTPublisherKit, audioLevelUpdated audioLevel: Float) {
+    // Levels only count once there is a stream to show them for.
+    guard let streamId = publisher.stream?.streamId else {
+      return
+    }
+    audioLevelHandler?(streamId, audioLevel)
+  }
+}
+
+// MARK: OTPublisherKitNetworkStatsDelegate
+
+extension TiVonagePublication : OTPublisherKitNetworkStatsDelegate {
+
+  func publisher(_ publisher: OTPublisherKit, videoNetworkStatsUpdated stats: [OTPublisherKitVideoNetworkStats]) {
+    guard let controller = captureController, let capturer = videoCapturer else {
+      return
+    }
+    controller.addVideoNetworkStats(stats)
+    guard controller.update() else {
+      return
+    }
+    capturer.setCaptureSize(controller.captureSize, frameRate: controller.captureFrameRate)
+    fireEvent("captureFormatChanged", captureFormat(controller))
+  }
+}
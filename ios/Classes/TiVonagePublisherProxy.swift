@@ -0,0 +1,140 @@
+//
+//  TiVonagePublisherProxy.swift
+//  ti.vonage
+//
+
+import TitaniumKit
+
+/// The handle createPublisher() returns. It owns one published stream and
+/// fires that stream's events on itself; the module publishes it once the
+/// session is connected.
+@objc(TiVonagePublisherProxy)
+public class TiVonagePublisherProxy : TiProxy {
+
+  weak var module: TiVonageModule?
+
+  var publication: TiVonagePublication?
+
+  var viewProxy: TiVonageVideoProxy?
+
+  func _init(withPageContext context: TiEvaluator!, module: TiVonageModule, publication: TiVonagePublication) -> Self! {
+    super._init(withPageContext: context)
+    self.module = module
+    self.publication = publication
+    publication.fireEvent = { [weak self] name, event in
+      self?.fireEvent(name, with: event)
+    }
+    return self
+  }
+
+  @objc(publish:)
+  func publish(unused: Any?) {
+    guard let publication = publication else {
+      NSLog("[ERROR] The publisher was destroyed")
+      return
+    }
+    module?.publish(publication)
+  }
+
+  @objc(unpublish:)
+  func unpublish(unused: Any?) {
+    guard let publication = publication else {
+      return
+    }
+    module?.unpublish(publication)
+  }
+
+  /// Unpublishes and stops capturing for good.
+  @objc(destroy:)
+  func destroy(unused: Any?) {
+    guard let publication = publication else {
+      return
+    }
+    module?.destroy(publication)
+    publication.fireEvent = { _, _ in }
+    self.publication = nil
+    viewProxy = nil
+  }
+
+  @objc(view:)
+  func view(unused: Any?) -> TiVonageVideoProxy? {
+    if viewProxy == nil, let view = publication?.view {
+      view.frame = CGRect(x: 0, y: 0, width: 512, height: 512)
+      viewProxy = TiVonageVideoProxy()._init(withPageContext: pageContext, videoView: view)
+    }
+    return viewProxy
+  }
+
+  @objc(published:)
+  func published(unused: Any?) -> Bool {
+    return publication?.isPublished ?? false
+  }
+
+  @objc(streamId:)
+  func streamId(unused: Any?) -> String? {
+    return publication?.publisher.stream?.streamId
+  }
+
+  @objc(videoSource:)
+  func videoSource(unused: Any?) -> String? {
+    return publication?.options.videoSource
+  }
+
+  @objc(setPublishAudio:)
+  func setPublishAudio(publishAudio: Bool) {
+    publication?.publisher.publishAudio = publishAudio
+  }
+
+  @objc(publishAudio:)
+  func publishAudio(unused: Any?) -> Bool {
+    return publication?.publisher.publishAudio ?? false
+  }
+
+  @objc(setPublishVideo:)
+  func setPublishVideo(publishVideo: Bool) {
+    publication?.publisher.publishVideo = publishVideo
+  }
+
+  @objc(publishVideo:)
+  func publishVideo(unused: Any?) -> Bool {
+    return publication?.publisher.publishVideo ?? false
+  }
+
+  @objc(setStaticSceneDetection:)
+  func setStaticSceneDetection(staticSceneDetection: Bool) {
+    publication?.videoCapturer?.detectsStaticScene = staticSceneDetection
+  }
+
+  @objc(setProcessingStages:)
+  func setProcessingStages(processingStages: [[String: Any]]) {
+    publication?.setProcessingStages(processingStages)
+  }
+
+  @objc(setProcessingBudget:)
+  func setProcessingBudget(processingBudget: Double) {
+    publication?.videoCapturer?.processingBudget = processingBudget
+  }
+
+  @objc(setScreenContentHint:)
+  func setScreenContentHint(screenContentHint: String) {
+    publication?.screenCapturer?.videoContentHint = screenContentHint == "detail" ? .detail : .text
+  }
+
+  @objc(setFrameMetadataPayload:)
+  func setFrameMetadataPayload(arguments: Array<Any>?) {
+    guard let capturer = publication?.videoCapturer, capturer.stampsFrameMetadata else {
+      NSLog("[ERROR] Frame metadata is only sent by publishers created with \"frameMetadata\"")
+      return
+    }
+    guard let payload = arguments?.first as? String else {
+      capturer.metadataPayload = nil
+      return
+    }
+    capturer.metadataPayload = TiVonageModule.frameMetadataPayload(payload)
+  }
+
+  @objc(getStats:)
+  func getStats(unused: Any?) -> [String: Any]? {
+    return publication?.stats()
+  }
+}
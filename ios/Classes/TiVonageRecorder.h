@@ -0,0 +1,53 @@
+//
+//  TiVonageRecorder.h
+//  ti.vonage
+//
+//  Objective-C facade over tivonage::MediaRecorder (see core/).
+//
+
+#import <Foundation/Foundation.h>
+
+#import "TiVonageVideoRenderer.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Records the frames a TiVonageVideoRenderer receives to a .y4m file, and
+ * PCM handed to -writeAudio:count: to a .wav file. Disk writes happen on a
+ * thread of their own; when they fall behind, frames are dropped and
+ * counted rather than queued.
+ */
+@interface TiVonageRecorder : NSObject
+
+/// Nil if the audio file can't be created. A nil audioPath records video only.
+- (nullable instancetype)initWithVideoPath:(NSString *)videoPath audioPath:(nullable NSString *)audioPath;
+
+/// Records mono audio at sampleRate; the initializer above uses 48 kHz.
+- (nullable instancetype)initWithVideoPath:(NSString *)videoPath audioPath:(nullable NSString *)audioPath audioSampleRate:(int)sampleRate;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, readonly) NSString *videoPath;
+@property (nonatomic, readonly, nullable) NSString *audioPath;
+
+@property (nonatomic, readonly) uint64_t recordedFrames;
+/// Copies written to keep a source slower than 30 fps in time.
+@property (nonatomic, readonly) uint64_t repeatedFrames;
+@property (nonatomic, readonly) uint64_t droppedFrames;
+@property (nonatomic, readonly) uint64_t recordedSamples;
+@property (nonatomic, readonly) uint64_t droppedSamples;
+/// A write failed, e.g. because the disk is full.
+@property (nonatomic, readonly) BOOL failed;
+
+/// Starts recording every frame the renderer receives, at full resolution.
+- (void)recordRenderer:(TiVonageVideoRenderer *)renderer;
+
+/// Interleaved 16-bit samples, from one audio thread.
+- (void)writeAudio:(const int16_t *)samples count:(NSUInteger)count;
+
+/// Detaches from the renderer, writes what is queued and closes the files.
+- (void)stop;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,94 @@
+//
+//  TiVonageRecorder.mm
+//  ti.vonage
+//
+
+#import "TiVonageRecorder.h"
+
+#import "TiVonageRenderView.h"
+
+#include "tivonage/MediaRecorder.h"
+
+#include <memory>
+
+@implementation TiVonageRecorder {
+  std::shared_ptr<tivonage::MediaRecorder> _recorder;
+  __weak TiVonageVideoRenderer *_renderer;
+}
+
+- (instancetype)initWithVideoPath:(NSString *)videoPath audioPath:(NSString *)audioPath
+{
+  return [self initWithVideoPath:videoPath audioPath:audioPath audioSampleRate:tivonage::MediaRecorder::Config().audioSampleRate];
+}
+
+- (instancetype)initWithVideoPath:(NSString *)videoPath audioPath:(NSString *)audioPath audioSampleRate:(int)sampleRate
+{
+  if (self = [super init]) {
+    tivonage::MediaRecorder::Config config;
+    config.audioSampleRate = sampleRate;
+    _recorder = tivonage::MediaRecorder::create(videoPath.fileSystemRepresentation,
+        audioPath != nil ? audioPath.fileSystemRepresentation : "", config);
+    if (!_recorder) {
+      return nil;
+    }
+    _videoPath = [videoPath copy];
+    _audioPath = [audioPath copy];
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  [self stop];
+}
+
+- (uint64_t)recordedFrames
+{
+  return _recorder->counters().recordedFrames;
+}
+
+- (uint64_t)repeatedFrames
+{
+  return _recorder->counters().repeatedFrames;
+}
+
+- (uint64_t)droppedFrames
+{
+  return _recorder->counters().droppedFrames;
+}
+
+- (uint64_t)recordedSamples
+{
+  return _recorder->counters().recordedSamples;
+}
+
+- (uint64_t)droppedSamples
+{
+  return _recorder->counters().droppedSamples;
+}
+
+- (BOOL)failed
+{
+  return _recorder->counters().failed;
+}
+
+- (void)recordRenderer:(TiVonageVideoRenderer *)renderer
+{
+  [_renderer setRecorder:nullptr];
+  _renderer = renderer;
+  [renderer setRecorder:_recorder];
+}
+
+- (void)writeAudio:(const int16_t *)samples count:(NSUInteger)count
+{
+  _recorder->writeAudio(samples, count);
+}
+
+- (void)stop
+{
+  [_renderer setRecorder:nullptr];
+  _renderer = nil;
+  _recorder->stop();
+}
+
+@end
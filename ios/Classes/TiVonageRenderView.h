@@ -0,0 +1,78 @@
+//
+//  TiVonageRenderView.h
+//  ti.vonage
+//
+//  Display side of the module's renderers. Objective-C++ only; not part of
+//  the public headers.
+//
+
+#import <AVFoundation/AVFoundation.h>
+#import <UIKit/UIKit.h>
+
+#import "TiVonageVideoRenderer.h"
+
+#include "tivonage/FrameMailbox.h"
+#include "tivonage/FramePool.h"
+#include "tivonage/MediaRecorder.h"
+#include "tivonage/RenderStats.h"
+
+#include <memory>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Where a TiVonageVideoRenderer delivers its frames: by default its own
+ * view, or a tile of a TiVonageGallery. The first two methods are called
+ * from the SDK render thread.
+ */
+@protocol TiVonageFrameTarget <NSObject>
+
+// Size to scale frames to, in device pixels; zero for "as received".
+- (void)getPixelWidth:(int *)width height:(int *)height;
+
+// NO if this replaced a frame that was never shown (a dropped frame).
+- (BOOL)publishFrame:(tivonage::FrameHandle)frame;
+
+// Where to count the frames that reach the screen.
+- (void)setRenderStats:(std::shared_ptr<tivonage::RenderStats>)stats;
+
+@end
+
+@interface TiVonageVideoRenderer (FrameTarget)
+
+// nil sends frames to the renderer's own view again.
+- (void)setFrameTarget:(nullable id<TiVonageFrameTarget>)target;
+
+@end
+
+@interface TiVonageVideoRenderer (Recording)
+
+// Every received frame is also handed to the recorder, before any scaling.
+- (void)setRecorder:(std::shared_ptr<tivonage::MediaRecorder>)recorder;
+
+@end
+
+// Wraps the pooled planes in a CVPixelBuffer without copying them. The lease
+// on the pool buffer is returned when CoreVideo releases the pixel buffer.
+CVPixelBufferRef _Nullable TiVonageCreatePixelBuffer(tivonage::FrameHandle handle) CF_RETURNS_RETAINED;
+
+@interface TiVonageRenderView : UIView <TiVonageFrameTarget>
+
+@property (nonatomic, readonly) AVSampleBufferDisplayLayer *displayLayer;
+
+// The target's pixel size is the view's, updated on layout and zero until
+// the view has been laid out. The newest published frame is shown on the next
+// display refresh; frames replaced before that are dropped, not queued.
+
+// Runs on the main thread once per display refresh while the view is in a
+// window. Subclasses that produce their own frames override it.
+- (void)displayRefresh:(CADisplayLink *)displayLink;
+
+// Shows the pixel buffer as soon as possible. NO if it could not be queued
+// on the layer.
+- (BOOL)enqueuePixelBuffer:(CVPixelBufferRef)pixelBuffer timestamp:(CMTime)timestamp;
+
+@end
+
+
+NS_ASSUME_NONNULL_END
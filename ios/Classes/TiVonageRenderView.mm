@@ -0,0 +1,207 @@
+//
+//  TiVonageRenderView.mm
+//  ti.vonage
+//
+
+#import "TiVonageRenderView.h"
+
+#include "tivonage/Clock.h"
+
+#include <atomic>
+
+static OSType TiVonagePixelBufferType(tivonage::PixelFormat format)
+{
+  switch (format) {
+  case tivonage::PixelFormat::I420:
+    return kCVPixelFormatType_420YpCbCr8Planar;
+  case tivonage::PixelFormat::NV12:
+    return kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange;
+  case tivonage::PixelFormat::ARGB:
+    // OpenTok's ARGB is libyuv ARGB, i.e. B, G, R, A in memory.
+    return kCVPixelFormatType_32BGRA;
+  }
+  return 0;
+}
+
+static void TiVonageReleasePooledPlanes(void *releaseRefCon, const void *dataPtr, size_t dataSize, size_t numberOfPlanes, const void *planeAddresses[])
+{
+  tivonage::FrameHandle::adopt(releaseRefCon);
+}
+
+static void TiVonageReleasePooledBytes(void *releaseRefCon, const void *baseAddress)
+{
+  tivonage::FrameHandle::adopt(releaseRefCon);
+}
+
+CVPixelBufferRef TiVonageCreatePixelBuffer(tivonage::FrameHandle handle)
+{
+  tivonage::VideoFrame &frame = handle.frame();
+  size_t planeCount = size_t(tivonage::planeCount(frame.format));
+  void *baseAddresses[3];
+  size_t widths[3], heights[3], bytesPerRow[3];
+  for (size_t plane = 0; plane < planeCount; plane++) {
+    baseAddresses[plane] = frame.planes[plane].data;
+    widths[plane] = plane == 0 ? size_t(frame.width) : size_t(frame.width + 1) / 2;
+    heights[plane] = size_t(tivonage::planeRows(frame.format, int(plane), frame.height));
+    bytesPerRow[plane] = size_t(frame.planes[plane].stride);
+  }
+
+  CVPixelBufferRef pixelBuffer = NULL;
+  CVReturn result;
+  OSType type = TiVonagePixelBufferType(frame.format);
+  size_t width = size_t(frame.width);
+  size_t height = size_t(frame.height);
+  void *lease = handle.detach();
+  if (planeCount == 1) {
+    result = CVPixelBufferCreateWithBytes(kCFAllocatorDefault, width, height, type, baseAddresses[0], bytesPerRow[0],
+        TiVonageReleasePooledBytes, lease, NULL, &pixelBuffer);
+  } else {
+    result = CVPixelBufferCreateWithPlanarBytes(kCFAllocatorDefault, width, height, type, NULL, 0, planeCount,
+        baseAddresses, widths, heights, bytesPerRow, TiVonageReleasePooledPlanes, lease, NULL, &pixelBuffer);
+  }
+
+  if (result != kCVReturnSuccess) {
+    tivonage::FrameHandle::adopt(lease);
+    return NULL;
+  }
+  return pixelBuffer;
+}
+
+@implementation TiVonageRenderView {
+  CMVideoFormatDescriptionRef _formatDescription;
+  std::atomic<uint64_t> _pixelSize;
+  tivonage::FrameMailbox _mailbox;
+  std::shared_ptr<tivonage::RenderStats> _stats;
+  CADisplayLink *_displayLink;
+}
+
++ (Class)layerClass
+{
+  return [AVSampleBufferDisplayLayer class];
+}
+
+- (instancetype)initWithFrame:(CGRect)frame
+{
+  if (self = [super initWithFrame:frame]) {
+    self.displayLayer.videoGravity = AVLayerVideoGravityResizeAspectFill;
+    self.backgroundColor = [UIColor blackColor];
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  [_displayLink invalidate];
+  if (_formatDescription != NULL) {
+    CFRelease(_formatDescription);
+  }
+}
+
+- (AVSampleBufferDisplayLayer *)displayLayer
+{
+  return (AVSampleBufferDisplayLayer *)self.layer;
+}
+
+- (void)layoutSubviews
+{
+  [super layoutSubviews];
+  CGFloat scale = self.window != nil ? self.window.screen.scale : [UIScreen mainScreen].scale;
+  uint64_t width = uint64_t(MAX(CGRectGetWidth(self.bounds) * scale, 0.0));
+  uint64_t height = uint64_t(MAX(CGRectGetHeight(self.bounds) * scale, 0.0));
+  _pixelSize.store(width << 32 | height, std::memory_order_relaxed);
+}
+
+- (void)getPixelWidth:(int *)width height:(int *)height
+{
+  uint64_t size = _pixelSize.load(std::memory_order_relaxed);
+  *width = int(size >> 32);
+  *height = int(size & 0xFFFFFFFF);
+}
+
+// The display link retains its target, so it only runs while the view is on
+// screen; that also breaks the cycle once the view is removed.
+- (void)didMoveToWindow
+{
+  [super didMoveToWindow];
+  if (self.window != nil && _displayLink == nil) {
+    _displayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(displayRefresh:)];
+    [_displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+  } else if (self.window == nil && _displayLink != nil) {
+    [_displayLink invalidate];
+    _displayLink = nil;
+  }
+}
+
+- (BOOL)publishFrame:(tivonage::FrameHandle)frame
+{
+  return _mailbox.publish(std::move(frame));
+}
+
+- (void)setRenderStats:(std::shared_ptr<tivonage::RenderStats>)stats
+{
+  @synchronized(self) {
+    _stats = std::move(stats);
+  }
+}
+
+- (void)countDisplayedFrame
+{
+  std::shared_ptr<tivonage::RenderStats> stats;
+  @synchronized(self) {
+    stats = _stats;
+  }
+  if (stats) {
+    stats->frameDisplayed(tivonage::monotonicMicros());
+  }
+}
+
+- (void)displayRefresh:(CADisplayLink *)displayLink
+{
+  tivonage::FrameHandle frame;
+  if (!_mailbox.take(frame)) {
+    return;
+  }
+  CMTime timestamp = CMTimeMake(frame.frame().timestampUs, 1000000);
+  CVPixelBufferRef pixelBuffer = TiVonageCreatePixelBuffer(std::move(frame));
+  if (pixelBuffer == NULL) {
+    return;
+  }
+  // Only frames that reached the layer count as displayed.
+  if ([self enqueuePixelBuffer:pixelBuffer timestamp:timestamp]) {
+    [self countDisplayedFrame];
+  }
+  CVPixelBufferRelease(pixelBuffer);
+}
+
+- (BOOL)enqueuePixelBuffer:(CVPixelBufferRef)pixelBuffer timestamp:(CMTime)timestamp
+{
+  if (_formatDescription == NULL || !CMVideoFormatDescriptionMatchesImageBuffer(_formatDescription, pixelBuffer)) {
+    if (_formatDescription != NULL) {
+      CFRelease(_formatDescription);
+      _formatDescription = NULL;
+    }
+    if (CMVideoFormatDescriptionCreateForImageBuffer(kCFAllocatorDefault, pixelBuffer, &_formatDescription) != noErr) {
+      return NO;
+    }
+  }
+
+  CMSampleTimingInfo timing = { kCMTimeInvalid, timestamp, kCMTimeInvalid };
+  CMSampleBufferRef sampleBuffer = NULL;
+  if (CMSampleBufferCreateReadyWithImageBuffer(kCFAllocatorDefault, pixelBuffer, _formatDescription, &timing, &sampleBuffer) != noErr) {
+    return NO;
+  }
+
+  CFArrayRef attachments = CMSampleBufferGetSampleAttachmentsArray(sampleBuffer, YES);
+  CFMutableDictionaryRef attachment = (CFMutableDictionaryRef)CFArrayGetValueAtIndex(attachments, 0);
+  CFDictionarySetValue(attachment, kCMSampleAttachmentKey_DisplayImmediately, kCFBooleanTrue);
+
+  AVSampleBufferDisplayLayer *displayLayer = self.displayLayer;
+  if (displayLayer.status == AVQueuedSampleBufferRenderingStatusFailed) {
+    [displayLayer flush];
+  }
+  [displayLayer enqueueSampleBuffer:sampleBuffer];
+  CFRelease(sampleBuffer);
+  return displayLayer.status != AVQueuedSampleBufferRenderingStatusFailed;
+}
+
+@end
@@ -0,0 +1,37 @@
+//
+//  TiVonageScreenCapturer.h
+//  ti.vonage
+//
+
+#import <OpenTok/OpenTok.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * OTVideoCapture publishing the app's key window, for screen sharing. The
+ * window is drawn into one reused buffer at frameRate; frames whose tiles all
+ * hash the same as the previous one are not handed to the SDK at all, so a
+ * static slide costs no encoding or bandwidth. An unchanged frame is still
+ * sent every couple of seconds so late subscribers get a picture. Assign it
+ * to OTPublisherKit.videoCapture and set videoType to
+ * OTPublisherKitVideoTypeScreen before publishing.
+ */
+@interface TiVonageScreenCapturer : NSObject <OTVideoCapture>
+
+@property (atomic, weak) id<OTVideoCaptureConsumer> _Nullable videoCaptureConsumer;
+/// OTVideoContentHintText unless changed: keep glyph edges sharp over
+/// frame rate.
+@property (nonatomic, readwrite) OTVideoContentHint videoContentHint;
+
+/// Window samples per second; 15 unless changed before capturing starts.
+@property (nonatomic, assign) NSInteger frameRate;
+
+/// Frames handed to the SDK, and samples skipped because nothing changed.
+@property (nonatomic, readonly) uint64_t sentFrames;
+@property (nonatomic, readonly) uint64_t skippedFrames;
+
+- (instancetype)init;
+
+@end
+
+NS_ASSUME_NONNULL_END
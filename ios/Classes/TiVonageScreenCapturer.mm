@@ -0,0 +1,169 @@
+//
+//  TiVonageScreenCapturer.mm
+//  ti.vonage
+//
+
+#import "TiVonageScreenCapturer.h"
+
+#import <UIKit/UIKit.h>
+
+#include "tivonage/Clock.h"
+#include "tivonage/FrameBuffer.h"
+#include "tivonage/TileHasher.h"
+
+#include <algorithm>
+#include <memory>
+
+// Longest side of the published frame, in pixels. Full retina resolution
+// would more than double the encoder's work for little legibility gain.
+static const CGFloat TiVonageScreenMaxDimension = 1280;
+
+// Unchanged frames are still sent this often so subscribers that join, or
+// lose a frame, get a picture.
+static const int64_t TiVonageScreenRefreshUs = 2000000;
+
+@implementation TiVonageScreenCapturer {
+  CADisplayLink *_displayLink;
+  std::unique_ptr<tivonage::FrameBuffer> _buffer;
+  CGContextRef _context;
+  CGFloat _scale;
+  OTVideoFrame *_frame;
+  tivonage::TileHasher _hasher;
+  int64_t _lastSentUs;
+  uint64_t _sentFrames;
+  uint64_t _skippedFrames;
+}
+
+- (instancetype)init
+{
+  if (self = [super init]) {
+    _videoContentHint = OTVideoContentHintText;
+    _frameRate = 15;
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  [_displayLink invalidate];
+  if (_context != NULL) {
+    CGContextRelease(_context);
+  }
+}
+
+- (uint64_t)sentFrames
+{
+  return _sentFrames;
+}
+
+- (uint64_t)skippedFrames
+{
+  return _skippedFrames;
+}
+
+// Sizes the buffer, bitmap context and SDK frame for the window once; they
+// are reused for every sample.
+- (void)initCapture
+{
+  dispatch_block_t setup = ^{
+    CGSize size = [UIScreen mainScreen].bounds.size;
+    self->_scale = MIN([UIScreen mainScreen].scale, TiVonageScreenMaxDimension / MAX(size.width, size.height));
+    int width = int(size.width * self->_scale) & ~1;
+    int height = int(size.height * self->_scale) & ~1;
+    self->_buffer = tivonage::FrameBuffer::create(tivonage::PixelFormat::ARGB, width, height);
+    if (!self->_buffer) {
+      NSLog(@"[ERROR] Cannot allocate the screen capture buffer");
+      return;
+    }
+
+    tivonage::VideoPlane &plane = self->_buffer->frame().planes[0];
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    // OpenTok's ARGB is B, G, R, A in memory: little-endian 32-bit ARGB.
+    self->_context = CGBitmapContextCreate(plane.data, size_t(width), size_t(height), 8, size_t(plane.stride), colorSpace,
+        kCGImageAlphaPremultipliedFirst | kCGBitmapByteOrder32Little);
+    CGColorSpaceRelease(colorSpace);
+
+    OTVideoFormat *format = [OTVideoFormat videoFormatARGBWithWidth:uint32_t(width) height:uint32_t(height)];
+    [format.bytesPerRow setArray:@[ @(plane.stride) ]];
+    self->_frame = [[OTVideoFrame alloc] initWithFormat:format];
+    self->_frame.orientation = OTVideoOrientationUp;
+    uint8_t *planes[] = { plane.data };
+    [self->_frame setPlanesWithPointers:planes numPlanes:1];
+  };
+  [NSThread isMainThread] ? setup() : dispatch_sync(dispatch_get_main_queue(), setup);
+}
+
+- (void)releaseCapture
+{
+  [self stopCapture];
+}
+
+- (int32_t)startCapture
+{
+  if (_context == NULL) {
+    return -1;
+  }
+  dispatch_async(dispatch_get_main_queue(), ^{
+    if (self->_displayLink != nil) {
+      return;
+    }
+    self->_hasher.reset();
+    self->_displayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(captureScreen:)];
+    self->_displayLink.preferredFramesPerSecond = self.frameRate;
+    [self->_displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+  });
+  return 0;
+}
+
+- (int32_t)stopCapture
+{
+  dispatch_async(dispatch_get_main_queue(), ^{
+    [self->_displayLink invalidate];
+    self->_displayLink = nil;
+  });
+  return 0;
+}
+
+- (BOOL)isCaptureStarted
+{
+  return _displayLink != nil;
+}
+
+- (int32_t)captureSettings:(OTVideoFormat *)videoFormat
+{
+  videoFormat.pixelFormat = OTPixelFormatARGB;
+  videoFormat.imageWidth = uint32_t(_buffer ? _buffer->width() : 0);
+  videoFormat.imageHeight = uint32_t(_buffer ? _buffer->height() : 0);
+  videoFormat.estimatedFramesPerSecond = double(self.frameRate);
+  return 0;
+}
+
+// Main thread: UIKit only draws there.
+- (void)captureScreen:(CADisplayLink *)displayLink
+{
+  id<OTVideoCaptureConsumer> consumer = self.videoCaptureConsumer;
+  UIWindow *window = UIApplication.sharedApplication.keyWindow;
+  if (consumer == nil || window == nil) {
+    return;
+  }
+
+  CGContextSaveGState(_context);
+  CGContextTranslateCTM(_context, 0, CGFloat(_buffer->height()));
+  CGContextScaleCTM(_context, _scale, -_scale);
+  UIGraphicsPushContext(_context);
+  [window drawViewHierarchyInRect:window.bounds afterScreenUpdates:NO];
+  UIGraphicsPopContext();
+  CGContextRestoreGState(_context);
+
+  int64_t nowUs = tivonage::monotonicMicros();
+  if (_hasher.update(_buffer->frame()) == 0 && nowUs - _lastSentUs < TiVonageScreenRefreshUs) {
+    _skippedFrames++;
+    return;
+  }
+  _lastSentUs = nowUs;
+  _frame.timestamp = CMTimeMake(nowUs, 1000000);
+  [consumer consumeFrame:_frame];
+  _sentFrames++;
+}
+
+@end
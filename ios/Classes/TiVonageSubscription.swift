@@ -0,0 +1,49 @@
+//
+//  TiVonageSubscription.swift
+//  ti.vonage
+//
+
+import OpenTok
+
+/// Book-keeping for one subscribed stream: the SDK subscriber, the proxy the
+/// app shows it in, and the controller deciding what to request for it.
+class TiVonageSubscription {
+
+  let subscriber: OTSubscriber
+
+  weak var viewProxy: TiVonageVideoProxy?
+
+  let controller = TiVonageSubscriptionController()
+
+  /// Set when the stream is shown as a tile of the gallery instead of its
+  /// own view; the tile then decides the size to ask for.
+  weak var gallery: TiVonageGallery?
+
+  /// The module's renderer, when the stream is rendered through it.
+  var renderer: TiVonageVideoRenderer? {
+    return subscriber.videoRender as? TiVonageVideoRenderer
+  }
+
+  init(subscriber: OTSubscriber, viewProxy: TiVonageVideoProxy?) {
+    self.subscriber = subscriber
+    self.viewProxy = viewProxy
+  }
+
+  /// Feeds the current on-screen state to the controller and applies its
+  /// decision to the subscriber when it changed. Disabled features are fed
+  /// neutral observations (always visible, unknown view size, priority).
+  func refresh(pauseHiddenVideo: Bool, adaptVideoToView: Bool, highPriority: Bool) {
+    controller.visible = !pauseHiddenVideo || (viewProxy?.isVisibleOnScreen ?? false)
+    controller.highPriority = highPriority
+    controller.streamSize = subscriber.stream?.videoDimensions ?? .zero
+    controller.viewPixelSize = adaptVideoToView ? (gallery?.tilePixelSize ?? viewProxy?.pixelSize ?? .zero) : .zero
+
+    guard controller.update() else {
+      return
+    }
+    subscriber.subscribeToVideo = controller.subscribeToVideo
+    subscriber.preferredResolution = controller.preferredResolution
+    // The SDK takes the largest float as "no preference".
+    subscriber.preferredFrameRate = controller.preferredFrameRate > 0 ? controller.preferredFrameRate : Float.greatestFiniteMagnitude
+  }
+}
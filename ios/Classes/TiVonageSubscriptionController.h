@@ -0,0 +1,46 @@
+//
+//  TiVonageSubscriptionController.h
+//  ti.vonage
+//
+//  Objective-C facade over tivonage::SubscriptionController (see core/).
+//
+
+#import <CoreGraphics/CoreGraphics.h>
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Decides, per subscribed stream, what to request from the SDK based on how
+ * the stream's view is shown. Call -update on the UI tick and apply the
+ * decision when it returns YES. Main thread only.
+ */
+@interface TiVonageSubscriptionController : NSObject
+
+@property (nonatomic, assign) BOOL visible;
+
+/// The stream's full video dimensions (OTStream.videoDimensions).
+@property (nonatomic, assign) CGSize streamSize;
+
+/// The size of the stream's view in device pixels.
+@property (nonatomic, assign) CGSize viewPixelSize;
+
+/// Whether the stream may use its full-size layer; streams outside the
+/// active speakers get half size at most. YES at first.
+@property (nonatomic, assign) BOOL highPriority;
+
+/// Whether video should currently be subscribed.
+@property (nonatomic, readonly) BOOL subscribeToVideo;
+
+/// Simulcast layer to ask for; CGSizeZero for no preference (full size).
+@property (nonatomic, readonly) CGSize preferredResolution;
+
+/// Frame rate to ask for; 0 for no preference.
+@property (nonatomic, readonly) float preferredFrameRate;
+
+/// Re-evaluates the decision; YES if it changed since the last call.
+- (BOOL)update;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,80 @@
+//
+//  TiVonageSubscriptionController.mm
+//  ti.vonage
+//
+
+#import "TiVonageSubscriptionController.h"
+
+#include "tivonage/Clock.h"
+#include "tivonage/SubscriptionController.h"
+
+@implementation TiVonageSubscriptionController {
+  tivonage::SubscriptionController _controller;
+  CGSize _streamSize;
+  CGSize _viewPixelSize;
+}
+
+- (BOOL)visible
+{
+  return _controller.visible();
+}
+
+- (void)setVisible:(BOOL)visible
+{
+  _controller.setVisible(visible, tivonage::monotonicMicros());
+}
+
+- (CGSize)streamSize
+{
+  return _streamSize;
+}
+
+- (void)setStreamSize:(CGSize)streamSize
+{
+  _streamSize = streamSize;
+  _controller.setStreamSize(int(streamSize.width), int(streamSize.height));
+}
+
+- (CGSize)viewPixelSize
+{
+  return _viewPixelSize;
+}
+
+- (void)setViewPixelSize:(CGSize)viewPixelSize
+{
+  _viewPixelSize = viewPixelSize;
+  _controller.setViewSize(int(viewPixelSize.width), int(viewPixelSize.height));
+}
+
+- (BOOL)highPriority
+{
+  return _controller.highPriority();
+}
+
+- (void)setHighPriority:(BOOL)highPriority
+{
+  _controller.setHighPriority(highPriority);
+}
+
+- (CGSize)preferredResolution
+{
+  const tivonage::SubscriptionController::Decision &decision = _controller.decision();
+  return CGSizeMake(decision.preferredWidth, decision.preferredHeight);
+}
+
+- (float)preferredFrameRate
+{
+  return _controller.decision().preferredFrameRate;
+}
+
+- (BOOL)subscribeToVideo
+{
+  return _controller.decision().video;
+}
+
+- (BOOL)update
+{
+  return _controller.update(tivonage::monotonicMicros());
+}
+
+@end
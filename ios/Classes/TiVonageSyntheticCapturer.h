@@ -0,0 +1,42 @@
+//
+//  TiVonageSyntheticCapturer.h
+//  ti.vonage
+//
+
+#import <OpenTok/OpenTok.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * OTVideoCapture publishing a memory-mapped .y4m file (looped) or a moving
+ * test pattern instead of the camera, for reproducible load tests of the
+ * publish path. Frames are produced on their own thread, paced against
+ * absolute deadlines (see core/include/tivonage/SyntheticVideoSource.h).
+ * Assign it to OTPublisherKit.videoCapture before publishing.
+ */
+@interface TiVonageSyntheticCapturer : NSObject <OTVideoCapture>
+
+@property (atomic, weak) id<OTVideoCaptureConsumer> _Nullable videoCaptureConsumer;
+@property (nonatomic, readwrite) OTVideoContentHint videoContentHint;
+
+/// A nil path publishes the test pattern. A size of 0 keeps the file's
+/// (640x480 for the pattern) and a frame rate of 0 the file's (30 for the
+/// pattern). realTime NO sends frames as fast as the SDK takes them. Returns
+/// nil if the file can't be read or the size is odd.
+- (nullable instancetype)initWithPath:(nullable NSString *)path
+                                width:(int)width
+                               height:(int)height
+                            frameRate:(double)frameRate
+                             realTime:(BOOL)realTime;
+
+@property (nonatomic, readonly) int width;
+@property (nonatomic, readonly) int height;
+@property (nonatomic, readonly) double frameRate;
+
+/// frames, skipped, meanLateness and maxLateness (milliseconds) and fps,
+/// since capturing last started.
+@property (atomic, readonly) NSDictionary<NSString *, NSNumber *> *stats;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,127 @@
+//
+//  TiVonageSyntheticCapturer.mm
+//  ti.vonage
+//
+
+#import "TiVonageSyntheticCapturer.h"
+
+#include "tivonage/SyntheticVideoSource.h"
+
+#include <memory>
+
+@implementation TiVonageSyntheticCapturer {
+  std::unique_ptr<tivonage::SyntheticVideoSource> _source;
+  // Source thread only, after -initCapture.
+  OTVideoFrame *_frame;
+  BOOL _capturing;
+}
+
+- (nullable instancetype)initWithPath:(NSString *)path width:(int)width height:(int)height frameRate:(double)frameRate realTime:(BOOL)realTime
+{
+  if (self = [super init]) {
+    tivonage::SyntheticVideoSource::Config config;
+    if (path != nil) {
+      config.path = path.fileSystemRepresentation;
+    }
+    config.width = width;
+    config.height = height;
+    config.frameRate = frameRate;
+    config.realTime = realTime;
+    __weak TiVonageSyntheticCapturer *weakSelf = self;
+    _source = tivonage::SyntheticVideoSource::create(config, [weakSelf](const tivonage::VideoFrame &frame) {
+      [weakSelf sendFrame:frame];
+    });
+    if (!_source) {
+      return nil;
+    }
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  _source->stop();
+}
+
+- (int)width
+{
+  return _source->width();
+}
+
+- (int)height
+{
+  return _source->height();
+}
+
+- (double)frameRate
+{
+  return _source->frameRate();
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)stats
+{
+  tivonage::SyntheticVideoSource::Stats stats = _source->stats();
+  return @{
+    @"frames" : @(stats.frames),
+    @"skipped" : @(stats.skipped),
+    @"meanLateness" : @(stats.meanLatenessUs / 1000.0),
+    @"maxLateness" : @(double(stats.maxLatenessUs) / 1000.0),
+    @"fps" : @(stats.elapsedUs > 0 ? double(stats.frames) * 1000000.0 / double(stats.elapsedUs) : 0.0),
+  };
+}
+
+- (void)initCapture
+{
+  OTVideoFormat *format = [OTVideoFormat videoFormatI420WithWidth:uint32_t(_source->width()) height:uint32_t(_source->height())];
+  _frame = [[OTVideoFrame alloc] initWithFormat:format];
+  _frame.orientation = OTVideoOrientationUp;
+}
+
+- (void)releaseCapture
+{
+  [self stopCapture];
+}
+
+- (int32_t)startCapture
+{
+  _capturing = YES;
+  return _source->start() ? 0 : -1;
+}
+
+- (int32_t)stopCapture
+{
+  _capturing = NO;
+  _source->stop();
+  return 0;
+}
+
+- (BOOL)isCaptureStarted
+{
+  return _capturing;
+}
+
+- (int32_t)captureSettings:(OTVideoFormat *)videoFormat
+{
+  videoFormat.pixelFormat = OTPixelFormatI420;
+  videoFormat.imageWidth = uint32_t(_source->width());
+  videoFormat.imageHeight = uint32_t(_source->height());
+  videoFormat.estimatedFramesPerSecond = _source->frameRate();
+  return 0;
+}
+
+// Source thread. Frames read from the file point straight into its mapping
+// and the SDK copies them before returning, so nothing is copied here.
+- (void)sendFrame:(const tivonage::VideoFrame &)frame
+{
+  id<OTVideoCaptureConsumer> consumer = self.videoCaptureConsumer;
+  if (consumer == nil || _frame == nil) {
+    return;
+  }
+  [_frame.format.bytesPerRow setArray:@[ @(frame.planes[0].stride), @(frame.planes[1].stride), @(frame.planes[2].stride) ]];
+  uint8_t *planes[] = { frame.planes[0].data, frame.planes[1].data, frame.planes[2].data };
+  [_frame setPlanesWithPointers:planes numPlanes:3];
+  _frame.timestamp = CMTimeMake(frame.timestampUs, 1000000);
+  [consumer consumeFrame:_frame];
+}
+
+@end
@@ -14,8 +14,14 @@ public class TiVonageVideo : TiUIView {
   
   public var videoView: UIView?
 
+  /// The view's size in device pixels, as of the last layout.
+  public private(set) var pixelSize: CGSize = .zero
+
   public override func frameSizeChanged(_ frame: CGRect, bounds: CGRect) {
     super.frameSizeChanged(frame, bounds: bounds)
+
+    let scale = window?.screen.scale ?? UIScreen.main.scale
+    pixelSize = CGSize(width: bounds.width * scale, height: bounds.height * scale)
     
     if let videoView = videoView {
       if self.subviews.isEmpty {
@@ -25,4 +31,27 @@ public class TiVonageVideo : TiUIView {
       TiUtils.setView(videoView, positionRect: bounds)
     }
   }
+
+  /// Whether any part of the view can currently be seen: it is in a window,
+  /// neither it nor an ancestor is hidden or transparent, and it is not
+  /// clipped away by an ancestor (e.g. scrolled out of a scroll view).
+  public var isVisibleOnScreen: Bool {
+    guard let window = window, !isHidden, alpha > 0.01 else {
+      return false
+    }
+
+    var visibleRect = convert(bounds, to: window).intersection(window.bounds)
+    var ancestor = superview
+    while let view = ancestor, !visibleRect.isEmpty {
+      if view.isHidden || view.alpha <= 0.01 {
+        return false
+      }
+      if view.clipsToBounds {
+        visibleRect = visibleRect.intersection(view.convert(view.bounds, to: window))
+      }
+      ancestor = view.superview
+    }
+
+    return !visibleRect.isEmpty
+  }
 }
@@ -0,0 +1,71 @@
+//
+//  TiVonageVideoCapturer.h
+//  ti.vonage
+//
+
+#import <OpenTok/OpenTok.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Camera OTVideoCapture owned by the module. Camera frames are copied into
+ * a small recycled pixel buffer pool before they are handed to the SDK, so
+ * the camera's own buffers go back right away and published frames can be
+ * processed or carry per-frame metadata (see
+ * core/include/tivonage/FrameMetadata.h) without allocating per frame.
+ * Assign it to OTPublisherKit.videoCapture before publishing.
+ */
+@interface TiVonageVideoCapturer : NSObject <OTVideoCapture>
+
+@property (atomic, weak) id<OTVideoCaptureConsumer> _Nullable videoCaptureConsumer;
+@property (nonatomic, readwrite) OTVideoContentHint videoContentHint;
+
+/// Stamp each frame with a sequence number and its capture time.
+@property (atomic, assign) BOOL stampsFrameMetadata;
+
+/// Up to 16 bytes sent along with every stamped frame until changed.
+@property (atomic, copy, nullable) NSData *metadataPayload;
+
+/// Frames handed to the SDK, and frames dropped because every pooled buffer
+/// was still held downstream.
+@property (atomic, readonly) uint64_t capturedFrames;
+@property (atomic, readonly) uint64_t droppedFrames;
+
+/// Scale frames to this size and send at most this many per second, e.g.
+/// to follow a congested uplink. CGSizeZero and 0 send the camera's own
+/// format (portrait 480x640 at 30 fps). Any thread.
+- (void)setCaptureSize:(CGSize)size frameRate:(double)frameRate;
+
+/// Runs these processing stages on every frame before it is sent, on a
+/// dedicated worker (see core/include/tivonage/FrameProcessor.h). Each entry
+/// is a dictionary with a "type" of "crop", "scale", "lut", "overlay" or
+/// "blur" and its options, as documented in the README. An empty array
+/// turns processing off. On error the current stages are kept.
+- (BOOL)setProcessingStages:(NSArray<NSDictionary<NSString *, id> *> *)stages error:(NSError **)error;
+
+/// Time the stages may take per frame, in milliseconds (20 by default).
+/// Effects that no longer fit are skipped for that frame.
+@property (atomic, assign) double processingBudget;
+
+/// One entry per stage: type, runs, skips and averageTime (milliseconds).
+@property (atomic, readonly) NSArray<NSDictionary<NSString *, id> *> *processingStats;
+
+/// Compare each camera frame with the previous one (see
+/// core/include/tivonage/StaticSceneDetector.h). While the scene is still,
+/// frames are sent at a few per second and videoContentHint is Detail; the
+/// first frame with motion restores the full rate and the Motion hint. Off
+/// by default; the hint is left alone while off.
+@property (atomic, assign) BOOL detectsStaticScene;
+
+/// Whether the scene is currently considered still.
+@property (atomic, readonly) BOOL sceneIsStatic;
+
+/// Called on the capture queue whenever the scene turns still or moves
+/// again, with the frame rate now sent.
+@property (atomic, copy, nullable) void (^staticSceneHandler)(BOOL isStatic, double frameRate);
+
+- (instancetype)init;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,465 @@
+//
+//  TiVonageVideoCapturer.mm
+//  ti.vonage
+//
+
+#import "TiVonageVideoCapturer.h"
+
+#import <AVFoundation/AVFoundation.h>
+
+#import "TiVonageProcessingStages.h"
+
+#include "tivonage/Clock.h"
+#include "tivonage/FrameMetadata.h"
+#include "tivonage/FrameProcessor.h"
+#include "tivonage/FrameScaler.h"
+#include "tivonage/StaticSceneDetector.h"
+#include "tivonage/VideoFrame.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+// Enough for the frame being encoded, one queued for the encoder and one
+// being filled. The SDK releases a buffer once it has encoded it; when all
+// are still held the camera frame is dropped instead of growing the pool.
+static const int TiVonageCapturePoolSize = 3;
+
+// The camera's format, as configured in -initCapture.
+static const int TiVonageCameraWidth = 480;
+static const int TiVonageCameraHeight = 640;
+static const double TiVonageCameraFrameRate = 30;
+
+@interface TiVonageVideoCapturer () <AVCaptureVideoDataOutputSampleBufferDelegate>
+@end
+
+@implementation TiVonageVideoCapturer {
+  AVCaptureSession *_captureSession;
+  dispatch_queue_t _captureQueue;
+  CVPixelBufferPoolRef _pool;
+  CFDictionaryRef _poolAuxAttributes;
+  size_t _poolWidth;
+  size_t _poolHeight;
+  NSMutableData *_metadata;
+  std::unique_ptr<tivonage::FrameScaler> _scaler;
+  // Width << 32 | height; 0 for the camera's size.
+  std::atomic<uint64_t> _captureSize;
+  std::atomic<double> _frameRate;
+  int64_t _nextFrameUs;
+  uint32_t _sequence;
+  std::atomic<uint64_t> _capturedFrames;
+  std::atomic<uint64_t> _droppedFrames;
+  // Frames go through the processor while it has stages. Either way they are
+  // sent by -sendFrame:timestamp:, from the capture queue or the processing
+  // worker; the mutex covers the pool, scaler and metadata it uses when
+  // processing is switched on or off mid-frame.
+  std::unique_ptr<tivonage::FrameProcessor> _processor;
+  std::atomic<bool> _processing;
+  double _processingBudget;
+  std::mutex _sendMutex;
+  // Capture queue only, apart from the flags.
+  tivonage::StaticSceneDetector _sceneDetector;
+  std::atomic<bool> _detectsStaticScene;
+  std::atomic<bool> _sceneIsStatic;
+  BOOL _capturing;
+}
+
+- (instancetype)init
+{
+  if (self = [super init]) {
+    _captureQueue = dispatch_queue_create("ti.vonage.capture", DISPATCH_QUEUE_SERIAL);
+    _metadata = [NSMutableData dataWithLength:tivonage::FrameMetadata::kMaxEncodedSize];
+    _poolAuxAttributes = (__bridge_retained CFDictionaryRef) @{ (id)kCVPixelBufferPoolAllocationThresholdKey : @(TiVonageCapturePoolSize) };
+    _scaler.reset(new tivonage::FrameScaler(tivonage::ScaleFilter::Bilinear));
+    _processingBudget = 20;
+    __weak TiVonageVideoCapturer *weakSelf = self;
+    _processor = tivonage::FrameProcessor::create([weakSelf](const tivonage::VideoFrame &frame) {
+      [weakSelf sendFrame:frame timestamp:CMTimeMake(frame.timestampUs, 1000000)];
+    });
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  _processor->stop();
+  if (_pool != NULL) {
+    CVPixelBufferPoolRelease(_pool);
+  }
+  CFRelease(_poolAuxAttributes);
+}
+
+- (uint64_t)capturedFrames
+{
+  return _capturedFrames.load(std::memory_order_relaxed);
+}
+
+- (uint64_t)droppedFrames
+{
+  return _droppedFrames.load(std::memory_order_relaxed);
+}
+
+- (BOOL)detectsStaticScene
+{
+  return _detectsStaticScene.load(std::memory_order_relaxed);
+}
+
+- (void)setDetectsStaticScene:(BOOL)detectsStaticScene
+{
+  _detectsStaticScene.store(detectsStaticScene, std::memory_order_relaxed);
+}
+
+- (BOOL)sceneIsStatic
+{
+  return _sceneIsStatic.load(std::memory_order_relaxed);
+}
+
+- (void)setCaptureSize:(CGSize)size frameRate:(double)frameRate
+{
+  uint64_t width = uint64_t(MAX(size.width, 0.0)) & ~uint64_t(1);
+  uint64_t height = uint64_t(MAX(size.height, 0.0)) & ~uint64_t(1);
+  _captureSize.store(width > 0 && height > 0 ? width << 32 | height : 0, std::memory_order_relaxed);
+  _frameRate.store(MAX(frameRate, 0.0), std::memory_order_relaxed);
+}
+
+- (BOOL)setProcessingStages:(NSArray<NSDictionary<NSString *, id> *> *)specs error:(NSError **)error
+{
+  std::vector<std::unique_ptr<tivonage::FrameStage>> stages;
+  NSString *reason = nil;
+  if (!TiVonageMakeProcessingStages(specs, stages, &reason)) {
+    if (error != NULL) {
+      *error = [NSError errorWithDomain:@"ti.vonage" code:1 userInfo:@{ NSLocalizedDescriptionKey : reason ?: @"Invalid processing stage" }];
+    }
+    return NO;
+  }
+  bool processing = !stages.empty();
+  _processor->setStages(std::move(stages));
+  _processing.store(processing, std::memory_order_relaxed);
+  return YES;
+}
+
+- (double)processingBudget
+{
+  @synchronized(self) {
+    return _processingBudget;
+  }
+}
+
+- (void)setProcessingBudget:(double)processingBudget
+{
+  @synchronized(self) {
+    _processingBudget = MAX(processingBudget, 0.0);
+    _processor->setBudgetUs(int64_t(_processingBudget * 1000.0));
+  }
+}
+
+- (NSArray<NSDictionary<NSString *, id> *> *)processingStats
+{
+  NSMutableArray<NSDictionary<NSString *, id> *> *stats = [NSMutableArray array];
+  for (const tivonage::FramePipeline::StageStats &stage : _processor->stageStats()) {
+    [stats addObject:@{
+      @"type" : @(stage.name.c_str()),
+      @"runs" : @(stage.runs),
+      @"skips" : @(stage.skips),
+      @"averageTime" : @(stage.averageUs / 1000.0),
+    }];
+  }
+  return stats;
+}
+
+- (void)initCapture
+{
+  AVCaptureDevice *device = [AVCaptureDevice defaultDeviceWithDeviceType:AVCaptureDeviceTypeBuiltInWideAngleCamera
+                                                               mediaType:AVMediaTypeVideo
+                                                                position:AVCaptureDevicePositionFront];
+  NSError *error = nil;
+  AVCaptureDeviceInput *input = device != nil ? [AVCaptureDeviceInput deviceInputWithDevice:device error:&error] : nil;
+  if (input == nil) {
+    NSLog(@"[ERROR] Cannot open the camera: %@", error.localizedDescription);
+    return;
+  }
+
+  AVCaptureVideoDataOutput *output = [[AVCaptureVideoDataOutput alloc] init];
+  output.videoSettings = @{ (id)kCVPixelBufferPixelFormatTypeKey : @(kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange) };
+  output.alwaysDiscardsLateVideoFrames = YES;
+  [output setSampleBufferDelegate:self queue:_captureQueue];
+
+  _captureSession = [[AVCaptureSession alloc] init];
+  _captureSession.sessionPreset = AVCaptureSessionPreset640x480;
+  if (![_captureSession canAddInput:input] || ![_captureSession canAddOutput:output]) {
+    NSLog(@"[ERROR] Cannot configure the capture session");
+    _captureSession = nil;
+    return;
+  }
+  [_captureSession addInput:input];
+  [_captureSession addOutput:output];
+
+  AVCaptureConnection *connection = [output connectionWithMediaType:AVMediaTypeVideo];
+  if (connection.isVideoOrientationSupported) {
+    connection.videoOrientation = AVCaptureVideoOrientationPortrait;
+  }
+}
+
+- (void)releaseCapture
+{
+  [self stopCapture];
+  _captureSession = nil;
+}
+
+- (int32_t)startCapture
+{
+  if (_captureSession == nil) {
+    return -1;
+  }
+  _capturing = YES;
+  dispatch_async(_captureQueue, ^{
+    [self->_captureSession startRunning];
+  });
+  return 0;
+}
+
+- (int32_t)stopCapture
+{
+  _capturing = NO;
+  AVCaptureSession *session = _captureSession;
+  dispatch_sync(_captureQueue, ^{
+    [session stopRunning];
+  });
+  return 0;
+}
+
+- (BOOL)isCaptureStarted
+{
+  return _capturing;
+}
+
+- (int32_t)captureSettings:(OTVideoFormat *)videoFormat
+{
+  uint64_t size = _captureSize.load(std::memory_order_relaxed);
+  double frameRate = _frameRate.load(std::memory_order_relaxed);
+  videoFormat.pixelFormat = OTPixelFormatNV12;
+  videoFormat.imageWidth = size != 0 ? uint32_t(size >> 32) : TiVonageCameraWidth;
+  videoFormat.imageHeight = size != 0 ? uint32_t(size & 0xFFFFFFFF) : TiVonageCameraHeight;
+  videoFormat.estimatedFramesPerSecond = frameRate > 0 ? frameRate : TiVonageCameraFrameRate;
+  return 0;
+}
+
+// Capture queue only. The pool is created for the camera's size and
+// recreated if that ever changes.
+- (CVPixelBufferRef)createPooledBufferWithWidth:(size_t)width height:(size_t)height CF_RETURNS_RETAINED
+{
+  if (_pool == NULL || width != _poolWidth || height != _poolHeight) {
+    if (_pool != NULL) {
+      CVPixelBufferPoolRelease(_pool);
+      _pool = NULL;
+    }
+    NSDictionary *poolAttributes = @{ (id)kCVPixelBufferPoolMinimumBufferCountKey : @(TiVonageCapturePoolSize) };
+    NSDictionary *bufferAttributes = @{
+      (id)kCVPixelBufferPixelFormatTypeKey : @(kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange),
+      (id)kCVPixelBufferWidthKey : @(width),
+      (id)kCVPixelBufferHeightKey : @(height),
+      (id)kCVPixelBufferIOSurfacePropertiesKey : @{},
+    };
+    if (CVPixelBufferPoolCreate(kCFAllocatorDefault, (__bridge CFDictionaryRef)poolAttributes, (__bridge CFDictionaryRef)bufferAttributes, &_pool) != kCVReturnSuccess) {
+      NSLog(@"[ERROR] Cannot create the capture buffer pool");
+      _pool = NULL;
+      return NULL;
+    }
+    _poolWidth = width;
+    _poolHeight = height;
+  }
+
+  CVPixelBufferRef pixelBuffer = NULL;
+  if (CVPixelBufferPoolCreatePixelBufferWithAuxAttributes(kCFAllocatorDefault, _pool, _poolAuxAttributes, &pixelBuffer) != kCVReturnSuccess) {
+    return NULL;
+  }
+  return pixelBuffer;
+}
+
+static tivonage::VideoFrame TiVonageLockedFrame(CVPixelBufferRef pixelBuffer)
+{
+  tivonage::VideoFrame frame;
+  frame.format = tivonage::PixelFormat::NV12;
+  frame.width = int(CVPixelBufferGetWidth(pixelBuffer));
+  frame.height = int(CVPixelBufferGetHeight(pixelBuffer));
+  for (size_t plane = 0; plane < 2; plane++) {
+    frame.planes[plane].data = (uint8_t *)CVPixelBufferGetBaseAddressOfPlane(pixelBuffer, plane);
+    frame.planes[plane].stride = int(CVPixelBufferGetBytesPerRowOfPlane(pixelBuffer, plane));
+  }
+  return frame;
+}
+
+// Copies the frame into a pooled buffer, scaling it to the capture size if
+// one is set, or returns NULL when the pool is exhausted.
+- (CVPixelBufferRef)copyToPooledBuffer:(const tivonage::VideoFrame &)source CF_RETURNS_RETAINED
+{
+  size_t width = size_t(source.width);
+  size_t height = size_t(source.height);
+  uint64_t captureSize = _captureSize.load(std::memory_order_relaxed);
+  if (captureSize != 0) {
+    width = MIN(width, size_t(captureSize >> 32));
+    height = MIN(height, size_t(captureSize & 0xFFFFFFFF));
+  }
+  CVPixelBufferRef pixelBuffer = [self createPooledBufferWithWidth:width height:height];
+  if (pixelBuffer == NULL) {
+    return NULL;
+  }
+
+  CVPixelBufferLockBaseAddress(pixelBuffer, 0);
+  tivonage::VideoFrame destination = TiVonageLockedFrame(pixelBuffer);
+  bool copied = source.width == destination.width && source.height == destination.height
+      ? tivonage::copyFrame(source, destination)
+      : _scaler->scale(source, destination);
+  CVPixelBufferUnlockBaseAddress(pixelBuffer, 0);
+
+  if (!copied) {
+    CVPixelBufferRelease(pixelBuffer);
+    return NULL;
+  }
+  return pixelBuffer;
+}
+
+// Encodes into the one reused buffer; the consumer copies metadata into its
+// frame before returning.
+- (NSData *)nextFrameMetadata
+{
+  tivonage::FrameMetadata metadata;
+  metadata.sequence = _sequence++;
+  metadata.captureTimeUs = tivonage::wallClockMicros();
+  NSData *payload = self.metadataPayload;
+  metadata.payloadSize = uint8_t(std::min<NSUInteger>(payload.length, tivonage::FrameMetadata::kMaxPayloadSize));
+  memcpy(metadata.payload, payload.bytes, metadata.payloadSize);
+
+  _metadata.length = tivonage::FrameMetadata::kMaxEncodedSize;
+  size_t size = tivonage::encodeFrameMetadata(metadata, (uint8_t *)_metadata.mutableBytes, _metadata.length);
+  if (size == 0) {
+    return nil;
+  }
+  _metadata.length = size;
+  return _metadata;
+}
+
+// Runs the static scene detector on a locked camera frame, switching the
+// content hint when the state changes. Capture queue only.
+- (void)detectStaticScene:(const tivonage::VideoFrame &)frame timestamp:(CMTime)timestamp
+{
+  if (!_detectsStaticScene.load(std::memory_order_relaxed)) {
+    if (_sceneIsStatic.exchange(false, std::memory_order_relaxed)) {
+      _sceneDetector.reset();
+      [self sceneDidChange:NO];
+    }
+    return;
+  }
+  int64_t nowUs = CMTIME_IS_VALID(timestamp) ? int64_t(CMTimeGetSeconds(timestamp) * 1000000.0) : tivonage::monotonicMicros();
+  if (!_sceneDetector.update(frame, nowUs)) {
+    return;
+  }
+  bool isStatic = _sceneDetector.isStatic();
+  _sceneIsStatic.store(isStatic, std::memory_order_relaxed);
+  self.videoContentHint = isStatic ? OTVideoContentHintDetail : OTVideoContentHintMotion;
+  // Motion is sent from the very next frame rather than at the end of the
+  // slow interval.
+  if (!isStatic) {
+    _nextFrameUs = 0;
+  }
+  [self sceneDidChange:isStatic];
+}
+
+- (void)sceneDidChange:(BOOL)isStatic
+{
+  void (^handler)(BOOL, double) = self.staticSceneHandler;
+  if (handler != nil) {
+    handler(isStatic, [self sendFrameRate]);
+  }
+}
+
+// The lower of the capture frame rate and the static scene's, 0 for the
+// camera's own.
+- (double)sendFrameRate
+{
+  double frameRate = _frameRate.load(std::memory_order_relaxed);
+  if (_sceneIsStatic.load(std::memory_order_relaxed)) {
+    double staticRate = _sceneDetector.config().staticFrameRate;
+    frameRate = frameRate > 0 ? MIN(frameRate, staticRate) : staticRate;
+  }
+  return frameRate;
+}
+
+// Thins the camera's frames out to the capture frame rate. Capture queue
+// only.
+- (BOOL)shouldSendFrameAt:(CMTime)timestamp
+{
+  double frameRate = [self sendFrameRate];
+  if (frameRate <= 0 || frameRate >= TiVonageCameraFrameRate || !CMTIME_IS_VALID(timestamp)) {
+    return YES;
+  }
+  int64_t nowUs = int64_t(CMTimeGetSeconds(timestamp) * 1000000.0);
+  int64_t intervalUs = int64_t(1000000.0 / frameRate);
+  // Half a camera frame of slack, so a 15 fps target keeps every other frame.
+  int64_t slackUs = int64_t(500000.0 / TiVonageCameraFrameRate);
+  if (nowUs + slackUs < _nextFrameUs) {
+    return NO;
+  }
+  _nextFrameUs = MAX(_nextFrameUs, nowUs) + intervalUs;
+  return YES;
+}
+
+// Capture queue, or the processing worker while there are stages.
+- (void)sendFrame:(const tivonage::VideoFrame &)frame timestamp:(CMTime)timestamp
+{
+  id<OTVideoCaptureConsumer> consumer = self.videoCaptureConsumer;
+  if (consumer == nil || !_capturing) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(_sendMutex);
+  CVPixelBufferRef pixelBuffer = [self copyToPooledBuffer:frame];
+  if (pixelBuffer == NULL) {
+    _droppedFrames.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  NSData *metadata = self.stampsFrameMetadata ? [self nextFrameMetadata] : nil;
+  [consumer consumeImageBuffer:pixelBuffer
+                   orientation:OTVideoOrientationUp
+                     timestamp:timestamp
+                      metadata:metadata];
+  CVPixelBufferRelease(pixelBuffer);
+  _capturedFrames.fetch_add(1, std::memory_order_relaxed);
+}
+
+#pragma mark AVCaptureVideoDataOutputSampleBufferDelegate
+
+- (void)captureOutput:(AVCaptureOutput *)output didOutputSampleBuffer:(CMSampleBufferRef)sampleBuffer fromConnection:(AVCaptureConnection *)connection
+{
+  CVImageBufferRef imageBuffer = CMSampleBufferGetImageBuffer(sampleBuffer);
+  if (imageBuffer == NULL || self.videoCaptureConsumer == nil || !_capturing
+      || CVPixelBufferGetPixelFormatType(imageBuffer) != kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange) {
+    return;
+  }
+  CMTime timestamp = CMSampleBufferGetPresentationTimeStamp(sampleBuffer);
+
+  CVPixelBufferLockBaseAddress(imageBuffer, kCVPixelBufferLock_ReadOnly);
+  tivonage::VideoFrame frame = TiVonageLockedFrame(imageBuffer);
+  // Every camera frame is compared, including the ones thinned out below, so
+  // motion is caught on the frame it starts.
+  [self detectStaticScene:frame timestamp:timestamp];
+  if (![self shouldSendFrameAt:timestamp]) {
+    CVPixelBufferUnlockBaseAddress(imageBuffer, kCVPixelBufferLock_ReadOnly);
+    return;
+  }
+  if (_processing.load(std::memory_order_relaxed)) {
+    // The processor copies the frame, so the camera buffer goes back before
+    // any stage runs; the worker sends the result.
+    frame.timestampUs = CMTIME_IS_VALID(timestamp) ? int64_t(CMTimeGetSeconds(timestamp) * 1000000.0) : 0;
+    if (!_processor->submit(frame)) {
+      _droppedFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+  } else {
+    [self sendFrame:frame timestamp:timestamp];
+  }
+  CVPixelBufferUnlockBaseAddress(imageBuffer, kCVPixelBufferLock_ReadOnly);
+}
+
+@end
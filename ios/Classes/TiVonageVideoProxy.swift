@@ -15,11 +15,21 @@ public class TiVonageVideoProxy : TiViewProxy {
   public func _init(withPageContext context: TiEvaluator!, videoView: UIView) -> Self! {
     super._init(withPageContext: context)
     
-    self.publisherView.videoView = publisherView
+    self.publisherView.videoView = videoView
     
     return self
   }
 
+  /// The view's size in device pixels; zero while it isn't attached.
+  var pixelSize: CGSize {
+    return viewAttached() ? publisherView.pixelSize : .zero
+  }
+
+  /// Whether the proxy's view exists, is attached and can be seen.
+  var isVisibleOnScreen: Bool {
+    return viewAttached() && publisherView.isVisibleOnScreen
+  }
+
   lazy var publisherView: TiVonageVideo = {
     return self.view as! TiVonageVideo
   }()
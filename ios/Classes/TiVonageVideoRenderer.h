@@ -0,0 +1,63 @@
+//
+//  TiVonageVideoRenderer.h
+//  ti.vonage
+//
+
+#import <OpenTok/OpenTok.h>
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * OTVideoRender that receives frames into a fixed pool of reusable plane
+ * buffers and hands those buffers to its view without a further copy.
+ * Assign it to OTSubscriberKit.videoRender / OTPublisherKit.videoRender and
+ * show `view` instead of the SDK's own view.
+ */
+@interface TiVonageVideoRenderer : NSObject <OTVideoRender>
+
+@property (nonatomic, readonly) UIView *view;
+
+/// Frames shown by the view (or gallery tile), and frames dropped on the
+/// way: no pool buffer free, or replaced by a newer one before the next
+/// display refresh could show them.
+@property (nonatomic, readonly) uint64_t displayedFrames;
+@property (nonatomic, readonly) uint64_t droppedFrames;
+
+/**
+ * Render health: `received`, `displayed` and `dropped` frame counts, and
+ * over the last 128 frames `receivedFps`, `displayedFps`, `jitter` and
+ * `displayJitter` (standard deviation of the inter-frame interval, ms) and
+ * `maxFrameInterval` (ms). Rates read 0 while the stream is stalled.
+ */
+- (NSDictionary<NSString *, NSNumber *> *)renderStats;
+
+/// Collect the module's per-frame metadata (sequence, capture time, payload)
+/// from rendered frames. Off by default.
+@property (atomic, assign) BOOL collectsFrameMetadata;
+
+/**
+ * Returns and forgets the metadata collected since the last call, oldest
+ * first, as dictionaries with `sequence`, `captureTime` and `receiveTime`
+ * (wall-clock milliseconds) and `payload` (string, if any). Call from one
+ * thread only.
+ */
+- (NSArray<NSDictionary<NSString *, id> *> *)drainFrameMetadata;
+
+/// Record the time from capture (per the sender's frame metadata) to this
+/// renderer receiving each frame. Off by default.
+@property (atomic, assign) BOOL measuresLatency;
+
+/**
+ * Latency recorded so far: `count`, plus `min`, `mean`, `p50`, `p95`, `p99`
+ * and `max` in milliseconds. Both clocks are wall clocks, so the numbers are
+ * only as good as the devices' clock synchronisation.
+ */
+- (NSDictionary<NSString *, NSNumber *> *)latencyStats;
+
+- (instancetype)init;
+- (instancetype)initWithPoolCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,246 @@
+//
+//  TiVonageVideoRenderer.mm
+//  ti.vonage
+//
+
+#import "TiVonageVideoRenderer.h"
+
+#import "TiVonageRenderView.h"
+
+#include "tivonage/Clock.h"
+#include "tivonage/FrameMetadata.h"
+#include "tivonage/FrameScaler.h"
+#include "tivonage/LatencyHistogram.h"
+#include "tivonage/PixelConvert.h"
+#include "tivonage/SpscQueue.h"
+
+#include <atomic>
+#include <memory>
+
+// Enough for one frame on screen, one queued in the display layer, one
+// waiting in the mailbox and one being written by the SDK thread, plus one
+// spare for resolution changes.
+static const NSUInteger TiVonageDefaultPoolCapacity = 5;
+
+// Metadata records kept between drains; at 30 fps a drain every second
+// needs 30. Records beyond this are dropped.
+static const size_t TiVonageMetadataQueueCapacity = 256;
+
+@implementation TiVonageVideoRenderer {
+  std::shared_ptr<tivonage::FramePool> _pool;
+  std::unique_ptr<tivonage::FrameScaler> _scaler;
+  std::unique_ptr<tivonage::SpscQueue<tivonage::ReceivedFrameMetadata>> _metadata;
+  std::unique_ptr<tivonage::LatencyHistogram> _latency;
+  TiVonageRenderView *_renderView;
+  id<TiVonageFrameTarget> _target;
+  std::shared_ptr<tivonage::MediaRecorder> _recorder;
+  std::shared_ptr<tivonage::RenderStats> _stats;
+}
+
+- (instancetype)init
+{
+  return [self initWithPoolCapacity:TiVonageDefaultPoolCapacity];
+}
+
+- (instancetype)initWithPoolCapacity:(NSUInteger)capacity
+{
+  if (self = [super init]) {
+    _pool = tivonage::FramePool::create(capacity);
+    _scaler.reset(new tivonage::FrameScaler(tivonage::ScaleFilter::Box));
+    _metadata.reset(new tivonage::SpscQueue<tivonage::ReceivedFrameMetadata>(TiVonageMetadataQueueCapacity));
+    _latency.reset(new tivonage::LatencyHistogram());
+    _stats = std::make_shared<tivonage::RenderStats>();
+    _renderView = [[TiVonageRenderView alloc] initWithFrame:CGRectZero];
+    [_renderView setRenderStats:_stats];
+    _target = _renderView;
+  }
+  return self;
+}
+
+- (UIView *)view
+{
+  return _renderView;
+}
+
+- (void)renderVideoFrame:(OTVideoFrame *)frame
+{
+  OTVideoFormat *format = frame.format;
+  if (format == nil || frame.planes == nil) {
+    return;
+  }
+  const int64_t receivedUs = tivonage::monotonicMicros();
+  _stats->frameReceived(receivedUs);
+
+  BOOL collects = self.collectsFrameMetadata;
+  BOOL measures = self.measuresLatency;
+  if (collects || measures) {
+    [self readMetadata:frame.metadata collect:collects measure:measures];
+  }
+
+  tivonage::VideoFrame source;
+  source.format = tivonage::PixelFormat(format.pixelFormat);
+  source.width = int(format.imageWidth);
+  source.height = int(format.imageHeight);
+  source.orientation = tivonage::VideoOrientation(frame.orientation);
+  // Arrival time, on the clock the played audio runs to, places the frame on
+  // the recording's frame grid.
+  source.timestampUs = receivedUs;
+  NSUInteger planeCount = MIN(frame.planes.count, format.bytesPerRow.count);
+  if (planeCount < NSUInteger(tivonage::planeCount(source.format))) {
+    return;
+  }
+  for (NSUInteger plane = 0; plane < planeCount && plane < 3; plane++) {
+    source.planes[plane].data = (uint8_t *)[frame.planes pointerAtIndex:plane];
+    source.planes[plane].stride = [format.bytesPerRow[plane] intValue];
+  }
+
+  if (std::shared_ptr<tivonage::MediaRecorder> recorder = [self recorder]) {
+    recorder->writeVideoFrame(source);
+  }
+
+  // The SDK reuses its planes once this method returns, so this is the one
+  // copy a frame gets; from here on only the pooled buffer is passed around.
+  // The display layer takes bi-planar 4:2:0 natively, so planar I420 is
+  // interleaved to NV12 as part of that copy. Tiles smaller than the stream
+  // are downscaled and rotated frames turned upright in the same pass, so the
+  // display layer never has to resample (or keep) more pixels than the view
+  // shows, nor composite a transformed layer.
+  tivonage::PixelFormat displayFormat = source.format == tivonage::PixelFormat::I420 ? tivonage::PixelFormat::NV12 : source.format;
+  tivonage::Rotation rotation = tivonage::uprightRotation(source.orientation);
+  bool swap = tivonage::swapsDimensions(rotation);
+  int uprightWidth = swap ? source.height : source.width;
+  int uprightHeight = swap ? source.width : source.height;
+  int boundsWidth = 0;
+  int boundsHeight = 0;
+  id<TiVonageFrameTarget> target = [self frameTarget];
+  [target getPixelWidth:&boundsWidth height:&boundsHeight];
+  int width = uprightWidth;
+  int height = uprightHeight;
+  tivonage::scaledSizeToFill(uprightWidth, uprightHeight, boundsWidth, boundsHeight, width, height);
+
+  tivonage::FrameHandle handle = _pool->acquire(displayFormat, width, height);
+  if (!handle) {
+    // Every buffer is still on its way to the screen.
+    _stats->frameDropped();
+    return;
+  }
+  bool copied = rotation == tivonage::Rotation::None && width == source.width && height == source.height
+      ? tivonage::convertFrame(source, handle.frame())
+      : _scaler->scale(source, handle.frame(), rotation);
+  if (!copied) {
+    return;
+  }
+
+  // Hand off without touching the main thread; if the UI falls behind, the
+  // mailbox keeps only the newest frame.
+  handle.frame().timestampUs = CMTIME_IS_VALID(frame.timestamp) ? int64_t(CMTimeGetSeconds(frame.timestamp) * 1000000.0) : 0;
+  if (![target publishFrame:std::move(handle)]) {
+    _stats->frameDropped();
+  }
+}
+
+- (id<TiVonageFrameTarget>)frameTarget
+{
+  @synchronized(self) {
+    return _target;
+  }
+}
+
+- (void)setFrameTarget:(id<TiVonageFrameTarget>)target
+{
+  @synchronized(self) {
+    _target = target ?: _renderView;
+    [_target setRenderStats:_stats];
+  }
+}
+
+- (std::shared_ptr<tivonage::MediaRecorder>)recorder
+{
+  @synchronized(self) {
+    return _recorder;
+  }
+}
+
+- (void)setRecorder:(std::shared_ptr<tivonage::MediaRecorder>)recorder
+{
+  @synchronized(self) {
+    _recorder = std::move(recorder);
+  }
+}
+
+- (void)readMetadata:(NSData *)data collect:(BOOL)collect measure:(BOOL)measure
+{
+  tivonage::ReceivedFrameMetadata record;
+  if (data.length == 0 || !tivonage::decodeFrameMetadata((const uint8_t *)data.bytes, data.length, record.metadata)) {
+    return;
+  }
+  record.receivedTimeUs = tivonage::wallClockMicros();
+  if (measure) {
+    _latency->record(record.receivedTimeUs - record.metadata.captureTimeUs);
+  }
+  if (collect) {
+    _metadata->push(record);
+  }
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)latencyStats
+{
+  tivonage::LatencyHistogram::Summary summary = _latency->summary();
+  return @{
+    @"count" : @(summary.count),
+    @"min" : @(double(summary.minUs) / 1000.0),
+    @"mean" : @(double(summary.meanUs) / 1000.0),
+    @"p50" : @(double(summary.p50Us) / 1000.0),
+    @"p95" : @(double(summary.p95Us) / 1000.0),
+    @"p99" : @(double(summary.p99Us) / 1000.0),
+    @"max" : @(double(summary.maxUs) / 1000.0),
+  };
+}
+
+- (NSArray<NSDictionary<NSString *, id> *> *)drainFrameMetadata
+{
+  NSMutableArray<NSDictionary<NSString *, id> *> *frames = [NSMutableArray array];
+  tivonage::ReceivedFrameMetadata record;
+  while (_metadata->pop(record)) {
+    NSMutableDictionary<NSString *, id> *entry = [NSMutableDictionary dictionaryWithDictionary:@{
+      @"sequence" : @(record.metadata.sequence),
+      @"captureTime" : @(double(record.metadata.captureTimeUs) / 1000.0),
+      @"receiveTime" : @(double(record.receivedTimeUs) / 1000.0),
+    }];
+    if (record.metadata.payloadSize > 0) {
+      NSString *payload = [[NSString alloc] initWithBytes:record.metadata.payload length:record.metadata.payloadSize encoding:NSUTF8StringEncoding];
+      if (payload != nil) {
+        entry[@"payload"] = payload;
+      }
+    }
+    [frames addObject:entry];
+  }
+  return frames;
+}
+
+- (uint64_t)droppedFrames
+{
+  return _stats->snapshot(tivonage::monotonicMicros()).dropped;
+}
+
+- (uint64_t)displayedFrames
+{
+  return _stats->snapshot(tivonage::monotonicMicros()).displayed;
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)renderStats
+{
+  tivonage::RenderStats::Snapshot snapshot = _stats->snapshot(tivonage::monotonicMicros());
+  return @{
+    @"received" : @(snapshot.received),
+    @"displayed" : @(snapshot.displayed),
+    @"dropped" : @(snapshot.dropped),
+    @"receivedFps" : @(snapshot.receiving.fps),
+    @"displayedFps" : @(snapshot.displaying.fps),
+    @"jitter" : @(snapshot.receiving.jitterMs),
+    @"displayJitter" : @(snapshot.displaying.jitterMs),
+    @"maxFrameInterval" : @(snapshot.receiving.maxIntervalMs),
+  };
+}
+
+@end